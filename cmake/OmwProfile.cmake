@@ -0,0 +1,40 @@
+# Prepares the profile recorded by an instrumented module for the optimized build
+#
+# Invoked with cmake -P by the PGO stage of omw_add_octave and omw_add_mathematica,
+# after the workload ran on the instrumented module:
+#  COMPILER_ID     - CMAKE_CXX_COMPILER_ID of the build
+#  GENERATE_DIR    - GNU: object directory of the instrumented target
+#  USE_DIR         - GNU: object directory of the optimized target
+#  PROFILE_DIR     - Clang: directory of the raw profiles
+#  LLVM_PROFDATA   - Clang: llvm-profdata executable
+#  STAMP           - File to touch once the profile is ready
+
+if(COMPILER_ID STREQUAL "GNU")
+  # GCC looks for the profile of an object next to it, so the .gcda files written next
+  # to the instrumented objects are moved to the same place in the optimized target
+  file(GLOB_RECURSE GCDA_FILES RELATIVE ${GENERATE_DIR} ${GENERATE_DIR}/*.gcda)
+  if(NOT GCDA_FILES)
+    message(FATAL_ERROR "The workload did not record any profile in ${GENERATE_DIR}")
+  endif()
+
+  foreach(GCDA_FILE ${GCDA_FILES})
+    get_filename_component(GCDA_DIR ${USE_DIR}/${GCDA_FILE} DIRECTORY)
+    file(MAKE_DIRECTORY ${GCDA_DIR})
+    file(RENAME ${GENERATE_DIR}/${GCDA_FILE} ${USE_DIR}/${GCDA_FILE})
+  endforeach()
+else()
+  file(GLOB PROFRAW_FILES ${PROFILE_DIR}/*.profraw)
+  if(NOT PROFRAW_FILES)
+    message(FATAL_ERROR "The workload did not record any profile in ${PROFILE_DIR}")
+  endif()
+
+  execute_process(COMMAND ${LLVM_PROFDATA} merge -o ${PROFILE_DIR}/default.profdata ${PROFRAW_FILES}
+    RESULT_VARIABLE MERGE_RESULT)
+  if(NOT MERGE_RESULT EQUAL 0)
+    message(FATAL_ERROR "Failed to merge the profiles in ${PROFILE_DIR}")
+  endif()
+
+  file(REMOVE ${PROFRAW_FILES})
+endif()
+
+file(WRITE ${STAMP} "")
@@ -9,11 +9,32 @@
 #define _OMW_HPP_
 
 #include "omw/array.hpp"
+#include "omw/autotune.hpp"
+#include "omw/batch_file.hpp"
+#include "omw/bitmask.hpp"
+#include "omw/call_profiler.hpp"
+#include "omw/dictionary.hpp"
+#include "omw/frame_delta.hpp"
+#include "omw/graphics.hpp"
 #include "omw/matrix.hpp"
+#include "omw/matrix_batch.hpp"
+#include "omw/matrix_view.hpp"
+#include "omw/message_queue.hpp"
+#include "omw/mip_pyramid.hpp"
+#include "omw/pipeline.hpp"
+#include "omw/plugin.hpp"
+#include "omw/ragged_array.hpp"
+#include "omw/range_view.hpp"
+#include "omw/remote_array.hpp"
+#include "omw/snapshot.hpp"
+#include "omw/tiled_matrix.hpp"
+#include "omw/transpose.hpp"
 
 #include "omw/wrapper_base.hpp"
 
+#include "omw/batch.hpp"
 #include "omw/mathematica.hpp"
 #include "omw/octavew.hpp"
+#include "omw/python.hpp"
 
 #endif /* _OMW_HPP_ */
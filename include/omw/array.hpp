@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "omw/pre.hpp"
+#include "omw/validation.hpp"
 
 namespace omw
 {
@@ -21,6 +22,8 @@ namespace omw
  */
 template <typename T> class basic_array
 {
+	array_stats m_stats;
+
 	public:
 	/**
 	 * @brief Base class destructor
@@ -49,6 +52,20 @@ template <typename T> class basic_array
 	 * @return Number of elements in the array
 	 */
 	virtual std::size_t size() const = 0;
+
+	/**
+	 * @brief Statistics gathered while this array was read as a parameter.
+	 *
+	 * @return Statistics, not valid if none were requested
+	 */
+	const array_stats &stats() const { return m_stats; }
+
+	/**
+	 * @brief Attaches statistics to this array.
+	 *
+	 * @param stats Statistics gathered while reading the array
+	 */
+	void stats(const array_stats &stats) { m_stats = stats; }
 };
 
 /**
@@ -100,6 +117,62 @@ public:
 		return std::make_shared<vector_array<T>>(std::vector<T>(std::forward<Args>(args)...));
 	}
 };
+
+/**
+ * @brief Represents a 1D array stored in memory owned by another object, such as a
+ * buffer exported by the host.
+ */
+template <typename T> class mapped_array : public basic_array<T>
+{
+	std::shared_ptr<const void> m_owner;
+	const T *m_data;
+	std::size_t m_size;
+
+public:
+	/**
+	 * @brief Pointer to the array data.
+	 *
+	 * @return Pointer to the underlying memory block
+	 */
+	const T *data() const override { return m_data; }
+
+	/**
+	 * @brief Accesses an element by index.
+	 *
+	 * @param idx 0-based index of the element in the array
+	 * @return Reference to the element at the given index
+	 */
+	const T &operator[](std::size_t idx) const override { return m_data[idx]; }
+
+	/**
+	 * @brief Obtains the size of the array.
+	 *
+	 * @return Number of elements in the array
+	 */
+	std::size_t size() const override { return m_size; }
+
+	/**
+	 * @brief Initializes a new instance of the omw::mapped_array class.
+	 *
+	 * @param owner Object that keeps \p data alive
+	 * @param data  Elements of the array
+	 * @param size  Number of elements
+	 */
+	mapped_array(std::shared_ptr<const void> owner, const T *data, std::size_t size)
+	: m_owner(std::move(owner)), m_data(data), m_size(size)
+	{
+	}
+
+	/**
+	 * @brief Builds an omw::mapped_array &lt;T&gt; from arguments to its constructor.
+	 *
+	 * @see #mapped_array
+	 */
+	template <typename... Args> static std::shared_ptr<basic_array<T>> make(Args&&... args)
+	{
+		return std::make_shared<mapped_array<T>>(std::forward<Args>(args)...);
+	}
+};
 }
 
 #endif /* _OMW_ARRAY_HPP_ */
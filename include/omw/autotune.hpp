@@ -0,0 +1,68 @@
+/**
+ * @file   omw/autotune.hpp
+ * @brief  Definition of omw::autotune
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_AUTOTUNE_HPP_
+#define _OMW_AUTOTUNE_HPP_
+
+#include <string>
+
+namespace omw
+{
+/**
+ * @brief Machine-dependent parameters of the marshaling kernels
+ */
+struct tuning_parameters
+{
+	/// Block size of the column-major to row-major conversions, see omw::blocked_copy
+	int transpose_block = 32;
+	/// Tile size of omw::tiled_matrix parameters
+	int tile_size = 64;
+	/// true if the parameters were read from the cache file instead of measured
+	bool from_cache = false;
+};
+
+/**
+ * @brief Gets the model name of the CPU, used to key the autotuning cache
+ *
+ * @return CPU model name, or "unknown" if it cannot be determined
+ */
+std::string cpu_model();
+
+/**
+ * @brief Gets the default path of the autotuning cache.
+ *
+ * This is $OMW_AUTOTUNE_CACHE if set, otherwise omw/autotune in $XDG_CACHE_HOME or
+ * $HOME/.cache.
+ *
+ * @return Path of the cache file, or an empty string if no location is known
+ */
+std::string default_autotune_cache();
+
+/**
+ * @brief Micro-benchmarks the marshaling kernels with every candidate parameter
+ *
+ * This takes in the order of a few hundred milliseconds.
+ *
+ * @return Fastest parameters on this host
+ */
+tuning_parameters measure_tuning_parameters();
+
+/**
+ * @brief Gets the tuning parameters for this host.
+ *
+ * The parameters are read from the cache file if it has an entry for the CPU model of
+ * this host. Otherwise they are measured and appended to the cache file, so the
+ * measurement happens once per CPU model. Entries of other CPU models are kept, so a
+ * cache file can be shared by several hosts.
+ *
+ * @param cache_path Path of the cache file, or an empty string to always measure
+ * @return Tuning parameters
+ */
+tuning_parameters autotune(const std::string &cache_path = default_autotune_cache());
+}
+
+#endif /* _OMW_AUTOTUNE_HPP_ */
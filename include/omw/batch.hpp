@@ -0,0 +1,662 @@
+/**
+ * @file   omw/batch.hpp
+ * @brief  Definition of omw::batch
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_BATCH_HPP_
+#define _OMW_BATCH_HPP_
+
+#if OMW_BATCH
+
+#include <map>
+#include <sstream>
+#include <stack>
+
+#include <boost/optional.hpp>
+
+#include "omw/pre.hpp"
+#include "omw/batch_file.hpp"
+#include "omw/type_traits.hpp"
+
+namespace omw
+{
+/**
+ * @brief Represents the interface wrapper for batch runs, where arguments are read
+ * from batch files instead of an interpreter. See omw::batch_main.
+ */
+class batch : public wrapper_base<batch>
+{
+	/// Current list of arguments
+	const batch_record *current_args_;
+	/// Current list of values to return
+	batch_value result_;
+	/// Result sublist stack
+	std::stack<batch_value *> result_stack_;
+
+	public:
+	/**
+	 * @brief Constructs a new batch interface wrapper
+	 * @param userInitializer User initialization function.
+	 */
+	batch(std::function<void(void)> userInitializer = std::function<void(void)>());
+
+	/**
+	 * @brief Get the result object for the current function call.
+	 *
+	 * @return Reference to the list of values to be returned
+	 */
+	batch_value &result();
+
+	/**
+	 * @brief Pushes a new sublist onto the result stack
+	 */
+	void push_result();
+
+	/**
+	 * @brief Pops the top sublist of the result stack
+	 */
+	void pop_result();
+
+	/**
+	 * @brief Get the arguments object for the current function call.
+	 *
+	 * @return Reference to the record that contains the parameters
+	 */
+	inline const batch_record &args() { return *current_args_; }
+
+	/**
+	 * @brief Base class for wrapper parameter readers
+	 */
+	struct param_reader_base
+	{
+		protected:
+		/// Reference to the object that created this parameter reader
+		batch &w_;
+
+		/**
+		 * @brief Initializes a new instance of the ParamReaderBase class
+		 *
+		 * @param w Wrapper this instance is reading parameters from.
+		 */
+		param_reader_base(batch &w);
+
+		/**
+		 * @brief Ensures the current parameter matches the parameter requested by the caller.
+		 * @param paramIdx  Ordinal index of the parameter
+		 * @param paramName User-friendly name of the parameter
+		 * @throws std::runtime_error See GetParam for details.
+		 */
+		void check_parameter_idx(size_t paramIdx, const std::string &paramName);
+
+		/**
+		 * @brief Gets the value of a parameter
+		 *
+		 * @param paramIdx Ordinal index of the parameter
+		 * @return Value of the parameter
+		 */
+		const batch_value &arg(size_t paramIdx) const { return w_.current_args_->items[paramIdx]; }
+	};
+
+	/**
+	 * @brief Template declaration for parameter readers
+	 */
+	template <class T, typename Enable = void> struct param_reader;
+
+	/**
+	 * @brief Atomic parameter reader template
+	 */
+	template <class T0>
+	struct param_reader<T0, typename std::enable_if<is_simple_param_type<T0>::value>::type> : public param_reader_base
+	{
+		/// Type of the returned parameter
+		typedef T0 return_type;
+
+		/**
+		 * @brief Initializes a new instance of the param_reader class.
+		 *
+		 * @param w Wrapper to read parameters from.
+		 */
+		param_reader(batch &w) : param_reader_base(w) {}
+
+		/**
+		 * @brief Attempts reading a parameter from the associated wrapper.
+		 *
+		 * @param paramIdx  Ordinal index of the parameter in the function call
+		 * @param paramName User-friendly name of the parameter
+		 * @param success   true on success, false on failure
+		 * @param getData   true if the function should attempt to read the parameter data,
+		 *                  false if the caller is just interested in the potential success.
+		 *
+		 * @return If \p getData is true and \p success is true, the value of the parameter.
+		 * Otherwise the return value is undefined.
+		 */
+		T0 try_read(size_t paramIdx, const std::string &paramName, bool &success, bool getData);
+
+		/**
+		 * @brief Attempts reading a parameter from the associated wrapper.
+		 *
+		 * @param paramIdx  Ordinal index of the parameter in the function call
+		 * @param paramName User-friendly name of the parameter
+		 * @return Value of the parameter
+		 * @throws std::runtime_error When the actual parameter is not of the requested type
+		 */
+		T0 operator()(size_t paramIdx, const std::string &paramName)
+		{
+			bool success = true;
+			T0 value = try_read(paramIdx, paramName, success, true);
+
+			if (!success)
+			{
+				std::stringstream ss;
+				ss << "Failed to read parameter " << paramName << " at index " << paramIdx;
+				throw std::runtime_error(ss.str());
+			}
+
+			return value;
+		}
+
+		/**
+		 * @brief Tests if the given parameter is of the required type.
+		 *
+		 * This function does not advance the current parameter.
+		 *
+		 * @param paramIdx  Ordinal index of the parameter in the function call
+		 * @param paramName User-friendly name of the parameter
+		 * @return true if the parameter is of the requested type, false otherwise
+		 */
+		bool is_type(size_t paramIdx, const std::string &paramName)
+		{
+			bool success = true;
+			try_read(paramIdx, paramName, success, false);
+
+			return success;
+		}
+	};
+
+	/**
+	 * @brief Optional parameter reader template
+	 */
+	template <class T> struct param_reader<boost::optional<T>> : public param_reader_base
+	{
+		/// Type of the returned parameter
+		typedef boost::optional<T> return_type;
+
+		/**
+		 * @brief Initializes a new instance of the param_reader class.
+		 *
+		 * @param w Wrapper to read parameters from.
+		 */
+		param_reader(batch &w) : param_reader_base(w) {}
+
+		/**
+		 * @brief Attempts reading a parameter from the associated wrapper.
+		 *
+		 * @param paramIdx  Ordinal index of the parameter in the function call
+		 * @param paramName User-friendly name of the parameter
+		 * @return Value of the parameter
+		 * @throws std::runtime_error When the actual parameter is not of the requested type
+		 */
+		return_type operator()(size_t paramIdx, const std::string &paramName)
+		{
+			if (paramIdx >= w_.current_args_->items.size())
+			{
+				return boost::optional<T>();
+			}
+
+			return boost::optional<T>(w_.get_param<T>(paramIdx, paramName));
+		}
+	};
+
+	/**
+	 * @brief Tuple parameter reader template
+	 */
+	template <class... Types>
+	struct param_reader<std::tuple<Types...>, typename std::enable_if<(sizeof...(Types) > 1)>::type>
+	: public param_reader_base
+	{
+		/// Type of the returned parameter
+		typedef std::tuple<Types...> return_type;
+
+		/**
+		 * @brief Initializes a new instance of the param_reader class.
+		 *
+		 * @param w Wrapper to read parameters from.
+		 */
+		param_reader(batch &w) : param_reader_base(w) {}
+
+		private:
+		/**
+		 * @brief Implementation of GetTupleParam variadic template function
+		 */
+		template <std::size_t... I>
+		decltype(auto)
+		get_tuple_param_impl(size_t paramIdx, const std::string &paramName, std::index_sequence<I...>)
+		{
+			return return_type{ w_.get_param<Types>(paramIdx + I, paramName)... };
+		}
+
+		public:
+		/**
+		 * @brief Attempts reading a parameter from the associated wrapper.
+		 *
+		 * @param firstParamIdx Ordinal index of the parameter in the function call
+		 * @param paramName     User-friendly name of the parameter
+		 * @return Value of the parameter
+		 * @throws std::runtime_error When the actual parameter is not of the requested type
+		 */
+		return_type operator()(size_t firstParamIdx, const std::string &paramName)
+		{
+			// Check first parameter location
+			check_parameter_idx(firstParamIdx, paramName);
+
+			// Check enough args are available
+			if (firstParamIdx + sizeof...(Types) > w_.current_args_->items.size())
+			{
+				std::stringstream ss;
+				ss << "Not enough args for building a tuple of size " << sizeof...(Types)
+				   << " for parameter " << paramName << " at index " << firstParamIdx;
+				throw std::runtime_error(ss.str());
+			}
+
+			std::tuple<Types...> result(
+			get_tuple_param_impl(firstParamIdx, paramName, std::make_index_sequence<sizeof...(Types)>()));
+
+			return result;
+		}
+	};
+
+	/**
+	 * @brief Variant parameter reader template
+	 */
+	template <class... Types>
+	struct param_reader<boost::variant<Types...>, typename std::enable_if<(sizeof...(Types) > 0)>::type>
+	: public param_reader_base
+	{
+		/// Type of the returned parameter
+		typedef boost::variant<Types...> return_type;
+
+		/// Type of this parameter reader
+		typedef param_reader<boost::variant<Types...>, typename std::enable_if<(sizeof...(Types) > 0)>::type> self_type;
+
+		/**
+		 * @brief Initializes a new instance of the param_reader class.
+		 *
+		 * @param w Wrapper to read parameters from.
+		 */
+		param_reader(batch &w) : param_reader_base(w) {}
+
+		private:
+		template <typename T>
+		static return_type variant_reader(self_type &pr, size_t paramIdx, const std::string &paramName)
+		{
+			if (!param_reader<T>(pr.w_).is_type(paramIdx, paramName))
+			{
+				std::stringstream ss;
+				ss << "Failed to get variant for parameter " << paramName << " at index " << paramIdx;
+				throw std::runtime_error(ss.str());
+			}
+
+			return return_type(param_reader<T>(pr.w_)(paramIdx, paramName));
+		}
+
+		template <typename T0, typename... Tn, typename = typename std::enable_if<(sizeof...(Tn) > 0)>::type>
+		static return_type variant_reader(self_type &pr, size_t paramIdx, const std::string &paramName)
+		{
+			if (param_reader<T0>(pr.w_).is_type(paramIdx, paramName))
+			{
+				return return_type(param_reader<T0>(pr.w_)(paramIdx, paramName));
+			}
+
+			return variant_reader<Tn...>(pr, paramIdx, paramName);
+		}
+
+		public:
+		/**
+		 * @brief Attempts reading a parameter from the associated wrapper.
+		 *
+		 * @param paramIdx  Ordinal index of the parameter in the function call
+		 * @param paramName User-friendly name of the parameter
+		 * @return Value of the parameter
+		 * @throws std::runtime_error When the actual parameter is not of the requested type
+		 */
+		return_type operator()(size_t paramIdx, const std::string &paramName)
+		{
+			return variant_reader<Types...>(*this, paramIdx, paramName);
+		}
+	};
+
+	/**
+	 * @brief Helper class to read a list of parameters
+	 */
+	template <class... Types>
+	class param_list_reader : public basic_param_list_reader<param_list_reader<Types...>, Types...>
+	{
+		typedef param_list_reader<Types...> self_type;
+
+		public:
+		/**
+		 * @brief Initializes a new instance of the param_list_reader class
+		 *
+		 * @param w         Wrapper to read parameters from
+		 * @param first_idx First parameter index
+		 * @param name      Name of the tuples to read
+		 */
+		param_list_reader(batch &w, size_t first_idx, const std::string &name)
+			: basic_param_list_reader<param_list_reader<Types...>, Types...>(w, first_idx, name)
+		{
+			basic_param_list_reader<param_list_reader<Types...>, Types...>::count_ =
+				(w.args().items.size() - first_idx) / sizeof...(Types);
+		}
+
+		static constexpr const size_t sizeof_tuple = sizeof...(Types);
+	};
+
+	/**
+	 * @brief Runs a named function on an argument record.
+	 * @param name Name of the function, used to aggregate its profile
+	 * @param args Record of arguments to the function
+	 * @param fun  Function to invoke
+	 * @return List of return values, or an error value if the function failed
+	 */
+	batch_value run_function(const char *name, const batch_record &args, std::function<void(batch &)> fun);
+
+	/**
+	 * @brief Base class for wrapper result writers
+	 */
+	struct result_writer_base
+	{
+		protected:
+		/// Reference to the object that created this result writer
+		batch &w_;
+
+		/**
+		 * @brief Initializes a new instance of the result_writer_base class
+		 *
+		 * @param w Wrapper this instance will write results to
+		 */
+		result_writer_base(batch &w);
+	};
+
+	/**
+	 * @brief Template declaration for result writers
+	 */
+	template <class T, typename Enable = void, class... Types> struct result_writer;
+
+	/**
+	 * @brief Atomic result writer template
+	 *
+	 * Matrices are stored by reference until the output file is written.
+	 */
+	template <class T0>
+	struct result_writer<T0, typename std::enable_if<is_simple_param_type<T0>::value>::type> : public result_writer_base
+	{
+		/// Type of the result
+		typedef T0 result_type;
+
+		/**
+		 * @brief Initialize a new instance of the result_writer class
+		 *
+		 * @param w Wrapper to write the result to
+		 */
+		result_writer(batch &w) : result_writer_base(w) {}
+
+		/**
+		 * @brief Writes the result to the wrapper instance
+		 *
+		 * @param result Result value to write
+		 */
+		void operator()(const result_type &result)
+		{
+			w_.result().items.push_back(batch_value(result));
+		}
+	};
+
+	/**
+	 * @brief Multiple result writer template
+	 */
+	template <class T0, class... Types>
+	struct result_writer<T0, typename std::enable_if<(sizeof...(Types) > 0)>::type, Types...>
+	: public result_writer_base
+	{
+		/**
+		 * @brief Initializes a new instance of the result_writer class.
+		 *
+		 * @param w Wrapper to read parameters from.
+		 */
+		result_writer(batch &w) : result_writer_base(w) {}
+
+		/**
+		 * @brief Writes the results to the wrapper instance
+		 *
+		 * @param result Result value to write
+		 */
+		void operator()(const T0& arg0, const Types&... results)
+		{
+			w_.push_result();
+
+			int _[] = { (w_.write_result<T0>(arg0), 0), (w_.write_result<Types>(results), 0)... };
+			(void)_;
+
+			w_.pop_result();
+		}
+	};
+
+	/**
+	 * @brief Writes the result \p args to the output record of the current call
+	 *
+	 * @param args Results to write
+	 */
+	template <class T0, class... Types>
+	void write_result(const T0& arg0, const Types&... args)
+	{
+		profile_results(arg0, args...);
+		call_profiler::phase_scope scope(profiler(), phase_encode);
+
+		result_writer<typename std::remove_reference<T0>::type, void,
+					  typename std::remove_reference<Types>::type...>(*this)(
+							arg0, args...);
+	}
+
+	/**
+	 * @brief Writes a frame of an animation stream as the result.
+	 *
+	 * Batch results are independent, so frames are always written in full.
+	 *
+	 * @param stream_id     Identifier of the stream
+	 * @param frame         Frame to write
+	 * @param host_sequence Unused, see mathematica::write_frame
+	 */
+	void write_frame(const std::string &stream_id, const std::shared_ptr<basic_matrix<float>> &frame,
+					 int host_sequence = -1)
+	{
+		(void)stream_id;
+		(void)host_sequence;
+		write_result(frame);
+	}
+
+	/**
+	 * @brief Replaces the result of the current call with an error value.
+	 * @param exceptionMessage Text of the error
+	 * @param messageName      Name of the message, prefixed to the text
+	 */
+	void send_failure(const std::string &exceptionMessage, const std::string &messageName = std::string("err"));
+
+	/**
+	 * @brief Writes queued messages to the standard error of the runner in a single
+	 * write, one line per message prefixed with its name. Records only hold results.
+	 *
+	 * @param messages Messages to write
+	 */
+	void send_messages(const std::vector<queued_message> &messages);
+};
+
+template <>
+bool batch::param_reader<bool>::try_read(size_t paramIdx, const std::string &paramName, bool &success, bool getData);
+
+template <>
+int batch::param_reader<int>::try_read(size_t paramIdx, const std::string &paramName, bool &success, bool getData);
+
+template <>
+unsigned int batch::param_reader<unsigned int>::try_read(size_t paramIdx, const std::string &paramName,
+														bool &success, bool getData);
+
+template <>
+float batch::param_reader<float>::try_read(size_t paramIdx, const std::string &paramName, bool &success, bool getData);
+
+template <>
+std::string batch::param_reader<std::string>::try_read(size_t paramIdx, const std::string &paramName,
+													  bool &success, bool getData);
+
+template <>
+std::shared_ptr<basic_array<float>>
+batch::param_reader<std::shared_ptr<basic_array<float>>>::try_read(size_t paramIdx, const std::string &paramName,
+																  bool &success, bool getData);
+
+template <>
+std::shared_ptr<basic_matrix<float>>
+batch::param_reader<std::shared_ptr<basic_matrix<float>>>::try_read(size_t paramIdx, const std::string &paramName,
+																   bool &success, bool getData);
+
+template <>
+matrix_view<float>
+batch::param_reader<matrix_view<float>>::try_read(size_t paramIdx, const std::string &paramName,
+												  bool &success, bool getData);
+
+template <>
+range_view<float>
+batch::param_reader<range_view<float>>::try_read(size_t paramIdx, const std::string &paramName,
+												  bool &success, bool getData);
+
+template <>
+ragged_array<float>
+batch::param_reader<ragged_array<float>>::try_read(size_t paramIdx, const std::string &paramName,
+												  bool &success, bool getData);
+
+template <>
+matrix_batch<float>
+batch::param_reader<matrix_batch<float>>::try_read(size_t paramIdx, const std::string &paramName,
+												  bool &success, bool getData);
+
+template <>
+bitmask
+batch::param_reader<bitmask>::try_read(size_t paramIdx, const std::string &paramName,
+									   bool &success, bool getData);
+
+template <>
+dictionary
+batch::param_reader<dictionary>::try_read(size_t paramIdx, const std::string &paramName,
+										  bool &success, bool getData);
+
+template <>
+std::shared_ptr<tiled_matrix<float>>
+batch::param_reader<std::shared_ptr<tiled_matrix<float>>>::try_read(size_t paramIdx, const std::string &paramName,
+																   bool &success, bool getData);
+
+template <>
+void batch::result_writer<ragged_array<float>, void>::operator()(const ragged_array<float> &result);
+
+template <>
+void batch::result_writer<matrix_batch<float>, void>::operator()(const matrix_batch<float> &result);
+
+template <>
+void batch::result_writer<bitmask, void>::operator()(const bitmask &result);
+
+template <>
+void batch::result_writer<dictionary, void>::operator()(const dictionary &result);
+
+/**
+ * @brief Function that can be run by the batch runner. Declare instances at namespace
+ * scope, usually through OM_DEFUN, to register them.
+ */
+class batch_function
+{
+	const char *name_;
+	const char *usage_;
+	std::function<void(batch &)> fun_;
+
+	public:
+	/**
+	 * @brief Registers a function
+	 *
+	 * @param name  Name of the function on the command line
+	 * @param usage Usage string of the function
+	 * @param fun   Implementation of the function
+	 */
+	batch_function(const char *name, const char *usage, std::function<void(batch &)> fun);
+
+	/// Name of the function on the command line
+	const char *name() const { return name_; }
+	/// Usage string of the function
+	const char *usage() const { return usage_; }
+
+	/**
+	 * @brief Runs the function on an argument record
+	 *
+	 * @param w    Wrapper to run the function with
+	 * @param args Record of arguments
+	 * @return List of return values, or an error value if the function failed
+	 */
+	batch_value operator()(batch &w, const batch_record &args) const { return w.run_function(name_, args, fun_); }
+
+	/**
+	 * @brief Gets the registered functions, by name
+	 */
+	static std::map<std::string, const batch_function *> &registry();
+};
+
+/**
+ * @brief Runs a function on every record, in parallel.
+ *
+ * Each worker thread runs the function with its own wrapper, so wrapper state (such as
+ * progressive results or the resident state) is not shared between records.
+ *
+ * @param function  Function to run
+ * @param records   Argument records
+ * @param jobs      Number of worker threads, 0 for one per hardware thread
+ * @param configure Function invoked on the wrapper of each worker before it starts
+ * @return Result records, in the order of \p records
+ * @throws std::exception thrown by \p configure or by a wrapper outside of a call, once
+ * every worker has stopped
+ */
+std::vector<batch_record> run_batch(const batch_function &function, const std::vector<batch_record> &records,
+									int jobs = 0, const std::function<void(batch &)> &configure = {});
+
+/**
+ * @brief Entry point of batch runners.
+ *
+ * @code
+ * runner [-j jobs] function input output
+ * runner --list
+ * @endcode
+ *
+ * Reads the argument records of \p input, runs \p function on each of them and writes
+ * the results to \p output, in the same order. Calls that fail produce error records.
+ *
+ * @param argc      Number of command-line arguments
+ * @param argv      Command-line arguments
+ * @param configure Function invoked on the wrapper of each worker before it starts
+ * @return 0 if every call succeeded, 1 if some calls failed, 2 on usage or I/O errors
+ */
+int batch_main(int argc, char *argv[], const std::function<void(batch &)> &configure = {});
+
+// Precompiled in the omw_batch library
+OMW_WRAPPER_INSTANTIATIONS(extern, batch)
+}
+
+/**
+ * @brief Run code when called from a batch runner.
+ *
+ * @param w    Wrapper object to invoke the method on
+ * @param code Lambda function with void(void) signature to run
+ */
+#define OM_BATCH(w, code) (code)()
+
+#else /* OMW_BATCH */
+
+#define OM_BATCH(w, code)
+
+#endif /* OMW_BATCH */
+
+#endif /* _OMW_BATCH_HPP_ */
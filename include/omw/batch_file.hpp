@@ -0,0 +1,142 @@
+/**
+ * @file   omw/batch_file.hpp
+ * @brief  Definition of omw::batch_value
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_BATCH_FILE_HPP_
+#define _OMW_BATCH_FILE_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "omw/pre.hpp"
+#include "omw/matrix.hpp"
+
+namespace omw
+{
+/**
+ * @brief Argument or result of a function run by the omw::batch wrapper.
+ *
+ * Batch files hold a sequence of records, each record being a value. Input records are
+ * lists of arguments; output records are either lists of results or errors. All
+ * numbers are stored in the byte order of the machine that wrote the file, and every
+ * value starts on an 8-byte boundary:
+ *
+ *  - header: magic "OMWBATC1", uint32 0x01020304 (byte order check), uint32 record count
+ *  - value: uint32 kind, uint32 size, then depending on the kind:
+ *     - bool, int, unsigned int: int64
+ *     - float: float64
+ *     - string, error: size bytes of text, padded
+ *     - matrix: size int32 dimensions, padded, then the float32 elements in row-major
+ *       order, padded
+ *     - list: size values
+ *
+ * Matrices read from a batch file point into the mapping of the file, so arguments are
+ * never copied.
+ */
+struct batch_value
+{
+	/// Kinds of values, as stored in batch files
+	enum value_kind
+	{
+		/// bool
+		kind_bool = 0,
+		/// int
+		kind_int = 1,
+		/// unsigned int
+		kind_unsigned = 2,
+		/// float
+		kind_float = 3,
+		/// std::string
+		kind_string = 4,
+		/// omw::basic_matrix&lt;float&gt;
+		kind_matrix = 5,
+		/// List of values
+		kind_list = 6,
+		/// Error message of a failed call
+		kind_error = 7
+	};
+
+	/// Kind of the value
+	value_kind kind;
+	/// Value of bool, int and unsigned int values
+	std::int64_t integer;
+	/// Value of float values
+	double real;
+	/// Value of string and error values
+	std::string text;
+	/// Value of matrix values
+	std::shared_ptr<basic_matrix<float>> matrix;
+	/// Items of list values
+	std::vector<batch_value> items;
+
+	/// Initializes an empty list
+	batch_value() : kind(kind_list), integer(0), real(0.) {}
+	/// Initializes a bool value
+	batch_value(bool value) : kind(kind_bool), integer(value), real(0.) {}
+	/// Initializes an int value
+	batch_value(int value) : kind(kind_int), integer(value), real(0.) {}
+	/// Initializes an unsigned int value
+	batch_value(unsigned int value) : kind(kind_unsigned), integer(value), real(0.) {}
+	/// Initializes a float value
+	batch_value(float value) : kind(kind_float), integer(0), real(value) {}
+	/// Initializes a string value
+	batch_value(const std::string &value) : kind(kind_string), integer(0), real(0.), text(value) {}
+	/// Initializes a string value
+	batch_value(const char *value) : kind(kind_string), integer(0), real(0.), text(value) {}
+	/// Initializes a matrix value
+	batch_value(std::shared_ptr<basic_matrix<float>> value)
+	: kind(kind_matrix), integer(0), real(0.), matrix(std::move(value))
+	{
+	}
+
+	/**
+	 * @brief Builds an error value
+	 *
+	 * @param message Error message
+	 */
+	static batch_value error(const std::string &message)
+	{
+		batch_value result(message);
+		result.kind = kind_error;
+		return result;
+	}
+
+	/**
+	 * @brief Tests if this value is a number: bool, int, unsigned int or float
+	 */
+	bool numeric() const { return kind <= kind_float; }
+
+	/**
+	 * @brief Gets the value of a number as a double
+	 */
+	double number() const { return kind == kind_float ? real : static_cast<double>(integer); }
+};
+
+/// Record of a batch file
+typedef batch_value batch_record;
+
+/**
+ * @brief Reads a batch file. Matrices point into the mapping of the file.
+ *
+ * @param path Path of the batch file
+ * @return Records of the file
+ * @throws std::runtime_error if the file does not exist or is not a valid batch file
+ */
+std::vector<batch_record> read_batch_file(const std::string &path);
+
+/**
+ * @brief Writes a batch file. The file is replaced atomically.
+ *
+ * @param path    Path of the batch file
+ * @param records Records to write
+ * @throws std::runtime_error if the file cannot be written
+ */
+void write_batch_file(const std::string &path, const std::vector<batch_record> &records);
+}
+
+#endif /* _OMW_BATCH_FILE_HPP_ */
@@ -0,0 +1,291 @@
+/**
+ * @file   omw/bitmask.hpp
+ * @brief  Definition of omw::bitmask
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_BITMASK_HPP_
+#define _OMW_BITMASK_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "omw/pre.hpp"
+
+namespace omw
+{
+/**
+ * @brief Counts the bits set in a word
+ *
+ * @param word Word to count the bits of
+ * @return Number of bits set
+ */
+inline int popcount64(std::uint64_t word)
+{
+#if defined(__GNUC__)
+	return __builtin_popcountll(word);
+#else
+	word = word - ((word >> 1) & 0x5555555555555555ULL);
+	word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+	word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+	return static_cast<int>((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/**
+ * @brief Gets the index of the lowest bit set in a non-zero word
+ */
+inline int lowest_bit64(std::uint64_t word)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll(word);
+#else
+	int idx = 0;
+	while (!(word & 1))
+	{
+		word >>= 1;
+		++idx;
+	}
+	return idx;
+#endif
+}
+
+/**
+ * @brief Checks that every element of a numeric mask is 0 or 1. Masks are not read by
+ * truthiness, so that arrays passed in place of a mask by mistake are reported.
+ *
+ * @param src        Elements, in the order of the host
+ * @param count      Number of elements
+ * @param param_name Name of the parameter, for the error message
+ * @throws std::runtime_error at the first element that is neither 0 nor 1
+ */
+template <typename T> void check_binary(const T *src, std::size_t count, const std::string &param_name)
+{
+	// Branchless scan of blocks, the element is only located on failure
+	const std::size_t block = 256;
+	for (std::size_t begin = 0; begin < count; begin += block)
+	{
+		const std::size_t end = std::min(count, begin + block);
+
+		bool other = false;
+		for (std::size_t i = begin; i < end; ++i)
+			other |= (src[i] != T(0)) & (src[i] != T(1));
+
+		if (!other)
+			continue;
+
+		std::size_t idx = begin;
+		while (src[idx] == T(0) || src[idx] == T(1))
+			++idx;
+
+		std::stringstream ss;
+		ss << "Mask elements must be 0 or 1, found " << +src[idx] << " at element " << idx << " of parameter "
+		   << param_name;
+		throw std::runtime_error(ss.str());
+	}
+}
+
+/**
+ * @brief Represents an array of booleans, such as a selection or an image mask, stored
+ * with one bit per element.
+ *
+ * Elements are in row-major order, like the elements of omw::basic_matrix, and bit j of
+ * word i holds element 64 * i + j. Unused bits of the last word are always cleared, so
+ * that whole words can be counted and combined. Hosts pass masks as lists of booleans,
+ * 0/1 integer arrays or logical arrays, and readers pack them 64 elements at a time.
+ * Readers reject numeric arrays holding other values, see omw::check_binary.
+ */
+class bitmask
+{
+	std::vector<std::uint64_t> m_words;
+	std::vector<int> m_dims;
+	std::size_t m_size;
+
+public:
+	/**
+	 * @brief Initializes an empty mask.
+	 */
+	bitmask() : m_words(), m_dims(1, 0), m_size(0) {}
+
+	/**
+	 * @brief Initializes a mask with all elements cleared.
+	 *
+	 * @param dims Dimensions of the mask
+	 * @throws std::runtime_error if a dimension is negative
+	 */
+	explicit bitmask(std::vector<int> dims) : m_words(), m_dims(std::move(dims)), m_size(1)
+	{
+		for (int d : m_dims)
+		{
+			if (d < 0)
+			{
+				std::stringstream ss;
+				ss << "Invalid bitmask dimension " << d;
+				throw std::runtime_error(ss.str());
+			}
+
+			m_size *= d;
+		}
+
+		m_words.resize((m_size + 63) / 64);
+	}
+
+	/**
+	 * @brief Number of elements.
+	 */
+	std::size_t size() const { return m_size; }
+
+	/**
+	 * @brief Dimensions of the mask.
+	 */
+	const std::vector<int> &dims() const { return m_dims; }
+
+	/**
+	 * @brief Words holding the elements, 64 per word.
+	 */
+	const std::vector<std::uint64_t> &words() const { return m_words; }
+
+	/**
+	 * @brief Pointer to the words holding the elements, which can be modified in place as
+	 * long as the unused bits of the last word stay cleared.
+	 */
+	std::uint64_t *data() { return m_words.data(); }
+
+	/**
+	 * @brief Gets an element.
+	 *
+	 * @param idx Index of the element
+	 */
+	bool test(std::size_t idx) const { return (m_words[idx / 64] >> (idx % 64)) & 1; }
+
+	/**
+	 * @brief Sets an element.
+	 *
+	 * @param idx   Index of the element
+	 * @param value New value of the element
+	 */
+	void set(std::size_t idx, bool value = true)
+	{
+		const std::uint64_t bit = std::uint64_t(1) << (idx % 64);
+		m_words[idx / 64] = value ? (m_words[idx / 64] | bit) : (m_words[idx / 64] & ~bit);
+	}
+
+	/**
+	 * @brief Packs the elements of an array, non-zero elements being set.
+	 *
+	 * @param src Array of size() elements
+	 */
+	template <typename T> void assign(const T *src)
+	{
+		const std::size_t full = m_size / 64;
+
+		// Branchless inner loop, so that compilers vectorize the comparisons and shifts
+		for (std::size_t i = 0; i < full; ++i)
+		{
+			const T *s = src + i * 64;
+			std::uint64_t word = 0;
+
+			for (int j = 0; j < 64; ++j)
+				word |= std::uint64_t(s[j] != T(0)) << j;
+
+			m_words[i] = word;
+		}
+
+		if (m_size % 64)
+		{
+			const T *s = src + full * 64;
+			std::uint64_t word = 0;
+
+			for (int j = 0; j < int(m_size % 64); ++j)
+				word |= std::uint64_t(s[j] != T(0)) << j;
+
+			m_words[full] = word;
+		}
+	}
+
+	/**
+	 * @brief Unpacks the elements to an array, as 0 and 1.
+	 *
+	 * @param dst Array of size() elements
+	 */
+	template <typename T> void unpack(T *dst) const
+	{
+		for (std::size_t i = 0; i < m_words.size(); ++i)
+		{
+			const std::uint64_t word = m_words[i];
+			const int n = (i + 1) * 64 <= m_size ? 64 : int(m_size % 64);
+			T *d = dst + i * 64;
+
+			for (int j = 0; j < n; ++j)
+				d[j] = T((word >> j) & 1);
+		}
+	}
+
+	/**
+	 * @brief Number of elements set.
+	 */
+	std::size_t count() const
+	{
+		std::size_t n = 0;
+		for (std::uint64_t word : m_words)
+			n += popcount64(word);
+		return n;
+	}
+
+	/**
+	 * @brief Calls a function with the index of every element set, in increasing order.
+	 *
+	 * @param fun Function taking the index of an element
+	 */
+	template <typename Fun> void for_each_set(Fun &&fun) const
+	{
+		for (std::size_t i = 0; i < m_words.size(); ++i)
+		{
+			// Clear the lowest bit until the word is empty, skipping runs of zeros
+			for (std::uint64_t word = m_words[i]; word; word &= word - 1)
+				fun(i * 64 + lowest_bit64(word));
+		}
+	}
+
+	/**
+	 * @brief Copies the elements of an array whose element in this mask is set.
+	 *
+	 * @param src Array of size() elements
+	 * @param dst Array of at least count() elements
+	 * @return Number of elements copied
+	 */
+	template <typename T> std::size_t select(const T *src, T *dst) const
+	{
+		std::size_t n = 0;
+
+		for (std::size_t i = 0; i < m_words.size(); ++i)
+		{
+			const std::uint64_t word = m_words[i];
+			const T *s = src + i * 64;
+
+			if (word == ~std::uint64_t(0))
+			{
+				// Full words are copied at once
+				for (int j = 0; j < 64; ++j)
+					dst[n + j] = s[j];
+				n += 64;
+			}
+			else
+			{
+				for (std::uint64_t w = word; w; w &= w - 1)
+					dst[n++] = s[lowest_bit64(w)];
+			}
+		}
+
+		return n;
+	}
+};
+}
+
+#endif /* _OMW_BITMASK_HPP_ */
@@ -0,0 +1,348 @@
+/**
+ * @file   omw/call_profiler.hpp
+ * @brief  Definition of omw::call_profiler
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_CALL_PROFILER_HPP_
+#define _OMW_CALL_PROFILER_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "omw/metrics.hpp"
+#include "omw/perf_counters.hpp"
+#include "omw/slow_call_log.hpp"
+
+namespace omw
+{
+/**
+ * @brief Phases of a wrapped function call
+ */
+enum call_phase
+{
+	/// Reading parameters from the host
+	phase_decode,
+	/// Running user code
+	phase_user,
+	/// Writing results to the host
+	phase_encode,
+	/// Number of phases
+	call_phase_count
+};
+
+/**
+ * @brief Gets the display name of a call phase
+ *
+ * @param phase Call phase
+ * @return Name of the phase
+ */
+const char *call_phase_name(call_phase phase);
+
+/**
+ * @brief Time and hardware events spent in a call phase
+ */
+struct phase_sample
+{
+	/// Wall-clock time, in nanoseconds
+	std::uint64_t nanoseconds = 0;
+	/// Hardware counter deltas, indexed by omw::perf_event
+	std::uint64_t counters[perf_event_count] = {};
+
+	/**
+	 * @brief Accumulates another sample into this one
+	 */
+	phase_sample &operator+=(const phase_sample &other);
+};
+
+/**
+ * @brief Distribution of durations, in power-of-two buckets from 1 µs to about 8 s
+ */
+struct latency_histogram
+{
+	/// Number of finite buckets
+	static const int bucket_count = 24;
+	/// Number of durations per bucket, the last one counts durations above every bound
+	std::uint64_t counts[bucket_count + 1] = {};
+
+	/**
+	 * @brief Gets the upper bound of a bucket
+	 *
+	 * @param bucket Index of the bucket, less than #bucket_count
+	 * @return Upper bound, in nanoseconds
+	 */
+	static std::uint64_t upper_bound(int bucket)
+	{ return std::uint64_t(1000) << bucket; }
+
+	/**
+	 * @brief Adds a duration to the histogram
+	 *
+	 * @param nanoseconds Duration, in nanoseconds
+	 */
+	void add(std::uint64_t nanoseconds);
+
+	/**
+	 * @brief Estimates a quantile as the upper bound of the bucket it falls in
+	 *
+	 * @param q Quantile, between 0 and 1
+	 * @return Estimated duration, in nanoseconds
+	 */
+	std::uint64_t quantile(double q) const;
+};
+
+/**
+ * @brief Aggregated profile of a wrapped function
+ */
+struct function_profile
+{
+	/// Number of calls
+	std::uint64_t calls = 0;
+	/// Number of calls that failed
+	std::uint64_t failures = 0;
+	/// Total time and events per phase, indexed by omw::call_phase
+	phase_sample phases[call_phase_count];
+	/// Distribution of the time spent per phase, indexed by omw::call_phase
+	latency_histogram phase_latency[call_phase_count];
+	/// Longest call, in nanoseconds
+	std::uint64_t max_nanoseconds = 0;
+	/// Bytes of parameter data read from the host
+	std::uint64_t bytes_in = 0;
+	/// Bytes of result data written to the host
+	std::uint64_t bytes_out = 0;
+};
+
+/**
+ * @brief Measures the phases of wrapped function calls and aggregates them per function.
+ *
+ * The wrappers switch to the decode phase while reading parameters and to the encode
+ * phase while writing results; everything else in a call is attributed to user code.
+ * Profiling is disabled by default and costs a single test per phase switch when off.
+ *
+ * Calls are also timed while the slow call log is enabled, even if profiling is not.
+ * In that case the wrappers describe every argument and result so that calls exceeding
+ * the threshold can be recorded with the shape of their data.
+ */
+class call_profiler
+{
+	bool enabled_;
+	std::unique_ptr<perf_counters> counters_;
+	std::map<std::string, function_profile> functions_;
+	slow_call_log slow_calls_;
+
+	bool in_call_;
+	std::string current_function_;
+	call_phase current_phase_;
+	std::chrono::steady_clock::time_point phase_start_;
+	perf_reading phase_counters_;
+	phase_sample current_call_[call_phase_count];
+	std::vector<std::string> current_arguments_;
+	std::vector<std::string> current_results_;
+	std::uint64_t current_bytes_in_;
+	std::uint64_t current_bytes_out_;
+
+	void snapshot(std::chrono::steady_clock::time_point &time, perf_reading &counters) const;
+	void close_phase();
+
+	public:
+	/**
+	 * @brief Initializes a new, disabled, call profiler
+	 */
+	call_profiler();
+
+	/**
+	 * @brief Tests if profiling is enabled
+	 */
+	inline bool enabled() const
+	{ return enabled_; }
+
+	/**
+	 * @brief Enables or disables profiling
+	 *
+	 * @param new_enabled true to enable profiling
+	 */
+	inline void enabled(bool new_enabled)
+	{ enabled_ = new_enabled; }
+
+	/**
+	 * @brief Tests if hardware counters are sampled
+	 */
+	inline bool hardware_counters() const
+	{ return counters_ && counters_->available(); }
+
+	/**
+	 * @brief Enables or disables the sampling of hardware counters.
+	 *
+	 * Counters are opened for the calling thread, which should be the thread running
+	 * the wrapped functions.
+	 *
+	 * @param enable true to sample hardware counters
+	 * @return true if at least one hardware counter is available, false otherwise
+	 */
+	bool hardware_counters(bool enable);
+
+	/**
+	 * @brief Gets the hardware counters, if enabled
+	 *
+	 * @return Pointer to the counters, or nullptr
+	 */
+	inline const perf_counters *counters() const
+	{ return counters_.get(); }
+
+	/**
+	 * @brief Gets the log of calls exceeding a time threshold
+	 *
+	 * @return Reference to the slow call log
+	 */
+	inline slow_call_log &slow_calls()
+	{ return slow_calls_; }
+
+	/**
+	 * @brief Gets the log of calls exceeding a time threshold
+	 *
+	 * @return Reference to the slow call log
+	 */
+	inline const slow_call_log &slow_calls() const
+	{ return slow_calls_; }
+
+	/**
+	 * @brief Starts profiling a call, in the user phase
+	 *
+	 * @param function Name of the called function
+	 */
+	void begin_call(const char *function);
+
+	/**
+	 * @brief Switches the current call to another phase
+	 *
+	 * @param phase New phase
+	 * @return Previous phase
+	 */
+	call_phase switch_phase(call_phase phase);
+
+	/**
+	 * @brief Ends the current call and aggregates its profile
+	 *
+	 * @param failed true if the call failed
+	 */
+	void end_call(bool failed);
+
+	/**
+	 * @brief Tests if a call is being profiled
+	 */
+	inline bool in_call() const
+	{ return in_call_; }
+
+	/**
+	 * @brief Gets the phase of the current call
+	 */
+	inline call_phase phase() const
+	{ return current_phase_; }
+
+	/**
+	 * @brief Tests if arguments and results of the current call should be described
+	 */
+	inline bool describing() const
+	{ return in_call_ && slow_calls_.enabled(); }
+
+	/**
+	 * @brief Adds the description of an argument of the current call
+	 *
+	 * @param description Name, type and extents of the argument
+	 */
+	inline void add_argument(std::string description)
+	{ current_arguments_.push_back(std::move(description)); }
+
+	/**
+	 * @brief Adds the description of a result of the current call
+	 *
+	 * @param description Type and extents of the result
+	 */
+	inline void add_result(std::string description)
+	{ current_results_.push_back(std::move(description)); }
+
+	/**
+	 * @brief Counts parameter data read by the current call
+	 *
+	 * @param bytes Number of bytes
+	 */
+	inline void add_bytes_in(std::uint64_t bytes)
+	{ current_bytes_in_ += bytes; }
+
+	/**
+	 * @brief Counts result data written by the current call
+	 *
+	 * @param bytes Number of bytes
+	 */
+	inline void add_bytes_out(std::uint64_t bytes)
+	{ current_bytes_out_ += bytes; }
+
+	/**
+	 * @brief Gets the aggregated profiles, indexed by function name
+	 */
+	inline const std::map<std::string, function_profile> &functions() const
+	{ return functions_; }
+
+	/**
+	 * @brief Clears the aggregated profiles
+	 */
+	void reset();
+
+	/**
+	 * @brief Formats the aggregated profiles as a human-readable table
+	 *
+	 * @return Text report
+	 */
+	std::string report() const;
+
+	/**
+	 * @brief Writes the aggregated profiles as Prometheus metrics: call and failure
+	 * counters, phase time summaries and marshaled bytes, labeled by function.
+	 *
+	 * @param writer Metrics writer
+	 */
+	void write_metrics(metrics_writer &writer) const;
+
+	/**
+	 * @brief Switches to a phase for the lifetime of this object
+	 */
+	class phase_scope
+	{
+		call_profiler &profiler_;
+		bool active_;
+		call_phase previous_;
+
+		public:
+		/**
+		 * @brief Switches \p profiler to \p phase if it is profiling a call
+		 *
+		 * @param profiler Profiler to update
+		 * @param phase    Phase of the scope
+		 */
+		phase_scope(call_profiler &profiler, call_phase phase)
+			: profiler_(profiler), active_(profiler.in_call_), previous_(phase)
+		{
+			if (active_)
+				previous_ = profiler_.switch_phase(phase);
+		}
+
+		/**
+		 * @brief Switches back to the previous phase
+		 */
+		~phase_scope()
+		{
+			if (active_)
+				profiler_.switch_phase(previous_);
+		}
+
+		phase_scope(const phase_scope &) = delete;
+		phase_scope &operator=(const phase_scope &) = delete;
+	};
+};
+}
+
+#endif /* _OMW_CALL_PROFILER_HPP_ */
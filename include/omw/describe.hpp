@@ -0,0 +1,440 @@
+/**
+ * @file   omw/describe.hpp
+ * @brief  Definition of omw::describe_value and omw::value_bytes
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_DESCRIBE_HPP_
+#define _OMW_DESCRIBE_HPP_
+
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/optional.hpp>
+#include <boost/variant.hpp>
+
+#include "omw/array.hpp"
+#include "omw/bitmask.hpp"
+#include "omw/dictionary.hpp"
+#include "omw/graphics.hpp"
+#include "omw/matrix.hpp"
+#include "omw/matrix_batch.hpp"
+#include "omw/matrix_view.hpp"
+#include "omw/ragged_array.hpp"
+#include "omw/range_view.hpp"
+
+namespace omw
+{
+/**
+ * @brief Gets a short display name for a scalar type
+ *
+ * @tparam T Scalar type
+ * @return Name of the type
+ */
+template <typename T> const char *scalar_type_name()
+{
+	if (std::is_same<T, bool>::value)
+		return "bool";
+	if (std::is_same<T, float>::value)
+		return "float";
+	if (std::is_same<T, double>::value)
+		return "double";
+	if (std::is_integral<T>::value)
+		return std::is_signed<T>::value ? "int" : "uint";
+	return "number";
+}
+
+/**
+ * @brief Writes the extents of a multi-dimensional value, as in "[3x4]"
+ *
+ * @param os    Output stream
+ * @param dims  Dimensions
+ * @param depth Number of dimensions
+ */
+inline void describe_extents(std::ostream &os, const int *dims, int depth)
+{
+	os << '[';
+	for (int d = 0; d < depth; ++d)
+		os << (d > 0 ? "x" : "") << dims[d];
+	os << ']';
+}
+
+namespace detail
+{
+template <typename U> std::true_type derives_from_container(const basic_array<U> *);
+template <typename U> std::true_type derives_from_container(const basic_matrix<U> *);
+std::false_type derives_from_container(const void *);
+
+/// Tests if T derives from omw::basic_array or omw::basic_matrix, so the generic
+/// overloads do not hide the ones of the base classes
+template <typename T> using is_container = decltype(derives_from_container(std::declval<const T *>()));
+
+template <typename T> void describe_scalar(std::ostream &os, const T &, std::true_type)
+{
+	os << scalar_type_name<T>();
+}
+
+template <typename T> void describe_scalar(std::ostream &os, const T &, std::false_type)
+{
+	os << '?';
+}
+}
+
+/**
+ * @brief Writes the type and extents of a value, without its contents.
+ *
+ * Used to summarize the arguments and results of wrapped calls, for example in the slow
+ * call log. Values of unknown types are written as "?".
+ *
+ * @param os    Output stream
+ * @param value Value to describe
+ */
+template <typename T>
+typename std::enable_if<!detail::is_container<T>::value>::type describe_value(std::ostream &os, const T &value)
+{
+	detail::describe_scalar(os, value, std::is_arithmetic<T>());
+}
+
+/**
+ * @brief Writes the length of a string
+ */
+inline void describe_value(std::ostream &os, const std::string &value)
+{
+	os << "string[" << value.size() << ']';
+}
+
+/**
+ * @brief Writes the element type and length of an array
+ */
+template <typename T> void describe_value(std::ostream &os, const basic_array<T> &value)
+{
+	os << "array<" << scalar_type_name<T>() << ">[" << value.size() << ']';
+}
+
+/**
+ * @brief Writes the element type and dimensions of a matrix
+ */
+template <typename T> void describe_value(std::ostream &os, const basic_matrix<T> &value)
+{
+	os << "matrix<" << scalar_type_name<T>() << '>';
+	describe_extents(os, value.dims(), value.depth());
+}
+
+/**
+ * @brief Writes the element type and dimensions of a matrix view
+ */
+template <typename T> void describe_value(std::ostream &os, const matrix_view<T> &value)
+{
+	os << "view<" << scalar_type_name<T>() << '>';
+	describe_extents(os, value.dims(), value.depth());
+}
+
+/**
+ * @brief Writes the element type and length of a range
+ */
+template <typename T> void describe_value(std::ostream &os, const range_view<T> &value)
+{
+	os << "range<" << scalar_type_name<T>() << ">[" << value.size() << ']';
+}
+
+/**
+ * @brief Writes the element type and length of a list
+ */
+template <typename T> void describe_value(std::ostream &os, const std::vector<T> &value)
+{
+	os << "list<" << scalar_type_name<T>() << ">[" << value.size() << ']';
+}
+
+/**
+ * @brief Writes the dimensions of a bitmask
+ */
+inline void describe_value(std::ostream &os, const bitmask &value)
+{
+	os << "mask";
+	describe_extents(os, value.dims().data(), static_cast<int>(value.dims().size()));
+}
+
+/**
+ * @brief Writes the number of entries of a dictionary
+ */
+inline void describe_value(std::ostream &os, const dictionary &value)
+{
+	os << "dict[" << value.size() << ']';
+}
+
+/**
+ * @brief Writes the dimension and the number of vertices and primitives of graphics
+ */
+inline void describe_value(std::ostream &os, const graphics &value)
+{
+	os << "graphics" << value.dimension() << "d[" << value.vertex_count() << "; "
+	   << value.point_indices().size() << ", " << value.line_count() << ", " << value.polygon_count() << ']';
+}
+
+/**
+ * @brief Writes the element type, number of items and item dimensions of a matrix batch
+ */
+template <typename T> void describe_value(std::ostream &os, const matrix_batch<T> &value)
+{
+	os << "batch<" << scalar_type_name<T>() << ">[" << value.size() << "; ";
+	describe_extents(os, value.item_dims().data(), static_cast<int>(value.item_dims().size()));
+	os << ']';
+}
+
+/**
+ * @brief Writes the element type, number of rows and number of values of a ragged array
+ */
+template <typename T> void describe_value(std::ostream &os, const ragged_array<T> &value)
+{
+	os << "ragged<" << scalar_type_name<T>() << ">[" << value.size() << "; " << value.total_size() << ']';
+}
+
+/**
+ * @brief Describes the pointee of a shared pointer
+ */
+template <typename T> void describe_value(std::ostream &os, const std::shared_ptr<T> &value)
+{
+	if (value)
+		describe_value(os, *value);
+	else
+		os << "null";
+}
+
+/**
+ * @brief Describes the value of an optional, if any
+ */
+template <typename T> void describe_value(std::ostream &os, const boost::optional<T> &value)
+{
+	if (value)
+		describe_value(os, *value);
+	else
+		os << "none";
+}
+
+namespace detail
+{
+struct describe_visitor : public boost::static_visitor<void>
+{
+	std::ostream &os;
+
+	explicit describe_visitor(std::ostream &os) : os(os) {}
+
+	template <typename T> void operator()(const T &value) const { describe_value(os, value); }
+};
+
+template <typename Tuple, std::size_t... I>
+void describe_tuple(std::ostream &os, const Tuple &value, std::index_sequence<I...>)
+{
+	int unused[] = { 0, ((I > 0 ? os << ", " : os), describe_value(os, std::get<I>(value)), 0)... };
+	(void)unused;
+}
+}
+
+/**
+ * @brief Describes the active alternative of a variant
+ */
+template <typename... Types> void describe_value(std::ostream &os, const boost::variant<Types...> &value)
+{
+	boost::apply_visitor(detail::describe_visitor(os), value);
+}
+
+/**
+ * @brief Describes every element of a tuple
+ */
+template <typename... Types> void describe_value(std::ostream &os, const std::tuple<Types...> &value)
+{
+	os << '(';
+	detail::describe_tuple(os, value, std::index_sequence_for<Types...>());
+	os << ')';
+}
+
+namespace detail
+{
+template <typename T> std::size_t scalar_bytes(const T &, std::true_type) { return sizeof(T); }
+
+template <typename T> std::size_t scalar_bytes(const T &, std::false_type) { return 0; }
+}
+
+/**
+ * @brief Estimates the number of bytes of data a value carries.
+ *
+ * Used to count the data marshaled by wrapped calls. Values of unknown types count
+ * as 0 bytes.
+ *
+ * @param value Value to measure
+ * @return Size of the data, in bytes
+ */
+template <typename T>
+typename std::enable_if<!detail::is_container<T>::value, std::size_t>::type value_bytes(const T &value)
+{
+	return detail::scalar_bytes(value, std::is_arithmetic<T>());
+}
+
+/**
+ * @brief Gets the number of characters of a string
+ */
+inline std::size_t value_bytes(const std::string &value)
+{
+	return value.size();
+}
+
+/**
+ * @brief Gets the number of bytes of the elements of an array
+ */
+template <typename T> std::size_t value_bytes(const basic_array<T> &value)
+{
+	return value.size() * sizeof(T);
+}
+
+/**
+ * @brief Gets the number of bytes of the elements of a matrix
+ */
+template <typename T> std::size_t value_bytes(const basic_matrix<T> &value)
+{
+	std::size_t count = 1;
+	for (int d = 0; d < value.depth(); ++d)
+		count *= value.dims()[d];
+	return count * sizeof(T);
+}
+
+/**
+ * @brief Gets the number of bytes of the elements of a matrix view
+ */
+template <typename T> std::size_t value_bytes(const matrix_view<T> &value)
+{
+	return value.size() * sizeof(T);
+}
+
+/**
+ * @brief Gets the number of bytes of a range, which is passed by its bounds only
+ */
+template <typename T> std::size_t value_bytes(const range_view<T> &value)
+{
+	return 3 * sizeof(double);
+}
+
+/**
+ * @brief Gets the number of bytes of the elements of a list
+ */
+template <typename T> std::size_t value_bytes(const std::vector<T> &value)
+{
+	return value.size() * sizeof(T);
+}
+
+/**
+ * @brief Gets the number of bytes of the words of a bitmask
+ */
+inline std::size_t value_bytes(const bitmask &value)
+{
+	return value.words().size() * sizeof(std::uint64_t);
+}
+
+/**
+ * @brief Gets the number of bytes of the coordinates and vertex indices of graphics
+ */
+inline std::size_t value_bytes(const graphics &value)
+{
+	return value.coordinates().size() * sizeof(float) +
+		   (value.point_indices().size() + value.line_indices().size() + value.polygon_indices().size()) *
+			   sizeof(std::uint32_t);
+}
+
+/**
+ * @brief Gets the number of bytes of the items of a matrix batch
+ */
+template <typename T> std::size_t value_bytes(const matrix_batch<T> &value)
+{
+	return value.size() * value.item_size() * sizeof(T);
+}
+
+/**
+ * @brief Gets the number of bytes of the values and offsets of a ragged array
+ */
+template <typename T> std::size_t value_bytes(const ragged_array<T> &value)
+{
+	return value.total_size() * sizeof(T) + value.offsets().size() * sizeof(std::size_t);
+}
+
+/**
+ * @brief Gets the number of bytes of the pointee of a shared pointer
+ */
+template <typename T> std::size_t value_bytes(const std::shared_ptr<T> &value)
+{
+	return value ? value_bytes(*value) : 0;
+}
+
+/**
+ * @brief Gets the number of bytes of the value of an optional, if any
+ */
+template <typename T> std::size_t value_bytes(const boost::optional<T> &value)
+{
+	return value ? value_bytes(*value) : 0;
+}
+
+namespace detail
+{
+struct bytes_visitor : public boost::static_visitor<std::size_t>
+{
+	template <typename T> std::size_t operator()(const T &value) const { return value_bytes(value); }
+};
+
+template <typename Tuple, std::size_t... I>
+std::size_t tuple_bytes(const Tuple &value, std::index_sequence<I...>)
+{
+	std::size_t sizes[] = { 0, value_bytes(std::get<I>(value))... };
+	std::size_t total = 0;
+	for (auto size : sizes)
+		total += size;
+	return total;
+}
+}
+
+/**
+ * @brief Gets the number of bytes of the active alternative of a variant
+ */
+template <typename... Types> std::size_t value_bytes(const boost::variant<Types...> &value)
+{
+	return boost::apply_visitor(detail::bytes_visitor(), value);
+}
+
+/**
+ * @brief Gets the number of bytes of every element of a tuple
+ */
+template <typename... Types> std::size_t value_bytes(const std::tuple<Types...> &value)
+{
+	return detail::tuple_bytes(value, std::index_sequence_for<Types...>());
+}
+
+/**
+ * @brief Gets the number of bytes of the keys and values of a dictionary
+ */
+inline std::size_t value_bytes(const dictionary &value)
+{
+	std::size_t total = value.key_bytes();
+	for (std::size_t i = 0; i < value.size(); ++i)
+		total += value_bytes(value.value(i));
+	return total;
+}
+
+/**
+ * @brief Describes a value as a string
+ *
+ * @param value Value to describe
+ * @return Type and extents of \p value
+ */
+template <typename T> std::string describe_value(const T &value)
+{
+	std::stringstream ss;
+	describe_value(ss, value);
+	return ss.str();
+}
+}
+
+#endif /* _OMW_DESCRIBE_HPP_ */
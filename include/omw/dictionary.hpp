@@ -0,0 +1,267 @@
+/**
+ * @file   omw/dictionary.hpp
+ * @brief  Definition of omw::dictionary
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_DICTIONARY_HPP_
+#define _OMW_DICTIONARY_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/variant.hpp>
+
+#include "omw/pre.hpp"
+#include "omw/matrix.hpp"
+
+namespace omw
+{
+/**
+ * @brief Value of a dictionary entry. Integer lists, such as extents, are only written
+ * to the host; lists read from the host are float matrices.
+ */
+typedef boost::variant<bool, int, float, std::string, std::shared_ptr<basic_matrix<float>>, std::vector<int>>
+	dictionary_value;
+
+namespace detail
+{
+[[noreturn]] inline void unexpected_dictionary_type(const std::string &key)
+{
+	std::stringstream ss;
+	ss << "Unexpected type for dictionary key " << key;
+	throw std::runtime_error(ss.str());
+}
+
+/**
+ * @brief Gets dictionary values of type T, by reference to the stored value
+ */
+template <typename T> struct dictionary_get
+{
+	typedef const T &type;
+
+	static const T &convert(const dictionary_value &value, const std::string &key)
+	{
+		const T *result = boost::get<T>(&value);
+		if (!result)
+			unexpected_dictionary_type(key);
+		return *result;
+	}
+};
+
+/**
+ * @brief Gets integer values, from floats that hold an integer
+ *
+ * Hosts such as Octave only have floating-point numbers, and others pass 2. where 2 is
+ * expected, so numeric values are converted as long as no information is lost.
+ */
+template <> struct dictionary_get<int>
+{
+	typedef int type;
+
+	static int convert(const dictionary_value &value, const std::string &key)
+	{
+		if (const int *i = boost::get<int>(&value))
+			return *i;
+
+		const float *f = boost::get<float>(&value);
+		if (!f)
+			unexpected_dictionary_type(key);
+
+		// Every float of this range converts exactly
+		if (std::trunc(*f) != *f || *f < -2147483648.0f || *f >= 2147483648.0f)
+		{
+			std::stringstream ss;
+			ss << "Dictionary key " << key << " is not an integer: " << *f;
+			throw std::runtime_error(ss.str());
+		}
+
+		return static_cast<int>(*f);
+	}
+};
+
+/**
+ * @brief Gets floating-point values, from integers as well
+ */
+template <> struct dictionary_get<float>
+{
+	typedef float type;
+
+	static float convert(const dictionary_value &value, const std::string &key)
+	{
+		if (const float *f = boost::get<float>(&value))
+			return *f;
+
+		const int *i = boost::get<int>(&value);
+		if (!i)
+			unexpected_dictionary_type(key);
+		return static_cast<float>(*i);
+	}
+};
+}
+
+/**
+ * @brief Represents open-ended key/value inputs, such as Mathematica associations or
+ * Octave structs with arbitrary fields, which no option struct can describe.
+ *
+ * Entries are kept in insertion order and found through an open-addressing table with
+ * linear probing. Keys are stored one after the other in a single arena, so reading a
+ * dictionary allocates once for the keys instead of once per key.
+ */
+class dictionary
+{
+	/// Entry of the dictionary, whose key is in m_keys
+	struct entry
+	{
+		std::uint32_t key_offset;
+		std::uint32_t key_size;
+		std::uint32_t hash;
+		dictionary_value value;
+	};
+
+	/// Keys of all the entries, one after the other
+	std::vector<char> m_keys;
+	/// Entries, in insertion order
+	std::vector<entry> m_entries;
+	/// Index of the entries in m_entries by hash, or empty_slot
+	std::vector<std::uint32_t> m_slots;
+
+	/// Value of unused slots
+	static const std::uint32_t empty_slot = static_cast<std::uint32_t>(-1);
+
+	/// Finds the slot of a key, or the unused slot where it would be inserted
+	std::size_t probe(const char *key, std::size_t key_size, std::uint32_t hash) const;
+
+	/// Resizes the table to \p slots slots, a power of two
+	void rehash(std::size_t slots);
+
+public:
+	/**
+	 * @brief Initializes an empty dictionary.
+	 */
+	dictionary();
+
+	/**
+	 * @brief Reserves storage for the entries and keys of insert.
+	 *
+	 * @param entries   Number of entries
+	 * @param key_bytes Total length of the keys
+	 */
+	void reserve(std::size_t entries, std::size_t key_bytes);
+
+	/**
+	 * @brief Number of entries.
+	 */
+	std::size_t size() const { return m_entries.size(); }
+
+	/**
+	 * @brief Tests if the dictionary has no entries.
+	 */
+	bool empty() const { return m_entries.empty(); }
+
+	/**
+	 * @brief Total length of the keys, in bytes.
+	 */
+	std::size_t key_bytes() const { return m_keys.size(); }
+
+	/**
+	 * @brief Inserts an entry, replacing the value of an existing entry with the same key.
+	 *
+	 * @param key      Pointer to the key
+	 * @param key_size Length of the key
+	 * @param value    Value of the entry
+	 * @return true if a new entry was inserted, false if a value was replaced
+	 */
+	bool insert(const char *key, std::size_t key_size, dictionary_value value);
+
+	/// @copydoc insert(const char *, std::size_t, dictionary_value)
+	bool insert(const std::string &key, dictionary_value value)
+	{
+		return insert(key.data(), key.size(), std::move(value));
+	}
+
+	/**
+	 * @brief Finds the value of a key.
+	 *
+	 * @param key      Pointer to the key
+	 * @param key_size Length of the key
+	 * @return Pointer to the value, or nullptr if there is no such entry
+	 */
+	const dictionary_value *find(const char *key, std::size_t key_size) const;
+
+	/// @copydoc find(const char *, std::size_t) const
+	const dictionary_value *find(const std::string &key) const { return find(key.data(), key.size()); }
+
+	/**
+	 * @brief Tests if there is an entry for a key.
+	 *
+	 * @param key Key to look for
+	 */
+	bool contains(const std::string &key) const { return find(key) != nullptr; }
+
+	/**
+	 * @brief Gets the value of a key.
+	 *
+	 * Numeric values are converted between int and float: integers to float, and floats
+	 * holding an integer to int. Other values must be of type T, and are returned by
+	 * reference.
+	 *
+	 * @tparam T Type of the value
+	 * @param key Key to look for
+	 * @return Value of the entry
+	 * @throws std::runtime_error if there is no such entry, or if its value is not a T
+	 */
+	template <typename T> typename detail::dictionary_get<T>::type get(const std::string &key) const
+	{
+		const dictionary_value *value = find(key);
+		if (!value)
+		{
+			std::stringstream ss;
+			ss << "Missing dictionary key " << key;
+			throw std::runtime_error(ss.str());
+		}
+
+		return detail::dictionary_get<T>::convert(*value, key);
+	}
+
+	/**
+	 * @brief Gets the value of a key, or a default value if there is no such entry.
+	 *
+	 * @tparam T Type of the value
+	 * @param key      Key to look for
+	 * @param fallback Value to return if there is no such entry
+	 * @return Value of the entry, or \p fallback
+	 * @throws std::runtime_error if the value of the entry is not a T
+	 */
+	template <typename T> T get(const std::string &key, const T &fallback) const
+	{
+		return contains(key) ? get<T>(key) : fallback;
+	}
+
+	/**
+	 * @brief Gets the key of an entry.
+	 *
+	 * @param idx Index of the entry, in insertion order
+	 */
+	std::string key(std::size_t idx) const
+	{
+		return std::string(m_keys.data() + m_entries[idx].key_offset, m_entries[idx].key_size);
+	}
+
+	/**
+	 * @brief Gets the value of an entry.
+	 *
+	 * @param idx Index of the entry, in insertion order
+	 */
+	const dictionary_value &value(std::size_t idx) const { return m_entries[idx].value; }
+};
+}
+
+#endif /* _OMW_DICTIONARY_HPP_ */
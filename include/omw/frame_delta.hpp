@@ -0,0 +1,166 @@
+/**
+ * @file   omw/frame_delta.hpp
+ * @brief  Definition of omw::frame_delta_encoder
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_FRAME_DELTA_HPP_
+#define _OMW_FRAME_DELTA_HPP_
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "omw/pre.hpp"
+
+namespace omw
+{
+/**
+ * @brief Computes the tiles that changed between successive frames of named streams.
+ *
+ * The encoder keeps a copy of the last frame of every stream. Each new frame is
+ * compared to it tile by tile, and only the tiles that differ have to be sent to
+ * the host.
+ *
+ * Every encoded frame gets a sequence number, unique across the streams of the encoder,
+ * and a patch names the sequence number of the frame it applies to. The host has to
+ * check it before applying the patch, and the writer has to reset the stream when the
+ * host did not apply the last frame, so that the next one is sent in full.
+ */
+class frame_delta_encoder
+{
+	public:
+	/**
+	 * @brief Describes a changed tile
+	 */
+	struct tile
+	{
+		/// Row of the first element of the tile
+		int row;
+		/// Column of the first element of the tile
+		int col;
+		/// Number of rows of the tile
+		int rows;
+		/// Number of columns of the tile
+		int cols;
+	};
+
+	/**
+	 * @brief Result of encoding a frame
+	 */
+	struct frame_delta
+	{
+		/// true if the frame had to be sent in full
+		bool key_frame;
+		/// Sequence number of the frame
+		int sequence;
+		/// Sequence number of the frame the patch applies to, 0 for key frames
+		int base;
+		/// List of changed tiles
+		std::vector<tile> tiles;
+		/// Total number of tiles in the frame
+		std::size_t total_tiles;
+		/// Dimensions of the frame
+		const std::vector<int> *dims;
+		/// Row-major contents of the frame, valid until the next call to encode
+		const float *data;
+
+		/**
+		 * @brief Copies a tile of the frame to a row-major buffer
+		 *
+		 * @param t   Tile to copy
+		 * @param dst Destination buffer, of at least rows * cols * channels elements
+		 */
+		void copy_tile(const tile &t, float *dst) const;
+
+		/**
+		 * @brief Number of channels of the frame
+		 */
+		int channels() const { return dims->size() == 3 ? (*dims)[2] : 1; }
+	};
+
+	private:
+	/**
+	 * @brief Last frame sent on a stream
+	 */
+	struct stream_state
+	{
+		std::vector<int> dims;
+		std::vector<float> last;
+		int sequence;
+	};
+
+	int tile_size_;
+	int next_sequence_;
+	std::unordered_map<std::string, stream_state> streams_;
+	std::size_t tiles_sent_;
+	std::size_t tiles_total_;
+
+	public:
+	/**
+	 * @brief Initializes a new frame delta encoder
+	 *
+	 * @param tile_size Number of rows and columns of the compared tiles
+	 */
+	frame_delta_encoder(int tile_size = 32);
+
+	/**
+	 * @brief Get the size of the compared tiles
+	 */
+	inline int tile_size() const
+	{ return tile_size_; }
+
+	/**
+	 * @brief Sets the size of the compared tiles. This resets every stream.
+	 *
+	 * @param new_tile_size Number of rows and columns of the compared tiles
+	 */
+	void tile_size(int new_tile_size);
+
+	/**
+	 * @brief Compares a frame to the last frame of a stream, and remembers it.
+	 *
+	 * @param stream_id Identifier of the stream
+	 * @param frame     New frame, of depth 2 or 3
+	 * @return Changed tiles of the frame
+	 * @throws std::runtime_error If the frame is not of depth 2 or 3
+	 */
+	frame_delta encode(const std::string &stream_id, const basic_matrix<float> &frame);
+
+	/**
+	 * @brief Get the sequence number of the last frame of a stream
+	 *
+	 * @param stream_id Identifier of the stream
+	 * @return Sequence number, 0 if the next frame of the stream is a key frame
+	 */
+	int sequence(const std::string &stream_id) const;
+
+	/**
+	 * @brief Forgets the last frame of a stream, so the next one is sent in full.
+	 *
+	 * @param stream_id Identifier of the stream
+	 */
+	void reset(const std::string &stream_id);
+
+	/**
+	 * @brief Forgets the last frame of every stream.
+	 */
+	void reset();
+
+	/**
+	 * @brief Total number of tiles sent since the creation of the encoder
+	 */
+	inline std::size_t tiles_sent() const
+	{ return tiles_sent_; }
+
+	/**
+	 * @brief Total number of tiles encoded since the creation of the encoder
+	 */
+	inline std::size_t tiles_total() const
+	{ return tiles_total_; }
+};
+}
+
+#endif /* _OMW_FRAME_DELTA_HPP_ */
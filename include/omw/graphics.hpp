@@ -0,0 +1,264 @@
+/**
+ * @file   omw/graphics.hpp
+ * @brief  Definition of omw::graphics
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_GRAPHICS_HPP_
+#define _OMW_GRAPHICS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "omw/pre.hpp"
+
+namespace omw
+{
+/**
+ * @brief Builds graphics made of many points, lines and polygons, such as scatter plots
+ * or meshes, for the Mathematica wrapper.
+ *
+ * Primitives refer to shared vertices by their 0-based index. The result is written as
+ * a GraphicsComplex whose coordinates are one packed array, with a single Point, Line
+ * and Polygon head holding all the primitives of their kind, so that the kernel reads
+ * packed arrays instead of millions of nested expressions.
+ */
+class graphics
+{
+	int m_dimension;
+	std::vector<float> m_coordinates;
+	std::vector<std::uint32_t> m_points;
+	std::vector<std::uint32_t> m_line_indices;
+	std::vector<std::size_t> m_line_offsets;
+	std::vector<std::uint32_t> m_polygon_indices;
+	std::vector<std::size_t> m_polygon_offsets;
+
+	/// Checks the vertex indices of a primitive
+	void check_indices(const std::uint32_t *indices, std::size_t count) const
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			if (indices[i] >= vertex_count())
+			{
+				std::stringstream ss;
+				ss << "Invalid vertex index " << indices[i] << " for " << vertex_count() << " vertices";
+				throw std::runtime_error(ss.str());
+			}
+		}
+	}
+
+	/// Checks the number of coordinates of a single vertex
+	void check_dimension(int dimension) const
+	{
+		if (dimension != m_dimension)
+		{
+			std::stringstream ss;
+			ss << "Cannot add a " << dimension << "D vertex to " << m_dimension << "D graphics";
+			throw std::runtime_error(ss.str());
+		}
+	}
+
+	/// Appends consecutive vertex indices
+	static void append_range(std::vector<std::uint32_t> &indices, std::uint32_t first, std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+			indices.push_back(static_cast<std::uint32_t>(first + i));
+	}
+
+public:
+	/**
+	 * @brief Initializes empty graphics.
+	 *
+	 * @param dimension Number of coordinates of the vertices, 2 for Graphics or 3 for
+	 *                  Graphics3D
+	 * @throws std::runtime_error if \p dimension is not 2 or 3
+	 */
+	explicit graphics(int dimension = 2)
+	: m_dimension(dimension), m_coordinates(), m_points(), m_line_indices(), m_line_offsets(1, 0),
+	  m_polygon_indices(), m_polygon_offsets(1, 0)
+	{
+		if (dimension != 2 && dimension != 3)
+		{
+			std::stringstream ss;
+			ss << "Invalid graphics dimension " << dimension;
+			throw std::runtime_error(ss.str());
+		}
+	}
+
+	/**
+	 * @brief Number of coordinates of the vertices.
+	 */
+	int dimension() const { return m_dimension; }
+
+	/**
+	 * @brief Number of vertices.
+	 */
+	std::size_t vertex_count() const { return m_coordinates.size() / m_dimension; }
+
+	/**
+	 * @brief Coordinates of all the vertices, one vertex after the other.
+	 */
+	const std::vector<float> &coordinates() const { return m_coordinates; }
+
+	/**
+	 * @brief Reserves storage for the vertices added afterwards.
+	 *
+	 * @param vertices Number of vertices
+	 */
+	void reserve(std::size_t vertices) { m_coordinates.reserve(vertices * m_dimension); }
+
+	/**
+	 * @brief Adds vertices.
+	 *
+	 * @param coordinates Coordinates of the vertices, dimension() per vertex
+	 * @param count       Number of vertices
+	 * @return Index of the first vertex
+	 */
+	std::uint32_t vertices(const float *coordinates, std::size_t count)
+	{
+		const std::uint32_t first = static_cast<std::uint32_t>(vertex_count());
+		m_coordinates.insert(m_coordinates.end(), coordinates, coordinates + count * m_dimension);
+		return first;
+	}
+
+	/**
+	 * @brief Adds a 2D vertex.
+	 *
+	 * @return Index of the vertex
+	 * @throws std::runtime_error if dimension() is not 2
+	 */
+	std::uint32_t vertex(float x, float y)
+	{
+		check_dimension(2);
+		const float coordinates[] = { x, y };
+		return vertices(coordinates, 1);
+	}
+
+	/**
+	 * @brief Adds a 3D vertex.
+	 *
+	 * @return Index of the vertex
+	 * @throws std::runtime_error if dimension() is not 3
+	 */
+	std::uint32_t vertex(float x, float y, float z)
+	{
+		check_dimension(3);
+		const float coordinates[] = { x, y, z };
+		return vertices(coordinates, 1);
+	}
+
+	/**
+	 * @brief Adds points at existing vertices.
+	 *
+	 * @param indices Indices of the vertices
+	 * @param count   Number of points
+	 */
+	void points(const std::uint32_t *indices, std::size_t count)
+	{
+		check_indices(indices, count);
+		m_points.insert(m_points.end(), indices, indices + count);
+	}
+
+	/**
+	 * @brief Adds a line through existing vertices.
+	 *
+	 * @param indices Indices of the vertices, in order
+	 * @param count   Number of vertices of the line
+	 */
+	void line(const std::uint32_t *indices, std::size_t count)
+	{
+		check_indices(indices, count);
+		m_line_indices.insert(m_line_indices.end(), indices, indices + count);
+		m_line_offsets.push_back(m_line_indices.size());
+	}
+
+	/**
+	 * @brief Adds a polygon whose corners are existing vertices.
+	 *
+	 * @param indices Indices of the corners, in order
+	 * @param count   Number of corners
+	 */
+	void polygon(const std::uint32_t *indices, std::size_t count)
+	{
+		check_indices(indices, count);
+		m_polygon_indices.insert(m_polygon_indices.end(), indices, indices + count);
+		m_polygon_offsets.push_back(m_polygon_indices.size());
+	}
+
+	/**
+	 * @brief Adds points at new vertices.
+	 *
+	 * @param coordinates Coordinates of the points, dimension() per point
+	 * @param count       Number of points
+	 */
+	void add_points(const float *coordinates, std::size_t count)
+	{
+		append_range(m_points, vertices(coordinates, count), count);
+	}
+
+	/**
+	 * @brief Adds a line through new vertices.
+	 *
+	 * @param coordinates Coordinates of the vertices, dimension() per vertex
+	 * @param count       Number of vertices of the line
+	 */
+	void add_line(const float *coordinates, std::size_t count)
+	{
+		append_range(m_line_indices, vertices(coordinates, count), count);
+		m_line_offsets.push_back(m_line_indices.size());
+	}
+
+	/**
+	 * @brief Adds a polygon whose corners are new vertices.
+	 *
+	 * @param coordinates Coordinates of the corners, dimension() per corner
+	 * @param count       Number of corners
+	 */
+	void add_polygon(const float *coordinates, std::size_t count)
+	{
+		append_range(m_polygon_indices, vertices(coordinates, count), count);
+		m_polygon_offsets.push_back(m_polygon_indices.size());
+	}
+
+	/**
+	 * @brief Vertex indices of the points.
+	 */
+	const std::vector<std::uint32_t> &point_indices() const { return m_points; }
+
+	/**
+	 * @brief Vertex indices of all the lines, one line after the other.
+	 */
+	const std::vector<std::uint32_t> &line_indices() const { return m_line_indices; }
+
+	/**
+	 * @brief Offset of each line in line_indices(), followed by the number of indices.
+	 */
+	const std::vector<std::size_t> &line_offsets() const { return m_line_offsets; }
+
+	/**
+	 * @brief Vertex indices of all the polygons, one polygon after the other.
+	 */
+	const std::vector<std::uint32_t> &polygon_indices() const { return m_polygon_indices; }
+
+	/**
+	 * @brief Offset of each polygon in polygon_indices(), followed by the number of indices.
+	 */
+	const std::vector<std::size_t> &polygon_offsets() const { return m_polygon_offsets; }
+
+	/**
+	 * @brief Number of lines.
+	 */
+	std::size_t line_count() const { return m_line_offsets.size() - 1; }
+
+	/**
+	 * @brief Number of polygons.
+	 */
+	std::size_t polygon_count() const { return m_polygon_offsets.size() - 1; }
+};
+}
+
+#endif /* _OMW_GRAPHICS_HPP_ */
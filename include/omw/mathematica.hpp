@@ -10,11 +10,15 @@
 
 #if OMW_MATHEMATICA
 
+#include <map>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 #include "wstp.h"
 
 #include "omw/pre.hpp"
+#include "omw/frame_delta.hpp"
 #include "omw/type_traits.hpp"
 
 #include "omw/mathematica/array.hpp"
@@ -23,6 +27,88 @@
 namespace omw
 {
 
+/**
+ * @brief Decides when the results of a pipelined batch of calls are flushed to the
+ * kernel.
+ *
+ * Flushing after every call lets the kernel start receiving results as early as
+ * possible, while flushing every few calls or bytes saves link writes when the calls
+ * are small. The last results of a batch are always flushed with the answer.
+ */
+struct flush_policy
+{
+	/// Kind of flush policy
+	enum mode_type
+	{
+		/// Flush after every call
+		per_call,
+		/// Flush after a number of calls
+		per_calls,
+		/// Flush once results exceed a number of bytes
+		per_bytes
+	};
+
+	/// Kind of flush policy
+	mode_type mode;
+	/// Number of calls between flushes, for per_calls
+	std::size_t calls;
+	/// Number of result bytes between flushes, for per_bytes
+	std::size_t bytes;
+
+	/**
+	 * @brief Initializes a policy flushing after every call
+	 */
+	flush_policy() : mode(per_call), calls(1), bytes(0) {}
+
+	/**
+	 * @brief Builds a policy flushing after every \p n calls
+	 *
+	 * @param n Number of calls between flushes
+	 * @return Flush policy
+	 */
+	static flush_policy every_calls(std::size_t n)
+	{
+		flush_policy policy;
+		policy.mode = per_calls;
+		policy.calls = n;
+		return policy;
+	}
+
+	/**
+	 * @brief Builds a policy flushing once at least \p n bytes of results are pending
+	 *
+	 * @param n Number of result bytes between flushes
+	 * @return Flush policy
+	 */
+	static flush_policy every_bytes(std::size_t n)
+	{
+		flush_policy policy;
+		policy.mode = per_bytes;
+		policy.bytes = n;
+		return policy;
+	}
+
+	/**
+	 * @brief Tests if pending results should be flushed
+	 *
+	 * @param pending_calls Number of calls written since the last flush
+	 * @param pending_bytes Number of result bytes written since the last flush
+	 * @return true if the link should be flushed
+	 */
+	bool should_flush(std::size_t pending_calls, std::size_t pending_bytes) const
+	{
+		switch (mode)
+		{
+		case per_calls:
+			return pending_calls >= calls;
+		case per_bytes:
+			return pending_bytes >= bytes;
+		default:
+			return pending_calls > 0;
+		}
+	}
+};
+
 /**
  * @brief Represents the interface wrapper for Mathematica (WSTP) code.
  */
@@ -34,6 +120,22 @@ class mathematica : public wrapper_base<mathematica>
 	std::string math_namespace_;
 	/// A flag indicating if the current function has returned a result yet
 	bool has_result_;
+	/// Last frames sent by write_frame
+	frame_delta_encoder frames_;
+	/// Flush policy of pipelined calls
+	flush_policy flush_policy_;
+	/// A flag indicating if the calls of a pipelined batch are being run
+	bool pipelining_;
+	/// Number of calls written since the last flush of a pipelined batch
+	std::size_t pending_calls_;
+	/// Number of result bytes written since the last flush of a pipelined batch
+	std::size_t pending_bytes_;
+	/// Messages of the current pipelined batch, including failures
+	std::vector<queued_message> pipeline_messages_;
+	/// Number of calls run in pipelined batches
+	std::uint64_t pipelined_calls_;
+	/// Number of flushes of pipelined batches
+	std::uint64_t pipelined_flushes_;
 
 	public:
 	/// Reference to the link object to use
@@ -49,6 +151,11 @@ class mathematica : public wrapper_base<mathematica>
 	mathematica(const std::string &mathNamespace, WSLINK &link,
 				std::function<void(void)> userInitializer = std::function<void(void)>());
 
+	/**
+	 * @brief Stops publishing metrics before the frame encoder is destroyed
+	 */
+	~mathematica();
+
 	/**
 	 * @brief Base class for wrapper parameter readers
 	 */
@@ -378,9 +485,11 @@ class mathematica : public wrapper_base<mathematica>
 	template <class... Types>
 	typename param_reader<Types...>::return_type get_param(size_t paramIdx, const std::string &paramName)
 	{
-		return param_reader<Types...>(*this)(paramIdx, paramName);
+		return wrapper_base<mathematica>::get_param<Types...>(paramIdx, paramName);
 	}
 
+	using wrapper_base<mathematica>::get_param;
+
 	/**
 	 * @brief Helper class to read a list of tuples
 	 */
@@ -426,6 +535,50 @@ class mathematica : public wrapper_base<mathematica>
 	 */
 	bool run_function(std::function<void(mathematica &)> fun);
 
+	/**
+	 * @brief Runs a named function using the state of the link associated with this
+	 * interface wrapper.
+	 * @param name Name of the function, used to aggregate its profile
+	 * @param fun  Function to invoke when the link is ready.
+	 * @return true
+	 */
+	bool run_function(const char *name, std::function<void(mathematica &)> fun);
+
+	/**
+	 * @brief Runs a pipelined batch of calls sent as the only argument of the current
+	 * call packet.
+	 *
+	 * The argument is a list of calls {"name", args...} to functions registered with
+	 * omw::mathematica_function. They are run back to back and their results are written
+	 * as they are computed, flushing the link according to #pipeline_flush. The answer
+	 * is {results, failures}, where failures holds the held Message expressions of the
+	 * failed calls; the CallPipelined function of the package issues them and returns
+	 * the results.
+	 *
+	 * WSTP only lets the mprep loop end the answer packet, so the flush policy decides
+	 * when the results written so far are pushed to the kernel while the next calls
+	 * compute.
+	 *
+	 * @return true
+	 */
+	bool run_pipelined();
+
+	/**
+	 * @brief Gets the flush policy of pipelined calls
+	 *
+	 * @return Reference to the flush policy
+	 */
+	inline const flush_policy &pipeline_flush() const
+	{ return flush_policy_; }
+
+	/**
+	 * @brief Sets the flush policy of pipelined calls
+	 *
+	 * @param policy New flush policy
+	 */
+	inline void pipeline_flush(const flush_policy &policy)
+	{ flush_policy_ = policy; }
+
 	/**
 	 * @brief Evaluates the given function, assuming its execution returns a result
 	 * @param fun Code to execute to return the result
@@ -514,6 +667,16 @@ class mathematica : public wrapper_base<mathematica>
 	template <class T0, class... Types>
 	void write_result(const T0& arg0, const Types&... args)
 	{
+		profile_results(arg0, args...);
+
+		if (pipelining_)
+		{
+			int sizes[] = { (pending_bytes_ += value_bytes(arg0), 0), (pending_bytes_ += value_bytes(args), 0)... };
+			(void)sizes;
+		}
+
+		call_profiler::phase_scope scope(profiler(), phase_encode);
+
 		evaluate_result([this, &arg0, &args...]() {
 							result_writer<typename std::remove_reference<T0>::type, void,
 										  typename std::remove_reference<Types>::type...>(*this)(
@@ -521,15 +684,145 @@ class mathematica : public wrapper_base<mathematica>
 						});
 	}
 
+	/**
+	 * @brief Writes a frame of an animation stream as the result.
+	 *
+	 * Only the tiles that changed since the last frame of the stream are sent, along
+	 * with a call to the ApplyFramePatch function of the package which rebuilds the
+	 * full frame on the kernel side. The package context must be the namespace given
+	 * to the constructor.
+	 *
+	 * A patch is lost if its result is discarded or the call is aborted. To detect it
+	 * without a round trip to the kernel, functions writing frames take the sequence
+	 * number of the last frame the kernel applied as an argument, evaluated with the
+	 * call, for example:
+	 *
+	 * @code
+	 * :Pattern:   MyFrame[id_String, m_List]
+	 * :Arguments: { id, m, MyPackage`FrameSequence[id] }
+	 * @endcode
+	 *
+	 * Outside of pipelined batches, the frame is sent in full if this number is not the
+	 * one of the last frame written. Otherwise, ApplyFramePatch reports the lost patch
+	 * and drops the stream, which is sent in full again once a host sequence is given.
+	 *
+	 * @param stream_id     Identifier of the stream
+	 * @param frame         Frame to write, of depth 2 or 3
+	 * @param host_sequence Sequence number of the last frame of the stream the kernel
+	 *                      applied, or -1 if unknown
+	 */
+	void write_frame(const std::string &stream_id, const std::shared_ptr<basic_matrix<float>> &frame,
+					 int host_sequence = -1);
+
+	/**
+	 * @brief Get the encoder used by write_frame
+	 *
+	 * @return Reference to the frame encoder
+	 */
+	inline frame_delta_encoder &frame_encoder()
+	{ return frames_; }
+
+	/**
+	 * @brief Writes the metrics of this wrapper: the profiler metrics, the reuse of
+	 * frame tiles by write_frame, and the calls and flushes of pipelined batches.
+	 *
+	 * @param writer Metrics writer
+	 */
+	void write_metrics(metrics_writer &writer);
+
+	/**
+	 * @brief Sends a preview of a result to the kernel before the function returns.
+	 *
+	 * The preview is stored by the SetPreview function of the package, and can be
+	 * displayed with Dynamic[Preview[id]].
+	 *
+	 * @param id      Identifier of the result
+	 * @param preview Preview matrix
+	 */
+	void send_preview(const std::string &id, const std::shared_ptr<basic_matrix<float>> &preview);
+
+	/**
+	 * @brief Writes a result after streaming its downsampled mip levels as previews,
+	 * coarsest first.
+	 *
+	 * @param id     Identifier of the result
+	 * @param matrix Full resolution result
+	 * @param levels Number of downsampled levels, each one halving the resolution
+	 */
+	void stream_progressive(const std::string &id, const std::shared_ptr<basic_matrix<float>> &matrix, int levels);
+
 	/**
 	 * @brief Sends a failure message on the link object to notify of a failure.
+	 *
+	 * If the current call already wrote its result, the result is kept and the failure
+	 * is only reported as a message.
+	 *
 	 * @param exceptionMessage Text to send in the message
 	 * @param messageName      Name of the format string to use
 	 */
 	void send_failure(const std::string &exceptionMessage, const std::string &messageName = std::string("err"));
 
+	/**
+	 * @brief Sends queued messages to the kernel in a single evaluation, before the
+	 * result of the call is written. Messages queued after the result was written are
+	 * sent with the next call.
+	 *
+	 * Warnings and errors are issued as messages of the namespace, and progress updates
+	 * are stored by the SetProgress function of the package. In pipelined batches, they
+	 * are held and returned with the answer instead.
+	 *
+	 * Outside of batches, the evaluation starts a new packet: the arguments of the call
+	 * that were not read yet are discarded, so messages must only be delivered once
+	 * every parameter has been read.
+	 *
+	 * @param messages Messages to send
+	 */
+	void send_messages(const std::vector<queued_message> &messages);
+
 	private:
 	std::shared_ptr<MLinkMark> place_mark();
+	void put_message(const queued_message &message);
+	void run_pipelined_call(size_t index);
+};
+
+/**
+ * @brief Registers a function so that it can be called in pipelined batches.
+ *
+ * Instances are meant to be declared at namespace scope, usually through OM_DEFUN,
+ * next to the function called by mprep.
+ */
+class mathematica_function
+{
+	std::string name_;
+	std::function<void(mathematica &)> fun_;
+
+	public:
+	/**
+	 * @brief Registers a function
+	 *
+	 * @param name Name of the function in pipelined calls
+	 * @param fun  Implementation of the function
+	 */
+	mathematica_function(const char *name, std::function<void(mathematica &)> fun);
+
+	/**
+	 * @brief Gets the name of the function
+	 */
+	inline const std::string &name() const
+	{ return name_; }
+
+	/**
+	 * @brief Gets the implementation of the function
+	 */
+	inline const std::function<void(mathematica &)> &function() const
+	{ return fun_; }
+
+	/**
+	 * @brief Gets the registered functions, indexed by name
+	 *
+	 * @return Reference to the registry
+	 */
+	static std::map<std::string, const mathematica_function *> &registry();
 };
 
 template <>
@@ -562,6 +855,41 @@ std::shared_ptr<basic_matrix<float>>
 mathematica::param_reader<std::shared_ptr<basic_matrix<float>>>::try_read(size_t paramIdx, const std::string &paramName,
 																		  bool &success, bool getData);
 
+template <>
+matrix_view<float>
+mathematica::param_reader<matrix_view<float>>::try_read(size_t paramIdx, const std::string &paramName,
+														bool &success, bool getData);
+
+template <>
+range_view<float>
+mathematica::param_reader<range_view<float>>::try_read(size_t paramIdx, const std::string &paramName,
+														bool &success, bool getData);
+
+template <>
+ragged_array<float>
+mathematica::param_reader<ragged_array<float>>::try_read(size_t paramIdx, const std::string &paramName,
+														bool &success, bool getData);
+
+template <>
+matrix_batch<float>
+mathematica::param_reader<matrix_batch<float>>::try_read(size_t paramIdx, const std::string &paramName,
+														  bool &success, bool getData);
+
+template <>
+bitmask
+mathematica::param_reader<bitmask>::try_read(size_t paramIdx, const std::string &paramName,
+											 bool &success, bool getData);
+
+template <>
+dictionary
+mathematica::param_reader<dictionary>::try_read(size_t paramIdx, const std::string &paramName,
+												bool &success, bool getData);
+
+template <>
+std::shared_ptr<tiled_matrix<float>>
+mathematica::param_reader<std::shared_ptr<tiled_matrix<float>>>::try_read(size_t paramIdx, const std::string &paramName,
+																		  bool &success, bool getData);
+
 template <>
 void mathematica::result_writer<int, void>::operator()(const int &result);
 
@@ -579,6 +907,27 @@ void mathematica::result_writer<std::string, void>::operator()(const std::string
 
 template <>
 void mathematica::result_writer<std::shared_ptr<basic_matrix<float>>, void>::operator()(const std::shared_ptr<basic_matrix<float>> &result);
+
+template <>
+void mathematica::result_writer<std::shared_ptr<tiled_matrix<float>>, void>::operator()(const std::shared_ptr<tiled_matrix<float>> &result);
+
+template <>
+void mathematica::result_writer<ragged_array<float>, void>::operator()(const ragged_array<float> &result);
+
+template <>
+void mathematica::result_writer<matrix_batch<float>, void>::operator()(const matrix_batch<float> &result);
+
+template <>
+void mathematica::result_writer<bitmask, void>::operator()(const bitmask &result);
+
+template <>
+void mathematica::result_writer<dictionary, void>::operator()(const dictionary &result);
+
+template <>
+void mathematica::result_writer<graphics, void>::operator()(const graphics &result);
+
+// Precompiled in the omw_mathematica library
+OMW_WRAPPER_INSTANTIATIONS(extern, mathematica)
 }
 
 /**
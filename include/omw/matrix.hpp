@@ -8,10 +8,13 @@
 #ifndef _OMW_MATRIX_HPP_
 #define _OMW_MATRIX_HPP_
 
+#include <algorithm>
+#include <array>
 #include <memory>
 #include <vector>
 
 #include "omw/pre.hpp"
+#include "omw/validation.hpp"
 
 namespace omw
 {
@@ -20,6 +23,8 @@ namespace omw
  */
 template <typename T> class basic_matrix
 {
+	array_stats m_stats;
+
 public:
 	/**
 	 * @brief Base class deleter
@@ -27,9 +32,11 @@ public:
 	virtual ~basic_matrix() {}
 
 	/**
-	 * @brief Pointer to the matrix data.
+	 * @brief Pointer to the matrix data, in row-major order. Implementations whose
+	 * #row_major is false throw instead, so callers must check it or use #copy_to.
 	 *
 	 * @return Pointer to the underlying memory block
+	 * @throws std::runtime_error If the matrix is not stored in row-major order
 	 */
 	virtual const T *data() const = 0;
 
@@ -64,6 +71,42 @@ public:
 	 * @return Pointer to the head data
 	 */
 	virtual char **heads() const = 0;
+
+	/**
+	 * @brief Tests if the elements are stored in row-major order, in which case
+	 * #data can be used.
+	 *
+	 * @return true if #data is available
+	 */
+	virtual bool row_major() const { return true; }
+
+	/**
+	 * @brief Copies the elements of the matrix to a buffer in row-major order.
+	 *
+	 * @param dst Destination buffer, large enough to hold every element
+	 */
+	virtual void copy_to(T *dst) const
+	{
+		std::size_t n = 1;
+		for (int i = 0; i < depth(); ++i)
+			n *= dims()[i];
+
+		std::copy_n(data(), n, dst);
+	}
+
+	/**
+	 * @brief Statistics gathered while this matrix was read as a parameter.
+	 *
+	 * @return Statistics, not valid if none were requested
+	 */
+	const array_stats &stats() const { return m_stats; }
+
+	/**
+	 * @brief Attaches statistics to this matrix.
+	 *
+	 * @param stats Statistics gathered while reading the matrix
+	 */
+	void stats(const array_stats &stats) { m_stats = stats; }
 };
 
 /**
@@ -227,6 +270,32 @@ template <typename T> class ref_matrix : public basic_matrix<T>
 		return std::make_shared<ref_matrix<T>>(std::forward<Args>(args)...);
 	}
 };
+
+/**
+ * @brief Gets a matrix that owns its elements, so that it can be kept after the call
+ * that read it.
+ *
+ * Matrices read from the host, such as Python buffers, Mathematica arrays owned by the
+ * link or mapped batch files, can be modified or freed once the call returns. Only
+ * omw::vector_matrix instances own their elements, other matrices are copied in
+ * row-major order.
+ *
+ * @param matrix Matrix to keep
+ * @return \p matrix if it is an omw::vector_matrix, a copy of it otherwise
+ */
+template <typename T> std::shared_ptr<basic_matrix<T>> owned_matrix(const std::shared_ptr<basic_matrix<T>> &matrix)
+{
+	if (dynamic_cast<const vector_matrix<T> *>(matrix.get()))
+		return matrix;
+
+	std::size_t count = 1;
+	for (int k = 0; k < matrix->depth(); ++k)
+		count *= matrix->dims()[k];
+
+	std::vector<T> elements(count);
+	matrix->copy_to(elements.data());
+	return vector_matrix<T>::make(std::move(elements), std::vector<int>(matrix->dims(), matrix->dims() + matrix->depth()));
+}
 }
 
 #endif /* _OMW_MATRIX_HPP_ */
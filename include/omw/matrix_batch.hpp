@@ -0,0 +1,141 @@
+/**
+ * @file   omw/matrix_batch.hpp
+ * @brief  Definition of omw::matrix_batch
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_MATRIX_BATCH_HPP_
+#define _OMW_MATRIX_BATCH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "omw/pre.hpp"
+#include "omw/matrix.hpp"
+#include "omw/snapshot.hpp"
+
+namespace omw
+{
+/**
+ * @brief Represents a list of matrices of the same dimensions, such as the frames of a
+ * clip or a batch of tiles, stored one after the other in a single aligned buffer.
+ *
+ * Each item is stored in row-major order, like the elements of omw::basic_matrix, so
+ * the whole batch is a row-major array whose first dimension is the item index. Hosts
+ * pass batches as lists of equally shaped arrays or as packed arrays of one more
+ * dimension, and readers decode them with a single allocation.
+ */
+template <typename T> class matrix_batch
+{
+	std::shared_ptr<void> m_owner;
+	T *m_data;
+	std::size_t m_count;
+	std::vector<int> m_item_dims;
+	std::size_t m_item_size;
+
+public:
+	/// Alignment of the elements, in bytes
+	static constexpr std::size_t alignment = 64;
+
+	/**
+	 * @brief Initializes an empty batch.
+	 */
+	matrix_batch() : m_owner(), m_data(nullptr), m_count(0), m_item_dims(), m_item_size(0) {}
+
+	/**
+	 * @brief Initializes a batch of zero-filled items.
+	 *
+	 * @param count     Number of items
+	 * @param item_dims Dimensions of each item
+	 * @throws std::runtime_error if a dimension is negative
+	 */
+	matrix_batch(std::size_t count, std::vector<int> item_dims)
+	: m_owner(), m_data(nullptr), m_count(count), m_item_dims(std::move(item_dims)), m_item_size(1)
+	{
+		for (int d : m_item_dims)
+		{
+			if (d < 0)
+			{
+				std::stringstream ss;
+				ss << "Invalid matrix batch dimension " << d;
+				throw std::runtime_error(ss.str());
+			}
+
+			m_item_size *= d;
+		}
+
+		// Over-allocate so that the elements can start on an aligned address
+		const std::size_t bytes = m_count * m_item_size * sizeof(T) + alignment;
+		std::shared_ptr<unsigned char> block(new unsigned char[bytes](), std::default_delete<unsigned char[]>());
+
+		const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block.get());
+		m_data = reinterpret_cast<T *>((address + alignment - 1) / alignment * alignment);
+		m_owner = std::move(block);
+	}
+
+	/**
+	 * @brief Number of items.
+	 */
+	std::size_t size() const { return m_count; }
+
+	/**
+	 * @brief Dimensions of each item.
+	 */
+	const std::vector<int> &item_dims() const { return m_item_dims; }
+
+	/**
+	 * @brief Number of elements of each item.
+	 */
+	std::size_t item_size() const { return m_item_size; }
+
+	/**
+	 * @brief Pointer to the elements of all the items, aligned on #alignment bytes.
+	 */
+	const T *data() const { return m_data; }
+
+	/// @copydoc data() const
+	T *data() { return m_data; }
+
+	/**
+	 * @brief Pointer to the elements of an item, in row-major order.
+	 *
+	 * @param idx Index of the item
+	 */
+	const T *item(std::size_t idx) const { return m_data + idx * m_item_size; }
+
+	/// @copydoc item(std::size_t) const
+	T *item(std::size_t idx) { return m_data + idx * m_item_size; }
+
+	/**
+	 * @brief Gets an item as a matrix sharing the storage of the batch.
+	 *
+	 * @param idx Index of the item
+	 * @return Matrix of the item dimensions
+	 */
+	std::shared_ptr<basic_matrix<T>> matrix(std::size_t idx) const
+	{
+		return mapped_matrix<T>::make(m_owner, item(idx), std::vector<int>(m_item_dims));
+	}
+
+	/**
+	 * @brief Gets the whole batch as a matrix sharing its storage, whose first dimension
+	 * is the item index.
+	 *
+	 * @return Matrix of one more dimension than the items
+	 */
+	std::shared_ptr<basic_matrix<T>> as_matrix() const
+	{
+		std::vector<int> dims(1, static_cast<int>(m_count));
+		dims.insert(dims.end(), m_item_dims.begin(), m_item_dims.end());
+
+		return mapped_matrix<T>::make(m_owner, m_data, std::move(dims));
+	}
+};
+}
+
+#endif /* _OMW_MATRIX_BATCH_HPP_ */
@@ -0,0 +1,306 @@
+/**
+ * @file   omw/matrix_view.hpp
+ * @brief  Definition of omw::matrix_view
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_MATRIX_VIEW_HPP_
+#define _OMW_MATRIX_VIEW_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "omw/pre.hpp"
+#include "omw/matrix.hpp"
+
+namespace omw
+{
+/**
+ * @brief Casts a strided run of source elements into a strided run of destination elements.
+ *
+ * When both strides are 1, the loop is a plain contiguous conversion the compiler can
+ * vectorize. Otherwise it is a strided gather/scatter.
+ *
+ * @param src        Pointer to the first source element
+ * @param src_stride Distance between two source elements, in elements
+ * @param dst        Pointer to the first destination element
+ * @param dst_stride Distance between two destination elements, in elements
+ * @param count      Number of elements to convert
+ */
+template <typename T, typename TSrc>
+void cast_run(const void *src, std::ptrdiff_t src_stride, T *dst, std::ptrdiff_t dst_stride, std::size_t count)
+{
+	const TSrc *s = static_cast<const TSrc *>(src);
+
+	if (src_stride == 1 && dst_stride == 1)
+	{
+		for (std::size_t n = 0; n < count; ++n)
+			dst[n] = static_cast<T>(s[n]);
+	}
+	else
+	{
+		for (std::size_t n = 0; n < count; ++n)
+			dst[n * dst_stride] = static_cast<T>(s[n * src_stride]);
+	}
+}
+
+/**
+ * @brief Represents a lazy, read-only 3D view over an array owned by someone else.
+ *
+ * The view does not copy its source: the element type conversion and the layout change
+ * (for example from Octave's column-major order to omw's row-major order) happen when
+ * elements are accessed. Sub-views (regions of interest, strided subsamplings,
+ * transpositions) are created in constant time, so kernels only pay for the elements
+ * they actually read.
+ *
+ * Dimensions are always (rows, columns, channels); 2D sources have a single channel.
+ */
+template <typename T> class matrix_view
+{
+public:
+	/// Type of the function used to convert runs of source elements
+	typedef void (*load_function)(const void *, std::ptrdiff_t, T *, std::ptrdiff_t, std::size_t);
+
+private:
+	std::shared_ptr<const void> m_owner;
+	const char *m_data;
+	std::size_t m_elem_size;
+	std::array<int, 3> m_dims;
+	std::array<std::ptrdiff_t, 3> m_strides;
+	load_function m_load;
+
+	const void *address(int i, int j, int k) const
+	{
+		return m_data + (i * m_strides[0] + j * m_strides[1] + k * m_strides[2]) * static_cast<std::ptrdiff_t>(m_elem_size);
+	}
+
+public:
+	/**
+	 * @brief Initializes an empty view.
+	 */
+	matrix_view() : m_owner(), m_data(nullptr), m_elem_size(0), m_dims{ { 0, 0, 0 } }, m_strides{ { 0, 0, 0 } }, m_load(nullptr) {}
+
+	/**
+	 * @brief Initializes a new view over a source array.
+	 *
+	 * @param owner   Object that keeps the source memory alive for the lifetime of the view
+	 * @param data    Pointer to the source element (0, 0, 0)
+	 * @param dims    Number of rows, columns and channels of the view
+	 * @param strides Distance in source elements between two consecutive rows, columns
+	 *                and channels
+	 */
+	template <typename TSrc>
+	matrix_view(std::shared_ptr<const void> owner, const TSrc *data, const std::array<int, 3> &dims,
+				const std::array<std::ptrdiff_t, 3> &strides)
+	: m_owner(std::move(owner)), m_data(reinterpret_cast<const char *>(data)), m_elem_size(sizeof(TSrc)),
+	  m_dims(dims), m_strides(strides), m_load(&cast_run<T, TSrc>)
+	{
+	}
+
+	/**
+	 * @brief Builds a view over an omw::basic_matrix, which is stored in row-major order.
+	 *
+	 * @param matrix Matrix to view. The view keeps a reference to it.
+	 * @return View over \p matrix
+	 * @throws std::runtime_error If the matrix has more than 3 dimensions
+	 */
+	template <typename TSrc> static matrix_view<T> of(const std::shared_ptr<basic_matrix<TSrc>> &matrix)
+	{
+		int d = matrix->depth();
+		if (d < 1 || d > 3)
+			throw std::runtime_error("Only matrices of depth 1 to 3 can be viewed");
+
+		if (!matrix->row_major())
+		{
+			// Views need a row-major source
+			std::vector<int> dims(matrix->dims(), matrix->dims() + d);
+			std::vector<TSrc> vec(std::size_t(dims[0]) * (d >= 2 ? dims[1] : 1) * (d == 3 ? dims[2] : 1));
+			matrix->copy_to(vec.data());
+			return of(vector_matrix<TSrc>::make(std::move(vec), std::move(dims)));
+		}
+
+		std::array<int, 3> dims{ { matrix->dims()[0], d >= 2 ? matrix->dims()[1] : 1, d == 3 ? matrix->dims()[2] : 1 } };
+		std::array<std::ptrdiff_t, 3> strides{ { std::ptrdiff_t(dims[1]) * dims[2], dims[2], 1 } };
+
+		return matrix_view<T>(matrix, matrix->data(), dims, strides);
+	}
+
+	/**
+	 * @brief Pointer to the dimensions array (rows, columns, channels).
+	 *
+	 * @return Pointer to the dimensions array
+	 */
+	const int *dims() const { return m_dims.data(); }
+
+	/**
+	 * @brief Depth of the view. This is always 3.
+	 *
+	 * @return Depth of the view
+	 */
+	int depth() const { return 3; }
+
+	/**
+	 * @brief Number of elements in the view.
+	 *
+	 * @return Number of elements
+	 */
+	std::size_t size() const { return std::size_t(m_dims[0]) * m_dims[1] * m_dims[2]; }
+
+	/**
+	 * @brief Tests if this view refers to a source array.
+	 */
+	explicit operator bool() const { return m_load != nullptr; }
+
+	/**
+	 * @brief Reads and converts a single element.
+	 *
+	 * @param i Row index
+	 * @param j Column index
+	 * @param k Channel index
+	 * @return Converted element value
+	 */
+	T operator()(int i, int j, int k = 0) const
+	{
+		T value;
+		m_load(address(i, j, k), 1, &value, 1, 1);
+		return value;
+	}
+
+	/**
+	 * @brief Converts a block of the view into a row-major buffer.
+	 *
+	 * The inner loop follows the source dimension with the smallest stride, so contiguous
+	 * source runs are converted in one vectorizable pass and only the destination is
+	 * scattered.
+	 *
+	 * @param i0  First row of the block
+	 * @param j0  First column of the block
+	 * @param h   Number of rows of the block
+	 * @param w   Number of columns of the block
+	 * @param dst Destination buffer, of at least h * w * channels elements
+	 * @throws std::out_of_range If the block is not contained in this view
+	 */
+	void read_block(int i0, int j0, int h, int w, T *dst) const
+	{
+		if (i0 < 0 || j0 < 0 || h < 0 || w < 0 || i0 + h > m_dims[0] || j0 + w > m_dims[1])
+			throw std::out_of_range("Block is outside of the view");
+
+		if (h == 0 || w == 0)
+			return;
+
+		const int c = m_dims[2];
+		const std::ptrdiff_t ds[3] = { std::ptrdiff_t(w) * c, c, 1 };
+		const int n[3] = { h, w, c };
+
+		// Pick the innermost axis as the one with the smallest source stride
+		int inner = 0;
+		for (int a = 1; a < 3; ++a)
+			if (n[a] > 1 && (n[inner] <= 1 || std::abs(m_strides[a]) < std::abs(m_strides[inner])))
+				inner = a;
+
+		int outer[2], o = 0;
+		for (int a = 0; a < 3; ++a)
+			if (a != inner)
+				outer[o++] = a;
+
+		int idx[3];
+		for (int p = 0; p < n[outer[0]]; ++p)
+		{
+			for (int q = 0; q < n[outer[1]]; ++q)
+			{
+				idx[outer[0]] = p;
+				idx[outer[1]] = q;
+				idx[inner] = 0;
+
+				m_load(address(i0 + idx[0], j0 + idx[1], idx[2]), m_strides[inner],
+					   dst + idx[0] * ds[0] + idx[1] * ds[1] + idx[2] * ds[2], ds[inner], n[inner]);
+			}
+		}
+	}
+
+	/**
+	 * @brief Converts a full row of the view into a row-major buffer.
+	 *
+	 * @param i   Row index
+	 * @param dst Destination buffer, of at least columns * channels elements
+	 */
+	void read_row(int i, T *dst) const { read_block(i, 0, 1, m_dims[1], dst); }
+
+	/**
+	 * @brief Builds a view over a rectangular region of this view.
+	 *
+	 * @param i0 First row of the region
+	 * @param j0 First column of the region
+	 * @param h  Number of rows of the region
+	 * @param w  Number of columns of the region
+	 * @return View over the region
+	 * @throws std::out_of_range If the region is not contained in this view
+	 */
+	matrix_view<T> roi(int i0, int j0, int h, int w) const
+	{
+		if (i0 < 0 || j0 < 0 || h < 0 || w < 0 || i0 + h > m_dims[0] || j0 + w > m_dims[1])
+			throw std::out_of_range("Region of interest is outside of the view");
+
+		matrix_view<T> result(*this);
+		result.m_data = static_cast<const char *>(address(i0, j0, 0));
+		result.m_dims[0] = h;
+		result.m_dims[1] = w;
+		return result;
+	}
+
+	/**
+	 * @brief Builds a view over every \p si-th row and \p sj-th column of this view.
+	 *
+	 * @param si Row step
+	 * @param sj Column step
+	 * @return Subsampled view
+	 */
+	matrix_view<T> step(int si, int sj) const
+	{
+		if (si <= 0 || sj <= 0)
+			throw std::invalid_argument("View steps must be positive");
+
+		matrix_view<T> result(*this);
+		result.m_dims[0] = (m_dims[0] + si - 1) / si;
+		result.m_dims[1] = (m_dims[1] + sj - 1) / sj;
+		result.m_strides[0] *= si;
+		result.m_strides[1] *= sj;
+		return result;
+	}
+
+	/**
+	 * @brief Builds a view where rows and columns are swapped.
+	 *
+	 * @return Transposed view
+	 */
+	matrix_view<T> transposed() const
+	{
+		matrix_view<T> result(*this);
+		std::swap(result.m_dims[0], result.m_dims[1]);
+		std::swap(result.m_strides[0], result.m_strides[1]);
+		return result;
+	}
+
+	/**
+	 * @brief Converts the whole view into a new row-major matrix.
+	 *
+	 * @return Shared pointer to the newly allocated matrix
+	 */
+	std::shared_ptr<basic_matrix<T>> to_matrix() const
+	{
+		std::vector<T> vec(size());
+		if (!vec.empty())
+			read_block(0, 0, m_dims[0], m_dims[1], vec.data());
+
+		return vector_matrix<T>::make(std::move(vec), std::vector<int>(m_dims.begin(), m_dims.end()));
+	}
+};
+}
+
+#endif /* _OMW_MATRIX_VIEW_HPP_ */
@@ -0,0 +1,165 @@
+/**
+ * @file   omw/message_queue.hpp
+ * @brief  Definition of omw::message_queue
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_MESSAGE_QUEUE_HPP_
+#define _OMW_MESSAGE_QUEUE_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace omw
+{
+/**
+ * @brief Kinds of messages sent to the host
+ */
+enum message_kind
+{
+	/// Failure of the call
+	message_error,
+	/// Warning, the call goes on
+	message_warning,
+	/// Progress of the call, only the latest one is kept
+	message_progress
+};
+
+/**
+ * @brief Gets the name of a message kind
+ *
+ * @param kind Message kind
+ * @return Name of the kind, as used in the text of delivered messages
+ */
+const char *message_kind_name(message_kind kind);
+
+/**
+ * @brief Message waiting to be delivered to the host
+ */
+struct queued_message
+{
+	/// Kind of the message
+	message_kind kind;
+	/// Name of the message, such as the message name in Mathematica
+	std::string name;
+	/// Text of the message
+	std::string text;
+	/// Number of times the message was queued since the last delivery
+	std::size_t count;
+
+	/**
+	 * @brief Formats the text of this message, with the number of repetitions
+	 *
+	 * @return Text of the message
+	 */
+	std::string format() const;
+};
+
+/**
+ * @brief Queues the messages of wrapped calls, so that they are delivered as one batch
+ * instead of one host round trip each.
+ *
+ * Identical messages are merged and counted. Progress updates are coalesced into a
+ * single pending one, and request a delivery before the end of the call only once it
+ * waited for a progress interval, so long calls still report at that rate.
+ */
+class message_queue
+{
+	std::vector<queued_message> messages_;
+	/// Index of the pending messages in messages_, by kind, name and text
+	std::unordered_map<std::string, std::size_t> index_;
+	/// Index of the pending progress in messages_, if any
+	std::size_t progress_;
+	std::size_t capacity_;
+	std::size_t overflow_;
+	std::chrono::steady_clock::duration progress_interval_;
+	/// Time the pending progress was first queued
+	std::chrono::steady_clock::time_point progress_since_;
+	std::uint64_t queued_total_;
+	std::uint64_t delivered_total_;
+	std::uint64_t progress_coalesced_total_;
+
+	public:
+	/**
+	 * @brief Initializes a new, empty, message queue
+	 *
+	 * @param capacity Maximum number of distinct messages kept between two deliveries
+	 */
+	message_queue(std::size_t capacity = 256);
+
+	/**
+	 * @brief Gets the time a progress update may wait for the end of the call before
+	 * #progress requests its delivery
+	 */
+	inline std::chrono::steady_clock::duration progress_interval() const
+	{ return progress_interval_; }
+
+	/**
+	 * @brief Sets the time a progress update may wait for the end of the call before
+	 * #progress requests its delivery
+	 *
+	 * @param new_interval Maximum delay of progress updates
+	 */
+	inline void progress_interval(std::chrono::steady_clock::duration new_interval)
+	{ progress_interval_ = new_interval; }
+
+	/**
+	 * @brief Tests if no message is waiting to be delivered
+	 */
+	inline bool empty() const
+	{ return messages_.empty() && overflow_ == 0; }
+
+	/**
+	 * @brief Queues a message, merging it with an identical pending message.
+	 *
+	 * Messages beyond the capacity of the queue are only counted, and reported by a
+	 * single warning when they are taken.
+	 *
+	 * @param kind Kind of the message
+	 * @param name Name of the message
+	 * @param text Text of the message
+	 */
+	void push(message_kind kind, const std::string &name, const std::string &text);
+
+	/**
+	 * @brief Queues a progress update, replacing the pending one if any.
+	 *
+	 * @param text Text of the progress update
+	 * @return true if the pending progress was first queued at least one progress
+	 *         interval ago, in which case the queue should be delivered now
+	 */
+	bool progress(const std::string &text);
+
+	/**
+	 * @brief Takes the pending messages, in the order they were first queued
+	 *
+	 * @return Messages to deliver
+	 */
+	std::vector<queued_message> take();
+
+	/**
+	 * @brief Gets the number of messages queued, repetitions included
+	 */
+	inline std::uint64_t queued_total() const
+	{ return queued_total_; }
+
+	/**
+	 * @brief Gets the number of messages taken for delivery
+	 */
+	inline std::uint64_t delivered_total() const
+	{ return delivered_total_; }
+
+	/**
+	 * @brief Gets the number of progress updates replaced before their delivery
+	 */
+	inline std::uint64_t progress_coalesced_total() const
+	{ return progress_coalesced_total_; }
+};
+}
+
+#endif /* _OMW_MESSAGE_QUEUE_HPP_ */
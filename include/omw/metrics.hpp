@@ -0,0 +1,202 @@
+/**
+ * @file   omw/metrics.hpp
+ * @brief  Definition of omw::metrics_exporter
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_METRICS_HPP_
+#define _OMW_METRICS_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+namespace omw
+{
+/**
+ * @brief Writes metrics in the Prometheus text exposition format
+ */
+class metrics_writer
+{
+	std::ostream &os_;
+	std::string family_;
+
+	public:
+	/**
+	 * @brief Initializes a new metrics writer
+	 *
+	 * @param os Output stream
+	 */
+	metrics_writer(std::ostream &os);
+
+	/**
+	 * @brief Starts a metric family. Families must not be interleaved.
+	 *
+	 * @param name Name of the family
+	 * @param type Prometheus type (counter, gauge, summary, histogram)
+	 * @param help Description of the family
+	 */
+	void family(const std::string &name, const char *type, const char *help);
+
+	/**
+	 * @brief Writes a sample of the current family
+	 *
+	 * @param suffix Suffix of the sample name (such as _sum or _count), may be empty
+	 * @param labels Formatted labels, as returned by #label, may be empty
+	 * @param value  Value of the sample
+	 */
+	void sample(const char *suffix, const std::string &labels, double value);
+
+	/**
+	 * @brief Formats a label, escaping its value
+	 *
+	 * @param name  Name of the label
+	 * @param value Value of the label
+	 * @return Formatted label, to be joined with commas
+	 */
+	static std::string label(const char *name, const std::string &value);
+};
+
+/**
+ * @brief Mutex held by the wrappers while running a function, which the metrics
+ * collector can wait for without polling, and stop waiting for on request.
+ *
+ * Satisfies the Lockable requirements, so it is used with std::lock_guard.
+ */
+class call_mutex
+{
+	std::mutex mutex_;
+	std::condition_variable released_;
+	bool locked_;
+
+	public:
+	/**
+	 * @brief Initializes an unlocked mutex
+	 */
+	call_mutex();
+
+	call_mutex(const call_mutex &) = delete;
+	call_mutex &operator=(const call_mutex &) = delete;
+
+	/**
+	 * @brief Locks the mutex, blocking until it is released
+	 */
+	void lock();
+
+	/**
+	 * @brief Locks the mutex if it is free
+	 *
+	 * @return true if the mutex was locked
+	 */
+	bool try_lock();
+
+	/**
+	 * @brief Unlocks the mutex, waking up the waiting threads
+	 */
+	void unlock();
+
+	/**
+	 * @brief Locks the mutex, unless \p cancelled returns true before it is released.
+	 *
+	 * The predicate is evaluated when the mutex is released and after every call to
+	 * #interrupt.
+	 *
+	 * @param cancelled Predicate telling if the wait should be given up
+	 * @return true if the mutex was locked
+	 */
+	bool lock_unless(const std::function<bool()> &cancelled);
+
+	/**
+	 * @brief Wakes up the threads waiting in #lock_unless, so they evaluate their
+	 * predicate again
+	 */
+	void interrupt();
+};
+
+/**
+ * @brief Periodically publishes metrics in the Prometheus text format from a background
+ * thread.
+ *
+ * The target is either a file path, rewritten atomically at every interval (suitable
+ * for the textfile collector of node_exporter), or a Unix domain socket path prefixed by
+ * "unix:", served over HTTP with the latest snapshot.
+ *
+ * The collector runs on the background thread while holding #state_mutex. The wrappers
+ * hold this mutex while running a function, so the collector observes consistent state
+ * and only delays calls for the time it takes to format a snapshot. The exporter may be
+ * started and stopped from a wrapped function. The background thread runs at the lowest
+ * scheduling priority where supported.
+ */
+class metrics_exporter
+{
+	call_mutex state_mutex_;
+	std::function<void(metrics_writer &)> collector_;
+	std::string target_;
+	std::chrono::milliseconds interval_;
+	int listen_fd_;
+
+	std::thread thread_;
+	std::mutex thread_mutex_;
+	std::condition_variable wakeup_;
+	bool stop_;
+	bool running_;
+
+	void run();
+	bool collect(std::string &text);
+
+	public:
+	/**
+	 * @brief Initializes a new, stopped, metrics exporter
+	 */
+	metrics_exporter();
+
+	/**
+	 * @brief Stops the exporter
+	 */
+	~metrics_exporter();
+
+	metrics_exporter(const metrics_exporter &) = delete;
+	metrics_exporter &operator=(const metrics_exporter &) = delete;
+
+	/**
+	 * @brief Starts publishing metrics, restarting the exporter if it was running
+	 *
+	 * @param target    Path of the output file, or "unix:" followed by a socket path
+	 * @param interval  Time between two snapshots
+	 * @param collector Function that writes the metrics
+	 * @throws std::runtime_error if the socket cannot be created
+	 */
+	void start(const std::string &target, std::chrono::milliseconds interval,
+			   std::function<void(metrics_writer &)> collector);
+
+	/**
+	 * @brief Stops publishing metrics. Does nothing if the exporter is not running.
+	 */
+	void stop();
+
+	/**
+	 * @brief Tests if the exporter is running
+	 */
+	inline bool running() const
+	{ return running_; }
+
+	/**
+	 * @brief Gets the publication target
+	 */
+	inline const std::string &target() const
+	{ return target_; }
+
+	/**
+	 * @brief Gets the mutex protecting the state read by the collector
+	 */
+	inline call_mutex &state_mutex()
+	{ return state_mutex_; }
+};
+}
+
+#endif /* _OMW_METRICS_HPP_ */
@@ -0,0 +1,140 @@
+/**
+ * @file   omw/mip_pyramid.hpp
+ * @brief  Definition of omw::progressive_results
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_MIP_PYRAMID_HPP_
+#define _OMW_MIP_PYRAMID_HPP_
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "omw/pre.hpp"
+
+namespace omw
+{
+/**
+ * @brief Halves the number of rows and columns of a matrix with a 2x2 box filter.
+ *
+ * Odd rows and columns on the border are averaged with themselves.
+ *
+ * @param matrix Matrix of depth 2 or 3 to downsample
+ * @return Shared pointer to the downsampled matrix, of the same depth
+ * @throws std::runtime_error If the matrix is not of depth 2 or 3
+ */
+std::shared_ptr<basic_matrix<float>> downsample_box(const basic_matrix<float> &matrix);
+
+/**
+ * @brief Stores the mip levels of results that are delivered progressively.
+ *
+ * A progressive result is first delivered as its coarsest mip level, and then
+ * refined one level at a time on subsequent requests until the full resolution
+ * matrix has been delivered.
+ *
+ * Hosts may never request the last refinements of a result, so the pending levels are
+ * bounded: once their total size exceeds the capacity, the least recently used results
+ * are discarded. The result that was just started is always kept.
+ */
+class progressive_results
+{
+	/// Pending levels of a result
+	struct entry
+	{
+		/// Levels, coarsest last
+		std::vector<std::shared_ptr<basic_matrix<float>>> levels;
+		/// Size of the levels, in bytes
+		std::size_t bytes;
+		/// Position in lru_
+		std::list<std::string>::iterator lru;
+	};
+
+	/// Pending levels of each result
+	std::unordered_map<std::string, entry> pending_;
+	/// Ids of the pending results, least recently used first
+	std::list<std::string> lru_;
+	/// Total size of the pending levels, in bytes
+	std::size_t bytes_;
+	/// Size above which results are discarded, in bytes
+	std::size_t capacity_;
+	/// Number of results discarded so far
+	std::size_t evicted_total_;
+
+	/// Discards results until the pending levels fit in the capacity
+	void evict();
+
+	public:
+	/**
+	 * @brief Initializes an empty store.
+	 *
+	 * @param capacity Size above which results are discarded, in bytes
+	 */
+	explicit progressive_results(std::size_t capacity = std::size_t(256) << 20);
+
+	/**
+	 * @brief Builds the mip pyramid of a result and returns its coarsest level.
+	 *
+	 * Any pending refinement with the same identifier is discarded.
+	 *
+	 * @param id     Identifier of the result
+	 * @param matrix Full resolution result, copied unless it owns its elements (see omw::owned_matrix)
+	 * @param levels Number of downsampled levels to build
+	 * @return Coarsest level of the pyramid
+	 */
+	std::shared_ptr<basic_matrix<float>> begin(const std::string &id, const std::shared_ptr<basic_matrix<float>> &matrix, int levels);
+
+	/**
+	 * @brief Returns the next finer level of a result.
+	 *
+	 * @param id Identifier of the result
+	 * @return Next level, or an empty pointer if the result has been fully delivered or
+	 * discarded
+	 */
+	std::shared_ptr<basic_matrix<float>> next(const std::string &id);
+
+	/**
+	 * @brief Obtains the number of levels of a result that have not been delivered yet.
+	 *
+	 * @param id Identifier of the result
+	 * @return Number of pending levels
+	 */
+	size_t remaining(const std::string &id) const;
+
+	/**
+	 * @brief Discards the pending levels of a result.
+	 *
+	 * @param id Identifier of the result
+	 */
+	void cancel(const std::string &id);
+
+	/**
+	 * @brief Total size of the pending levels, in bytes.
+	 */
+	std::size_t bytes() const { return bytes_; }
+
+	/**
+	 * @brief Number of results discarded so far because of the capacity.
+	 */
+	std::size_t evicted_total() const { return evicted_total_; }
+
+	/**
+	 * @brief Size above which results are discarded, in bytes.
+	 */
+	std::size_t capacity() const { return capacity_; }
+
+	/**
+	 * @brief Sets the size above which results are discarded, discarding them right
+	 * away if needed.
+	 *
+	 * @param new_capacity New capacity, in bytes
+	 */
+	void capacity(std::size_t new_capacity);
+};
+}
+
+#endif /* _OMW_MIP_PYRAMID_HPP_ */
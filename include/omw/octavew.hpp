@@ -27,9 +27,15 @@
 
 #define _OCTAVE_ISNUMERIC isnumeric
 #define _OCTAVE_ISLOGICAL islogical
+#define _OCTAVE_ISCELL iscell
+#define _OCTAVE_ISSTRUCT isstruct
+#define _OCTAVE_ISINTEGER isinteger
 #else
 #define _OCTAVE_ISNUMERIC is_numeric_type
 #define _OCTAVE_ISLOGICAL is_bool_type
+#define _OCTAVE_ISCELL is_cell
+#define _OCTAVE_ISSTRUCT is_map
+#define _OCTAVE_ISINTEGER is_integer_type
 #endif
 
 #include "omw/pre.hpp"
@@ -383,6 +389,16 @@ class octavew : public wrapper_base<octavew>
 	 */
 	octave_value_list run_function(const octave_value_list &args, std::function<void(octavew &)> fun);
 
+	/**
+	 * @brief Runs a named function using the state of the link associated with this
+	 * interface wrapper.
+	 * @param name Name of the function, used to aggregate its profile
+	 * @param args Octave arguments to the function
+	 * @param fun  Function to invoke when the link is ready.
+	 * @return Octave list of return values
+	 */
+	octave_value_list run_function(const char *name, const octave_value_list &args, std::function<void(octavew &)> fun);
+
 	/**
 	 * @brief Base class for wrapper result writers
 	 */
@@ -470,17 +486,45 @@ class octavew : public wrapper_base<octavew>
 	template <class T0, class... Types>
 	void write_result(const T0& arg0, const Types&... args)
 	{
+		profile_results(arg0, args...);
+		call_profiler::phase_scope scope(profiler(), phase_encode);
+
 		result_writer<typename std::remove_reference<T0>::type, void,
 					  typename std::remove_reference<Types>::type...>(*this)(
 							arg0, args...);
 	}
 
+	/**
+	 * @brief Writes a frame of an animation stream as the result.
+	 *
+	 * Octave shares memory with the module, so frames are always written in full.
+	 *
+	 * @param stream_id     Identifier of the stream
+	 * @param frame         Frame to write
+	 * @param host_sequence Unused, see mathematica::write_frame
+	 */
+	void write_frame(const std::string &stream_id, const std::shared_ptr<basic_matrix<float>> &frame,
+					 int host_sequence = -1)
+	{
+		(void)stream_id;
+		(void)host_sequence;
+		write_result(frame);
+	}
+
 	/**
 	 * @brief Sends a failure message on the link object to notify of a failure.
 	 * @param exceptionMessage Text to send in the message
 	 * @param messageName      Name of the format string to use
 	 */
 	void send_failure(const std::string &exceptionMessage, const std::string &messageName = std::string("err"));
+
+	/**
+	 * @brief Writes queued messages to the Octave output in a single write, one line
+	 * per message prefixed with its name.
+	 *
+	 * @param messages Messages to write
+	 */
+	void send_messages(const std::vector<queued_message> &messages);
 };
 
 template <>
@@ -512,8 +556,61 @@ std::shared_ptr<basic_matrix<float>>
 octavew::param_reader<std::shared_ptr<basic_matrix<float>>>::try_read(size_t paramIdx, const std::string &paramName,
 																	 bool &success, bool getData);
 
+template <>
+matrix_view<float>
+octavew::param_reader<matrix_view<float>>::try_read(size_t paramIdx, const std::string &paramName,
+													bool &success, bool getData);
+
+template <>
+range_view<float>
+octavew::param_reader<range_view<float>>::try_read(size_t paramIdx, const std::string &paramName,
+													bool &success, bool getData);
+
+template <>
+ragged_array<float>
+octavew::param_reader<ragged_array<float>>::try_read(size_t paramIdx, const std::string &paramName,
+													bool &success, bool getData);
+
+template <>
+matrix_batch<float>
+octavew::param_reader<matrix_batch<float>>::try_read(size_t paramIdx, const std::string &paramName,
+													bool &success, bool getData);
+
+template <>
+bitmask
+octavew::param_reader<bitmask>::try_read(size_t paramIdx, const std::string &paramName,
+										 bool &success, bool getData);
+
+template <>
+dictionary
+octavew::param_reader<dictionary>::try_read(size_t paramIdx, const std::string &paramName,
+											bool &success, bool getData);
+
+template <>
+std::shared_ptr<tiled_matrix<float>>
+octavew::param_reader<std::shared_ptr<tiled_matrix<float>>>::try_read(size_t paramIdx, const std::string &paramName,
+																	 bool &success, bool getData);
+
 template <>
 void octavew::result_writer<std::shared_ptr<basic_matrix<float>>, void>::operator()(const std::shared_ptr<basic_matrix<float>> &result);
+
+template <>
+void octavew::result_writer<std::shared_ptr<tiled_matrix<float>>, void>::operator()(const std::shared_ptr<tiled_matrix<float>> &result);
+
+template <>
+void octavew::result_writer<ragged_array<float>, void>::operator()(const ragged_array<float> &result);
+
+template <>
+void octavew::result_writer<matrix_batch<float>, void>::operator()(const matrix_batch<float> &result);
+
+template <>
+void octavew::result_writer<bitmask, void>::operator()(const bitmask &result);
+
+template <>
+void octavew::result_writer<dictionary, void>::operator()(const dictionary &result);
+
+// Precompiled in the omw_octave library
+OMW_WRAPPER_INSTANTIATIONS(extern, octavew)
 }
 
 #define OM_RESULT_OCTAVE(w, code) (code)()
@@ -0,0 +1,132 @@
+/**
+ * @file   omw/perf_counters.hpp
+ * @brief  Definition of omw::perf_counters
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_PERF_COUNTERS_HPP_
+#define _OMW_PERF_COUNTERS_HPP_
+
+#include <cstdint>
+#include <string>
+
+namespace omw
+{
+/**
+ * @brief Hardware events counted by omw::perf_counters
+ */
+enum perf_event
+{
+	/// CPU cycles
+	perf_cycles,
+	/// Retired instructions
+	perf_instructions,
+	/// Last level cache misses
+	perf_llc_misses,
+	/// Mispredicted branches
+	perf_branch_misses,
+	/// Number of events
+	perf_event_count
+};
+
+/**
+ * @brief Gets the display name of a hardware event
+ *
+ * @param event Hardware event
+ * @return Name of the event
+ */
+const char *perf_event_name(perf_event event);
+
+/**
+ * @brief Raw reading of the counters, with the times the group was enabled and running
+ */
+struct perf_reading
+{
+	/// Raw counts, 0 for unavailable counters
+	std::uint64_t values[perf_event_count] = {};
+	/// Time the group was enabled, in nanoseconds
+	std::uint64_t time_enabled = 0;
+	/// Time the group was actually counting, in nanoseconds
+	std::uint64_t time_running = 0;
+
+	/**
+	 * @brief Estimates the number of events between an earlier reading and this one.
+	 *
+	 * The raw counts are subtracted first and then scaled by the fraction of that period
+	 * the group was counting. Scaled readings are estimates which are not monotonic, so
+	 * subtracting two of them could give negative counts.
+	 *
+	 * @param start  Earlier reading
+	 * @param deltas Destination array
+	 */
+	void elapsed_since(const perf_reading &start, std::uint64_t deltas[perf_event_count]) const;
+};
+
+/**
+ * @brief Reads hardware performance counters of the calling thread.
+ *
+ * On Linux, counters are opened with perf_event_open as a single group so they are
+ * read with one system call. Counters that cannot be opened (missing permissions,
+ * virtual machines, other platforms) read as zero; #available tells which ones work.
+ */
+class perf_counters
+{
+	int fds_[perf_event_count];
+	int slots_[perf_event_count];
+	int leader_;
+	int open_count_;
+	std::string error_;
+
+	public:
+	/**
+	 * @brief Opens and starts the counters for the calling thread.
+	 */
+	perf_counters();
+
+	/**
+	 * @brief Closes the counters.
+	 */
+	~perf_counters();
+
+	perf_counters(const perf_counters &) = delete;
+	perf_counters &operator=(const perf_counters &) = delete;
+
+	/**
+	 * @brief Tests if at least one counter could be opened
+	 */
+	bool available() const { return open_count_ > 0; }
+
+	/**
+	 * @brief Tests if a given counter could be opened
+	 *
+	 * @param event Hardware event
+	 */
+	bool available(perf_event event) const { return fds_[event] >= 0; }
+
+	/**
+	 * @brief Reason why counters are unavailable, if any
+	 */
+	const std::string &error() const { return error_; }
+
+	/**
+	 * @brief Reads the current value of every counter
+	 *
+	 * Values are scaled by the fraction of time the group was actually counting, so they
+	 * remain estimates of the whole period when the kernel multiplexes the counters.
+	 *
+	 * @param values Destination array, unavailable counters are set to 0
+	 */
+	void read(std::uint64_t values[perf_event_count]) const;
+
+	/**
+	 * @brief Reads the raw value of every counter, to be subtracted from a later reading
+	 * with perf_reading::elapsed_since
+	 *
+	 * @param reading Destination, unavailable counters are set to 0
+	 */
+	void read(perf_reading &reading) const;
+};
+}
+
+#endif /* _OMW_PERF_COUNTERS_HPP_ */
@@ -0,0 +1,244 @@
+/**
+ * @file   omw/pipeline.hpp
+ * @brief  Definition of omw::pipeline
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_PIPELINE_HPP_
+#define _OMW_PIPELINE_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "omw/pre.hpp"
+#include "omw/matrix.hpp"
+
+namespace omw
+{
+/**
+ * @brief Kernel of an elementwise pipeline stage.
+ *
+ * Kernels transform a chunk of elements in place. Chunks are small enough to stay in
+ * the L1 cache, so chains of elementwise stages are fused: every stage of the chain is
+ * applied to a chunk before moving on to the next one, and intermediates are never
+ * written to memory in full.
+ *
+ * @param values Elements to transform, from the first matrix argument
+ * @param inputs Matching chunks of the other matrix arguments
+ * @param count  Number of elements in the chunk
+ * @param params Scalar arguments
+ */
+typedef std::function<void(float *values, const float *const *inputs, std::size_t count, const double *params)>
+	elementwise_kernel;
+
+/**
+ * @brief Implementation of a general pipeline stage
+ *
+ * @param inputs Matrix arguments
+ * @param params Scalar arguments
+ * @return Result of the stage
+ */
+typedef std::function<std::shared_ptr<basic_matrix<float>>(const std::vector<std::shared_ptr<basic_matrix<float>>> &inputs,
+														   const std::vector<double> &params)>
+	stage_function;
+
+/**
+ * @brief Stage of a pipeline, registered in an omw::pipeline_registry
+ */
+struct pipeline_stage
+{
+	/// Name of the stage in pipeline descriptions
+	std::string name;
+	/// Number of matrix arguments, which come first
+	int matrix_args;
+	/// Number of scalar arguments, which come after the matrix arguments
+	int scalar_args;
+	/// Kernel, if the stage is elementwise
+	elementwise_kernel kernel;
+	/// Implementation, if the stage is not elementwise
+	stage_function function;
+
+	/**
+	 * @brief Tests if the stage is elementwise, and thus can be fused
+	 */
+	bool elementwise() const { return static_cast<bool>(kernel); }
+};
+
+/**
+ * @brief Set of the stages available to pipelines.
+ *
+ * A new registry contains the following builtin stages:
+ *  - elementwise: scale(x, k), offset(x, k), clamp(x, lo, hi), abs(x), sqrt(x),
+ *    add(a, b), sub(a, b), mul(a, b)
+ *  - general: transpose(x), downsample(x)
+ */
+class pipeline_registry
+{
+	std::map<std::string, pipeline_stage> stages_;
+	/// Number of changes to the registered stages
+	std::size_t revision_;
+
+	public:
+	/**
+	 * @brief Initializes a new registry with the builtin stages
+	 */
+	pipeline_registry();
+
+	/**
+	 * @brief Registers an elementwise stage, replacing any stage with the same name
+	 *
+	 * @param name        Name of the stage
+	 * @param matrix_args Number of matrix arguments, at least 1. Every matrix argument
+	 *                    must have the dimensions of the first one.
+	 * @param scalar_args Number of scalar arguments
+	 * @param kernel      Kernel of the stage
+	 */
+	void add_elementwise(const std::string &name, int matrix_args, int scalar_args, elementwise_kernel kernel);
+
+	/**
+	 * @brief Registers a general stage, replacing any stage with the same name
+	 *
+	 * @param name        Name of the stage
+	 * @param matrix_args Number of matrix arguments
+	 * @param scalar_args Number of scalar arguments
+	 * @param function    Implementation of the stage
+	 */
+	void add_stage(const std::string &name, int matrix_args, int scalar_args, stage_function function);
+
+	/**
+	 * @brief Removes a stage
+	 *
+	 * @param name Name of the stage
+	 * @return true if the stage was registered
+	 */
+	bool remove(const std::string &name);
+
+	/**
+	 * @brief Finds a stage by name
+	 *
+	 * @param name Name of the stage
+	 * @return Pointer to the stage, or nullptr if it is not registered
+	 */
+	const pipeline_stage *find(const std::string &name) const;
+
+	/**
+	 * @brief Gets the number of changes to the registered stages. Parsed pipelines
+	 * refer to the stages, and must be parsed again when it changes.
+	 */
+	std::size_t revision() const { return revision_; }
+};
+
+/**
+ * @brief A pipeline of registered stages, executed natively.
+ *
+ * Pipelines are described by a sequence of statements separated by semicolons. Each
+ * statement is a call, optionally bound to a name that later statements can refer to,
+ * so descriptions can express DAGs:
+ *
+ * @code
+ * a = scale(offset(x, 1), 2); add(a, transpose(a))
+ * @endcode
+ *
+ * Arguments are calls, names or numbers. Names that are not bound by a statement are
+ * inputs of the pipeline. The result of the last statement is the output. Intermediates
+ * are passed between stages in memory; chains of elementwise stages whose intermediates
+ * are used only once are fused into a single pass.
+ */
+class pipeline
+{
+	struct step
+	{
+		const pipeline_stage *stage;
+		std::vector<int> inputs;
+		std::vector<double> params;
+	};
+
+	/// Names of the inputs, their slots come first
+	std::vector<std::string> inputs_;
+	/// Steps, step i writes slot inputs_.size() + i
+	std::vector<step> steps_;
+	/// Fused chains of steps, in execution order
+	std::vector<std::vector<int>> groups_;
+
+	friend class pipeline_parser;
+
+	void plan();
+	int slot_of(int step) const { return static_cast<int>(inputs_.size()) + step; }
+
+	public:
+	/**
+	 * @brief Parses a pipeline description
+	 *
+	 * @param description Description of the pipeline
+	 * @param registry    Stages the description can use
+	 * @return Parsed pipeline
+	 * @throws std::runtime_error if the description is invalid
+	 */
+	static pipeline parse(const std::string &description, const pipeline_registry &registry);
+
+	/**
+	 * @brief Gets the names of the inputs of the pipeline
+	 */
+	const std::vector<std::string> &inputs() const { return inputs_; }
+
+	/**
+	 * @brief Gets the number of passes the pipeline runs, after fusion
+	 */
+	std::size_t passes() const { return groups_.size(); }
+
+	/**
+	 * @brief Runs the pipeline
+	 *
+	 * @param inputs Values of the inputs, by name
+	 * @return Output of the pipeline
+	 * @throws std::runtime_error if an input is missing or a stage fails
+	 */
+	std::shared_ptr<basic_matrix<float>> run(const std::map<std::string, std::shared_ptr<basic_matrix<float>>> &inputs) const;
+};
+
+/**
+ * @brief Keeps parsed pipelines by description, so that hosts running the same
+ * description repeatedly only parse it once.
+ *
+ * The cache is emptied whenever the stages of the registry change, and when it is
+ * full.
+ */
+class pipeline_cache
+{
+	std::map<std::string, std::shared_ptr<const pipeline>> pipelines_;
+	/// Revision of the registry the pipelines were parsed with
+	std::size_t revision_;
+	/// Maximum number of pipelines
+	std::size_t capacity_;
+
+	public:
+	/**
+	 * @brief Initializes an empty cache
+	 *
+	 * @param capacity Maximum number of pipelines
+	 */
+	explicit pipeline_cache(std::size_t capacity = 64);
+
+	/**
+	 * @brief Gets the parsed pipeline of a description, parsing it if needed
+	 *
+	 * @param description Description of the pipeline
+	 * @param registry    Registry of the stages
+	 * @return Parsed pipeline
+	 * @throws std::runtime_error if the description is invalid
+	 */
+	std::shared_ptr<const pipeline> get(const std::string &description, const pipeline_registry &registry);
+
+	/**
+	 * @brief Number of cached pipelines
+	 */
+	std::size_t size() const { return pipelines_.size(); }
+};
+}
+
+#endif /* _OMW_PIPELINE_HPP_ */
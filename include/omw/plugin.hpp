@@ -0,0 +1,171 @@
+/**
+ * @file   omw/plugin.hpp
+ * @brief  Definition of omw::plugin_loader
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_PLUGIN_HPP_
+#define _OMW_PLUGIN_HPP_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "omw/pre.hpp"
+#include "omw/pipeline.hpp"
+
+/// Version of the plugin interface, bumped whenever omw::plugin_registrar changes
+#define OMW_PLUGIN_ABI 1
+
+/**
+ * @brief Defines the entry point of a plugin, followed by its body which registers the
+ * stages of the plugin with the given registrar.
+ *
+ * @code
+ * OMW_PLUGIN(registrar)
+ * {
+ *     registrar.add_elementwise("twice", 1, 0, [](float *v, const float *const *, std::size_t n, const double *) {
+ *         for (std::size_t i = 0; i < n; ++i)
+ *             v[i] *= 2.0f;
+ *     });
+ * }
+ * @endcode
+ */
+#define OMW_PLUGIN(registrar)                                                               \
+	static void omw_plugin_body(omw::plugin_registrar &registrar);                          \
+	extern "C" __attribute__((visibility("default"))) int omw_plugin_abi() { return OMW_PLUGIN_ABI; } \
+	extern "C" __attribute__((visibility("default"))) void omw_plugin_register(omw::plugin_registrar *r) \
+	{                                                                                       \
+		omw_plugin_body(*r);                                                                \
+	}                                                                                       \
+	static void omw_plugin_body(omw::plugin_registrar &registrar)
+
+namespace omw
+{
+/**
+ * @brief Interface given to plugins to register their stages.
+ *
+ * Calls go through the virtual table of the host, so plugins do not need to resolve
+ * any symbol of the host module.
+ */
+class plugin_registrar
+{
+	public:
+	virtual ~plugin_registrar() {}
+
+	/**
+	 * @brief Registers an elementwise stage, see pipeline_registry::add_elementwise
+	 */
+	virtual void add_elementwise(const std::string &name, int matrix_args, int scalar_args, elementwise_kernel kernel) = 0;
+
+	/**
+	 * @brief Registers a general stage, see pipeline_registry::add_stage
+	 */
+	virtual void add_stage(const std::string &name, int matrix_args, int scalar_args, stage_function function) = 0;
+};
+
+/**
+ * @brief Loads pipeline stages from shared objects that can be rebuilt and swapped while
+ * the host module keeps running.
+ *
+ * Kernels under development are built as plugins with omw_add_plugin and run through
+ * pipelines, while the wrapper keeps owning the resident state, progressive and remote
+ * results and every other cache. Reloading a plugin replaces its stages, so the next
+ * pipelines use the new code without a restart of the host.
+ *
+ * Each load maps a private copy of the shared object, so that a plugin can be reloaded
+ * from the path it is rebuilt to. Replaced copies are never unmapped: matrices created
+ * by their code may still be referenced by the caches of the host, and their virtual
+ * tables live in the old copy.
+ */
+class plugin_loader
+{
+	/// Loaded plugin
+	struct plugin
+	{
+		/// Handle of the current copy
+		void *handle;
+		/// Modification time of the file when it was loaded, in nanoseconds
+		std::int64_t mtime;
+		/// Names of the stages it registered
+		std::vector<std::string> stages;
+		/// Number of times it was loaded
+		int generation;
+	};
+
+	/// Loaded plugins, by path
+	std::map<std::string, plugin> plugins_;
+	/// Handles of the replaced copies, kept mapped
+	std::vector<void *> retired_;
+
+	/**
+	 * @brief Checks the stages registered by a plugin, before they are added to the
+	 * registry
+	 *
+	 * @throws std::runtime_error if a stage is invalid, or its name is already taken by
+	 * a builtin stage or a stage of another plugin
+	 */
+	void check_stages(const std::string &path, const std::vector<pipeline_stage> &stages,
+					  const pipeline_registry &registry) const;
+
+	public:
+	/**
+	 * @brief Initializes a loader without plugins
+	 */
+	plugin_loader();
+
+	plugin_loader(const plugin_loader &) = delete;
+	plugin_loader &operator=(const plugin_loader &) = delete;
+
+	/**
+	 * @brief Loads a plugin and registers its stages, or reloads it if it was already
+	 * loaded. Stages of the previous version that are not registered anymore are removed.
+	 *
+	 * Plugins cannot replace builtin stages or stages of other plugins, so unloading a
+	 * plugin never removes stages it did not register. If loading fails, including
+	 * because of such a name collision, the previous version of the plugin stays in use.
+	 *
+	 * @param path     Path of the shared object
+	 * @param registry Registry to add the stages to
+	 * @return Number of stages registered by the plugin
+	 * @throws std::runtime_error if the plugin cannot be loaded, or one of its stages is
+	 * invalid or already registered
+	 */
+	std::size_t load(const std::string &path, pipeline_registry &registry);
+
+	/**
+	 * @brief Reloads the plugins whose file was modified since they were loaded.
+	 *
+	 * @param registry Registry to add the stages to
+	 * @return Number of reloaded plugins
+	 * @throws std::runtime_error if a plugin cannot be loaded
+	 */
+	std::size_t refresh(pipeline_registry &registry);
+
+	/**
+	 * @brief Removes the stages of a plugin.
+	 *
+	 * @param path     Path the plugin was loaded from
+	 * @param registry Registry to remove the stages from
+	 * @return true if the plugin was loaded
+	 */
+	bool unload(const std::string &path, pipeline_registry &registry);
+
+	/**
+	 * @brief Gets the number of times a plugin was loaded.
+	 *
+	 * @param path Path the plugin was loaded from
+	 * @return Number of loads, 0 if the plugin is not loaded
+	 */
+	int generation(const std::string &path) const;
+
+	/**
+	 * @brief Number of loaded plugins.
+	 */
+	std::size_t size() const { return plugins_.size(); }
+};
+}
+
+#endif /* _OMW_PLUGIN_HPP_ */
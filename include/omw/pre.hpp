@@ -12,8 +12,20 @@ namespace omw
 {
 template <typename T> class basic_array;
 template <typename T> class basic_matrix;
+class bitmask;
+class dictionary;
+class graphics;
+template <typename T> class matrix_batch;
+template <typename T> class matrix_view;
+template <typename T> class ragged_array;
+template <typename T> class range_view;
+template <typename T> class tiled_matrix;
 template <typename wrapper_impl> class wrapper_base;
 
+#if OMW_BATCH
+class batch;
+#endif
+
 #if OMW_MATHEMATICA
 class mathematica;
 #endif
@@ -21,6 +33,10 @@ class mathematica;
 #if OMW_OCTAVE
 class octavew;
 #endif
+
+#if OMW_PYTHON
+class python;
+#endif
 }
 
 #endif /* _OMW_PRE_HPP_ */
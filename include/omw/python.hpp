@@ -0,0 +1,697 @@
+/**
+ * @file   omw/python.hpp
+ * @brief  Definition of omw::python
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_PYTHON_HPP_
+#define _OMW_PYTHON_HPP_
+
+#if OMW_PYTHON
+
+// Python.h must come before standard headers
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <map>
+#include <sstream>
+#include <stack>
+
+#include <boost/optional.hpp>
+
+#include "omw/pre.hpp"
+#include "omw/type_traits.hpp"
+#include "omw/wrapper_base.hpp"
+
+namespace omw
+{
+/**
+ * @brief Represents the interface wrapper for CPython extension modules.
+ *
+ * Array and matrix parameters are read through the buffer protocol: float32 C-contiguous
+ * buffers (such as NumPy arrays of dtype float32) are used in place, other numeric
+ * buffers are converted. Matrix results are returned as omw.matrix objects, which export
+ * the result memory through the buffer protocol, so numpy.asarray does not copy them.
+ *
+ * Functions run with the GIL held.
+ */
+class python : public wrapper_base<python>
+{
+	/// Current tuple of arguments
+	PyObject *current_args_;
+	/// Current list of values to return
+	PyObject *result_;
+	/// Result sublist stack
+	std::stack<PyObject *> result_stack_;
+
+	public:
+	/**
+	 * @brief Constructs a new Python interface wrapper
+	 * @param userInitializer User initialization function.
+	 */
+	python(std::function<void(void)> userInitializer = std::function<void(void)>());
+
+	/**
+	 * @brief Get the result object for the current function call.
+	 *
+	 * @return Borrowed reference to the list of values to be returned
+	 */
+	PyObject *result();
+
+	/**
+	 * @brief Appends a value to the current result list
+	 *
+	 * @param value New reference to the value, stolen by this call
+	 * @throws std::runtime_error If \p value is null because of a Python error
+	 */
+	void append_result(PyObject *value);
+
+	/**
+	 * @brief Pushes a new sublist onto the result stack
+	 */
+	void push_result();
+
+	/**
+	 * @brief Pops the top sublist of the result stack
+	 */
+	void pop_result();
+
+	/**
+	 * @brief Get the arguments object for the current function call.
+	 *
+	 * @return Borrowed reference to the tuple that contains the parameters
+	 */
+	inline PyObject *args() { return current_args_; }
+
+	/**
+	 * @brief Base class for wrapper parameter readers
+	 */
+	struct param_reader_base
+	{
+		protected:
+		/// Reference to the object that created this parameter reader
+		python &w_;
+
+		/**
+		 * @brief Initializes a new instance of the ParamReaderBase class
+		 *
+		 * @param w Wrapper this instance is reading parameters from.
+		 */
+		param_reader_base(python &w);
+
+		/**
+		 * @brief Ensures the current parameter matches the parameter requested by the caller.
+		 * @param paramIdx  Ordinal index of the parameter
+		 * @param paramName User-friendly name of the parameter
+		 * @throws std::runtime_error See GetParam for details.
+		 */
+		void check_parameter_idx(size_t paramIdx, const std::string &paramName);
+
+		/**
+		 * @brief Gets the value of a parameter
+		 *
+		 * @param paramIdx Ordinal index of the parameter
+		 * @return Borrowed reference to the value of the parameter
+		 */
+		PyObject *arg(size_t paramIdx) const { return PyTuple_GET_ITEM(w_.current_args_, paramIdx); }
+	};
+
+	/**
+	 * @brief Template declaration for parameter readers
+	 */
+	template <class T, typename Enable = void> struct param_reader;
+
+	/**
+	 * @brief Atomic parameter reader template
+	 */
+	template <class T0>
+	struct param_reader<T0, typename std::enable_if<is_simple_param_type<T0>::value>::type> : public param_reader_base
+	{
+		/// Type of the returned parameter
+		typedef T0 return_type;
+
+		/**
+		 * @brief Initializes a new instance of the param_reader class.
+		 *
+		 * @param w Wrapper to read parameters from.
+		 */
+		param_reader(python &w) : param_reader_base(w) {}
+
+		/**
+		 * @brief Attempts reading a parameter from the associated wrapper.
+		 *
+		 * @param paramIdx  Ordinal index of the parameter in the function call
+		 * @param paramName User-friendly name of the parameter
+		 * @param success   true on success, false on failure
+		 * @param getData   true if the function should attempt to read the parameter data,
+		 *                  false if the caller is just interested in the potential success.
+		 *
+		 * @return If \p getData is true and \p success is true, the value of the parameter.
+		 * Otherwise the return value is undefined.
+		 */
+		T0 try_read(size_t paramIdx, const std::string &paramName, bool &success, bool getData);
+
+		/**
+		 * @brief Attempts reading a parameter from the associated wrapper.
+		 *
+		 * @param paramIdx  Ordinal index of the parameter in the function call
+		 * @param paramName User-friendly name of the parameter
+		 * @return Value of the parameter
+		 * @throws std::runtime_error When the actual parameter is not of the requested type
+		 */
+		T0 operator()(size_t paramIdx, const std::string &paramName)
+		{
+			bool success = true;
+			T0 value = try_read(paramIdx, paramName, success, true);
+
+			if (!success)
+			{
+				std::stringstream ss;
+				ss << "Failed to read parameter " << paramName << " at index " << paramIdx;
+				throw std::runtime_error(ss.str());
+			}
+
+			return value;
+		}
+
+		/**
+		 * @brief Tests if the given parameter is of the required type.
+		 *
+		 * This function does not advance the current parameter.
+		 *
+		 * @param paramIdx  Ordinal index of the parameter in the function call
+		 * @param paramName User-friendly name of the parameter
+		 * @return true if the parameter is of the requested type, false otherwise
+		 */
+		bool is_type(size_t paramIdx, const std::string &paramName)
+		{
+			bool success = true;
+			try_read(paramIdx, paramName, success, false);
+
+			return success;
+		}
+	};
+
+	/**
+	 * @brief Optional parameter reader template
+	 */
+	template <class T> struct param_reader<boost::optional<T>> : public param_reader_base
+	{
+		/// Type of the returned parameter
+		typedef boost::optional<T> return_type;
+
+		/**
+		 * @brief Initializes a new instance of the param_reader class.
+		 *
+		 * @param w Wrapper to read parameters from.
+		 */
+		param_reader(python &w) : param_reader_base(w) {}
+
+		/**
+		 * @brief Attempts reading a parameter from the associated wrapper.
+		 *
+		 * Missing parameters and None are both read as an empty optional.
+		 *
+		 * @param paramIdx  Ordinal index of the parameter in the function call
+		 * @param paramName User-friendly name of the parameter
+		 * @return Value of the parameter
+		 * @throws std::runtime_error When the actual parameter is not of the requested type
+		 */
+		return_type operator()(size_t paramIdx, const std::string &paramName)
+		{
+			if (paramIdx >= size_t(PyTuple_GET_SIZE(w_.current_args_)) || arg(paramIdx) == Py_None)
+			{
+				return boost::optional<T>();
+			}
+
+			return boost::optional<T>(w_.get_param<T>(paramIdx, paramName));
+		}
+	};
+
+	/**
+	 * @brief Tuple parameter reader template
+	 */
+	template <class... Types>
+	struct param_reader<std::tuple<Types...>, typename std::enable_if<(sizeof...(Types) > 1)>::type>
+	: public param_reader_base
+	{
+		/// Type of the returned parameter
+		typedef std::tuple<Types...> return_type;
+
+		/**
+		 * @brief Initializes a new instance of the param_reader class.
+		 *
+		 * @param w Wrapper to read parameters from.
+		 */
+		param_reader(python &w) : param_reader_base(w) {}
+
+		private:
+		/**
+		 * @brief Implementation of GetTupleParam variadic template function
+		 */
+		template <std::size_t... I>
+		decltype(auto)
+		get_tuple_param_impl(size_t paramIdx, const std::string &paramName, std::index_sequence<I...>)
+		{
+			return return_type{ w_.get_param<Types>(paramIdx + I, paramName)... };
+		}
+
+		public:
+		/**
+		 * @brief Attempts reading a parameter from the associated wrapper.
+		 *
+		 * @param firstParamIdx Ordinal index of the parameter in the function call
+		 * @param paramName     User-friendly name of the parameter
+		 * @return Value of the parameter
+		 * @throws std::runtime_error When the actual parameter is not of the requested type
+		 */
+		return_type operator()(size_t firstParamIdx, const std::string &paramName)
+		{
+			// Check first parameter location
+			check_parameter_idx(firstParamIdx, paramName);
+
+			// Check enough args are available
+			if (firstParamIdx + sizeof...(Types) > size_t(PyTuple_GET_SIZE(w_.current_args_)))
+			{
+				std::stringstream ss;
+				ss << "Not enough args for building a tuple of size " << sizeof...(Types)
+				   << " for parameter " << paramName << " at index " << firstParamIdx;
+				throw std::runtime_error(ss.str());
+			}
+
+			std::tuple<Types...> result(
+			get_tuple_param_impl(firstParamIdx, paramName, std::make_index_sequence<sizeof...(Types)>()));
+
+			return result;
+		}
+	};
+
+	/**
+	 * @brief Variant parameter reader template
+	 */
+	template <class... Types>
+	struct param_reader<boost::variant<Types...>, typename std::enable_if<(sizeof...(Types) > 0)>::type>
+	: public param_reader_base
+	{
+		/// Type of the returned parameter
+		typedef boost::variant<Types...> return_type;
+
+		/// Type of this parameter reader
+		typedef param_reader<boost::variant<Types...>, typename std::enable_if<(sizeof...(Types) > 0)>::type> self_type;
+
+		/**
+		 * @brief Initializes a new instance of the param_reader class.
+		 *
+		 * @param w Wrapper to read parameters from.
+		 */
+		param_reader(python &w) : param_reader_base(w) {}
+
+		private:
+		template <typename T>
+		static return_type variant_reader(self_type &pr, size_t paramIdx, const std::string &paramName)
+		{
+			if (!param_reader<T>(pr.w_).is_type(paramIdx, paramName))
+			{
+				std::stringstream ss;
+				ss << "Failed to get variant for parameter " << paramName << " at index " << paramIdx;
+				throw std::runtime_error(ss.str());
+			}
+
+			return return_type(param_reader<T>(pr.w_)(paramIdx, paramName));
+		}
+
+		template <typename T0, typename... Tn, typename = typename std::enable_if<(sizeof...(Tn) > 0)>::type>
+		static return_type variant_reader(self_type &pr, size_t paramIdx, const std::string &paramName)
+		{
+			if (param_reader<T0>(pr.w_).is_type(paramIdx, paramName))
+			{
+				return return_type(param_reader<T0>(pr.w_)(paramIdx, paramName));
+			}
+
+			return variant_reader<Tn...>(pr, paramIdx, paramName);
+		}
+
+		public:
+		/**
+		 * @brief Attempts reading a parameter from the associated wrapper.
+		 *
+		 * @param paramIdx  Ordinal index of the parameter in the function call
+		 * @param paramName User-friendly name of the parameter
+		 * @return Value of the parameter
+		 * @throws std::runtime_error When the actual parameter is not of the requested type
+		 */
+		return_type operator()(size_t paramIdx, const std::string &paramName)
+		{
+			return variant_reader<Types...>(*this, paramIdx, paramName);
+		}
+	};
+
+	/**
+	 * @brief Helper class to read a list of parameters
+	 */
+	template <class... Types>
+	class param_list_reader : public basic_param_list_reader<param_list_reader<Types...>, Types...>
+	{
+		typedef param_list_reader<Types...> self_type;
+
+		public:
+		/**
+		 * @brief Initializes a new instance of the param_list_reader class
+		 *
+		 * @param w         Wrapper to read parameters from
+		 * @param first_idx First parameter index
+		 * @param name      Name of the tuples to read
+		 */
+		param_list_reader(python &w, size_t first_idx, const std::string &name)
+			: basic_param_list_reader<param_list_reader<Types...>, Types...>(w, first_idx, name)
+		{
+			basic_param_list_reader<param_list_reader<Types...>, Types...>::count_ =
+				(PyTuple_GET_SIZE(w.args()) - first_idx) / sizeof...(Types);
+		}
+
+		static constexpr const size_t sizeof_tuple = sizeof...(Types);
+	};
+
+	/**
+	 * @brief Runs a named function on the arguments of a Python call.
+	 * @param name Name of the function, used to aggregate its profile
+	 * @param args Tuple of arguments to the function
+	 * @param fun  Function to invoke
+	 * @return New reference to the result: None, the single result or a tuple of the
+	 *         results. nullptr with a Python exception set if the function failed.
+	 */
+	PyObject *run_function(const char *name, PyObject *args, std::function<void(python &)> fun);
+
+	/**
+	 * @brief Converts a result to a Python object
+	 *
+	 * @return New reference to the Python object
+	 */
+	static PyObject *to_python(bool value);
+	/// @copydoc to_python(bool)
+	static PyObject *to_python(int value);
+	/// @copydoc to_python(bool)
+	static PyObject *to_python(unsigned int value);
+	/// @copydoc to_python(bool)
+	static PyObject *to_python(float value);
+	/// @copydoc to_python(bool)
+	static PyObject *to_python(const char *value);
+	/// @copydoc to_python(bool)
+	static PyObject *to_python(const std::string &value);
+	/**
+	 * @brief Converts an integer list result, such as extents, to a tuple of int
+	 *
+	 * @return New reference to the Python object
+	 */
+	static PyObject *to_python(const std::vector<int> &value);
+	/**
+	 * @brief Converts a matrix result to an omw.matrix object, which keeps a reference
+	 * to the matrix and exports its elements through the buffer protocol.
+	 *
+	 * @return New reference to the Python object
+	 */
+	static PyObject *to_python(const std::shared_ptr<basic_matrix<float>> &value);
+	/**
+	 * @brief Converts a ragged array result to a list of 1-D omw.matrix objects
+	 *
+	 * @return New reference to the Python object
+	 */
+	static PyObject *to_python(const ragged_array<float> &value);
+	/**
+	 * @brief Converts a matrix batch result to an omw.matrix object whose first dimension
+	 * is the item index, sharing the storage of the batch
+	 *
+	 * @return New reference to the Python object
+	 */
+	static PyObject *to_python(const matrix_batch<float> &value);
+	/**
+	 * @brief Converts a bitmask result to a memoryview of bool elements
+	 *
+	 * @return New reference to the Python object
+	 */
+	static PyObject *to_python(const bitmask &value);
+	/**
+	 * @brief Converts a dictionary result to a dict
+	 *
+	 * @return New reference to the Python object
+	 */
+	static PyObject *to_python(const dictionary &value);
+
+	/**
+	 * @brief Base class for wrapper result writers
+	 */
+	struct result_writer_base
+	{
+		protected:
+		/// Reference to the object that created this result writer
+		python &w_;
+
+		/**
+		 * @brief Initializes a new instance of the result_writer_base class
+		 *
+		 * @param w Wrapper this instance will write results to
+		 */
+		result_writer_base(python &w);
+	};
+
+	/**
+	 * @brief Template declaration for result writers
+	 */
+	template <class T, typename Enable = void, class... Types> struct result_writer;
+
+	/**
+	 * @brief Atomic result writer template
+	 */
+	template <class T0>
+	struct result_writer<T0, typename std::enable_if<is_simple_param_type<T0>::value>::type> : public result_writer_base
+	{
+		/// Type of the result
+		typedef T0 result_type;
+
+		/**
+		 * @brief Initialize a new instance of the result_writer class
+		 *
+		 * @param w Wrapper to write the result to
+		 */
+		result_writer(python &w) : result_writer_base(w) {}
+
+		/**
+		 * @brief Writes the result to the wrapper instance
+		 *
+		 * @param result Result value to write
+		 */
+		void operator()(const result_type &result)
+		{
+			w_.append_result(to_python(result));
+		}
+	};
+
+	/**
+	 * @brief Multiple result writer template
+	 */
+	template <class T0, class... Types>
+	struct result_writer<T0, typename std::enable_if<(sizeof...(Types) > 0)>::type, Types...>
+	: public result_writer_base
+	{
+		/**
+		 * @brief Initializes a new instance of the result_writer class.
+		 *
+		 * @param w Wrapper to read parameters from.
+		 */
+		result_writer(python &w) : result_writer_base(w) {}
+
+		/**
+		 * @brief Writes the results to the wrapper instance
+		 *
+		 * @param result Result value to write
+		 */
+		void operator()(const T0& arg0, const Types&... results)
+		{
+			w_.push_result();
+
+			int _[] = { (w_.write_result<T0>(arg0), 0), (w_.write_result<Types>(results), 0)... };
+			(void)_;
+
+			w_.pop_result();
+		}
+	};
+
+	/**
+	 * @brief Writes the result \p args to the return value of the current call
+	 *
+	 * @param args Results to write
+	 */
+	template <class T0, class... Types>
+	void write_result(const T0& arg0, const Types&... args)
+	{
+		profile_results(arg0, args...);
+		call_profiler::phase_scope scope(profiler(), phase_encode);
+
+		result_writer<typename std::remove_reference<T0>::type, void,
+					  typename std::remove_reference<Types>::type...>(*this)(
+							arg0, args...);
+	}
+
+	/**
+	 * @brief Writes a frame of an animation stream as the result.
+	 *
+	 * Python shares memory with the module, so frames are always written in full.
+	 *
+	 * @param stream_id     Identifier of the stream
+	 * @param frame         Frame to write
+	 * @param host_sequence Unused, see mathematica::write_frame
+	 */
+	void write_frame(const std::string &stream_id, const std::shared_ptr<basic_matrix<float>> &frame,
+					 int host_sequence = -1)
+	{
+		(void)stream_id;
+		(void)host_sequence;
+		write_result(frame);
+	}
+
+	/**
+	 * @brief Raises a RuntimeError in the caller to notify of a failure.
+	 * @param exceptionMessage Text to send in the message
+	 * @param messageName      Name of the message, prefixed to the text
+	 */
+	void send_failure(const std::string &exceptionMessage, const std::string &messageName = std::string("err"));
+
+	/**
+	 * @brief Issues queued warnings and errors as RuntimeWarning, and writes progress
+	 * updates to sys.stderr.
+	 *
+	 * @param messages Messages to send
+	 * @throws std::runtime_error if a warning was turned into an exception by the
+	 *                            warning filters
+	 */
+	void send_messages(const std::vector<queued_message> &messages);
+};
+
+template <>
+bool python::param_reader<bool>::try_read(size_t paramIdx, const std::string &paramName, bool &success, bool getData);
+
+template <>
+int python::param_reader<int>::try_read(size_t paramIdx, const std::string &paramName, bool &success, bool getData);
+
+template <>
+unsigned int python::param_reader<unsigned int>::try_read(size_t paramIdx, const std::string &paramName,
+														 bool &success, bool getData);
+
+template <>
+float python::param_reader<float>::try_read(size_t paramIdx, const std::string &paramName, bool &success, bool getData);
+
+template <>
+std::string python::param_reader<std::string>::try_read(size_t paramIdx, const std::string &paramName,
+													   bool &success, bool getData);
+
+template <>
+std::shared_ptr<basic_array<float>>
+python::param_reader<std::shared_ptr<basic_array<float>>>::try_read(size_t paramIdx, const std::string &paramName,
+																   bool &success, bool getData);
+
+template <>
+std::shared_ptr<basic_matrix<float>>
+python::param_reader<std::shared_ptr<basic_matrix<float>>>::try_read(size_t paramIdx, const std::string &paramName,
+																	bool &success, bool getData);
+
+template <>
+matrix_view<float>
+python::param_reader<matrix_view<float>>::try_read(size_t paramIdx, const std::string &paramName,
+												   bool &success, bool getData);
+
+template <>
+range_view<float>
+python::param_reader<range_view<float>>::try_read(size_t paramIdx, const std::string &paramName,
+												   bool &success, bool getData);
+
+template <>
+ragged_array<float>
+python::param_reader<ragged_array<float>>::try_read(size_t paramIdx, const std::string &paramName,
+												   bool &success, bool getData);
+
+template <>
+matrix_batch<float>
+python::param_reader<matrix_batch<float>>::try_read(size_t paramIdx, const std::string &paramName,
+												   bool &success, bool getData);
+
+template <>
+bitmask
+python::param_reader<bitmask>::try_read(size_t paramIdx, const std::string &paramName,
+										bool &success, bool getData);
+
+template <>
+dictionary
+python::param_reader<dictionary>::try_read(size_t paramIdx, const std::string &paramName,
+										   bool &success, bool getData);
+
+template <>
+std::shared_ptr<tiled_matrix<float>>
+python::param_reader<std::shared_ptr<tiled_matrix<float>>>::try_read(size_t paramIdx, const std::string &paramName,
+																	bool &success, bool getData);
+
+/**
+ * @brief Function exported by a Python extension module. Declare instances at namespace
+ * scope, usually through OM_DEFUN, to register them.
+ */
+class python_function
+{
+	PyMethodDef def_;
+	std::function<PyObject *(PyObject *)> fun_;
+
+	static PyObject *call(PyObject *self, PyObject *args);
+
+	public:
+	/**
+	 * @brief Registers a function
+	 *
+	 * @param name  Name of the function in the module
+	 * @param usage Docstring of the function
+	 * @param fun   Implementation of the function, which takes the tuple of arguments and
+	 *              returns a new reference to the result, usually through
+	 *              python::run_function
+	 */
+	python_function(const char *name, const char *usage, std::function<PyObject *(PyObject *)> fun);
+
+	/**
+	 * @brief Gets the registered functions, by name
+	 */
+	static std::map<std::string, python_function *> &registry();
+
+	/**
+	 * @brief Creates a function object for this function
+	 *
+	 * @param module Module the function belongs to
+	 * @return New reference to the function object
+	 */
+	PyObject *make_function(PyObject *module);
+};
+
+/**
+ * @brief Creates the extension module, with every registered function and the
+ * omw.matrix type. Called by the PyInit function generated by omw_add_python.
+ *
+ * @param name Name of the module
+ * @return New reference to the module, nullptr with a Python exception set on failure
+ */
+PyObject *python_module(const char *name);
+
+// Precompiled in the omw_python library
+OMW_WRAPPER_INSTANTIATIONS(extern, python)
+}
+
+/**
+ * @brief Run code when called from Python.
+ *
+ * @param w    Wrapper object to invoke the method on
+ * @param code Lambda function with void(void) signature to run
+ */
+#define OM_PYTHON(w, code) (code)()
+
+#else /* OMW_PYTHON */
+
+#define OM_PYTHON(w, code)
+
+#endif /* OMW_PYTHON */
+
+#endif /* _OMW_PYTHON_HPP_ */
@@ -0,0 +1,145 @@
+/**
+ * @file   omw/ragged_array.hpp
+ * @brief  Definition of omw::ragged_array
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_RAGGED_ARRAY_HPP_
+#define _OMW_RAGGED_ARRAY_HPP_
+
+#include <cstddef>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "omw/pre.hpp"
+
+namespace omw
+{
+/**
+ * @brief Represents a list of vectors of different lengths, such as polylines or
+ * neighbor lists, stored in a single values buffer.
+ *
+ * Row i holds the values between offsets()[i] and offsets()[i + 1], so the offsets
+ * array always has one more entry than there are rows. Hosts pass ragged arrays as
+ * nested lists (Mathematica), cell arrays of vectors (Octave) or lists of 1-D buffers
+ * (Python), and readers decode them with a single allocation.
+ */
+template <typename T> class ragged_array
+{
+	std::vector<T> m_values;
+	std::vector<std::size_t> m_offsets;
+
+public:
+	/**
+	 * @brief Initializes an empty ragged array.
+	 */
+	ragged_array() : m_values(), m_offsets(1, 0) {}
+
+	/**
+	 * @brief Initializes a ragged array from its buffers.
+	 *
+	 * @param values  Values of all the rows, one after the other
+	 * @param offsets Offset of each row in \p values, followed by the number of values
+	 * @throws std::runtime_error if the offsets do not delimit \p values
+	 */
+	ragged_array(std::vector<T> values, std::vector<std::size_t> offsets)
+	: m_values(std::move(values)), m_offsets(std::move(offsets))
+	{
+		if (m_offsets.empty() || m_offsets.front() != 0 || m_offsets.back() != m_values.size())
+		{
+			std::stringstream ss;
+			ss << "Invalid ragged array offsets for " << m_values.size() << " values";
+			throw std::runtime_error(ss.str());
+		}
+
+		for (std::size_t i = 1; i < m_offsets.size(); ++i)
+		{
+			if (m_offsets[i] < m_offsets[i - 1])
+				throw std::runtime_error("Ragged array offsets must not decrease");
+		}
+	}
+
+	/**
+	 * @brief Number of rows.
+	 */
+	std::size_t size() const { return m_offsets.size() - 1; }
+
+	/**
+	 * @brief Number of values in all the rows.
+	 */
+	std::size_t total_size() const { return m_values.size(); }
+
+	/**
+	 * @brief Number of values in a row.
+	 *
+	 * @param row Index of the row
+	 */
+	std::size_t row_size(std::size_t row) const { return m_offsets[row + 1] - m_offsets[row]; }
+
+	/**
+	 * @brief Pointer to the first value of a row.
+	 *
+	 * @param row Index of the row
+	 */
+	const T *row(std::size_t row) const { return m_values.data() + m_offsets[row]; }
+
+	/// @copydoc row(std::size_t) const
+	T *row(std::size_t row) { return m_values.data() + m_offsets[row]; }
+
+	/**
+	 * @brief Values of all the rows, one after the other.
+	 */
+	const std::vector<T> &values() const { return m_values; }
+
+	/**
+	 * @brief Pointer to the values of all the rows, which can be modified in place.
+	 */
+	T *data() { return m_values.data(); }
+
+	/**
+	 * @brief Offset of each row in values(), followed by the number of values.
+	 */
+	const std::vector<std::size_t> &offsets() const { return m_offsets; }
+
+	/**
+	 * @brief Reserves storage for rows and values appended by push_back.
+	 *
+	 * @param rows   Number of rows
+	 * @param values Number of values
+	 */
+	void reserve(std::size_t rows, std::size_t values)
+	{
+		m_offsets.reserve(rows + 1);
+		m_values.reserve(values);
+	}
+
+	/**
+	 * @brief Appends a row.
+	 *
+	 * @param first Iterator to the first value of the row
+	 * @param last  Iterator past the last value of the row
+	 */
+	template <typename It> void push_back(It first, It last)
+	{
+		m_values.insert(m_values.end(), first, last);
+		m_offsets.push_back(m_values.size());
+	}
+
+	/**
+	 * @brief Appends a row of \p count zeros, for the caller to fill.
+	 *
+	 * @param count Number of values in the row
+	 * @return Pointer to the first value of the new row
+	 */
+	T *append_row(std::size_t count)
+	{
+		m_values.resize(m_values.size() + count);
+		m_offsets.push_back(m_values.size());
+		return m_values.data() + m_values.size() - count;
+	}
+};
+}
+
+#endif /* _OMW_RAGGED_ARRAY_HPP_ */
@@ -0,0 +1,134 @@
+/**
+ * @file   omw/range_view.hpp
+ * @brief  Definition of omw::range_view
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_RANGE_VIEW_HPP_
+#define _OMW_RANGE_VIEW_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "omw/pre.hpp"
+#include "omw/array.hpp"
+
+namespace omw
+{
+/**
+ * @brief Represents a lazy arithmetic sequence, as passed by hosts which store ranges
+ * such as Octave's 1:1e8 by their base, increment and number of elements.
+ *
+ * Elements are computed when they are accessed, so a range parameter costs the same
+ * whatever its length. Readers only accept host ranges: functions which also take
+ * arbitrary arrays should read a boost::variant of a range_view and an array.
+ *
+ * The last element is stored apart, as hosts clamp it to the range limit and
+ * base + (size - 1) * increment may round past it.
+ */
+template <typename T> class range_view
+{
+	double m_base;
+	double m_increment;
+	double m_last;
+	std::size_t m_size;
+
+public:
+	/**
+	 * @brief Initializes an empty range.
+	 */
+	range_view() : m_base(0.0), m_increment(0.0), m_last(0.0), m_size(0) {}
+
+	/**
+	 * @brief Initializes a new range.
+	 *
+	 * @param base      First element
+	 * @param increment Difference between two consecutive elements
+	 * @param size      Number of elements
+	 */
+	range_view(double base, double increment, std::size_t size)
+	: m_base(base), m_increment(increment), m_last(base + (size > 0 ? size - 1 : 0) * increment), m_size(size)
+	{
+	}
+
+	/**
+	 * @brief Initializes a new range with an explicit last element.
+	 *
+	 * @param base       First element
+	 * @param increment  Difference between two consecutive elements
+	 * @param size       Number of elements
+	 * @param last       Last element
+	 */
+	range_view(double base, double increment, std::size_t size, double last)
+	: m_base(base), m_increment(increment), m_last(last), m_size(size)
+	{
+	}
+
+	/**
+	 * @brief First element of the range.
+	 */
+	double base() const { return m_base; }
+
+	/**
+	 * @brief Difference between two consecutive elements.
+	 */
+	double increment() const { return m_increment; }
+
+	/**
+	 * @brief Last element of the range, undefined if it is empty.
+	 */
+	double last() const { return m_last; }
+
+	/**
+	 * @brief Number of elements in the range.
+	 *
+	 * @return Number of elements
+	 */
+	std::size_t size() const { return m_size; }
+
+	/**
+	 * @brief Computes an element by index.
+	 *
+	 * @param idx 0-based index of the element in the range
+	 * @return Value of the element
+	 */
+	T operator[](std::size_t idx) const
+	{
+		if (idx + 1 == m_size)
+			return static_cast<T>(m_last);
+		return static_cast<T>(m_base + idx * m_increment);
+	}
+
+	/**
+	 * @brief Computes a run of elements into a buffer.
+	 *
+	 * @param first Index of the first element
+	 * @param count Number of elements
+	 * @param dst   Destination buffer, of at least \p count elements
+	 */
+	void read(std::size_t first, std::size_t count, T *dst) const
+	{
+		for (std::size_t n = 0; n < count; ++n)
+			dst[n] = static_cast<T>(m_base + (first + n) * m_increment);
+
+		if (count > 0 && first + count == m_size)
+			dst[count - 1] = static_cast<T>(m_last);
+	}
+
+	/**
+	 * @brief Materializes the range into an array.
+	 *
+	 * @return Shared pointer to a new array holding every element of the range
+	 */
+	std::shared_ptr<basic_array<T>> to_array() const
+	{
+		std::vector<T> vec(m_size);
+		read(0, m_size, vec.data());
+		return vector_array<T>::make(std::move(vec));
+	}
+};
+}
+
+#endif /* _OMW_RANGE_VIEW_HPP_ */
@@ -0,0 +1,177 @@
+/**
+ * @file   omw/remote_array.hpp
+ * @brief  Definition of omw::remote_arrays
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_REMOTE_ARRAY_HPP_
+#define _OMW_REMOTE_ARRAY_HPP_
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "omw/pre.hpp"
+
+namespace omw
+{
+/**
+ * @brief Extracts a strided slice of a matrix.
+ *
+ * Each dimension k keeps the indices start[k], start[k] + step[k], ... below stop[k],
+ * 0-based like row-major offsets, whatever the indexing convention of the host.
+ *
+ * @param matrix Matrix to slice
+ * @param start  First index of each dimension
+ * @param stop   Index past the last one of each dimension
+ * @param step   Step of each dimension
+ * @return Shared pointer to the slice, of the same depth
+ * @throws std::runtime_error If the bounds do not match the dimensions of the matrix
+ */
+std::shared_ptr<basic_matrix<float>> slice_matrix(const basic_matrix<float> &matrix, const std::vector<int> &start,
+												  const std::vector<int> &stop, const std::vector<int> &step);
+
+/**
+ * @brief Keeps large results in the native process, so that hosts only fetch the
+ * slices or downsampled views they look at.
+ *
+ * Each array is identified by an integer id handed to the host. Arrays are referenced
+ * by the host until it releases them; released arrays are kept as a cache until the
+ * total size of the arrays exceeds the capacity, and then evicted least recently used
+ * first. Referenced arrays are never evicted, so their total size is bounded by a
+ * separate limit: a host that never releases its arrays gets errors instead of
+ * exhausting the memory of the native process.
+ */
+class remote_arrays
+{
+	/// Stored array
+	struct entry
+	{
+		/// Elements in row-major order
+		std::shared_ptr<basic_matrix<float>> matrix;
+		/// Size of the elements, in bytes
+		std::size_t bytes;
+		/// true until the host releases the array
+		bool referenced;
+		/// Position in lru_ of released arrays
+		std::list<int>::iterator lru;
+	};
+
+	/// Arrays by id
+	std::unordered_map<int, entry> entries_;
+	/// Ids of the released arrays, least recently used first
+	std::list<int> lru_;
+	/// Total size of the arrays, in bytes
+	std::size_t bytes_;
+	/// Size above which released arrays are evicted, in bytes
+	std::size_t capacity_;
+	/// Total size of the referenced arrays, in bytes
+	std::size_t referenced_bytes_;
+	/// Size the referenced arrays may not exceed, in bytes
+	std::size_t reference_limit_;
+	/// Id of the next array
+	int next_id_;
+	/// Number of arrays evicted so far
+	std::size_t evicted_total_;
+
+	/// Evicts released arrays until the arrays fit in the capacity
+	void evict();
+
+	public:
+	/**
+	 * @brief Initializes an empty store.
+	 *
+	 * @param capacity        Size above which released arrays are evicted, in bytes
+	 * @param reference_limit Size the referenced arrays may not exceed, in bytes
+	 */
+	explicit remote_arrays(std::size_t capacity = std::size_t(1) << 30,
+						   std::size_t reference_limit = std::size_t(1) << 32);
+
+	/**
+	 * @brief Stores an array, referenced until #release is called.
+	 *
+	 * Arrays that do not own their elements are copied, see omw::owned_matrix.
+	 *
+	 * @param matrix Array to store
+	 * @return Id of the array
+	 * @throws std::runtime_error If the referenced arrays would exceed the reference
+	 *                            limit
+	 */
+	int put(const std::shared_ptr<basic_matrix<float>> &matrix);
+
+	/**
+	 * @brief Gets an array, marking it as the most recently used.
+	 *
+	 * @param id Id of the array
+	 * @return Array, in row-major order
+	 * @throws std::runtime_error If there is no such array, or it has been evicted
+	 */
+	std::shared_ptr<basic_matrix<float>> get(int id);
+
+	/**
+	 * @brief Releases the host reference to an array, letting it be evicted.
+	 *
+	 * @param id Id of the array
+	 * @return true if the array was referenced
+	 */
+	bool release(int id);
+
+	/**
+	 * @brief Discards an array immediately.
+	 *
+	 * @param id Id of the array
+	 */
+	void erase(int id);
+
+	/**
+	 * @brief Number of stored arrays.
+	 */
+	std::size_t size() const { return entries_.size(); }
+
+	/**
+	 * @brief Total size of the stored arrays, in bytes.
+	 */
+	std::size_t bytes() const { return bytes_; }
+
+	/**
+	 * @brief Total size of the arrays the host has not released yet, in bytes.
+	 */
+	std::size_t referenced_bytes() const { return referenced_bytes_; }
+
+	/**
+	 * @brief Number of arrays evicted so far.
+	 */
+	std::size_t evicted_total() const { return evicted_total_; }
+
+	/**
+	 * @brief Size above which released arrays are evicted, in bytes.
+	 */
+	std::size_t capacity() const { return capacity_; }
+
+	/**
+	 * @brief Sets the size above which released arrays are evicted, evicting them
+	 * right away if needed.
+	 *
+	 * @param new_capacity New capacity, in bytes
+	 */
+	void capacity(std::size_t new_capacity);
+
+	/**
+	 * @brief Size the referenced arrays may not exceed, in bytes.
+	 */
+	std::size_t reference_limit() const { return reference_limit_; }
+
+	/**
+	 * @brief Sets the size the referenced arrays may not exceed. Arrays referenced
+	 * already are kept, the limit applies to the next ones.
+	 *
+	 * @param new_limit New limit, in bytes
+	 */
+	void reference_limit(std::size_t new_limit) { reference_limit_ = new_limit; }
+};
+}
+
+#endif /* _OMW_REMOTE_ARRAY_HPP_ */
@@ -0,0 +1,137 @@
+/**
+ * @file   omw/slow_call_log.hpp
+ * @brief  Definition of omw::slow_call_log
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_SLOW_CALL_LOG_HPP_
+#define _OMW_SLOW_CALL_LOG_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace omw
+{
+/**
+ * @brief Summary of a wrapped call that exceeded the slow call threshold
+ */
+struct slow_call_record
+{
+	/// Name of the called function
+	std::string function;
+	/// Names, types and extents of the parameters that were read
+	std::vector<std::string> arguments;
+	/// Types and extents of the results that were written
+	std::vector<std::string> results;
+	/// Time spent in each phase, in nanoseconds, indexed by omw::call_phase
+	std::vector<std::uint64_t> phase_nanoseconds;
+	/// Total time of the call, in nanoseconds
+	std::uint64_t total_nanoseconds = 0;
+	/// true if the call failed
+	bool failed = false;
+
+	/**
+	 * @brief Formats this record on a single line
+	 *
+	 * @return Text representation of the record
+	 */
+	std::string format() const;
+};
+
+/**
+ * @brief Keeps the most recent slow calls in a bounded ring, and optionally appends
+ * them to a file.
+ *
+ * The log is disabled while its threshold is 0. Only calls that exceed the threshold are
+ * recorded, so it can stay enabled in production to investigate outliers after the fact.
+ */
+class slow_call_log
+{
+	std::uint64_t threshold_;
+	std::size_t capacity_;
+	std::deque<slow_call_record> records_;
+	std::string path_;
+	std::ofstream file_;
+
+	public:
+	/**
+	 * @brief Initializes a new, disabled, slow call log
+	 *
+	 * @param capacity Maximum number of records kept in memory
+	 */
+	slow_call_log(std::size_t capacity = 64);
+
+	/**
+	 * @brief Tests if slow calls are being recorded
+	 */
+	inline bool enabled() const
+	{ return threshold_ > 0; }
+
+	/**
+	 * @brief Gets the threshold above which calls are recorded, in nanoseconds
+	 */
+	inline std::uint64_t threshold() const
+	{ return threshold_; }
+
+	/**
+	 * @brief Sets the threshold above which calls are recorded
+	 *
+	 * @param new_threshold Threshold in nanoseconds, 0 to disable the log
+	 */
+	inline void threshold(std::uint64_t new_threshold)
+	{ threshold_ = new_threshold; }
+
+	/**
+	 * @brief Gets the maximum number of records kept in memory
+	 */
+	inline std::size_t capacity() const
+	{ return capacity_; }
+
+	/**
+	 * @brief Sets the maximum number of records kept in memory, dropping the oldest
+	 * records if needed
+	 *
+	 * @param new_capacity Maximum number of records
+	 */
+	void capacity(std::size_t new_capacity);
+
+	/**
+	 * @brief Gets the path of the file records are appended to
+	 */
+	inline const std::string &file() const
+	{ return path_; }
+
+	/**
+	 * @brief Sets the path of the file records are appended to
+	 *
+	 * @param path Path of the file, or an empty string to only keep records in memory
+	 * @throws std::runtime_error if the file cannot be opened
+	 */
+	void file(const std::string &path);
+
+	/**
+	 * @brief Gets the recorded slow calls, oldest first
+	 */
+	inline const std::deque<slow_call_record> &records() const
+	{ return records_; }
+
+	/**
+	 * @brief Records a slow call
+	 *
+	 * @param record Summary of the call
+	 */
+	void add(slow_call_record record);
+
+	/**
+	 * @brief Clears the in-memory records
+	 */
+	void clear();
+};
+}
+
+#endif /* _OMW_SLOW_CALL_LOG_HPP_ */
@@ -0,0 +1,283 @@
+/**
+ * @file   omw/snapshot.hpp
+ * @brief  Definition of omw::resident_state
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_SNAPSHOT_HPP_
+#define _OMW_SNAPSHOT_HPP_
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "omw/pre.hpp"
+#include "omw/matrix.hpp"
+
+namespace omw
+{
+/**
+ * @brief Maps a file in memory, read-only. Where mmap is not available, the file is
+ * read in a buffer instead.
+ *
+ * @param path Path of the file
+ * @param size Size of the mapping
+ * @return Owner of the mapping, nullptr if the file does not exist
+ * @throws std::runtime_error if the file exists but cannot be mapped
+ */
+std::shared_ptr<const void> map_file(const std::string &path, std::size_t &size);
+
+/**
+ * @brief Represents a ND array stored in memory owned by another object, such as a
+ * mapped snapshot file.
+ */
+template <typename T> class mapped_matrix : public basic_matrix<T>
+{
+	std::shared_ptr<const void> m_owner;
+	const T *m_data;
+	std::vector<int> m_dims;
+
+	public:
+	/**
+	 * @brief Pointer to the matrix data.
+	 *
+	 * @return Pointer to the underlying memory block
+	 */
+	const T *data() const override { return m_data; }
+
+	/**
+	 * @brief Accesses an element by index. The matrix is in
+	 * row-major order.
+	 *
+	 * @param idx 0-based index of the element in the array
+	 * @return Reference to the element at the given index
+	 */
+	const T &operator[](std::size_t idx) const override { return m_data[idx]; }
+
+	/**
+	 * @brief Pointer to the dimensions array. Each element
+	 * is the size of the corresponding dimension in the matrix.
+	 *
+	 * @return Pointer to the dimensions array
+	 */
+	const int *dims() const override { return m_dims.data(); }
+
+	/**
+	 * @brief Depth of the matrix. This is the size of the #dims array.
+	 *
+	 * @return Depth of the matrix
+	 */
+	int depth() const override { return m_dims.size(); }
+
+	/**
+	 * @brief Pointer to the head data. This is only defined when
+	 * using the omw::mathematica wrapper.
+	 *
+	 * @return Pointer to the head data
+	 */
+	char **heads() const override { return nullptr; }
+
+	/**
+	 * @brief Initializes a new instance of the omw::mapped_matrix class
+	 *
+	 * @param owner Object that keeps \p data alive
+	 * @param data  Elements of the matrix, in row-major order
+	 * @param dims  See #dims
+	 */
+	mapped_matrix(std::shared_ptr<const void> owner, const T *data, std::vector<int> &&dims)
+	: m_owner(std::move(owner)), m_data(data), m_dims(std::move(dims))
+	{
+	}
+
+	/**
+	 * @brief Create a new mapped_matrix&lt;T&gt; from arguments to
+	 * its constructor.
+	 *
+	 * @see #mapped_matrix
+	 */
+	template<typename... Args>
+	static std::shared_ptr<basic_matrix<T>> make(Args&&... args)
+	{
+		return std::make_shared<mapped_matrix<T>>(std::forward<Args>(args)...);
+	}
+};
+
+/**
+ * @brief Read-only reference to a table of trivially copyable elements
+ *
+ * @tparam T Type of the elements
+ */
+template <typename T> struct table_ref
+{
+	/// Object that keeps the elements alive
+	std::shared_ptr<const void> owner;
+	/// First element
+	const T *data = nullptr;
+	/// Number of elements
+	std::size_t count = 0;
+
+	/// Number of elements
+	std::size_t size() const { return count; }
+	/// Tests if the table is empty
+	bool empty() const { return count == 0; }
+	/// Iterator to the first element
+	const T *begin() const { return data; }
+	/// Iterator past the last element
+	const T *end() const { return data + count; }
+	/// Accesses an element by index
+	const T &operator[](std::size_t idx) const { return data[idx]; }
+};
+
+/**
+ * @brief Native state that survives restarts of the host through snapshot files.
+ *
+ * Modules register the state that is expensive to rebuild (cached matrices, lookup
+ * tables) under a name. #save writes every entry into a single file, with the elements
+ * laid out as they are in memory. #load maps that file and registers entries that point
+ * directly into the mapping: nothing is parsed or copied, so loading takes the time of
+ * an mmap call and pages are only read from disk when they are accessed.
+ *
+ * Snapshots are only meant to be loaded on the machine architecture that wrote them,
+ * by the same version of the file format; other snapshots are rejected by #load.
+ */
+class resident_state
+{
+	public:
+	/// Kinds of entries
+	enum entry_kind
+	{
+		/// omw::basic_matrix&lt;float&gt;
+		kind_matrix = 1,
+		/// Table of trivially copyable elements
+		kind_table = 2
+	};
+
+	private:
+	struct entry
+	{
+		entry_kind kind;
+		std::shared_ptr<basic_matrix<float>> matrix;
+		std::shared_ptr<const void> owner;
+		const void *data;
+		std::size_t bytes;
+		std::size_t element_size;
+	};
+
+	std::map<std::string, entry> entries_;
+
+	void put_owned(const std::string &name, std::shared_ptr<basic_matrix<float>> matrix);
+
+	void put_table(const std::string &name, std::shared_ptr<const void> owner, const void *data, std::size_t bytes,
+				   std::size_t element_size);
+
+	public:
+	/**
+	 * @brief Registers a matrix, replacing any entry with the same name
+	 *
+	 * Matrices that do not own their elements, such as views of host arrays, are
+	 * copied so that the entry outlives the call, see omw::owned_matrix.
+	 *
+	 * @param name   Name of the entry
+	 * @param matrix Matrix to register
+	 */
+	void put(const std::string &name, std::shared_ptr<basic_matrix<float>> matrix);
+
+	/**
+	 * @brief Registers a table, replacing any entry with the same name
+	 *
+	 * @param name  Name of the entry
+	 * @param table Elements of the table, moved into the state
+	 */
+	template <typename T> void put_table(const std::string &name, std::vector<T> table)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Table elements must be trivially copyable");
+
+		auto owner(std::make_shared<std::vector<T>>(std::move(table)));
+		put_table(name, owner, owner->data(), owner->size() * sizeof(T), sizeof(T));
+	}
+
+	/**
+	 * @brief Gets a registered matrix
+	 *
+	 * @param name Name of the entry
+	 * @return Registered matrix, or nullptr if there is no matrix with this name
+	 */
+	std::shared_ptr<basic_matrix<float>> matrix(const std::string &name) const;
+
+	/**
+	 * @brief Gets a registered table
+	 *
+	 * @param name Name of the entry
+	 * @return Reference to the table, empty if there is no table with this name
+	 * @throws std::runtime_error if the table has elements of another size
+	 */
+	template <typename T> table_ref<T> table(const std::string &name) const
+	{
+		table_ref<T> result;
+		auto it = entries_.find(name);
+		if (it == entries_.end() || it->second.kind != kind_table)
+			return result;
+
+		if (it->second.element_size != sizeof(T))
+			throw std::runtime_error("Table " + name + " has elements of another size");
+
+		result.owner = it->second.owner;
+		result.data = static_cast<const T *>(it->second.data);
+		result.count = it->second.bytes / sizeof(T);
+		return result;
+	}
+
+	/**
+	 * @brief Tests if an entry is registered
+	 *
+	 * @param name Name of the entry
+	 */
+	bool contains(const std::string &name) const
+	{ return entries_.count(name) > 0; }
+
+	/**
+	 * @brief Removes an entry
+	 *
+	 * @param name Name of the entry
+	 */
+	void erase(const std::string &name)
+	{ entries_.erase(name); }
+
+	/**
+	 * @brief Removes every entry
+	 */
+	void clear()
+	{ entries_.clear(); }
+
+	/**
+	 * @brief Gets the names of the registered entries
+	 */
+	std::vector<std::string> names() const;
+
+	/**
+	 * @brief Writes every entry to a snapshot file. The file is replaced atomically.
+	 *
+	 * @param path Path of the snapshot file
+	 * @throws std::runtime_error if the file cannot be written
+	 */
+	void save(const std::string &path) const;
+
+	/**
+	 * @brief Maps a snapshot file and registers its entries, replacing entries with the
+	 * same names.
+	 *
+	 * @param path Path of the snapshot file
+	 * @return Number of loaded entries, 0 if the file does not exist
+	 * @throws std::runtime_error if the file is not a valid snapshot, or was written by
+	 * another version of the format. No entry is registered in this case.
+	 */
+	std::size_t load(const std::string &path);
+};
+}
+
+#endif /* _OMW_SNAPSHOT_HPP_ */
@@ -0,0 +1,404 @@
+/**
+ * @file   omw/tiled_matrix.hpp
+ * @brief  Definition of omw::tiled_matrix
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_TILED_MATRIX_HPP_
+#define _OMW_TILED_MATRIX_HPP_
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "omw/pre.hpp"
+#include "omw/matrix.hpp"
+
+namespace omw
+{
+/**
+ * @brief Represents a 2D (optionally multi-channel) matrix stored as a grid of
+ * fixed-size tiles.
+ *
+ * Each tile is a contiguous tile_rows x tile_cols x channels block in row-major
+ * order, so 2D neighborhoods touch a few cache lines instead of one per image row.
+ * Tiles on the right and bottom borders are padded to the full tile size.
+ *
+ * The elements are not stored in row-major order, so #data throws; use #copy_to to
+ * obtain a row-major copy, or #storage to access the tiles directly.
+ */
+template <typename T> class tiled_matrix : public basic_matrix<T>
+{
+	std::vector<T> m_tiles;
+	std::vector<int> m_dims;
+	int m_channels;
+	int m_tile_rows;
+	int m_tile_cols;
+	int m_tiles_x;
+	int m_tiles_y;
+
+	std::size_t tile_offset(int ti, int tj) const
+	{
+		return (std::size_t(ti) * m_tiles_x + tj) * m_tile_rows * m_tile_cols * m_channels;
+	}
+
+	std::size_t offset(int i, int j, int k) const
+	{
+		int ti = i / m_tile_rows, tj = j / m_tile_cols;
+		return tile_offset(ti, tj) + ((i - ti * m_tile_rows) * m_tile_cols + (j - tj * m_tile_cols)) * m_channels + k;
+	}
+
+	public:
+	/**
+	 * @brief Describes a tile of the matrix
+	 */
+	template <typename TElem> struct basic_tile
+	{
+		/// Row of the first element of the tile in the matrix
+		int row;
+		/// Column of the first element of the tile in the matrix
+		int col;
+		/// Number of valid rows in the tile
+		int rows;
+		/// Number of valid columns in the tile
+		int cols;
+		/// Number of elements between the starts of two rows of the tile
+		int stride;
+		/// Pointer to the first element of the tile
+		TElem *data;
+	};
+
+	/// Mutable tile
+	typedef basic_tile<T> tile;
+	/// Read-only tile
+	typedef basic_tile<const T> const_tile;
+
+	/**
+	 * @brief Tiled matrices have no row-major memory block.
+	 *
+	 * @throws std::runtime_error Always, use #copy_to or #storage instead
+	 */
+	const T *data() const override
+	{
+		throw std::runtime_error("Tiled matrices are not stored in row-major order, use copy_to instead of data");
+	}
+
+	/**
+	 * @brief Pointer to the tiled storage, tile after tile in the order of #tiles.
+	 *
+	 * @return Pointer to the underlying memory block
+	 */
+	const T *storage() const { return m_tiles.data(); }
+
+	/**
+	 * @brief Accesses an element by its row-major index.
+	 *
+	 * @param idx 0-based index of the element in row-major order
+	 * @return Reference to the element at the given index
+	 */
+	const T &operator[](std::size_t idx) const override
+	{
+		std::size_t k = idx % m_channels;
+		std::size_t p = idx / m_channels;
+		return m_tiles[offset(static_cast<int>(p / m_dims[1]), static_cast<int>(p % m_dims[1]), static_cast<int>(k))];
+	}
+
+	/**
+	 * @brief Pointer to the dimensions array. Each element
+	 * is the size of the corresponding dimension in the matrix.
+	 *
+	 * @return Pointer to the dimensions array
+	 */
+	const int *dims() const override { return m_dims.data(); }
+
+	/**
+	 * @brief Depth of the matrix. This is the size of the #dims array.
+	 *
+	 * @return Depth of the matrix
+	 */
+	int depth() const override { return m_dims.size(); }
+
+	/**
+	 * @brief Pointer to the head data. This is only defined when
+	 * using the omw::mathematica wrapper.
+	 *
+	 * @return Pointer to the head data
+	 */
+	char **heads() const override { return nullptr; }
+
+	/**
+	 * @brief Tiled matrices are not stored in row-major order.
+	 *
+	 * @return false
+	 */
+	bool row_major() const override { return false; }
+
+	/**
+	 * @brief Copies the matrix to a row-major buffer, in a single pass over the tiles.
+	 *
+	 * @param dst Destination buffer, of at least rows * cols * channels elements
+	 */
+	void copy_to(T *dst) const override
+	{
+		const std::size_t dst_stride = std::size_t(m_dims[1]) * m_channels;
+
+		for (const auto &t : tiles())
+			for (int r = 0; r < t.rows; ++r)
+				std::copy_n(t.data + r * t.stride, t.cols * m_channels,
+							dst + (t.row + r) * dst_stride + t.col * m_channels);
+	}
+
+	/**
+	 * @brief Initializes a new zero-filled tiled matrix.
+	 *
+	 * @param dims      Dimensions of the matrix (rows, columns and optionally channels)
+	 * @param tile_rows Number of rows of each tile
+	 * @param tile_cols Number of columns of each tile
+	 */
+	tiled_matrix(std::vector<int> &&dims, int tile_rows = 64, int tile_cols = 64)
+	: m_dims(std::move(dims)), m_tile_rows(tile_rows), m_tile_cols(tile_cols)
+	{
+		if (m_dims.size() < 2 || m_dims.size() > 3)
+			throw std::runtime_error("Tiled matrices must have 2 or 3 dimensions");
+
+		if (m_tile_rows <= 0 || m_tile_cols <= 0)
+			throw std::runtime_error("Tile size must be positive");
+
+		m_channels = m_dims.size() == 3 ? m_dims[2] : 1;
+		m_tiles_y = (m_dims[0] + m_tile_rows - 1) / m_tile_rows;
+		m_tiles_x = (m_dims[1] + m_tile_cols - 1) / m_tile_cols;
+		m_tiles.resize(std::size_t(m_tiles_x) * m_tiles_y * m_tile_rows * m_tile_cols * m_channels);
+	}
+
+	/**
+	 * @brief Number of rows of the matrix
+	 */
+	int rows() const { return m_dims[0]; }
+
+	/**
+	 * @brief Number of columns of the matrix
+	 */
+	int cols() const { return m_dims[1]; }
+
+	/**
+	 * @brief Number of channels of the matrix
+	 */
+	int channels() const { return m_channels; }
+
+	/**
+	 * @brief Number of rows of each tile
+	 */
+	int tile_rows() const { return m_tile_rows; }
+
+	/**
+	 * @brief Number of columns of each tile
+	 */
+	int tile_cols() const { return m_tile_cols; }
+
+	/**
+	 * @brief Accesses an element by its coordinates.
+	 *
+	 * @param i Row index
+	 * @param j Column index
+	 * @param k Channel index
+	 * @return Reference to the element
+	 */
+	const T &at(int i, int j, int k = 0) const { return m_tiles[offset(i, j, k)]; }
+
+	/**
+	 * @brief Accesses an element by its coordinates.
+	 *
+	 * @param i Row index
+	 * @param j Column index
+	 * @param k Channel index
+	 * @return Reference to the element
+	 */
+	T &at(int i, int j, int k = 0) { return m_tiles[offset(i, j, k)]; }
+
+	/**
+	 * @brief Accesses an element by its coordinates, clamping them to the matrix borders.
+	 *
+	 * @param i Row index
+	 * @param j Column index
+	 * @param k Channel index
+	 * @return Reference to the nearest element
+	 */
+	const T &at_clamped(int i, int j, int k = 0) const
+	{
+		return at(std::min(std::max(i, 0), m_dims[0] - 1), std::min(std::max(j, 0), m_dims[1] - 1), k);
+	}
+
+	/**
+	 * @brief Copies the (2 * radius + 1)^2 neighborhood of an element, clamping at the
+	 * matrix borders.
+	 *
+	 * @param i      Row index of the center
+	 * @param j      Column index of the center
+	 * @param radius Radius of the neighborhood
+	 * @param dst    Destination buffer, of at least (2 * radius + 1)^2 * channels elements,
+	 *               filled in row-major order
+	 */
+	void neighborhood(int i, int j, int radius, T *dst) const
+	{
+		const int tr = i % m_tile_rows, tc = j % m_tile_cols;
+
+		if (i >= radius && j >= radius && i + radius < m_dims[0] && j + radius < m_dims[1] &&
+			tr >= radius && tr + radius < m_tile_rows && tc >= radius && tc + radius < m_tile_cols)
+		{
+			// Fast path: the neighborhood is contained in a single tile
+			const T *src = &at(i - radius, j - radius);
+			const int n = (2 * radius + 1) * m_channels;
+			for (int r = 0; r <= 2 * radius; ++r, dst += n)
+				std::copy_n(src + r * m_tile_cols * m_channels, n, dst);
+			return;
+		}
+
+		for (int r = i - radius; r <= i + radius; ++r)
+			for (int c = j - radius; c <= j + radius; ++c)
+				for (int k = 0; k < m_channels; ++k)
+					*dst++ = at_clamped(r, c, k);
+	}
+
+	/**
+	 * @brief Gets the tile at the given tile coordinates.
+	 *
+	 * @param ti Tile row
+	 * @param tj Tile column
+	 * @return Tile descriptor
+	 */
+	tile get_tile(int ti, int tj)
+	{
+		return tile{ ti * m_tile_rows, tj * m_tile_cols,
+					 std::min(m_tile_rows, m_dims[0] - ti * m_tile_rows),
+					 std::min(m_tile_cols, m_dims[1] - tj * m_tile_cols),
+					 m_tile_cols * m_channels, m_tiles.data() + tile_offset(ti, tj) };
+	}
+
+	/**
+	 * @brief Gets the tile at the given tile coordinates.
+	 *
+	 * @param ti Tile row
+	 * @param tj Tile column
+	 * @return Tile descriptor
+	 */
+	const_tile get_tile(int ti, int tj) const
+	{
+		tile t(const_cast<tiled_matrix<T> *>(this)->get_tile(ti, tj));
+		return const_tile{ t.row, t.col, t.rows, t.cols, t.stride, t.data };
+	}
+
+	/**
+	 * @brief Iterator over the tiles of a matrix, in storage order
+	 */
+	template <typename TMatrix, typename TTile> class basic_tile_iterator
+	{
+		TMatrix *m_matrix;
+		int m_idx;
+
+		public:
+		/**
+		 * @brief Initializes a new tile iterator
+		 *
+		 * @param matrix Matrix to iterate
+		 * @param idx    Index of the current tile in storage order
+		 */
+		basic_tile_iterator(TMatrix *matrix, int idx) : m_matrix(matrix), m_idx(idx) {}
+
+		/**
+		 * @brief Obtains the current tile
+		 */
+		TTile operator*() const { return m_matrix->get_tile(m_idx / m_matrix->m_tiles_x, m_idx % m_matrix->m_tiles_x); }
+
+		/**
+		 * @brief Moves this iterator to the next tile
+		 */
+		basic_tile_iterator &operator++()
+		{
+			m_idx++;
+			return *this;
+		}
+
+		/**
+		 * @brief Tests if this iterator and \p other are different
+		 */
+		bool operator!=(const basic_tile_iterator &other) const { return m_idx != other.m_idx; }
+	};
+
+	/**
+	 * @brief Range over the tiles of a matrix
+	 */
+	template <typename TMatrix, typename TTile> class basic_tile_range
+	{
+		TMatrix *m_matrix;
+
+		public:
+		/**
+		 * @brief Initializes a new tile range
+		 *
+		 * @param matrix Matrix to iterate
+		 */
+		basic_tile_range(TMatrix *matrix) : m_matrix(matrix) {}
+
+		/**
+		 * @brief Gets an iterator to the first tile
+		 */
+		basic_tile_iterator<TMatrix, TTile> begin() const { return { m_matrix, 0 }; }
+
+		/**
+		 * @brief Gets an iterator past the last tile
+		 */
+		basic_tile_iterator<TMatrix, TTile> end() const
+		{
+			return { m_matrix, m_matrix->m_tiles_x * m_matrix->m_tiles_y };
+		}
+	};
+
+	/**
+	 * @brief Gets a range over all the tiles of this matrix, in storage order.
+	 *
+	 * @return Range to be used in a range-based for loop
+	 */
+	basic_tile_range<tiled_matrix<T>, tile> tiles() { return { this }; }
+
+	/**
+	 * @brief Gets a range over all the tiles of this matrix, in storage order.
+	 *
+	 * @return Range to be used in a range-based for loop
+	 */
+	basic_tile_range<const tiled_matrix<T>, const_tile> tiles() const { return { this }; }
+
+	/**
+	 * @brief Fills this matrix from a row-major buffer, in a single pass.
+	 *
+	 * @param src Source buffer, of at least rows * cols * channels elements
+	 */
+	template <typename TSrc> void copy_from(const TSrc *src)
+	{
+		const std::size_t src_stride = std::size_t(m_dims[1]) * m_channels;
+
+		for (auto t : tiles())
+			for (int r = 0; r < t.rows; ++r)
+			{
+				const TSrc *s = src + (t.row + r) * src_stride + t.col * m_channels;
+				T *d = t.data + r * t.stride;
+				for (int n = 0; n < t.cols * m_channels; ++n)
+					d[n] = static_cast<T>(s[n]);
+			}
+	}
+
+	/**
+	 * @brief Create a new tiled_matrix&lt;T&gt; from arguments to
+	 * its constructor.
+	 *
+	 * @see #tiled_matrix
+	 */
+	template <typename... Args> static std::shared_ptr<tiled_matrix<T>> make(Args &&... args)
+	{
+		return std::make_shared<tiled_matrix<T>>(std::forward<Args>(args)...);
+	}
+};
+}
+
+#endif /* _OMW_TILED_MATRIX_HPP_ */
@@ -0,0 +1,91 @@
+/**
+ * @file   omw/transpose.hpp
+ * @brief  Definition of omw::blocked_copy
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_TRANSPOSE_HPP_
+#define _OMW_TRANSPOSE_HPP_
+
+#include <algorithm>
+#include <cstddef>
+
+namespace omw
+{
+namespace detail
+{
+/// Calls a converter with the source offset of the element, if it takes one
+template <typename Convert, typename T>
+auto convert_element(Convert &&convert, T value, std::ptrdiff_t offset, int) -> decltype(convert(value, offset))
+{
+	return convert(value, offset);
+}
+
+/// Calls a converter taking only the element
+template <typename Convert, typename T>
+auto convert_element(Convert &&convert, T value, std::ptrdiff_t, long) -> decltype(convert(value))
+{
+	return convert(value);
+}
+}
+
+/**
+ * @brief Copies a strided 2D plane block by block, converting every element.
+ *
+ * Converting between column-major (Octave) and row-major (omw) layouts reads or writes
+ * one of the arrays with a large stride. Processing square blocks keeps the cache lines
+ * of both arrays resident while a block is copied. The best block size depends on the
+ * cache hierarchy of the host, see omw::autotune.
+ *
+ * @param src     Source of the plane
+ * @param src_row Distance between two rows of the source, in elements
+ * @param src_col Distance between two columns of the source, in elements
+ * @param dst     Destination of the plane
+ * @param dst_row Distance between two rows of the destination, in elements
+ * @param dst_col Distance between two columns of the destination, in elements
+ * @param rows    Number of rows
+ * @param cols    Number of columns
+ * @param block   Size of the blocks, 0 to copy the plane without blocking
+ * @param convert Function applied to every converted element. If it takes a second
+ *                argument, it also receives the offset of the element in the source,
+ *                so that errors can refer to elements in the caller's order.
+ */
+template <typename TDst, typename TSrc, typename Convert>
+void blocked_copy(const TSrc *src, std::ptrdiff_t src_row, std::ptrdiff_t src_col, TDst *dst,
+				  std::ptrdiff_t dst_row, std::ptrdiff_t dst_col, int rows, int cols, int block, Convert &&convert)
+{
+	if (block <= 0)
+		block = std::max(rows, cols);
+
+	for (int i0 = 0; i0 < rows; i0 += block)
+	{
+		const int i1 = std::min(rows, i0 + block);
+
+		for (int j0 = 0; j0 < cols; j0 += block)
+		{
+			const int j1 = std::min(cols, j0 + block);
+
+			for (int i = i0; i < i1; ++i)
+				for (int j = j0; j < j1; ++j)
+				{
+					const std::ptrdiff_t offset = i * src_row + j * src_col;
+					dst[i * dst_row + j * dst_col] = detail::convert_element(convert, static_cast<TDst>(src[offset]), offset, 0);
+				}
+		}
+	}
+}
+
+/**
+ * @brief Copies a strided 2D plane block by block, converting every element with
+ * static_cast only.
+ */
+template <typename TDst, typename TSrc>
+void blocked_copy(const TSrc *src, std::ptrdiff_t src_row, std::ptrdiff_t src_col, TDst *dst,
+				  std::ptrdiff_t dst_row, std::ptrdiff_t dst_col, int rows, int cols, int block)
+{
+	blocked_copy(src, src_row, src_col, dst, dst_row, dst_col, rows, cols, block, [](TDst v) { return v; });
+}
+}
+
+#endif /* _OMW_TRANSPOSE_HPP_ */
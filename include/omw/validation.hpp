@@ -0,0 +1,181 @@
+/**
+ * @file   omw/validation.hpp
+ * @brief  Definition of omw::validation_options and omw::array_stats
+ * @author Alixinne <alixinne@pm.me>
+ * @date   2018
+ */
+
+#ifndef _OMW_VALIDATION_HPP_
+#define _OMW_VALIDATION_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace omw
+{
+/**
+ * @brief Options controlling the validation of array parameters.
+ *
+ * Validation is performed while the parameter is converted from the host
+ * representation, so it does not require another pass over the data.
+ */
+struct validation_options
+{
+	/**
+	 * @brief Action to take on values outside of [#min_value, #max_value]
+	 */
+	enum range_policy
+	{
+		/// Do not check the range of values
+		ignore_range,
+		/// Fail reading the parameter
+		reject_range,
+		/// Clamp values to the range
+		clamp_range
+	};
+
+	/// true if NaN and infinite values should make reading the parameter fail
+	bool reject_non_finite = false;
+	/// Range checking policy
+	range_policy range = ignore_range;
+	/// Lower bound of the range
+	double min_value = -std::numeric_limits<double>::infinity();
+	/// Upper bound of the range
+	double max_value = std::numeric_limits<double>::infinity();
+	/// true if minimum, maximum and sum should be computed
+	bool compute_stats = false;
+
+	/**
+	 * @brief Tests if these options require any work from parameter readers
+	 *
+	 * @return true if validation is enabled, false otherwise
+	 */
+	bool enabled() const { return reject_non_finite || range != ignore_range || compute_stats; }
+};
+
+/**
+ * @brief Statistics gathered while reading an array parameter
+ */
+struct array_stats
+{
+	/// true if the statistics have been computed
+	bool valid = false;
+	/// Number of finite elements
+	std::size_t count = 0;
+	/// Number of NaN or infinite elements
+	std::size_t non_finite = 0;
+	/// Number of elements that have been clamped
+	std::size_t clamped = 0;
+	/// Smallest finite element
+	double min = std::numeric_limits<double>::infinity();
+	/// Largest finite element
+	double max = -std::numeric_limits<double>::infinity();
+	/// Sum of finite elements
+	double sum = 0.0;
+};
+
+/**
+ * @brief Applies omw::validation_options to elements as they are converted.
+ *
+ * Parameter readers call this functor on every element in their conversion loop.
+ *
+ * @tparam T Element type
+ */
+template <typename T> class validator
+{
+	const validation_options &options_;
+	const std::string &param_name_;
+	std::size_t idx_;
+	array_stats stats_;
+
+	[[noreturn]] void fail(const char *reason) const
+	{
+		std::stringstream ss;
+		ss << reason << " at element " << idx_ << " of parameter " << param_name_;
+		throw std::runtime_error(ss.str());
+	}
+
+	public:
+	/**
+	 * @brief Initializes a new instance of the validator class
+	 *
+	 * @param options   Validation options
+	 * @param paramName User-friendly name of the parameter being read
+	 */
+	validator(const validation_options &options, const std::string &paramName)
+		: options_(options), param_name_(paramName), idx_(0)
+	{
+		stats_.valid = options.compute_stats;
+	}
+
+	/**
+	 * @brief Validates a single element
+	 *
+	 * @param value Element value
+	 * @return Element value, possibly clamped
+	 * @throws std::runtime_error If the element is rejected
+	 */
+	T operator()(T value)
+	{
+		if (!std::isfinite(value))
+		{
+			if (options_.reject_non_finite)
+				fail("Non-finite value");
+
+			stats_.non_finite++;
+			idx_++;
+			return value;
+		}
+
+		if (options_.range != validation_options::ignore_range &&
+			(value < options_.min_value || value > options_.max_value))
+		{
+			if (options_.range == validation_options::reject_range)
+				fail("Out of range value");
+
+			value = static_cast<T>(value < options_.min_value ? options_.min_value : options_.max_value);
+			stats_.clamped++;
+		}
+
+		if (options_.compute_stats)
+		{
+			if (value < stats_.min)
+				stats_.min = value;
+			if (value > stats_.max)
+				stats_.max = value;
+			stats_.sum += value;
+		}
+
+		stats_.count++;
+		idx_++;
+		return value;
+	}
+
+	/**
+	 * @brief Validates an element that is not converted in the caller's order
+	 *
+	 * @param value Element value
+	 * @param idx   Index of the element in the caller's order, reported on errors
+	 * @return Element value, possibly clamped
+	 * @throws std::runtime_error If the element is rejected
+	 */
+	T operator()(T value, std::size_t idx)
+	{
+		idx_ = idx;
+		return (*this)(value);
+	}
+
+	/**
+	 * @brief Statistics gathered so far
+	 *
+	 * @return Statistics of the validated elements
+	 */
+	const array_stats &stats() const { return stats_; }
+};
+}
+
+#endif /* _OMW_VALIDATION_HPP_ */
@@ -8,7 +8,26 @@
 #ifndef _OMW_WRAPPER_BASE_HPP_
 #define _OMW_WRAPPER_BASE_HPP_
 
+#include <chrono>
 #include <functional>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "omw/autotune.hpp"
+#include "omw/call_profiler.hpp"
+#include "omw/describe.hpp"
+#include "omw/dictionary.hpp"
+#include "omw/message_queue.hpp"
+#include "omw/metrics.hpp"
+#include "omw/mip_pyramid.hpp"
+#include "omw/pipeline.hpp"
+#include "omw/plugin.hpp"
+#include "omw/remote_array.hpp"
+#include "omw/snapshot.hpp"
+#include "omw/validation.hpp"
 
 namespace omw
 {
@@ -23,6 +42,32 @@ class wrapper_base
 	std::function<void(void)> user_initializer_;
 	/// A flag indicating if matrices written by write_result should be images or not
 	bool matrices_as_images_;
+	/// Validation options for the parameter currently being read
+	validation_options param_validation_;
+	/// Size of the tiles of omw::tiled_matrix parameters
+	int tile_size_;
+	/// Block size of layout conversions, see omw::blocked_copy
+	int transpose_block_;
+	/// Pending levels of progressive results
+	progressive_results progressive_;
+	/// Results kept in the native process for the host to fetch by slices
+	remote_arrays remote_;
+	/// Per-function call profiles
+	call_profiler profiler_;
+	/// Messages waiting to be delivered to the host
+	message_queue messages_;
+	/// Stages available to native pipelines
+	pipeline_registry pipelines_;
+	/// Parsed pipelines, by description
+	pipeline_cache pipeline_cache_;
+	/// Plugins providing pipeline stages
+	plugin_loader plugins_;
+	/// Native state kept across restarts
+	resident_state state_;
+	/// Snapshot file of state_, written when the wrapper is destroyed
+	std::string snapshot_path_;
+	/// Background publication of metrics, declared last so it stops first
+	metrics_exporter metrics_;
 
 	public:
 	/**
@@ -32,10 +77,32 @@ class wrapper_base
 	 */
 	wrapper_base(std::function<void(void)> &&userInitializer)
 		: user_initializer_(std::forward<std::function<void(void)>>(userInitializer)),
-		matrices_as_images_(false)
+		matrices_as_images_(false),
+		tile_size_(64),
+		transpose_block_(32)
 	{
 	}
 
+	/**
+	 * @brief Stops publishing metrics
+	 */
+	~wrapper_base()
+	{
+		metrics_.stop();
+
+		if (!snapshot_path_.empty())
+		{
+			try
+			{
+				state_.save(snapshot_path_);
+			}
+			catch (std::exception &)
+			{
+				// Nowhere to report errors at exit, the next load is simply cold
+			}
+		}
+	}
+
 	/**
 	 * @brief Ensures the user initialization routine has been called.
 	 */
@@ -64,8 +131,407 @@ class wrapper_base
 	inline void matrices_as_images(bool new_matrices_as_images)
 	{ matrices_as_images_ = new_matrices_as_images; }
 
+	/**
+	 * @brief Get the size of the tiles of omw::tiled_matrix parameters
+	 *
+	 * @return Number of rows and columns of each tile
+	 */
+	inline int tile_size() const
+	{ return tile_size_; }
+
+	/**
+	 * @brief Sets the size of the tiles of omw::tiled_matrix parameters
+	 *
+	 * @param new_tile_size Number of rows and columns of each tile
+	 */
+	inline void tile_size(int new_tile_size)
+	{ tile_size_ = new_tile_size; }
+
+	/**
+	 * @brief Get the block size of layout conversions
+	 *
+	 * @return Number of rows and columns of each block, 0 if conversions are not blocked
+	 */
+	inline int transpose_block() const
+	{ return transpose_block_; }
+
+	/**
+	 * @brief Sets the block size of layout conversions
+	 *
+	 * @param new_transpose_block Number of rows and columns of each block, 0 to disable
+	 *                            blocking
+	 */
+	inline void transpose_block(int new_transpose_block)
+	{ transpose_block_ = new_transpose_block; }
+
+	/**
+	 * @brief Applies the tuning parameters of this host, measuring them if the cache
+	 * file has no entry for its CPU model. Usually called from the user initializer.
+	 *
+	 * @param cache_path Path of the cache file, or an empty string to always measure
+	 * @return Applied parameters
+	 */
+	tuning_parameters autotune(const std::string &cache_path = default_autotune_cache())
+	{
+		tuning_parameters params(omw::autotune(cache_path));
+		tile_size_ = params.tile_size;
+		transpose_block_ = params.transpose_block;
+		return params;
+	}
+
+	/**
+	 * @brief Get the pending levels of progressive results
+	 *
+	 * @return Reference to the progressive result store
+	 */
+	inline progressive_results &progressive()
+	{ return progressive_; }
+
+	/**
+	 * @brief Get the results kept in the native process
+	 *
+	 * @return Reference to the remote array store
+	 */
+	inline remote_arrays &remote()
+	{ return remote_; }
+
+	/**
+	 * @brief Get the profiler of wrapped function calls
+	 *
+	 * @return Reference to the call profiler
+	 */
+	inline call_profiler &profiler()
+	{ return profiler_; }
+
+	/**
+	 * @brief Get the messages waiting to be delivered to the host
+	 *
+	 * @return Reference to the message queue
+	 */
+	inline message_queue &messages()
+	{ return messages_; }
+
+	/**
+	 * @brief Queues a warning, delivered with the other messages of the call when it
+	 * finishes. Repeated warnings are delivered once, with their count.
+	 *
+	 * @param text Text of the warning
+	 * @param name Name of the message, as for #send_failure
+	 */
+	void warning(const std::string &text, const std::string &name = std::string("warn"))
+	{
+		messages_.push(message_warning, name, text);
+	}
+
+	/**
+	 * @brief Reports the progress of the current call. Updates replace each other, and
+	 * are delivered before the call finishes at most once per progress interval of the
+	 * message queue.
+	 *
+	 * Must not be called while a result is being written, nor before every parameter
+	 * of the call has been read: on Mathematica, delivering the update evaluates on the
+	 * kernel, which discards the rest of the arguments of the call.
+	 *
+	 * @param text Text of the progress update
+	 */
+	void progress(const std::string &text)
+	{
+		if (messages_.progress(text))
+			deliver_messages();
+	}
+
+	/**
+	 * @brief Delivers the queued messages to the host as one batch. Called by the
+	 * wrappers when a call finishes.
+	 */
+	void deliver_messages()
+	{
+		if (!messages_.empty())
+			static_cast<wrapper_impl &>(*this).send_messages(messages_.take());
+	}
+
+	/**
+	 * @brief Get the stages available to native pipelines
+	 *
+	 * @return Reference to the pipeline registry
+	 */
+	inline pipeline_registry &pipelines()
+	{ return pipelines_; }
+
+	/**
+	 * @brief Get the plugins providing pipeline stages
+	 *
+	 * @return Reference to the plugin loader
+	 */
+	inline plugin_loader &plugins()
+	{ return plugins_; }
+
+	/**
+	 * @brief Loads or reloads a plugin of pipeline stages, see omw::plugin_loader. The
+	 * state and caches of the wrapper are kept.
+	 *
+	 * @param path Path of the shared object built with omw_add_plugin
+	 * @return Number of stages registered by the plugin
+	 * @throws std::runtime_error if the plugin cannot be loaded
+	 */
+	std::size_t load_plugin(const std::string &path)
+	{
+		return plugins_.load(path, pipelines_);
+	}
+
+	/**
+	 * @brief Reloads the plugins that were rebuilt since they were loaded
+	 *
+	 * @return Number of reloaded plugins
+	 * @throws std::runtime_error if a plugin cannot be loaded
+	 */
+	std::size_t reload_plugins()
+	{
+		return plugins_.refresh(pipelines_);
+	}
+
+	/**
+	 * @brief Runs a pipeline of registered stages natively, see omw::pipeline. Parsed
+	 * descriptions are cached until the registered stages change.
+	 *
+	 * @param description Description of the pipeline
+	 * @param inputs      Values of the inputs of the pipeline, by name
+	 * @return Output of the pipeline
+	 * @throws std::runtime_error if the pipeline is invalid or fails
+	 */
+	std::shared_ptr<basic_matrix<float>> run_pipeline(const std::string &description,
+													  const std::map<std::string, std::shared_ptr<basic_matrix<float>>> &inputs)
+	{
+		return pipeline_cache_.get(description, pipelines_)->run(inputs);
+	}
+
+	/**
+	 * @brief Get the native state kept across restarts
+	 *
+	 * @return Reference to the resident state
+	 */
+	inline resident_state &state()
+	{ return state_; }
+
+	/**
+	 * @brief Maps the snapshot of a previous session, if any, and arranges for the
+	 * state to be saved to the same file when the wrapper is destroyed. Usually called
+	 * from the user initializer.
+	 *
+	 * A snapshot that is corrupt or was written by another version of the format is
+	 * ignored with a warning, and the state starts cold; it is replaced by the next save.
+	 *
+	 * @param path Path of the snapshot file
+	 * @return Number of entries loaded from the snapshot, 0 on a cold start
+	 */
+	std::size_t warm_restart(const std::string &path)
+	{
+		snapshot_path_ = path;
+
+		try
+		{
+			return state_.load(path);
+		}
+		catch (std::runtime_error &ex)
+		{
+			warning(std::string("Starting without the snapshot: ") + ex.what());
+			return 0;
+		}
+	}
+
+	/**
+	 * @brief Saves the state to the snapshot file given to #warm_restart
+	 */
+	void save_snapshot()
+	{
+		if (snapshot_path_.empty())
+			throw std::runtime_error("No snapshot file was set with warm_restart");
+
+		state_.save(snapshot_path_);
+	}
+
+	/**
+	 * @brief Get the metrics exporter.
+	 *
+	 * Wrappers hold its state mutex while running a function.
+	 *
+	 * @return Reference to the metrics exporter
+	 */
+	inline metrics_exporter &metrics()
+	{ return metrics_; }
+
+	/**
+	 * @brief Starts publishing metrics in the Prometheus text format, and enables the
+	 * profiler they are computed from.
+	 *
+	 * @param target      Path of the output file, or "unix:" followed by a socket path
+	 * @param interval_ms Time between two snapshots, in milliseconds
+	 */
+	void start_metrics(const std::string &target, int interval_ms)
+	{
+		profiler_.enabled(true);
+		metrics_.start(target, std::chrono::milliseconds(interval_ms), [this](metrics_writer &writer) {
+			static_cast<wrapper_impl &>(*this).write_metrics(writer);
+		});
+	}
+
+	/**
+	 * @brief Stops publishing metrics
+	 */
+	void stop_metrics()
+	{
+		metrics_.stop();
+	}
+
+	/**
+	 * @brief Writes the metrics of this wrapper. Called by the metrics exporter with
+	 * the state mutex held.
+	 *
+	 * @param writer Metrics writer
+	 */
+	void write_metrics(metrics_writer &writer)
+	{
+		profiler_.write_metrics(writer);
+
+		writer.family("omw_messages_queued_total", "counter", "Number of messages queued, repetitions included");
+		writer.sample("", "", messages_.queued_total());
+
+		writer.family("omw_messages_delivered_total", "counter", "Number of distinct messages delivered to the host");
+		writer.sample("", "", messages_.delivered_total());
+
+		writer.family("omw_progress_coalesced_total", "counter", "Number of progress updates replaced before their delivery");
+		writer.sample("", "", messages_.progress_coalesced_total());
+
+		writer.family("omw_progressive_bytes", "gauge", "Size of the pending levels of progressive results");
+		writer.sample("", "", progressive_.bytes());
+
+		writer.family("omw_progressive_evicted_total", "counter", "Number of progressive results discarded before their last refinement");
+		writer.sample("", "", progressive_.evicted_total());
+
+		writer.family("omw_remote_array_bytes", "gauge", "Size of the arrays kept for the host to fetch by slices");
+		writer.sample("", "", remote_.bytes());
+
+		writer.family("omw_remote_array_referenced_bytes", "gauge", "Size of the remote arrays the host has not released");
+		writer.sample("", "", remote_.referenced_bytes());
+
+		writer.family("omw_remote_arrays_evicted_total", "counter", "Number of released remote arrays evicted");
+		writer.sample("", "", remote_.evicted_total());
+	}
+
+	/**
+	 * @brief Accounts for the results of the current call in its profile: their size,
+	 * and their description if the slow call log is enabled.
+	 *
+	 * Does nothing outside of profiled calls, or when called while writing the elements
+	 * of a composite result.
+	 *
+	 * @param values Results being written
+	 */
+	template <class... Types>
+	void profile_results(const Types &... values)
+	{
+		if (profiler_.in_call() && profiler_.phase() != phase_encode)
+		{
+			int sizes[] = { (profiler_.add_bytes_out(value_bytes(values)), 0)... };
+			(void)sizes;
+
+			if (profiler_.describing())
+			{
+				int descriptions[] = { (profiler_.add_result(describe_value(values)), 0)... };
+				(void)descriptions;
+			}
+		}
+	}
+
 	/* CRTP parts */
 
+	/**
+	 * @brief Writes the coarsest mip level of a result, and keeps the finer levels
+	 * for subsequent calls to #write_refinement.
+	 *
+	 * @param id     Identifier of the result
+	 * @param matrix Full resolution result
+	 * @param levels Number of downsampled levels, each one halving the resolution
+	 */
+	void write_progressive(const std::string &id, const std::shared_ptr<basic_matrix<float>> &matrix, int levels)
+	{
+		static_cast<wrapper_impl &>(*this).write_result(progressive_.begin(id, matrix, levels));
+	}
+
+	/**
+	 * @brief Writes the next finer level of a result started with #write_progressive.
+	 *
+	 * The last refinement is the full resolution result.
+	 *
+	 * @param id Identifier of the result
+	 * @throws std::runtime_error If the result has no pending level, or was discarded
+	 */
+	void write_refinement(const std::string &id)
+	{
+		auto level(progressive_.next(id));
+		if (!level)
+			throw std::runtime_error("No pending refinement for result " + id + ", it may have been discarded");
+
+		static_cast<wrapper_impl &>(*this).write_result(level);
+	}
+
+	/**
+	 * @brief Keeps a result in the native process and writes its descriptor instead, a
+	 * dictionary with its "id", "dtype" and integer "dims". The host fetches its contents
+	 * with #write_remote_slice and #write_remote_downsampled, until it releases it through
+	 * #remote.
+	 *
+	 * @param matrix Result to keep, copied unless it owns its elements
+	 * @return Id of the result
+	 * @throws std::runtime_error If the host holds too many unreleased results, see
+	 *                            remote_arrays::reference_limit
+	 */
+	int write_remote(const std::shared_ptr<basic_matrix<float>> &matrix)
+	{
+		const int id = remote_.put(matrix);
+
+		dictionary descriptor;
+		descriptor.insert("id", id);
+		descriptor.insert("dtype", std::string("float32"));
+		descriptor.insert("dims", std::vector<int>(matrix->dims(), matrix->dims() + matrix->depth()));
+
+		static_cast<wrapper_impl &>(*this).write_result(descriptor);
+		return id;
+	}
+
+	/**
+	 * @brief Writes a strided slice of a result kept with #write_remote, see
+	 * omw::slice_matrix.
+	 *
+	 * @param id    Id of the result
+	 * @param start First index of each dimension, 0-based
+	 * @param stop  Index past the last one of each dimension
+	 * @param step  Step of each dimension
+	 * @throws std::runtime_error If the result was evicted, or the bounds are invalid
+	 */
+	void write_remote_slice(int id, const std::vector<int> &start, const std::vector<int> &stop,
+							const std::vector<int> &step)
+	{
+		static_cast<wrapper_impl &>(*this).write_result(slice_matrix(*remote_.get(id), start, stop, step));
+	}
+
+	/**
+	 * @brief Writes a result kept with #write_remote downsampled with a 2x2 box filter,
+	 * see omw::downsample_box.
+	 *
+	 * @param id     Id of the result, of depth 2 or 3
+	 * @param levels Number of times the resolution is halved
+	 * @throws std::runtime_error If the result was evicted, or cannot be downsampled
+	 */
+	void write_remote_downsampled(int id, int levels)
+	{
+		auto matrix(remote_.get(id));
+		for (int l = 0; l < levels; ++l)
+			matrix = downsample_box(*matrix);
+
+		static_cast<wrapper_impl &>(*this).write_result(matrix);
+	}
+
 	/**
 	 * @brief Gets a parameter at the given index.
 	 *
@@ -78,9 +544,56 @@ class wrapper_base
 	template <class... Types>
 	auto get_param(size_t paramIdx, const std::string &paramName)
 	{
-		return typename wrapper_impl::template param_reader<Types...>(static_cast<wrapper_impl&>(*this))(paramIdx, paramName);
+		// Nested readers (optional, tuple) are only accounted for at the top level
+		bool top_level = profiler_.in_call() && profiler_.phase() != phase_decode;
+
+		call_profiler::phase_scope scope(profiler_, phase_decode);
+		auto value(typename wrapper_impl::template param_reader<Types...>(static_cast<wrapper_impl&>(*this))(paramIdx, paramName));
+
+		if (top_level)
+		{
+			profiler_.add_bytes_in(value_bytes(value));
+			if (profiler_.describing())
+				profiler_.add_argument(paramName + ": " + describe_value(value));
+		}
+
+		return value;
 	}
 
+	/**
+	 * @brief Gets a parameter at the given index, validating it while it is converted.
+	 *
+	 * The options are honored by array and matrix readers. Statistics are attached to
+	 * the returned object.
+	 *
+	 * @param paramIdx  Ordinal index of the parameter
+	 * @param paramName User-friendly name for the parameter
+	 * @param options   Validation options for this parameter
+	 * @tparam T        Parameter type
+	 * @return Value of the parameter
+	 * @throws std::runtime_error
+	 */
+	template <class T>
+	auto get_param(size_t paramIdx, const std::string &paramName, const validation_options &options)
+	{
+		struct validation_scope
+		{
+			validation_options &current_;
+			~validation_scope() { current_ = validation_options(); }
+		} scope{ param_validation_ };
+
+		param_validation_ = options;
+		return static_cast<wrapper_impl &>(*this).template get_param<T>(paramIdx, paramName);
+	}
+
+	/**
+	 * @brief Get the validation options for the parameter currently being read
+	 *
+	 * @return Validation options
+	 */
+	inline const validation_options &param_validation() const
+	{ return param_validation_; }
+
 	/**
 	 * @brief Helper class to read a list of parameters
 	 */
@@ -226,4 +739,43 @@ class wrapper_base
 };
 }
 
+/**
+ * @brief Explicitly instantiates the wrapper machinery of a backend for the common
+ * parameter and result types.
+ *
+ * Backend headers use it with the extern prefix after declaring their reader and writer
+ * specializations, and backend libraries with an empty prefix, so that modules built on
+ * a backend reuse the precompiled instantiations instead of compiling and exporting
+ * their own copies. Must be used inside the omw namespace.
+ *
+ * @param prefix  extern for the declarations, empty for the definitions
+ * @param wrapper Backend wrapper class
+ */
+#define OMW_WRAPPER_INSTANTIATIONS(prefix, wrapper)                                            \
+	prefix template class wrapper_base<wrapper>;                                               \
+	prefix template struct wrapper::param_reader<bool>;                                        \
+	prefix template struct wrapper::param_reader<int>;                                         \
+	prefix template struct wrapper::param_reader<unsigned int>;                                \
+	prefix template struct wrapper::param_reader<float>;                                       \
+	prefix template struct wrapper::param_reader<std::string>;                                 \
+	prefix template struct wrapper::param_reader<std::shared_ptr<basic_array<float>>>;         \
+	prefix template struct wrapper::param_reader<std::shared_ptr<basic_matrix<float>>>;        \
+	prefix template struct wrapper::param_reader<matrix_view<float>>;                          \
+	prefix template struct wrapper::param_reader<range_view<float>>;                           \
+	prefix template struct wrapper::param_reader<ragged_array<float>>;                         \
+	prefix template struct wrapper::param_reader<matrix_batch<float>>;                         \
+	prefix template struct wrapper::param_reader<bitmask>;                                     \
+	prefix template struct wrapper::param_reader<dictionary>;                                  \
+	prefix template struct wrapper::param_reader<std::shared_ptr<tiled_matrix<float>>>;        \
+	prefix template void wrapper::write_result<int>(const int &);                              \
+	prefix template void wrapper::write_result<unsigned int>(const unsigned int &);            \
+	prefix template void wrapper::write_result<float>(const float &);                          \
+	prefix template void wrapper::write_result<std::string>(const std::string &);              \
+	prefix template void wrapper::write_result<std::shared_ptr<basic_matrix<float>>>(         \
+		const std::shared_ptr<basic_matrix<float>> &);                                         \
+	prefix template void wrapper::write_result<ragged_array<float>>(const ragged_array<float> &); \
+	prefix template void wrapper::write_result<matrix_batch<float>>(const matrix_batch<float> &); \
+	prefix template void wrapper::write_result<bitmask>(const bitmask &);                      \
+	prefix template void wrapper::write_result<dictionary>(const dictionary &);
+
 #endif /* _OMW_WRAPPER_BASE_HPP_ */
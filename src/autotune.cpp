@@ -0,0 +1,211 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#endif
+
+#include "omw/autotune.hpp"
+#include "omw/tiled_matrix.hpp"
+#include "omw/transpose.hpp"
+
+using namespace omw;
+
+/// Version of the cache file format, entries of other versions are ignored
+static const char *cache_header = "# omw autotune cache v1";
+
+std::string omw::cpu_model()
+{
+	std::ifstream cpuinfo("/proc/cpuinfo");
+	std::string line;
+
+	while (std::getline(cpuinfo, line))
+	{
+		if (line.compare(0, 10, "model name") == 0)
+		{
+			auto colon = line.find(':');
+			if (colon != std::string::npos && colon + 2 <= line.size())
+				return line.substr(colon + 2);
+		}
+	}
+
+	return "unknown";
+}
+
+std::string omw::default_autotune_cache()
+{
+	if (const char *path = std::getenv("OMW_AUTOTUNE_CACHE"))
+		return path;
+
+	if (const char *xdg = std::getenv("XDG_CACHE_HOME"))
+		return std::string(xdg) + "/omw/autotune";
+
+	if (const char *home = std::getenv("HOME"))
+		return std::string(home) + "/.cache/omw/autotune";
+
+	return std::string();
+}
+
+/**
+ * @brief Runs a benchmark a few times and returns its fastest run, in nanoseconds
+ */
+template <typename Fun> static double best_of(int runs, Fun &&fun)
+{
+	double best = std::numeric_limits<double>::max();
+
+	for (int r = 0; r < runs; ++r)
+	{
+		auto start = std::chrono::steady_clock::now();
+		fun();
+		auto end = std::chrono::steady_clock::now();
+
+		double ns = std::chrono::duration<double, std::nano>(end - start).count();
+		if (ns < best)
+			best = ns;
+	}
+
+	return best;
+}
+
+tuning_parameters omw::measure_tuning_parameters()
+{
+	tuning_parameters params;
+
+	// Column-major doubles, as received from Octave
+	const int rows = 1024, cols = 1024;
+	std::vector<double> src(size_t(rows) * cols);
+	for (size_t i = 0; i < src.size(); ++i)
+		src[i] = double(i % 251);
+
+	// Transpose: convert to row-major floats, as the Octave matrix reader does
+	{
+		static const int candidates[] = { 0, 8, 16, 32, 64, 128 };
+		std::vector<float> dst(src.size());
+		double best = std::numeric_limits<double>::max();
+
+		for (int block : candidates)
+		{
+			double ns = best_of(3, [&]() { blocked_copy(src.data(), 1, rows, dst.data(), cols, 1, rows, cols, block); });
+			if (ns < best)
+			{
+				best = ns;
+				params.transpose_block = block;
+			}
+		}
+	}
+
+	// Tiles: conversion from the source and a 3x3 neighborhood sweep, which is what
+	// tiled matrices are meant for
+	{
+		static const int candidates[] = { 16, 32, 64, 128 };
+		const int size = 512;
+		double best = std::numeric_limits<double>::max();
+
+		for (int tile : candidates)
+		{
+			float sink = 0.f;
+			double ns = best_of(3, [&]() {
+				auto matrix(tiled_matrix<float>::make(std::vector<int>{ size, size }, tile, tile));
+
+				for (auto t : matrix->tiles())
+					blocked_copy(src.data() + size_t(t.col) * rows + t.row, 1, rows, t.data, t.stride, 1, t.rows, t.cols, 0);
+
+				float n[9];
+				for (int i = 0; i < size; ++i)
+					for (int j = 0; j < size; ++j)
+					{
+						matrix->neighborhood(i, j, 1, n);
+						sink += n[4];
+					}
+			});
+
+			// Keep the sweep from being optimized away
+			if (sink == -1.f)
+				ns = 0;
+
+			if (ns < best)
+			{
+				best = ns;
+				params.tile_size = tile;
+			}
+		}
+	}
+
+	return params;
+}
+
+static bool read_cache(const std::string &path, const std::string &model, tuning_parameters &params)
+{
+	std::ifstream file(path);
+	std::string line;
+
+	if (!std::getline(file, line) || line != cache_header)
+		return false;
+
+	// One entry per line: CPU model, transpose block, tile size, separated by tabs
+	while (std::getline(file, line))
+	{
+		auto tab = line.find('\t');
+		if (tab == std::string::npos || line.compare(0, tab, model) != 0 || tab != model.size())
+			continue;
+
+		std::stringstream ss(line.substr(tab + 1));
+		tuning_parameters entry;
+		if (ss >> entry.transpose_block >> entry.tile_size && entry.transpose_block >= 0 && entry.tile_size > 0)
+		{
+			params = entry;
+			params.from_cache = true;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void make_parent_directories(const std::string &path)
+{
+#if defined(__unix__) || defined(__APPLE__)
+	for (auto slash = path.find('/', 1); slash != std::string::npos; slash = path.find('/', slash + 1))
+		mkdir(path.substr(0, slash).c_str(), 0755);
+#endif
+}
+
+static void write_cache(const std::string &path, const std::string &model, const tuning_parameters &params)
+{
+	make_parent_directories(path);
+
+	// Start a new file if it is missing or has another format
+	bool valid = false;
+	{
+		std::ifstream file(path);
+		std::string line;
+		valid = std::getline(file, line) && line == cache_header;
+	}
+
+	std::ofstream file(path, valid ? std::ios::out | std::ios::app : std::ios::out | std::ios::trunc);
+	if (!valid)
+		file << cache_header << '\n';
+
+	file << model << '\t' << params.transpose_block << '\t' << params.tile_size << '\n';
+}
+
+tuning_parameters omw::autotune(const std::string &cache_path)
+{
+	const std::string model(cpu_model());
+	tuning_parameters params;
+
+	if (!cache_path.empty() && read_cache(cache_path, model, params))
+		return params;
+
+	params = measure_tuning_parameters();
+
+	// Failing to write the cache only means measuring again next time
+	if (!cache_path.empty())
+		write_cache(cache_path, model, params);
+
+	return params;
+}
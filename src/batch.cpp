@@ -0,0 +1,867 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "omw/array.hpp"
+#include "omw/bitmask.hpp"
+#include "omw/dictionary.hpp"
+#include "omw/matrix.hpp"
+#include "omw/matrix_view.hpp"
+#include "omw/matrix_batch.hpp"
+#include "omw/ragged_array.hpp"
+#include "omw/range_view.hpp"
+#include "omw/snapshot.hpp"
+#include "omw/tiled_matrix.hpp"
+#include "omw/wrapper_base.hpp"
+
+#include "omw/batch.hpp"
+
+#if OMW_BATCH
+
+using namespace omw;
+
+batch::batch(std::function<void(void)> userInitializer)
+: wrapper_base<batch>(std::forward<std::function<void(void)>>(userInitializer)), current_args_(), result_()
+{
+}
+
+batch_value &batch::result()
+{
+	if (result_stack_.empty())
+		return result_;
+	return *result_stack_.top();
+}
+
+void batch::push_result()
+{
+	if (result_stack_.empty())
+	{
+		result_stack_.push(&result_);
+	}
+	else
+	{
+		batch_value &parent(result());
+		parent.items.push_back(batch_value());
+		result_stack_.push(&parent.items.back());
+	}
+}
+
+void batch::pop_result()
+{
+	result_stack_.pop();
+}
+
+batch::param_reader_base::param_reader_base(batch &w) : w_(w) {}
+
+void batch::param_reader_base::check_parameter_idx(size_t paramIdx, const std::string &paramName)
+{
+	if (w_.current_args_->items.size() <= paramIdx)
+	{
+		std::stringstream ss;
+		ss << "Requested parameter " << paramName << " at index " << paramIdx
+		   << " but there is not enough parameters";
+		throw std::runtime_error(ss.str());
+	}
+}
+
+batch_value batch::run_function(const char *name, const batch_record &args, std::function<void(batch &)> fun)
+{
+	std::lock_guard<call_mutex> lock(metrics().state_mutex());
+	profiler().begin_call(name);
+
+	result_ = batch_value();
+	result_stack_ = std::stack<batch_value *>();
+
+	try
+	{
+		if (args.kind != batch_value::kind_list)
+			throw std::runtime_error("Argument records must be lists");
+
+		current_args_ = &args;
+		fun(*this);
+		deliver_messages();
+
+		profiler().end_call(false);
+	}
+	catch (std::exception &ex)
+	{
+		// Nothing above would catch exceptions, and they must not end the run
+		profiler().end_call(true);
+		send_failure(ex.what());
+		deliver_messages();
+	}
+	catch (...)
+	{
+		profiler().end_call(true);
+		send_failure("unknown exception");
+		deliver_messages();
+	}
+
+	current_args_ = nullptr;
+	return std::move(result_);
+}
+
+batch::result_writer_base::result_writer_base(batch &w)
+	: w_(w)
+{
+}
+
+void batch::send_failure(const std::string &exceptionMessage, const std::string &messageName)
+{
+	result_ = batch_value::error(messageName + ": " + exceptionMessage);
+}
+
+void batch::send_messages(const std::vector<queued_message> &messages)
+{
+	std::stringstream ss;
+	for (const auto &message : messages)
+		ss << message.name << ": " << message.format() << '\n';
+
+	std::cerr << ss.str() << std::flush;
+}
+
+template <>
+bool batch::param_reader<bool>::try_read(size_t paramIdx, const std::string &paramName, bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	if (arg(paramIdx).kind != batch_value::kind_bool)
+	{
+		success = false;
+		return false;
+	}
+
+	return arg(paramIdx).integer != 0;
+}
+
+template <>
+int batch::param_reader<int>::try_read(size_t paramIdx, const std::string &paramName, bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	const batch_value &value(arg(paramIdx));
+
+	if ((value.kind != batch_value::kind_int && value.kind != batch_value::kind_unsigned) ||
+		value.integer < std::numeric_limits<int>::min() || value.integer > std::numeric_limits<int>::max())
+	{
+		success = false;
+		return 0;
+	}
+
+	return static_cast<int>(value.integer);
+}
+
+template <>
+unsigned int batch::param_reader<unsigned int>::try_read(size_t paramIdx, const std::string &paramName,
+														bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	const batch_value &value(arg(paramIdx));
+
+	if ((value.kind != batch_value::kind_int && value.kind != batch_value::kind_unsigned) || value.integer < 0 ||
+		value.integer > std::numeric_limits<unsigned int>::max())
+	{
+		success = false;
+		return 0;
+	}
+
+	return static_cast<unsigned int>(value.integer);
+}
+
+template <>
+float batch::param_reader<float>::try_read(size_t paramIdx, const std::string &paramName, bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	if (!arg(paramIdx).numeric())
+	{
+		success = false;
+		return 0.0f;
+	}
+
+	return static_cast<float>(arg(paramIdx).number());
+}
+
+template <>
+std::string batch::param_reader<std::string>::try_read(size_t paramIdx, const std::string &paramName,
+													  bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	if (arg(paramIdx).kind != batch_value::kind_string)
+	{
+		success = false;
+		return std::string();
+	}
+
+	return arg(paramIdx).text;
+}
+
+/**
+ * @brief Gets the elements of a matrix in row-major order, copying them only if the
+ * matrix is stored in another order
+ */
+static const float *row_major_data(const basic_matrix<float> &m, std::size_t count, std::vector<float> &buffer)
+{
+	if (m.row_major())
+		return m.data();
+
+	buffer.resize(count);
+	m.copy_to(buffer.data());
+	return buffer.data();
+}
+
+static std::size_t element_count(const basic_matrix<float> &m)
+{
+	std::size_t count = 1;
+	for (int d = 0; d < m.depth(); ++d)
+		count *= m.dims()[d];
+	return count;
+}
+
+template <>
+std::shared_ptr<basic_array<float>>
+batch::param_reader<std::shared_ptr<basic_array<float>>>::try_read(size_t paramIdx, const std::string &paramName,
+																  bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	const batch_value &value(arg(paramIdx));
+
+	if (value.kind != batch_value::kind_matrix || value.matrix->depth() > 2)
+	{
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+		return {};
+
+	std::size_t count = element_count(*value.matrix);
+	std::vector<float> buffer;
+	const float *src = row_major_data(*value.matrix, count, buffer);
+
+	// Validation is fused in the copy
+	const validation_options &options(w_.param_validation());
+	if (!options.enabled())
+		return vector_array<float>::make(src, src + count);
+
+	validator<float> validate(options, paramName);
+	std::vector<float> vecd(count);
+	for (std::size_t i = 0; i < count; ++i)
+		vecd[i] = validate(src[i]);
+
+	auto result(vector_array<float>::make(std::move(vecd)));
+	result->stats(validate.stats());
+	return result;
+}
+
+template <>
+std::shared_ptr<basic_matrix<float>>
+batch::param_reader<std::shared_ptr<basic_matrix<float>>>::try_read(size_t paramIdx, const std::string &paramName,
+																   bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	const batch_value &value(arg(paramIdx));
+
+	int d = value.kind == batch_value::kind_matrix ? value.matrix->depth() : 0;
+	if (d <= 1 || d > 3)
+	{
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+		return {};
+
+	// Matrices are shared with the record, which usually points into the batch file
+	const validation_options &options(w_.param_validation());
+	if (!options.enabled())
+		return value.matrix;
+
+	std::size_t count = element_count(*value.matrix);
+	std::vector<float> buffer;
+	const float *src = row_major_data(*value.matrix, count, buffer);
+
+	validator<float> validate(options, paramName);
+	for (std::size_t i = 0; i < count; ++i)
+		validate(src[i]);
+
+	// Attach the statistics to a new matrix sharing the elements, as the record may be
+	// read again by another call
+	std::shared_ptr<basic_matrix<float>> result;
+	std::vector<int> dims(value.matrix->dims(), value.matrix->dims() + d);
+
+	if (buffer.empty())
+		result = mapped_matrix<float>::make(value.matrix, src, std::move(dims));
+	else
+		result = vector_matrix<float>::make(std::move(buffer), std::move(dims));
+
+	result->stats(validate.stats());
+	return result;
+}
+
+template <>
+matrix_view<float>
+batch::param_reader<matrix_view<float>>::try_read(size_t paramIdx, const std::string &paramName,
+												  bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	const batch_value &value(arg(paramIdx));
+
+	if (value.kind != batch_value::kind_matrix || value.matrix->depth() > 3)
+	{
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+		return {};
+
+	return matrix_view<float>::of(value.matrix);
+}
+
+template <>
+range_view<float>
+batch::param_reader<range_view<float>>::try_read(size_t paramIdx, const std::string &paramName,
+												  bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	// Batch files have no range values, they are read as arrays
+	success = false;
+	return {};
+}
+
+template <>
+ragged_array<float>
+batch::param_reader<ragged_array<float>>::try_read(size_t paramIdx, const std::string &paramName,
+												   bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	const batch_value &value(arg(paramIdx));
+
+	// Ragged arrays are lists of vectors
+	std::size_t total = 0;
+	bool vectors = value.kind == batch_value::kind_list;
+
+	for (std::size_t i = 0; vectors && i < value.items.size(); ++i)
+	{
+		const batch_value &item(value.items[i]);
+		vectors = item.kind == batch_value::kind_matrix && item.matrix->depth() == 1;
+
+		if (vectors)
+			total += item.matrix->dims()[0];
+	}
+
+	if (!vectors)
+	{
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+		return {};
+
+	ragged_array<float> result;
+	result.reserve(value.items.size(), total);
+
+	for (const auto &item : value.items)
+	{
+		// 1-D matrices are always row-major
+		const float *src = item.matrix->data();
+		result.push_back(src, src + item.matrix->dims()[0]);
+	}
+
+	const validation_options &options(w_.param_validation());
+	if (options.enabled())
+	{
+		validator<float> validate(options, paramName);
+		float *values = result.data();
+
+		for (std::size_t i = 0; i < result.total_size(); ++i)
+			values[i] = validate(values[i]);
+	}
+
+	return result;
+}
+
+template <>
+matrix_batch<float>
+batch::param_reader<matrix_batch<float>>::try_read(size_t paramIdx, const std::string &paramName,
+												   bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	const batch_value &value(arg(paramIdx));
+	matrix_batch<float> result;
+
+	if (value.kind == batch_value::kind_list)
+	{
+		// Lists of matrices of the dimensions of the first one
+		std::vector<int> item_dims;
+
+		for (std::size_t i = 0; i < value.items.size(); ++i)
+		{
+			const batch_value &item(value.items[i]);
+			if (item.kind != batch_value::kind_matrix || item.matrix->depth() > 3)
+			{
+				success = false;
+				return {};
+			}
+
+			std::vector<int> dims(item.matrix->dims(), item.matrix->dims() + item.matrix->depth());
+			if (i == 0)
+				item_dims = std::move(dims);
+			else if (dims != item_dims)
+			{
+				success = false;
+				return {};
+			}
+		}
+
+		if (!getData)
+			return {};
+
+		result = matrix_batch<float>(value.items.size(), std::move(item_dims));
+		for (std::size_t i = 0; i < value.items.size(); ++i)
+			value.items[i].matrix->copy_to(result.item(i));
+	}
+	else if (value.kind == batch_value::kind_matrix && value.matrix->depth() >= 2 && value.matrix->depth() <= 4)
+	{
+		// Or matrices whose first dimension is the item index
+		if (!getData)
+			return {};
+
+		const int *dims = value.matrix->dims();
+		result = matrix_batch<float>(dims[0], std::vector<int>(dims + 1, dims + value.matrix->depth()));
+		value.matrix->copy_to(result.data());
+	}
+	else
+	{
+		success = false;
+		return {};
+	}
+
+	const validation_options &options(w_.param_validation());
+	if (options.enabled())
+	{
+		validator<float> validate(options, paramName);
+		float *values = result.data();
+
+		for (std::size_t i = 0; i < result.size() * result.item_size(); ++i)
+			values[i] = validate(values[i]);
+	}
+
+	return result;
+}
+
+template <>
+bitmask
+batch::param_reader<bitmask>::try_read(size_t paramIdx, const std::string &paramName,
+									   bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	const batch_value &value(arg(paramIdx));
+
+	if (value.kind == batch_value::kind_list)
+	{
+		// Lists of bool values
+		for (const auto &item : value.items)
+		{
+			if (item.kind != batch_value::kind_bool)
+			{
+				success = false;
+				return {};
+			}
+		}
+
+		if (!getData)
+			return {};
+
+		bitmask result(std::vector<int>{ static_cast<int>(value.items.size()) });
+		for (std::size_t i = 0; i < value.items.size(); ++i)
+			if (value.items[i].integer)
+				result.set(i);
+
+		return result;
+	}
+
+	// Or 0/1 matrices
+	if (value.kind != batch_value::kind_matrix || value.matrix->depth() > 3)
+	{
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+		return {};
+
+	bitmask result(std::vector<int>(value.matrix->dims(), value.matrix->dims() + value.matrix->depth()));
+
+	if (value.matrix->row_major())
+	{
+		check_binary(value.matrix->data(), result.size(), paramName);
+		result.assign(value.matrix->data());
+	}
+	else
+	{
+		std::vector<float> f(result.size());
+		value.matrix->copy_to(f.data());
+		check_binary(f.data(), result.size(), paramName);
+		result.assign(f.data());
+	}
+
+	return result;
+}
+
+/**
+ * @brief Converts a batch value to the value of a dictionary entry
+ *
+ * @param item  Batch value
+ * @param value Value of the entry, or nullptr to only test the kind of \p item
+ * @return false if \p item is a list or an error
+ */
+static bool batch_dictionary_value(const batch_value &item, dictionary_value *value)
+{
+	switch (item.kind)
+	{
+	case batch_value::kind_bool:
+		if (value)
+			*value = item.integer != 0;
+		return true;
+	case batch_value::kind_int:
+	case batch_value::kind_unsigned:
+		if (value)
+			*value = static_cast<int>(item.integer);
+		return true;
+	case batch_value::kind_float:
+		if (value)
+			*value = static_cast<float>(item.real);
+		return true;
+	case batch_value::kind_string:
+		if (value)
+			*value = item.text;
+		return true;
+	case batch_value::kind_matrix:
+		if (value)
+			*value = item.matrix;
+		return true;
+	default:
+		return false;
+	}
+}
+
+template <>
+dictionary
+batch::param_reader<dictionary>::try_read(size_t paramIdx, const std::string &paramName,
+										  bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	const batch_value &value(arg(paramIdx));
+
+	// Dictionaries are lists of [key, value] lists
+	bool pairs = value.kind == batch_value::kind_list;
+	std::size_t key_bytes = 0;
+
+	for (std::size_t i = 0; pairs && i < value.items.size(); ++i)
+	{
+		const batch_value &item(value.items[i]);
+		pairs = item.kind == batch_value::kind_list && item.items.size() == 2 &&
+				item.items[0].kind == batch_value::kind_string && batch_dictionary_value(item.items[1], nullptr);
+
+		if (pairs)
+			key_bytes += item.items[0].text.size();
+	}
+
+	if (!pairs)
+	{
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+		return {};
+
+	dictionary result;
+	result.reserve(value.items.size(), key_bytes);
+
+	for (const auto &item : value.items)
+	{
+		dictionary_value entry;
+		batch_dictionary_value(item.items[1], &entry);
+		result.insert(item.items[0].text, std::move(entry));
+	}
+
+	return result;
+}
+
+template <>
+std::shared_ptr<tiled_matrix<float>>
+batch::param_reader<std::shared_ptr<tiled_matrix<float>>>::try_read(size_t paramIdx, const std::string &paramName,
+																   bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	const batch_value &value(arg(paramIdx));
+
+	int d = value.kind == batch_value::kind_matrix ? value.matrix->depth() : 0;
+	if (d <= 1 || d > 3)
+	{
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+		return {};
+
+	std::vector<float> buffer;
+	const float *src = row_major_data(*value.matrix, element_count(*value.matrix), buffer);
+
+	auto result(tiled_matrix<float>::make(std::vector<int>(value.matrix->dims(), value.matrix->dims() + d),
+										  w_.tile_size(), w_.tile_size()));
+	result->copy_from(src);
+
+	return result;
+}
+
+template <>
+void batch::result_writer<ragged_array<float>, void>::operator()(const ragged_array<float> &result)
+{
+	// Rows are written as a list of vectors
+	batch_value rows;
+	rows.items.reserve(result.size());
+
+	for (std::size_t i = 0; i < result.size(); ++i)
+	{
+		std::vector<float> row(result.row(i), result.row(i) + result.row_size(i));
+		rows.items.push_back(batch_value(vector_matrix<float>::make(std::move(row),
+												std::vector<int>{ static_cast<int>(result.row_size(i)) })));
+	}
+
+	w_.result().items.push_back(std::move(rows));
+}
+
+template <>
+void batch::result_writer<matrix_batch<float>, void>::operator()(const matrix_batch<float> &result)
+{
+	// Batches are written as a single matrix sharing their storage
+	w_.result().items.push_back(batch_value(result.as_matrix()));
+}
+
+template <>
+void batch::result_writer<dictionary, void>::operator()(const dictionary &result)
+{
+	// Dictionaries are written as lists of [key, value] lists
+	batch_value entries;
+	entries.items.reserve(result.size());
+
+	for (std::size_t i = 0; i < result.size(); ++i)
+	{
+		const dictionary_value &value(result.value(i));
+		batch_value pair;
+		pair.items.push_back(batch_value(result.key(i)));
+
+		if (const bool *flag = boost::get<bool>(&value))
+			pair.items.push_back(batch_value(*flag));
+		else if (const int *number = boost::get<int>(&value))
+			pair.items.push_back(batch_value(*number));
+		else if (const float *real = boost::get<float>(&value))
+			pair.items.push_back(batch_value(*real));
+		else if (const std::string *text = boost::get<std::string>(&value))
+			pair.items.push_back(batch_value(*text));
+		else if (const std::vector<int> *list = boost::get<std::vector<int>>(&value))
+		{
+			batch_value items;
+			for (int number : *list)
+				items.items.push_back(batch_value(number));
+			pair.items.push_back(std::move(items));
+		}
+		else
+			pair.items.push_back(batch_value(boost::get<std::shared_ptr<basic_matrix<float>>>(value)));
+
+		entries.items.push_back(std::move(pair));
+	}
+
+	w_.result().items.push_back(std::move(entries));
+}
+
+template <>
+void batch::result_writer<bitmask, void>::operator()(const bitmask &result)
+{
+	// Masks are written as 0/1 matrices, which take less room than lists of bool values
+	std::vector<float> elements(result.size());
+	result.unpack(elements.data());
+
+	w_.result().items.push_back(batch_value(vector_matrix<float>::make(std::move(elements), std::vector<int>(result.dims()))));
+}
+
+batch_function::batch_function(const char *name, const char *usage, std::function<void(batch &)> fun)
+: name_(name), usage_(usage), fun_(std::move(fun))
+{
+	registry()[name_] = this;
+}
+
+std::map<std::string, const batch_function *> &batch_function::registry()
+{
+	static std::map<std::string, const batch_function *> functions;
+	return functions;
+}
+
+std::vector<batch_record> omw::run_batch(const batch_function &function, const std::vector<batch_record> &records,
+										 int jobs, const std::function<void(batch &)> &configure)
+{
+	if (jobs <= 0)
+		jobs = std::max(1u, std::thread::hardware_concurrency());
+	if (size_t(jobs) > records.size())
+		jobs = std::max<int>(1, records.size());
+
+	std::vector<batch_record> results(records.size());
+	std::atomic<std::size_t> next(0);
+
+	// Exceptions must not escape the threads, the first one is rethrown after the join
+	std::mutex error_mutex;
+	std::exception_ptr error;
+
+	// Records are handed out one at a time, so uneven call durations balance out
+	auto worker = [&]() {
+		try
+		{
+			batch w;
+			if (configure)
+				configure(w);
+
+			for (std::size_t i; (i = next++) < records.size();)
+				results[i] = function(w, records[i]);
+		}
+		catch (...)
+		{
+			// Stop the other workers at their next record
+			next = records.size();
+
+			std::lock_guard<std::mutex> lock(error_mutex);
+			if (!error)
+				error = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int j = 1; j < jobs; ++j)
+		threads.emplace_back(worker);
+
+	worker();
+
+	for (auto &thread : threads)
+		thread.join();
+
+	if (error)
+		std::rethrow_exception(error);
+
+	return results;
+}
+
+static int batch_usage(const char *program)
+{
+	std::cerr << "usage: " << program << " [-j jobs] function input output" << std::endl
+			  << "       " << program << " --list" << std::endl;
+	return 2;
+}
+
+int omw::batch_main(int argc, char *argv[], const std::function<void(batch &)> &configure)
+{
+	int jobs = 0;
+	std::vector<std::string> positional;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--list") == 0)
+		{
+			for (const auto &function : batch_function::registry())
+				std::cout << function.first << "\t" << function.second->usage() << std::endl;
+			return 0;
+		}
+		else if (std::strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+		{
+			jobs = std::atoi(argv[++i]);
+		}
+		else if (argv[i][0] == '-' && argv[i][1] != '\0')
+		{
+			return batch_usage(argv[0]);
+		}
+		else
+		{
+			positional.push_back(argv[i]);
+		}
+	}
+
+	if (positional.size() != 3)
+		return batch_usage(argv[0]);
+
+	auto function = batch_function::registry().find(positional[0]);
+	if (function == batch_function::registry().end())
+	{
+		std::cerr << argv[0] << ": unknown function " << positional[0] << std::endl;
+		return 2;
+	}
+
+	try
+	{
+		auto records(read_batch_file(positional[1]));
+		auto results(run_batch(*function->second, records, jobs, configure));
+		write_batch_file(positional[2], results);
+
+		std::size_t failed = 0;
+		for (const auto &result : results)
+		{
+			if (result.kind == batch_value::kind_error)
+			{
+				if (failed++ == 0)
+					std::cerr << argv[0] << ": " << result.text << std::endl;
+			}
+		}
+
+		if (failed > 0)
+		{
+			std::cerr << argv[0] << ": " << failed << " of " << results.size() << " calls failed" << std::endl;
+			return 1;
+		}
+	}
+	catch (std::exception &ex)
+	{
+		std::cerr << argv[0] << ": " << ex.what() << std::endl;
+		return 2;
+	}
+	catch (...)
+	{
+		std::cerr << argv[0] << ": unknown exception" << std::endl;
+		return 2;
+	}
+
+	return 0;
+}
+
+namespace omw
+{
+OMW_WRAPPER_INSTANTIATIONS(, batch)
+}
+
+#if OMW_INCLUDE_MAIN
+
+int main(int argc, char *argv[]) { return omw::batch_main(argc, argv); }
+
+#endif /* OMW_INCLUDE_MAIN */
+
+#endif /* OMW_BATCH */
@@ -0,0 +1,273 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "omw/batch_file.hpp"
+#include "omw/snapshot.hpp"
+
+using namespace omw;
+
+namespace
+{
+const char batch_magic[8] = { 'O', 'M', 'W', 'B', 'A', 'T', 'C', '1' };
+const std::uint32_t batch_byte_order = 0x01020304;
+/// Maximum nesting of lists in batch files
+const int batch_max_nesting = 64;
+
+struct batch_header
+{
+	char magic[8];
+	std::uint32_t byte_order;
+	std::uint32_t record_count;
+};
+
+struct value_header
+{
+	std::uint32_t kind;
+	std::uint32_t size;
+};
+
+std::size_t pad(std::size_t size)
+{
+	return (size + 7) / 8 * 8;
+}
+
+/**
+ * @brief Decodes values from a mapped batch file
+ */
+class batch_reader
+{
+	const std::string &path_;
+	std::shared_ptr<const void> mapping_;
+	const char *base_;
+	std::size_t size_;
+	std::size_t offset_;
+
+	[[noreturn]] void invalid(const char *reason) const
+	{
+		std::stringstream ss;
+		ss << "Invalid batch file " << path_ << " at offset " << offset_ << ": " << reason;
+		throw std::runtime_error(ss.str());
+	}
+
+	const char *take(std::size_t bytes)
+	{
+		if (bytes > size_ - offset_)
+			invalid("truncated value");
+
+		const char *p = base_ + offset_;
+		offset_ += pad(bytes);
+		if (offset_ > size_)
+			offset_ = size_;
+		return p;
+	}
+
+	public:
+	batch_reader(const std::string &path, std::shared_ptr<const void> mapping, std::size_t size)
+	: path_(path), mapping_(std::move(mapping)), base_(static_cast<const char *>(mapping_.get())), size_(size),
+	  offset_(0)
+	{
+	}
+
+	batch_header header()
+	{
+		batch_header header;
+		std::memcpy(&header, take(sizeof(header)), sizeof(header));
+
+		if (std::memcmp(header.magic, batch_magic, sizeof(header.magic)) != 0)
+			invalid("bad magic");
+		if (header.byte_order != batch_byte_order)
+			invalid("written with another byte order");
+
+		return header;
+	}
+
+	/**
+	 * @brief Gets the number of bytes left to decode
+	 */
+	std::size_t remaining() const
+	{ return size_ - offset_; }
+
+	batch_value value(int nesting)
+	{
+		value_header vh;
+		std::memcpy(&vh, take(sizeof(vh)), sizeof(vh));
+
+		switch (vh.kind)
+		{
+		case batch_value::kind_bool:
+		case batch_value::kind_int:
+		case batch_value::kind_unsigned:
+		{
+			batch_value result;
+			result.kind = static_cast<batch_value::value_kind>(vh.kind);
+			std::memcpy(&result.integer, take(sizeof(std::int64_t)), sizeof(std::int64_t));
+			return result;
+		}
+		case batch_value::kind_float:
+		{
+			double real;
+			std::memcpy(&real, take(sizeof(double)), sizeof(double));
+			batch_value result(static_cast<float>(real));
+			result.real = real;
+			return result;
+		}
+		case batch_value::kind_string:
+		case batch_value::kind_error:
+		{
+			batch_value result(std::string(take(vh.size), vh.size));
+			result.kind = static_cast<batch_value::value_kind>(vh.kind);
+			return result;
+		}
+		case batch_value::kind_matrix:
+		{
+			if (vh.size < 1 || vh.size > 8)
+				invalid("bad matrix depth");
+
+			std::vector<int> dims(vh.size);
+			std::memcpy(dims.data(), take(vh.size * sizeof(std::int32_t)), vh.size * sizeof(std::int32_t));
+
+			std::size_t count = 1;
+			for (int d : dims)
+			{
+				if (d < 0 || (d > 0 && count > (size_ / sizeof(float)) / std::size_t(d)))
+					invalid("bad matrix dimensions");
+				count *= d;
+			}
+
+			// Elements are 8-byte aligned in the file, and the mapping is page-aligned
+			const float *data = reinterpret_cast<const float *>(take(count * sizeof(float)));
+			return batch_value(mapped_matrix<float>::make(mapping_, data, std::move(dims)));
+		}
+		case batch_value::kind_list:
+		{
+			if (nesting >= batch_max_nesting)
+				invalid("lists nested too deeply");
+			if (vh.size > (size_ - offset_) / sizeof(value_header))
+				invalid("truncated list");
+
+			batch_value result;
+			result.items.reserve(vh.size);
+			for (std::uint32_t i = 0; i < vh.size; ++i)
+				result.items.push_back(value(nesting + 1));
+			return result;
+		}
+		default:
+			invalid("bad value kind");
+		}
+	}
+};
+
+void write_value(std::ostream &os, const batch_value &value)
+{
+	static const char padding[8] = { 0 };
+
+	auto write_padded = [&](const void *data, std::size_t bytes) {
+		os.write(static_cast<const char *>(data), bytes);
+		os.write(padding, pad(bytes) - bytes);
+	};
+
+	value_header vh;
+	vh.kind = value.kind;
+	vh.size = 0;
+
+	switch (value.kind)
+	{
+	case batch_value::kind_bool:
+	case batch_value::kind_int:
+	case batch_value::kind_unsigned:
+		os.write(reinterpret_cast<const char *>(&vh), sizeof(vh));
+		os.write(reinterpret_cast<const char *>(&value.integer), sizeof(value.integer));
+		break;
+	case batch_value::kind_float:
+		os.write(reinterpret_cast<const char *>(&vh), sizeof(vh));
+		os.write(reinterpret_cast<const char *>(&value.real), sizeof(value.real));
+		break;
+	case batch_value::kind_string:
+	case batch_value::kind_error:
+		vh.size = static_cast<std::uint32_t>(value.text.size());
+		os.write(reinterpret_cast<const char *>(&vh), sizeof(vh));
+		write_padded(value.text.data(), value.text.size());
+		break;
+	case batch_value::kind_matrix:
+	{
+		const basic_matrix<float> &m(*value.matrix);
+		std::vector<std::int32_t> dims(m.dims(), m.dims() + m.depth());
+		std::size_t count = 1;
+		for (auto d : dims)
+			count *= d;
+
+		vh.size = static_cast<std::uint32_t>(dims.size());
+		os.write(reinterpret_cast<const char *>(&vh), sizeof(vh));
+		write_padded(dims.data(), dims.size() * sizeof(std::int32_t));
+
+		if (m.row_major())
+		{
+			write_padded(m.data(), count * sizeof(float));
+		}
+		else
+		{
+			std::vector<float> row_major(count);
+			m.copy_to(row_major.data());
+			write_padded(row_major.data(), count * sizeof(float));
+		}
+		break;
+	}
+	case batch_value::kind_list:
+		vh.size = static_cast<std::uint32_t>(value.items.size());
+		os.write(reinterpret_cast<const char *>(&vh), sizeof(vh));
+		for (const auto &item : value.items)
+			write_value(os, item);
+		break;
+	}
+}
+}
+
+std::vector<batch_record> omw::read_batch_file(const std::string &path)
+{
+	std::size_t size = 0;
+	auto mapping(map_file(path, size));
+	if (!mapping)
+		throw std::runtime_error("Batch file " + path + " does not exist");
+
+	batch_reader reader(path, mapping, size);
+	batch_header header(reader.header());
+
+	// Every record takes at least a value header
+	if (header.record_count > reader.remaining() / sizeof(value_header))
+		throw std::runtime_error("Invalid batch file " + path + ": truncated records");
+
+	std::vector<batch_record> records;
+	records.reserve(header.record_count);
+	for (std::uint32_t i = 0; i < header.record_count; ++i)
+		records.push_back(reader.value(0));
+
+	return records;
+}
+
+void omw::write_batch_file(const std::string &path, const std::vector<batch_record> &records)
+{
+	batch_header header;
+	std::memcpy(header.magic, batch_magic, sizeof(header.magic));
+	header.byte_order = batch_byte_order;
+	header.record_count = static_cast<std::uint32_t>(records.size());
+
+	const std::string tmp_path(path + ".tmp");
+	{
+		std::ofstream file(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file)
+			throw std::runtime_error("Cannot write batch file " + tmp_path);
+
+		file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		for (const auto &record : records)
+			write_value(file, record);
+
+		if (!file)
+			throw std::runtime_error("Cannot write batch file " + tmp_path);
+	}
+
+	if (std::rename(tmp_path.c_str(), path.c_str()) != 0)
+		throw std::runtime_error("Cannot replace batch file " + path + ": " + std::strerror(errno));
+}
@@ -0,0 +1,276 @@
+#include <iomanip>
+#include <sstream>
+
+#include "omw/call_profiler.hpp"
+
+using namespace omw;
+
+const char *omw::call_phase_name(call_phase phase)
+{
+	switch (phase)
+	{
+	case phase_decode:
+		return "decode";
+	case phase_user:
+		return "user";
+	case phase_encode:
+		return "encode";
+	default:
+		return "unknown";
+	}
+}
+
+phase_sample &phase_sample::operator+=(const phase_sample &other)
+{
+	nanoseconds += other.nanoseconds;
+	for (int i = 0; i < perf_event_count; ++i)
+		counters[i] += other.counters[i];
+	return *this;
+}
+
+void latency_histogram::add(std::uint64_t nanoseconds)
+{
+	int bucket = 0;
+	while (bucket < bucket_count && nanoseconds > upper_bound(bucket))
+		++bucket;
+
+	counts[bucket]++;
+}
+
+std::uint64_t latency_histogram::quantile(double q) const
+{
+	std::uint64_t total = 0;
+	for (auto count : counts)
+		total += count;
+
+	if (total == 0)
+		return 0;
+
+	// Rank of the quantile, the first sample has rank 1
+	const double rank = q * total;
+	std::uint64_t seen = 0;
+
+	for (int bucket = 0; bucket < bucket_count; ++bucket)
+	{
+		seen += counts[bucket];
+		if (seen >= rank && seen > 0)
+			return upper_bound(bucket);
+	}
+
+	// Past the last bound, the best estimate is the last bound
+	return upper_bound(bucket_count - 1);
+}
+
+call_profiler::call_profiler()
+	: enabled_(false), counters_(), functions_(), slow_calls_(), in_call_(false), current_function_(),
+	current_phase_(phase_user), current_bytes_in_(0), current_bytes_out_(0)
+{
+}
+
+bool call_profiler::hardware_counters(bool enable)
+{
+	if (!enable)
+	{
+		counters_.reset();
+		return false;
+	}
+
+	if (!counters_)
+		counters_.reset(new perf_counters());
+
+	return counters_->available();
+}
+
+void call_profiler::snapshot(std::chrono::steady_clock::time_point &time, perf_reading &counters) const
+{
+	if (counters_)
+		counters_->read(counters);
+	else
+		counters = perf_reading();
+
+	time = std::chrono::steady_clock::now();
+}
+
+void call_profiler::begin_call(const char *function)
+{
+	if (!enabled_ && !slow_calls_.enabled())
+		return;
+
+	in_call_ = true;
+	current_function_ = function;
+	current_phase_ = phase_user;
+
+	for (auto &sample : current_call_)
+		sample = phase_sample();
+
+	current_arguments_.clear();
+	current_results_.clear();
+	current_bytes_in_ = 0;
+	current_bytes_out_ = 0;
+
+	snapshot(phase_start_, phase_counters_);
+}
+
+void call_profiler::close_phase()
+{
+	std::chrono::steady_clock::time_point now;
+	perf_reading counters;
+	snapshot(now, counters);
+
+	// Attribute what happened since the last switch to the current phase
+	phase_sample &sample(current_call_[current_phase_]);
+	sample.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(now - phase_start_).count();
+
+	std::uint64_t deltas[perf_event_count];
+	counters.elapsed_since(phase_counters_, deltas);
+	for (int i = 0; i < perf_event_count; ++i)
+		sample.counters[i] += deltas[i];
+
+	phase_start_ = now;
+	phase_counters_ = counters;
+}
+
+call_phase call_profiler::switch_phase(call_phase phase)
+{
+	call_phase previous = current_phase_;
+	if (!in_call_ || phase == previous)
+		return previous;
+
+	close_phase();
+	current_phase_ = phase;
+	return previous;
+}
+
+void call_profiler::end_call(bool failed)
+{
+	if (!in_call_)
+		return;
+
+	close_phase();
+	in_call_ = false;
+
+	std::uint64_t total = 0;
+	for (int p = 0; p < call_phase_count; ++p)
+		total += current_call_[p].nanoseconds;
+
+	if (enabled_)
+	{
+		function_profile &profile(functions_[current_function_]);
+		profile.calls++;
+		if (failed)
+			profile.failures++;
+
+		for (int p = 0; p < call_phase_count; ++p)
+		{
+			profile.phases[p] += current_call_[p];
+			profile.phase_latency[p].add(current_call_[p].nanoseconds);
+		}
+
+		if (total > profile.max_nanoseconds)
+			profile.max_nanoseconds = total;
+
+		profile.bytes_in += current_bytes_in_;
+		profile.bytes_out += current_bytes_out_;
+	}
+
+	if (slow_calls_.enabled() && total >= slow_calls_.threshold())
+	{
+		slow_call_record record;
+		record.function = current_function_;
+		record.arguments = std::move(current_arguments_);
+		record.results = std::move(current_results_);
+		record.total_nanoseconds = total;
+		record.failed = failed;
+
+		for (int p = 0; p < call_phase_count; ++p)
+			record.phase_nanoseconds.push_back(current_call_[p].nanoseconds);
+
+		slow_calls_.add(std::move(record));
+	}
+}
+
+void call_profiler::reset()
+{
+	functions_.clear();
+}
+
+std::string call_profiler::report() const
+{
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(3);
+
+	for (const auto &entry : functions_)
+	{
+		const function_profile &profile(entry.second);
+		if (profile.calls == 0)
+			continue;
+
+		ss << entry.first << ": " << profile.calls << " calls, " << profile.failures << " failures, max "
+		   << profile.max_nanoseconds / 1e6 << " ms" << std::endl;
+
+		for (int p = 0; p < call_phase_count; ++p)
+		{
+			const phase_sample &sample(profile.phases[p]);
+			ss << "  " << std::setw(6) << call_phase_name(call_phase(p)) << ": mean "
+			   << sample.nanoseconds / 1e6 / profile.calls << " ms";
+
+			if (hardware_counters())
+			{
+				for (int i = 0; i < perf_event_count; ++i)
+					if (counters_->available(perf_event(i)))
+						ss << ", " << perf_event_name(perf_event(i)) << " " << sample.counters[i] / profile.calls;
+			}
+
+			ss << std::endl;
+		}
+	}
+
+	if (counters_ && !counters_->available())
+		ss << "hardware counters unavailable: " << counters_->error() << std::endl;
+
+	return ss.str();
+}
+
+void call_profiler::write_metrics(metrics_writer &writer) const
+{
+	static const double quantiles[] = { 0.5, 0.9, 0.99 };
+
+	writer.family("omw_calls_total", "counter", "Number of calls to wrapped functions");
+	for (const auto &entry : functions_)
+		writer.sample("", metrics_writer::label("function", entry.first), entry.second.calls);
+
+	writer.family("omw_call_failures_total", "counter", "Number of wrapped calls that failed");
+	for (const auto &entry : functions_)
+		writer.sample("", metrics_writer::label("function", entry.first), entry.second.failures);
+
+	writer.family("omw_phase_seconds", "summary", "Time spent per call phase");
+	for (const auto &entry : functions_)
+	{
+		const function_profile &profile(entry.second);
+
+		for (int p = 0; p < call_phase_count; ++p)
+		{
+			const std::string labels(metrics_writer::label("function", entry.first) + "," +
+									 metrics_writer::label("phase", call_phase_name(call_phase(p))));
+
+			for (double q : quantiles)
+			{
+				std::stringstream ql;
+				ql << q;
+				writer.sample("", labels + "," + metrics_writer::label("quantile", ql.str()),
+							  profile.phase_latency[p].quantile(q) / 1e9);
+			}
+
+			writer.sample("_sum", labels, profile.phases[p].nanoseconds / 1e9);
+			writer.sample("_count", labels, profile.calls);
+		}
+	}
+
+	writer.family("omw_marshaled_bytes_total", "counter", "Bytes of data exchanged with the host");
+	for (const auto &entry : functions_)
+	{
+		const std::string function(metrics_writer::label("function", entry.first));
+		writer.sample("", function + "," + metrics_writer::label("direction", "in"), entry.second.bytes_in);
+		writer.sample("", function + "," + metrics_writer::label("direction", "out"), entry.second.bytes_out);
+	}
+}
@@ -0,0 +1,103 @@
+#include <cstring>
+
+#include "omw/dictionary.hpp"
+
+using namespace omw;
+
+/**
+ * @brief Hashes a key with 32-bit FNV-1a
+ */
+static std::uint32_t hash_key(const char *key, std::size_t key_size)
+{
+	std::uint32_t hash = 2166136261u;
+	for (std::size_t i = 0; i < key_size; ++i)
+	{
+		hash ^= static_cast<unsigned char>(key[i]);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+const std::uint32_t dictionary::empty_slot;
+
+dictionary::dictionary() : m_keys(), m_entries(), m_slots() {}
+
+std::size_t dictionary::probe(const char *key, std::size_t key_size, std::uint32_t hash) const
+{
+	const std::size_t mask = m_slots.size() - 1;
+
+	for (std::size_t slot = hash & mask;; slot = (slot + 1) & mask)
+	{
+		const std::uint32_t idx = m_slots[slot];
+		if (idx == empty_slot)
+			return slot;
+
+		// Stored hashes rule out most mismatches before comparing keys
+		const entry &e(m_entries[idx]);
+		if (e.hash == hash && e.key_size == key_size && std::memcmp(m_keys.data() + e.key_offset, key, key_size) == 0)
+			return slot;
+	}
+}
+
+void dictionary::rehash(std::size_t slots)
+{
+	m_slots.assign(slots, empty_slot);
+
+	const std::size_t mask = slots - 1;
+	for (std::uint32_t idx = 0; idx < m_entries.size(); ++idx)
+	{
+		std::size_t slot = m_entries[idx].hash & mask;
+		while (m_slots[slot] != empty_slot)
+			slot = (slot + 1) & mask;
+
+		m_slots[slot] = idx;
+	}
+}
+
+void dictionary::reserve(std::size_t entries, std::size_t key_bytes)
+{
+	m_keys.reserve(key_bytes);
+	m_entries.reserve(entries);
+
+	// Keep the load factor at most 3/4
+	std::size_t slots = 16;
+	while (slots * 3 < entries * 4)
+		slots *= 2;
+
+	if (slots > m_slots.size())
+		rehash(slots);
+}
+
+bool dictionary::insert(const char *key, std::size_t key_size, dictionary_value value)
+{
+	if ((m_entries.size() + 1) * 4 > m_slots.size() * 3)
+		rehash(m_slots.empty() ? 16 : m_slots.size() * 2);
+
+	const std::uint32_t hash = hash_key(key, key_size);
+	const std::size_t slot = probe(key, key_size, hash);
+
+	if (m_slots[slot] != empty_slot)
+	{
+		m_entries[m_slots[slot]].value = std::move(value);
+		return false;
+	}
+
+	m_slots[slot] = static_cast<std::uint32_t>(m_entries.size());
+	m_entries.push_back(entry{ static_cast<std::uint32_t>(m_keys.size()), static_cast<std::uint32_t>(key_size), hash,
+							   std::move(value) });
+	m_keys.insert(m_keys.end(), key, key + key_size);
+
+	return true;
+}
+
+const dictionary_value *dictionary::find(const char *key, std::size_t key_size) const
+{
+	if (m_slots.empty())
+		return nullptr;
+
+	const std::size_t slot = probe(key, key_size, hash_key(key, key_size));
+	if (m_slots[slot] == empty_slot)
+		return nullptr;
+
+	return &m_entries[m_slots[slot]].value;
+}
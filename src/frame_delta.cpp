@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "omw/matrix.hpp"
+#include "omw/frame_delta.hpp"
+
+using namespace omw;
+
+void frame_delta_encoder::frame_delta::copy_tile(const tile &t, float *dst) const
+{
+	const size_t row_len = size_t((*dims)[1]) * channels();
+	const size_t tile_len = size_t(t.cols) * channels();
+
+	for (int r = 0; r < t.rows; ++r)
+		std::memcpy(dst + r * tile_len, data + (t.row + r) * row_len + t.col * channels(), tile_len * sizeof(float));
+}
+
+frame_delta_encoder::frame_delta_encoder(int tile_size)
+	: tile_size_(tile_size), next_sequence_(1), streams_(), tiles_sent_(0), tiles_total_(0)
+{
+	if (tile_size_ <= 0)
+		throw std::runtime_error("Tile size must be positive");
+}
+
+void frame_delta_encoder::tile_size(int new_tile_size)
+{
+	if (new_tile_size <= 0)
+		throw std::runtime_error("Tile size must be positive");
+
+	tile_size_ = new_tile_size;
+	reset();
+}
+
+frame_delta_encoder::frame_delta frame_delta_encoder::encode(const std::string &stream_id, const basic_matrix<float> &frame)
+{
+	if (frame.depth() < 2 || frame.depth() > 3)
+		throw std::runtime_error("Frames must be matrices of depth 2 or 3");
+
+	std::vector<int> dims(frame.dims(), frame.dims() + frame.depth());
+	const size_t length = size_t(dims[0]) * dims[1] * (dims.size() == 3 ? dims[2] : 1);
+
+	// Get the frame in row-major order
+	std::vector<float> row_major;
+	const float *src;
+
+	if (frame.row_major())
+	{
+		src = frame.data();
+	}
+	else
+	{
+		row_major.resize(length);
+		frame.copy_to(row_major.data());
+		src = row_major.data();
+	}
+
+	stream_state &state(streams_.emplace(stream_id, stream_state{ {}, {}, 0 }).first->second);
+
+	frame_delta delta;
+	delta.key_frame = state.dims != dims;
+	delta.base = delta.key_frame ? 0 : state.sequence;
+	delta.sequence = state.sequence = next_sequence_++;
+	delta.dims = &state.dims;
+
+	const int tiles_y = (dims[0] + tile_size_ - 1) / tile_size_;
+	const int tiles_x = (dims[1] + tile_size_ - 1) / tile_size_;
+	delta.total_tiles = size_t(tiles_x) * tiles_y;
+
+	if (delta.key_frame)
+	{
+		// No usable previous frame, send everything as a single tile
+		state.dims = std::move(dims);
+		state.last.assign(src, src + length);
+
+		delta.tiles.push_back(tile{ 0, 0, state.dims[0], state.dims[1] });
+		delta.data = state.last.data();
+
+		tiles_sent_ += delta.total_tiles;
+		tiles_total_ += delta.total_tiles;
+		return delta;
+	}
+
+	const int channels = dims.size() == 3 ? dims[2] : 1;
+	const size_t row_len = size_t(dims[1]) * channels;
+
+	for (int ty = 0; ty < tiles_y; ++ty)
+	{
+		for (int tx = 0; tx < tiles_x; ++tx)
+		{
+			tile t{ ty * tile_size_, tx * tile_size_, std::min(tile_size_, dims[0] - ty * tile_size_),
+					std::min(tile_size_, dims[1] - tx * tile_size_) };
+
+			const size_t tile_bytes = size_t(t.cols) * channels * sizeof(float);
+
+			// Compare the tile row by row; memcmp is vectorized by the C library
+			// and stops at the first difference
+			int r = 0;
+			for (; r < t.rows; ++r)
+			{
+				size_t offset = (t.row + r) * row_len + t.col * channels;
+				if (std::memcmp(src + offset, state.last.data() + offset, tile_bytes) != 0)
+					break;
+			}
+
+			if (r == t.rows)
+				continue;
+
+			// Update the remembered frame with the changed rows
+			for (; r < t.rows; ++r)
+			{
+				size_t offset = (t.row + r) * row_len + t.col * channels;
+				std::memcpy(state.last.data() + offset, src + offset, tile_bytes);
+			}
+
+			delta.tiles.push_back(t);
+		}
+	}
+
+	delta.data = state.last.data();
+
+	tiles_sent_ += delta.tiles.size();
+	tiles_total_ += delta.total_tiles;
+	return delta;
+}
+
+int frame_delta_encoder::sequence(const std::string &stream_id) const
+{
+	auto it = streams_.find(stream_id);
+	return it == streams_.end() ? 0 : it->second.sequence;
+}
+
+void frame_delta_encoder::reset(const std::string &stream_id)
+{
+	streams_.erase(stream_id);
+}
+
+void frame_delta_encoder::reset()
+{
+	streams_.clear();
+}
@@ -5,7 +5,15 @@
 #include <sstream>
 
 #include "omw/array.hpp"
+#include "omw/bitmask.hpp"
+#include "omw/dictionary.hpp"
+#include "omw/graphics.hpp"
 #include "omw/matrix.hpp"
+#include "omw/matrix_batch.hpp"
+#include "omw/matrix_view.hpp"
+#include "omw/ragged_array.hpp"
+#include "omw/range_view.hpp"
+#include "omw/tiled_matrix.hpp"
 #include "omw/wrapper_base.hpp"
 
 #include "omw/mathematica.hpp"
@@ -99,10 +107,16 @@ std::string mathematica_unescape(const std::string &source)
 
 mathematica::mathematica(const std::string &mathNamespace, WSLINK &link, std::function<void(void)> userInitializer)
 : wrapper_base<mathematica>(std::forward<std::function<void(void)>>(userInitializer)),
-  current_param_idx_(std::numeric_limits<size_t>::max()), math_namespace_(mathNamespace), link(link)
+  current_param_idx_(std::numeric_limits<size_t>::max()), math_namespace_(mathNamespace), flush_policy_(),
+  pipelining_(false), pending_calls_(0), pending_bytes_(0), pipelined_calls_(0), pipelined_flushes_(0), link(link)
 {
 }
 
+mathematica::~mathematica()
+{
+	stop_metrics();
+}
+
 mathematica::param_reader_base::param_reader_base(mathematica &w) : w_(w) {}
 
 void mathematica::param_reader_base::check_parameter_idx(size_t paramIdx, const std::string &paramName)
@@ -118,6 +132,15 @@ void mathematica::param_reader_base::check_parameter_idx(size_t paramIdx, const
 
 bool mathematica::run_function(std::function<void(mathematica &)> fun)
 {
+	return run_function("", fun);
+}
+
+bool mathematica::run_function(const char *name, std::function<void(mathematica &)> fun)
+{
+	bool failed = false;
+	std::lock_guard<call_mutex> lock(metrics().state_mutex());
+	profiler().begin_call(name);
+
 	try
 	{
 		current_param_idx_ = 0;
@@ -127,20 +150,140 @@ bool mathematica::run_function(std::function<void(mathematica &)> fun)
 
 		if (!has_result_)
 		{
+			deliver_messages();
 			WSPutSymbol(link, "Null");
 		}
 	}
 	catch (std::exception &ex)
 	{
+		failed = true;
 		send_failure(ex.what());
 	}
 
+	profiler().end_call(failed);
+
 	current_param_idx_ = std::numeric_limits<size_t>::max();
 	return true;
 }
 
+bool mathematica::run_pipelined()
+{
+	std::lock_guard<call_mutex> lock(metrics().state_mutex());
+
+	int count;
+	if (!WSTestHead(link, "List", &count))
+	{
+		WSClearError(link);
+		send_failure("Pipelined calls must be given as a list");
+		return true;
+	}
+
+	pipelining_ = true;
+	pending_calls_ = 0;
+	pending_bytes_ = 0;
+	pipeline_messages_.clear();
+
+	WSPutFunction(link, "List", 2);
+	WSPutFunction(link, "List", count);
+
+	for (int i = 0; i < count; ++i)
+	{
+		run_pipelined_call(i);
+
+		pending_calls_++;
+		pipelined_calls_++;
+
+		// The answer is flushed by the mprep loop, so the last call never needs it
+		if (i + 1 < count && flush_policy_.should_flush(pending_calls_, pending_bytes_))
+		{
+			WSFlush(link);
+			pipelined_flushes_++;
+
+			pending_calls_ = 0;
+			pending_bytes_ = 0;
+		}
+	}
+
+	pipelining_ = false;
+
+	// Messages are held, since the answer is already being written
+	WSPutFunction(link, "List", pipeline_messages_.size());
+	for (const auto &message : pipeline_messages_)
+	{
+		WSPutFunction(link, "Hold", 1);
+		put_message(message);
+	}
+
+	pipeline_messages_.clear();
+	return true;
+}
+
+void mathematica::run_pipelined_call(size_t index)
+{
+	// Calls are skipped as a whole from this mark, however many arguments were read
+	auto mark = place_mark();
+	has_result_ = false;
+
+	int argc;
+	const char *name = nullptr;
+	std::string function_name;
+
+	if (WSTestHead(link, "List", &argc) && argc >= 1 && WSGetString(link, &name))
+	{
+		function_name = name;
+		WSReleaseString(link, name);
+	}
+	else
+	{
+		WSClearError(link);
+	}
+
+	auto function = mathematica_function::registry().find(function_name);
+	if (function == mathematica_function::registry().end())
+	{
+		std::stringstream ss;
+		ss << "Pipelined call " << index + 1 << " is not a call to a registered function";
+		send_failure(ss.str());
+	}
+	else
+	{
+		bool failed = false;
+		profiler().begin_call(function->second->name().c_str());
+
+		try
+		{
+			current_param_idx_ = 0;
+			has_result_ = false;
+
+			function->second->function()(*this);
+
+			if (!has_result_)
+			{
+				deliver_messages();
+				WSPutSymbol(link, "Null");
+			}
+		}
+		catch (std::exception &ex)
+		{
+			failed = true;
+			send_failure(ex.what());
+		}
+
+		profiler().end_call(failed);
+		current_param_idx_ = std::numeric_limits<size_t>::max();
+	}
+
+	WSClearError(link);
+	WSSeekToMark(link, mark.get(), 0);
+	WSTransferExpression(static_cast<WSLINK>(0), link);
+}
+
 void mathematica::evaluate_result(std::function<void(void)> fun)
 {
+	// Messages must reach the kernel before the answer
+	if (!has_result_)
+		deliver_messages();
+
 	fun();
 	has_result_ = true;
 }
@@ -150,25 +293,197 @@ mathematica::result_writer_base::result_writer_base(mathematica &w)
 {
 }
 
-void mathematica::send_failure(const std::string &exceptionMessage, const std::string &messageName)
+void mathematica::write_frame(const std::string &stream_id, const std::shared_ptr<basic_matrix<float>> &frame,
+							  int host_sequence)
+{
+	profile_results(frame);
+	call_profiler::phase_scope scope(profiler(), phase_encode);
+
+	evaluate_result([this, &stream_id, &frame, host_sequence]() {
+		// The last patch may not have been applied, if its result was discarded or the
+		// call aborted. Within a pipelined batch, the sequence was evaluated before the
+		// earlier calls of the batch, so it is only checked outside of batches.
+		if (!pipelining_ && host_sequence >= 0 && host_sequence != frames_.sequence(stream_id))
+			frames_.reset(stream_id);
+
+		auto delta(frames_.encode(stream_id, *frame));
+		const int channels = delta.channels();
+
+		if (matrices_as_images())
+			WSPutFunction(link, "Image", 1);
+
+		// ApplyFramePatch[id, sequence, base, dims, {{row, col, tile}...}]
+		WSPutFunction(link, (math_namespace_ + "`ApplyFramePatch").c_str(), 5);
+		WSPutString(link, stream_id.c_str());
+		WSPutInteger32(link, delta.sequence);
+		WSPutInteger32(link, delta.base);
+		WSPutInteger32List(link, delta.dims->data(), delta.dims->size());
+		WSPutFunction(link, "List", delta.tiles.size());
+
+		std::vector<float> buffer;
+		for (const auto &t : delta.tiles)
+		{
+			buffer.resize(size_t(t.rows) * t.cols * channels);
+			delta.copy_tile(t, buffer.data());
+
+			int tile_dims[3] = { t.rows, t.cols, channels };
+
+			WSPutFunction(link, "List", 3);
+			WSPutInteger32(link, t.row);
+			WSPutInteger32(link, t.col);
+			WSPutReal32Array(link, buffer.data(), tile_dims, NULL, delta.dims->size());
+		}
+	});
+}
+
+void mathematica::write_metrics(metrics_writer &writer)
+{
+	wrapper_base<mathematica>::write_metrics(writer);
+
+	writer.family("omw_frame_tiles_total", "counter", "Number of frame tiles compared by write_frame");
+	writer.sample("", "", frames_.tiles_total());
+
+	writer.family("omw_frame_tiles_sent_total", "counter", "Number of changed frame tiles sent by write_frame");
+	writer.sample("", "", frames_.tiles_sent());
+
+	writer.family("omw_frame_tile_hit_ratio", "gauge", "Fraction of frame tiles reused from the previous frame");
+	writer.sample("", "", frames_.tiles_total() == 0 ? 0.0 : 1.0 - double(frames_.tiles_sent()) / frames_.tiles_total());
+
+	writer.family("omw_pipelined_calls_total", "counter", "Number of calls run in pipelined batches");
+	writer.sample("", "", pipelined_calls_);
+
+	writer.family("omw_pipelined_flushes_total", "counter", "Number of link flushes within pipelined batches");
+	writer.sample("", "", pipelined_flushes_);
+}
+
+void mathematica::send_preview(const std::string &id, const std::shared_ptr<basic_matrix<float>> &preview)
 {
-	WSNewPacket(link);
 	WSPutFunction(link, "EvaluatePacket", 1);
-	WSPutFunction(link, "Message", 2);
-	WSPutFunction(link, "MessageName", 2);
-	WSPutSymbol(link, math_namespace_.c_str());
-	WSPutString(link, messageName.c_str());
-	WSPutString(link, exceptionMessage.c_str());
+	WSPutFunction(link, (math_namespace_ + "`SetPreview").c_str(), 2);
+	WSPutString(link, id.c_str());
+
+	result_writer<std::shared_ptr<basic_matrix<float>>, void> writer(*this);
+	writer(preview);
+
+	WSEndPacket(link);
 	WSFlush(link);
-	WSNextPacket(link);
 
+	// Discard the result of the evaluation
+	WSNextPacket(link);
 	WSNewPacket(link);
+}
+
+void mathematica::stream_progressive(const std::string &id, const std::shared_ptr<basic_matrix<float>> &matrix, int levels)
+{
+	progressive().begin(id, matrix, levels);
+
+	// All levels but the last one are previews
+	while (progressive().remaining(id) > 1)
+		send_preview(id, progressive().next(id));
+
+	write_result(progressive().next(id));
+}
+
+void mathematica::send_failure(const std::string &exceptionMessage, const std::string &messageName)
+{
+	if (has_result_)
+	{
+		// The result of the call is already written and cannot be replaced, a second
+		// expression would shift the answers of a pipelined batch. Only report the error,
+		// with the messages of the batch or else of the next call.
+		messages().push(message_error, messageName, exceptionMessage);
+		if (pipelining_)
+			deliver_messages();
+		return;
+	}
+
+	// The failure is sent along with the messages queued by the call
+	if (!pipelining_)
+		WSNewPacket(link);
+
+	messages().push(message_error, messageName, exceptionMessage);
+	deliver_messages();
+
 	WSPutSymbol(link, "$Failed");
 
 	// Note that send_failure sends a result
 	has_result_ = true;
 }
 
+void mathematica::send_messages(const std::vector<queued_message> &messages)
+{
+	if (pipelining_)
+	{
+		// The messages are sent with the answer of the batch, see run_pipelined
+		pipeline_messages_.insert(pipeline_messages_.end(), messages.begin(), messages.end());
+		return;
+	}
+
+	WSPutFunction(link, "EvaluatePacket", 1);
+	WSPutFunction(link, "CompoundExpression", messages.size());
+	for (const auto &message : messages)
+		put_message(message);
+
+	WSEndPacket(link);
+	WSFlush(link);
+
+	// Discard the result of the evaluation
+	WSNextPacket(link);
+	WSNewPacket(link);
+}
+
+void mathematica::put_message(const queued_message &message)
+{
+	if (message.kind == message_progress)
+	{
+		WSPutFunction(link, (math_namespace_ + "`SetProgress").c_str(), 1);
+		WSPutString(link, message.text.c_str());
+		return;
+	}
+
+	WSPutFunction(link, "Message", 2);
+	WSPutFunction(link, "MessageName", 2);
+	WSPutSymbol(link, math_namespace_.c_str());
+	WSPutString(link, message.name.c_str());
+	WSPutString(link, message.format().c_str());
+}
+
+/**
+ * @brief Validates link-owned array data in place
+ *
+ * Arrays read from WSTP are not copied, so validation and clamping are applied
+ * directly to the memory returned by the link.
+ *
+ * @param data      Array data
+ * @param length    Number of elements in the array
+ * @param options   Validation options
+ * @param paramName User-friendly name of the parameter
+ * @return Statistics gathered during validation
+ * @throws std::runtime_error If an element is rejected
+ */
+static array_stats validate_in_place(float *data, size_t length, const validation_options &options,
+									 const std::string &paramName)
+{
+	validator<float> validate(options, paramName);
+
+	for (size_t i = 0; i < length; ++i)
+		data[i] = validate(data[i]);
+
+	return validate.stats();
+}
+
+mathematica_function::mathematica_function(const char *name, std::function<void(mathematica &)> fun)
+: name_(name), fun_(std::move(fun))
+{
+	registry()[name_] = this;
+}
+
+std::map<std::string, const mathematica_function *> &mathematica_function::registry()
+{
+	static std::map<std::string, const mathematica_function *> functions;
+	return functions;
+}
+
 std::shared_ptr<MLinkMark> mathematica::place_mark()
 {
 	MLinkMark *mark = WSCreateMark(link);
@@ -379,9 +694,15 @@ mathematica::param_reader<std::shared_ptr<basic_array<float>>>::try_read(size_t
 
 	if (getData)
 	{
+		auto result(mathematica_array<float>::make(arrayData, arrayLen, w_.link, WSReleaseReal32List));
+
+		const validation_options &options(w_.param_validation());
+		if (options.enabled())
+			result->stats(validate_in_place(arrayData, arrayLen, options, paramName));
+
 		w_.current_param_idx_++;
 
-		return mathematica_array<float>::make(arrayData, arrayLen, w_.link, WSReleaseReal32List);
+		return result;
 	}
 	else
 	{
@@ -419,9 +740,21 @@ mathematica::param_reader<std::shared_ptr<basic_matrix<float>>>::try_read(size_t
 
 	if (getData)
 	{
+		auto result(mathematica_matrix<float>::make(arrayData, arrayDims, arrayDepth, arrayHeads, w_.link, WSReleaseReal32Array));
+
+		const validation_options &options(w_.param_validation());
+		if (options.enabled())
+		{
+			size_t length = 1;
+			for (int i = 0; i < arrayDepth; ++i)
+				length *= arrayDims[i];
+
+			result->stats(validate_in_place(arrayData, length, options, paramName));
+		}
+
 		w_.current_param_idx_++;
 
-		return mathematica_matrix<float>::make(arrayData, arrayDims, arrayDepth, arrayHeads, w_.link, WSReleaseReal32Array);
+		return result;
 	}
 	else
 	{
@@ -433,6 +766,413 @@ mathematica::param_reader<std::shared_ptr<basic_matrix<float>>>::try_read(size_t
 	}
 }
 
+template <>
+matrix_view<float>
+mathematica::param_reader<matrix_view<float>>::try_read(size_t paramIdx, const std::string &paramName,
+														bool &success, bool getData)
+{
+	// Mathematica arrays are already row-major, so the view wraps the link-owned matrix
+	auto matrix(param_reader<std::shared_ptr<basic_matrix<float>>>(w_).try_read(paramIdx, paramName, success, getData));
+
+	if (!success || !getData)
+		return {};
+
+	return matrix_view<float>::of(matrix);
+}
+
+template <>
+range_view<float>
+mathematica::param_reader<range_view<float>>::try_read(size_t paramIdx, const std::string &paramName,
+														bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	// Range[] is evaluated by the kernel, lists are read as arrays
+	success = false;
+	return {};
+}
+
+template <>
+ragged_array<float>
+mathematica::param_reader<ragged_array<float>>::try_read(size_t paramIdx, const std::string &paramName,
+														  bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	// Place mark to allow rollback if needed
+	auto mark = w_.place_mark();
+
+	int rows;
+	if (!WSTestHead(w_.link, "List", &rows))
+	{
+		WSClearError(w_.link);
+		WSSeekToMark(w_.link, mark.get(), 0);
+
+		success = false;
+		return {};
+	}
+
+	// Rows are appended as they are read from the link, in a single pass
+	ragged_array<float> result;
+	result.reserve(rows, 0);
+
+	for (int i = 0; i < rows; ++i)
+	{
+		float *rowData;
+		int rowLen;
+
+		if (!WSGetReal32List(w_.link, &rowData, &rowLen))
+		{
+			WSClearError(w_.link);
+			WSSeekToMark(w_.link, mark.get(), 0);
+
+			success = false;
+			return {};
+		}
+
+		if (getData)
+			result.push_back(rowData, rowData + rowLen);
+
+		WSReleaseReal32List(w_.link, rowData, rowLen);
+	}
+
+	if (!getData)
+	{
+		// Not in data mode, rollback
+		WSSeekToMark(w_.link, mark.get(), 0);
+		return {};
+	}
+
+	const validation_options &options(w_.param_validation());
+	if (options.enabled())
+		validate_in_place(result.data(), result.total_size(), options, paramName);
+
+	w_.current_param_idx_++;
+
+	return result;
+}
+
+template <>
+matrix_batch<float>
+mathematica::param_reader<matrix_batch<float>>::try_read(size_t paramIdx, const std::string &paramName,
+														  bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	float *arrayData;
+	int *arrayDims;
+	int arrayDepth;
+	char **arrayHeads;
+
+	// Place mark to allow rollback if needed
+	auto mark = w_.place_mark();
+
+	// A list of equally shaped arrays is a full array of one more dimension on the link,
+	// so packed arrays and plain lists are both read by a single call
+	if (!WSGetReal32Array(w_.link, &arrayData, &arrayDims, &arrayHeads, &arrayDepth))
+	{
+		WSClearError(w_.link);
+		WSSeekToMark(w_.link, mark.get(), 0);
+
+		success = false;
+		return {};
+	}
+
+	if (arrayDepth < 2 || arrayDepth > 4)
+	{
+		WSReleaseReal32Array(w_.link, arrayData, arrayDims, arrayHeads, arrayDepth);
+		WSSeekToMark(w_.link, mark.get(), 0);
+
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+	{
+		// Not in data mode, release array and rollback
+		WSReleaseReal32Array(w_.link, arrayData, arrayDims, arrayHeads, arrayDepth);
+		WSSeekToMark(w_.link, mark.get(), 0);
+		return {};
+	}
+
+	matrix_batch<float> result(arrayDims[0], std::vector<int>(arrayDims + 1, arrayDims + arrayDepth));
+	std::memcpy(result.data(), arrayData, result.size() * result.item_size() * sizeof(float));
+
+	WSReleaseReal32Array(w_.link, arrayData, arrayDims, arrayHeads, arrayDepth);
+
+	const validation_options &options(w_.param_validation());
+	if (options.enabled())
+		validate_in_place(result.data(), result.size() * result.item_size(), options, paramName);
+
+	w_.current_param_idx_++;
+
+	return result;
+}
+
+template <>
+bitmask
+mathematica::param_reader<bitmask>::try_read(size_t paramIdx, const std::string &paramName,
+											 bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	unsigned char *arrayData;
+	int *arrayDims;
+	int arrayDepth;
+	char **arrayHeads;
+
+	// Place mark to allow rollback if needed
+	auto mark = w_.place_mark();
+
+	// 0/1 integer arrays are read as bytes by a single call
+	if (WSGetInteger8Array(w_.link, &arrayData, &arrayDims, &arrayHeads, &arrayDepth))
+	{
+		if (!getData)
+		{
+			// Not in data mode, release array and rollback
+			WSReleaseInteger8Array(w_.link, arrayData, arrayDims, arrayHeads, arrayDepth);
+			WSSeekToMark(w_.link, mark.get(), 0);
+			return {};
+		}
+
+		bitmask result(std::vector<int>(arrayDims, arrayDims + arrayDepth));
+
+		try
+		{
+			check_binary(arrayData, result.size(), paramName);
+		}
+		catch (...)
+		{
+			WSReleaseInteger8Array(w_.link, arrayData, arrayDims, arrayHeads, arrayDepth);
+			throw;
+		}
+
+		result.assign(arrayData);
+
+		WSReleaseInteger8Array(w_.link, arrayData, arrayDims, arrayHeads, arrayDepth);
+		w_.current_param_idx_++;
+
+		return result;
+	}
+
+	WSClearError(w_.link);
+	WSSeekToMark(w_.link, mark.get(), 0);
+
+	// Lists of True and False are sent as one symbol per element
+	int length;
+	if (!WSTestHead(w_.link, "List", &length))
+	{
+		WSClearError(w_.link);
+		WSSeekToMark(w_.link, mark.get(), 0);
+
+		success = false;
+		return {};
+	}
+
+	bitmask result(std::vector<int>{ length });
+
+	for (int i = 0; i < length; ++i)
+	{
+		const char *symbol;
+		if (!WSGetSymbol(w_.link, &symbol))
+		{
+			WSClearError(w_.link);
+			WSSeekToMark(w_.link, mark.get(), 0);
+
+			success = false;
+			return {};
+		}
+
+		const bool value = std::strcmp(symbol, "True") == 0;
+		const bool known = value || std::strcmp(symbol, "False") == 0;
+		WSReleaseSymbol(w_.link, symbol);
+
+		if (!known)
+		{
+			WSSeekToMark(w_.link, mark.get(), 0);
+
+			success = false;
+			return {};
+		}
+
+		if (value)
+			result.set(i);
+	}
+
+	if (!getData)
+	{
+		// Not in data mode, rollback
+		WSSeekToMark(w_.link, mark.get(), 0);
+		return {};
+	}
+
+	w_.current_param_idx_++;
+
+	return result;
+}
+
+/**
+ * @brief Reads the value of a dictionary entry
+ *
+ * @param link  Link to read from
+ * @param value Value to read
+ * @return false if the next expression is not a number, string, boolean or array
+ */
+static bool get_dictionary_value(WSLINK link, dictionary_value &value)
+{
+	switch (WSGetType(link))
+	{
+	case WSTKINT:
+	{
+		int number;
+		if (!WSGetInteger32(link, &number))
+			return false;
+
+		value = number;
+		return true;
+	}
+	case WSTKREAL:
+	{
+		float number;
+		if (!WSGetReal32(link, &number))
+			return false;
+
+		value = number;
+		return true;
+	}
+	case WSTKSTR:
+	{
+		const char *text;
+		if (!WSGetString(link, &text))
+			return false;
+
+		value = mathematica_unescape(text);
+		WSReleaseString(link, text);
+		return true;
+	}
+	case WSTKSYM:
+	{
+		const char *symbol;
+		if (!WSGetSymbol(link, &symbol))
+			return false;
+
+		const bool known = std::strcmp(symbol, "True") == 0 || std::strcmp(symbol, "False") == 0;
+		value = std::strcmp(symbol, "True") == 0;
+		WSReleaseSymbol(link, symbol);
+		return known;
+	}
+	case WSTKFUNC:
+	{
+		float *arrayData;
+		int *arrayDims;
+		int arrayDepth;
+		char **arrayHeads;
+
+		if (!WSGetReal32Array(link, &arrayData, &arrayDims, &arrayHeads, &arrayDepth))
+			return false;
+
+		value = std::shared_ptr<basic_matrix<float>>(
+			mathematica_matrix<float>::make(arrayData, arrayDims, arrayDepth, arrayHeads, link, WSReleaseReal32Array));
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+template <>
+dictionary
+mathematica::param_reader<dictionary>::try_read(size_t paramIdx, const std::string &paramName,
+												bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	// Place mark to allow rollback if needed
+	auto mark = w_.place_mark();
+
+	// Associations, or lists of rules
+	int length;
+	if (!WSTestHead(w_.link, "Association", &length))
+	{
+		WSClearError(w_.link);
+		WSSeekToMark(w_.link, mark.get(), 0);
+
+		if (!WSTestHead(w_.link, "List", &length))
+		{
+			WSClearError(w_.link);
+			WSSeekToMark(w_.link, mark.get(), 0);
+
+			success = false;
+			return {};
+		}
+	}
+
+	dictionary result;
+	result.reserve(length, 0);
+
+	// Entries are decoded as they are read from the link, in a single pass
+	for (int i = 0; i < length; ++i)
+	{
+		int ruleLength;
+		const char *key = nullptr;
+		dictionary_value value;
+
+		if (!WSTestHead(w_.link, "Rule", &ruleLength) || ruleLength != 2 || !WSGetString(w_.link, &key) ||
+			!get_dictionary_value(w_.link, value))
+		{
+			if (key)
+				WSReleaseString(w_.link, key);
+
+			WSClearError(w_.link);
+			WSSeekToMark(w_.link, mark.get(), 0);
+
+			success = false;
+			return {};
+		}
+
+		if (getData)
+			result.insert(mathematica_unescape(key), std::move(value));
+
+		WSReleaseString(w_.link, key);
+	}
+
+	if (!getData)
+	{
+		// Not in data mode, rollback
+		WSSeekToMark(w_.link, mark.get(), 0);
+		return {};
+	}
+
+	w_.current_param_idx_++;
+
+	return result;
+}
+
+template <>
+std::shared_ptr<tiled_matrix<float>>
+mathematica::param_reader<std::shared_ptr<tiled_matrix<float>>>::try_read(size_t paramIdx, const std::string &paramName,
+																		  bool &success, bool getData)
+{
+	auto matrix(param_reader<std::shared_ptr<basic_matrix<float>>>(w_).try_read(paramIdx, paramName, success, getData));
+
+	if (!success || !getData)
+		return {};
+
+	if (matrix->depth() < 2 || matrix->depth() > 3)
+	{
+		std::stringstream ss;
+		ss << "Expected a matrix of depth 2 or 3 for parameter " << paramName << " at index " << paramIdx;
+		throw std::runtime_error(ss.str());
+	}
+
+	// Tile the link-owned array in a single pass, it is released afterwards
+	auto result(tiled_matrix<float>::make(std::vector<int>(matrix->dims(), matrix->dims() + matrix->depth()),
+										  w_.tile_size(), w_.tile_size()));
+	result->copy_from(matrix->data());
+
+	return result;
+}
+
 template <>
 void mathematica::result_writer<int, void>::operator()(const int &result)
 {
@@ -470,7 +1210,179 @@ void mathematica::result_writer<std::shared_ptr<basic_matrix<float>>, void>::ope
 	if (w_.matrices_as_images())
 		WSPutFunction(w_.link, "Image", 1);
 
-	WSPutReal32Array(w_.link, result->data(), result->dims(), NULL, result->depth());
+	if (result->row_major())
+	{
+		WSPutReal32Array(w_.link, result->data(), result->dims(), NULL, result->depth());
+	}
+	else
+	{
+		size_t length = 1;
+		for (int i = 0; i < result->depth(); ++i)
+			length *= result->dims()[i];
+
+		std::vector<float> row_major(length);
+		result->copy_to(row_major.data());
+
+		WSPutReal32Array(w_.link, row_major.data(), result->dims(), NULL, result->depth());
+	}
+}
+
+template <>
+void mathematica::result_writer<std::shared_ptr<tiled_matrix<float>>, void>::operator()(const std::shared_ptr<tiled_matrix<float>> &result)
+{
+	result_writer<std::shared_ptr<basic_matrix<float>>, void> writer(w_);
+	writer(result);
+}
+
+template <>
+void mathematica::result_writer<ragged_array<float>, void>::operator()(const ragged_array<float> &result)
+{
+	WSPutFunction(w_.link, "List", result.size());
+
+	for (std::size_t i = 0; i < result.size(); ++i)
+		WSPutReal32List(w_.link, result.row(i), result.row_size(i));
+}
+
+template <>
+void mathematica::result_writer<matrix_batch<float>, void>::operator()(const matrix_batch<float> &result)
+{
+	// Items are contiguous and row-major, the batch is sent as a single packed array
+	std::vector<int> dims(1, static_cast<int>(result.size()));
+	dims.insert(dims.end(), result.item_dims().begin(), result.item_dims().end());
+
+	WSPutReal32Array(w_.link, result.data(), dims.data(), NULL, static_cast<int>(dims.size()));
+}
+
+template <>
+void mathematica::result_writer<bitmask, void>::operator()(const bitmask &result)
+{
+	// Masks are sent as packed 0/1 integer arrays, one byte per element instead of one
+	// symbol, which Pick[list, mask, 1] uses as is
+	std::vector<unsigned char> elements(result.size());
+	result.unpack(elements.data());
+
+	WSPutInteger8Array(w_.link, elements.data(), result.dims().data(), NULL, static_cast<int>(result.dims().size()));
+}
+
+/**
+ * @brief Writes primitives of one kind under a single head, as a packed matrix of
+ * 1-based vertex indices if they all have the same number of vertices
+ *
+ * @param link    Link to write to
+ * @param head    Head of the primitives
+ * @param indices 0-based vertex indices of all the primitives
+ * @param offsets Offset of each primitive in \p indices, followed by their number
+ * @param buffer  Buffer for the 1-based indices
+ */
+static void put_primitives(WSLINK link, const char *head, const std::vector<std::uint32_t> &indices,
+						   const std::vector<std::size_t> &offsets, std::vector<int> &buffer)
+{
+	buffer.resize(indices.size());
+	for (std::size_t i = 0; i < indices.size(); ++i)
+		buffer[i] = static_cast<int>(indices[i]) + 1;
+
+	const std::size_t count = offsets.size() - 1;
+	const std::size_t length = offsets[1] - offsets[0];
+
+	bool uniform = length > 0;
+	for (std::size_t i = 1; uniform && i < count; ++i)
+		uniform = offsets[i + 1] - offsets[i] == length;
+
+	WSPutFunction(link, head, 1);
+
+	if (uniform)
+	{
+		int dims[] = { static_cast<int>(count), static_cast<int>(length) };
+		WSPutInteger32Array(link, buffer.data(), dims, NULL, 2);
+		return;
+	}
+
+	WSPutFunction(link, "List", count);
+	for (std::size_t i = 0; i < count; ++i)
+		WSPutInteger32List(link, buffer.data() + offsets[i], offsets[i + 1] - offsets[i]);
+}
+
+template <>
+void mathematica::result_writer<graphics, void>::operator()(const graphics &result)
+{
+	// Primitives are grouped by kind, so every argument count is known before the first
+	// put and the expression is sent in one pass
+	const int groups = !result.point_indices().empty() + (result.line_count() > 0) + (result.polygon_count() > 0);
+
+	WSPutFunction(w_.link, result.dimension() == 3 ? "Graphics3D" : "Graphics", 1);
+	WSPutFunction(w_.link, "GraphicsComplex", 2);
+
+	int dims[] = { static_cast<int>(result.vertex_count()), result.dimension() };
+	WSPutReal32Array(w_.link, result.coordinates().data(), dims, NULL, 2);
+
+	WSPutFunction(w_.link, "List", groups);
+	std::vector<int> buffer;
+
+	if (!result.point_indices().empty())
+	{
+		// Point[{i1, i2, ...}] is a set of points, Point[{{i1, i2, ...}}] would be a
+		// single point of the wrong dimension, so the indices are sent as a flat list
+		const std::vector<std::uint32_t> &points(result.point_indices());
+		buffer.resize(points.size());
+		for (std::size_t i = 0; i < points.size(); ++i)
+			buffer[i] = static_cast<int>(points[i]) + 1;
+
+		WSPutFunction(w_.link, "Point", 1);
+		WSPutInteger32List(w_.link, buffer.data(), static_cast<int>(buffer.size()));
+	}
+
+	if (result.line_count() > 0)
+		put_primitives(w_.link, "Line", result.line_indices(), result.line_offsets(), buffer);
+
+	if (result.polygon_count() > 0)
+		put_primitives(w_.link, "Polygon", result.polygon_indices(), result.polygon_offsets(), buffer);
+}
+
+template <>
+void mathematica::result_writer<dictionary, void>::operator()(const dictionary &result)
+{
+	WSPutFunction(w_.link, "Association", result.size());
+
+	for (std::size_t i = 0; i < result.size(); ++i)
+	{
+		WSPutFunction(w_.link, "Rule", 2);
+		WSPutString(w_.link, result.key(i).c_str());
+
+		const dictionary_value &value(result.value(i));
+		if (const bool *flag = boost::get<bool>(&value))
+		{
+			WSPutSymbol(w_.link, *flag ? "True" : "False");
+		}
+		else if (const int *number = boost::get<int>(&value))
+		{
+			result_writer<int, void> writer(w_);
+			writer(*number);
+		}
+		else if (const float *real = boost::get<float>(&value))
+		{
+			result_writer<float, void> writer(w_);
+			writer(*real);
+		}
+		else if (const std::string *text = boost::get<std::string>(&value))
+		{
+			result_writer<std::string, void> writer(w_);
+			writer(*text);
+		}
+		else if (const std::vector<int> *list = boost::get<std::vector<int>>(&value))
+		{
+			WSPutInteger32List(w_.link, list->data(), static_cast<int>(list->size()));
+		}
+		else
+		{
+			result_writer<std::shared_ptr<basic_matrix<float>>, void> writer(w_);
+			writer(boost::get<std::shared_ptr<basic_matrix<float>>>(value));
+		}
+	}
+}
+
+namespace omw
+{
+OMW_WRAPPER_INSTANTIATIONS(, mathematica)
 }
 
 #if OMW_INCLUDE_MAIN
@@ -1,6 +1,16 @@
 (* @ML_PACKAGE_NAME@.m *)
 BeginPackage["@ML_PACKAGE_NAME@`"]
 
+ApplyFramePatch::usage = "ApplyFramePatch[id, sequence, base, dims, patches] updates the last frame of stream id with patches and returns it.";
+ApplyFramePatch::seq = "Frame `2` of stream `1` applies to frame `3`, which was not received; the stream is reset.";
+CallPipelined::usage = "CallPipelined[entry, calls] runs the calls {name, args...} back to back through the pipelined entry point entry and returns their results.";
+FrameSequence::usage = "FrameSequence[id] returns the sequence number of the last frame of stream id, or 0.";
+Progress::usage = "Progress[] returns the latest progress update sent by a function, or None.";
+Preview::usage = "Preview[id] returns the latest preview sent for the progressive result id, or None.";
+SetPreview::usage = "SetPreview[id, data] stores the preview of the progressive result id.";
+SetProgress::usage = "SetProgress[text] stores text as the latest progress update.";
+WithRemote::usage = "WithRemote[release, descriptor, expr] evaluates expr, and then releases the remote array of descriptor by evaluating release[descriptor[\"id\"]], even if the evaluation is aborted.";
+
 Begin["`Private`"]
 
 (* Find the binary location *)
@@ -18,6 +28,68 @@ If[Head[$currentLink] == LinkObject, Uninstall[$currentLink]];
 (* Create new connection *)
 $currentLink = Install[$executable];
 
+(* Sequence number and last frame of each stream written by write_frame *)
+$frames = <||>;
+
+FrameSequence[id_String] := Lookup[$frames, id, {0}][[1]];
+
+ApplyFramePatch[id_String, sequence_Integer, base_Integer, dims_List, patches_List] := Module[{frame},
+	(* Key frames have no base, patches apply to the frame they were computed from *)
+	If[base == 0,
+		frame = ConstantArray[0., dims],
+
+		If[FrameSequence[id] =!= base || Dimensions[$frames[id][[2]]] =!= dims,
+			Message[ApplyFramePatch::seq, id, sequence, base];
+			$frames = KeyDrop[$frames, id];
+			Return[$Failed]];
+
+		frame = $frames[id][[2]]];
+
+	Scan[Function[{patch},
+		frame[[patch[[1]] + 1 ;; patch[[1]] + Length[patch[[3]]],
+			patch[[2]] + 1 ;; patch[[2]] + Length[patch[[3, 1]]]]] = patch[[3]]], patches];
+
+	$frames[id] = {sequence, frame};
+	frame
+];
+
+(* Pipelined calls answer {results, failures}, failures being held messages *)
+CallPipelined[entry_, calls_List] := Module[{answer},
+	answer = entry[calls];
+	If[!MatchQ[answer, {_List, _List}], Return[$Failed]];
+
+	ReleaseHold[answer[[2]]];
+	answer[[1]]
+];
+
+(* Latest preview of each progressive result *)
+$previews = <||>;
+
+SetPreview[id_String, data_] := ($previews[id] = data;);
+
+Preview[id_String] := Lookup[$previews, id, None];
+
+(* Latest progress update, which can be displayed with Dynamic[Progress[]] *)
+$progress = None;
+
+SetProgress[text_String] := ($progress = text;);
+
+Progress[] := $progress;
+
+(* Remote arrays stay in the native process until the host releases them, so scope
+   them to the expression that fetches their slices *)
+SetAttributes[WithRemote, HoldRest];
+
+WithRemote[release_, descriptor_, expr_] := Module[{id = descriptor["id"], result},
+	result = CheckAbort[expr, release[id]; Abort[]];
+	release[id];
+	result
+];
+
 End[] (* `Private` *)
 
 EndPackage[]
+
+(* Template of the warnings queued by the native code. Messages are issued as
+   @ML_PACKAGE_NAME@::name, resolved in the context of the caller like here. *)
+@ML_PACKAGE_NAME@::warn = "`1`";
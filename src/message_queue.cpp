@@ -0,0 +1,107 @@
+#include <sstream>
+
+#include "omw/message_queue.hpp"
+
+using namespace omw;
+
+/// Value of message_queue::progress_ while no progress is pending
+static const std::size_t no_progress = static_cast<std::size_t>(-1);
+
+const char *omw::message_kind_name(message_kind kind)
+{
+	switch (kind)
+	{
+	case message_error:
+		return "error";
+	case message_warning:
+		return "warning";
+	default:
+		return "progress";
+	}
+}
+
+std::string queued_message::format() const
+{
+	// Progress updates replace each other, they are not repetitions
+	if (count <= 1 || kind == message_progress)
+		return text;
+
+	std::stringstream ss;
+	ss << text << " (repeated " << count << " times)";
+	return ss.str();
+}
+
+message_queue::message_queue(std::size_t capacity)
+	: messages_(), index_(), progress_(no_progress), capacity_(capacity), overflow_(0),
+	  progress_interval_(std::chrono::milliseconds(100)), progress_since_(),
+	  queued_total_(0), delivered_total_(0), progress_coalesced_total_(0)
+{
+}
+
+void message_queue::push(message_kind kind, const std::string &name, const std::string &text)
+{
+	queued_total_++;
+
+	std::string key;
+	key.reserve(name.size() + text.size() + 2);
+	key += static_cast<char>('0' + kind);
+	key += name;
+	key += '\0';
+	key += text;
+
+	auto it = index_.find(key);
+	if (it != index_.end())
+	{
+		messages_[it->second].count++;
+		return;
+	}
+
+	if (messages_.size() >= capacity_)
+	{
+		overflow_++;
+		return;
+	}
+
+	index_.emplace(std::move(key), messages_.size());
+	messages_.push_back(queued_message{ kind, name, text, 1 });
+}
+
+bool message_queue::progress(const std::string &text)
+{
+	queued_total_++;
+
+	if (progress_ != no_progress)
+	{
+		progress_coalesced_total_++;
+		messages_[progress_].text = text;
+		messages_[progress_].count++;
+	}
+	else
+	{
+		progress_ = messages_.size();
+		progress_since_ = std::chrono::steady_clock::now();
+		messages_.push_back(queued_message{ message_progress, "progress", text, 1 });
+	}
+
+	return std::chrono::steady_clock::now() - progress_since_ >= progress_interval_;
+}
+
+std::vector<queued_message> message_queue::take()
+{
+	std::vector<queued_message> messages;
+	messages.swap(messages_);
+
+	if (overflow_ > 0)
+	{
+		std::stringstream ss;
+		ss << overflow_ << " more distinct messages were dropped";
+		messages.push_back(queued_message{ message_warning, "warn", ss.str(), 1 });
+		overflow_ = 0;
+	}
+
+	delivered_total_ += messages.size();
+	index_.clear();
+	progress_ = no_progress;
+
+	return messages;
+}
@@ -0,0 +1,335 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define OMW_METRICS_SOCKETS 1
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+#include "omw/metrics.hpp"
+
+using namespace omw;
+
+metrics_writer::metrics_writer(std::ostream &os) : os_(os), family_() {}
+
+void metrics_writer::family(const std::string &name, const char *type, const char *help)
+{
+	family_ = name;
+	os_ << "# HELP " << name << ' ' << help << '\n';
+	os_ << "# TYPE " << name << ' ' << type << '\n';
+}
+
+void metrics_writer::sample(const char *suffix, const std::string &labels, double value)
+{
+	os_ << family_ << suffix;
+	if (!labels.empty())
+		os_ << '{' << labels << '}';
+	os_ << ' ' << std::setprecision(12) << value << '\n';
+}
+
+std::string metrics_writer::label(const char *name, const std::string &value)
+{
+	std::string result(name);
+	result += "=\"";
+
+	for (char c : value)
+	{
+		if (c == '\\' || c == '"')
+			result += '\\';
+		if (c == '\n')
+		{
+			result += "\\n";
+			continue;
+		}
+		result += c;
+	}
+
+	result += '"';
+	return result;
+}
+
+#if OMW_METRICS_SOCKETS
+/**
+ * @brief Opens a listening Unix domain socket
+ *
+ * @param path  Path of the socket
+ * @param error Set to the errno value of the failure
+ * @return Socket descriptor, or -1 on failure
+ */
+static int open_socket(const std::string &path, int &error)
+{
+	struct sockaddr_un addr;
+	std::memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+
+	if (path.size() >= sizeof(addr.sun_path))
+	{
+		error = ENAMETOOLONG;
+		return -1;
+	}
+	std::strcpy(addr.sun_path, path.c_str());
+
+	// Remove a stale socket from a previous process, but never another kind of file
+	struct stat st;
+	if (lstat(path.c_str(), &st) == 0)
+	{
+		if (!S_ISSOCK(st.st_mode))
+		{
+			error = EEXIST;
+			return -1;
+		}
+
+		unlink(path.c_str());
+	}
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+	{
+		error = errno;
+		return -1;
+	}
+
+	if (bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0 || listen(fd, 4) < 0)
+	{
+		error = errno;
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+static void serve_client(int listen_fd, const std::string &body)
+{
+	int fd = accept(listen_fd, nullptr, nullptr);
+	if (fd < 0)
+		return;
+
+	// Consume the request if it arrives promptly, its contents do not matter
+	struct pollfd pfd = { fd, POLLIN, 0 };
+	char request[1024];
+	if (poll(&pfd, 1, 100) > 0)
+		recv(fd, request, sizeof(request), 0);
+
+	std::stringstream ss;
+	ss << "HTTP/1.0 200 OK\r\n"
+	   << "Content-Type: text/plain; version=0.0.4\r\n"
+	   << "Content-Length: " << body.size() << "\r\n\r\n"
+	   << body;
+
+	std::string response(ss.str());
+	size_t sent = 0;
+	while (sent < response.size())
+	{
+		ssize_t n = send(fd, response.data() + sent, response.size() - sent, 0);
+		if (n <= 0)
+			break;
+		sent += n;
+	}
+
+	close(fd);
+}
+#endif
+
+call_mutex::call_mutex() : mutex_(), released_(), locked_(false) {}
+
+void call_mutex::lock()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	released_.wait(lock, [this]() { return !locked_; });
+	locked_ = true;
+}
+
+bool call_mutex::try_lock()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (locked_)
+		return false;
+
+	locked_ = true;
+	return true;
+}
+
+void call_mutex::unlock()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		locked_ = false;
+	}
+
+	released_.notify_all();
+}
+
+bool call_mutex::lock_unless(const std::function<bool()> &cancelled)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	released_.wait(lock, [this, &cancelled]() { return !locked_ || cancelled(); });
+
+	if (locked_)
+		return false;
+
+	locked_ = true;
+	return true;
+}
+
+void call_mutex::interrupt()
+{
+	// Taking the mutex orders this with the predicate evaluations of the waiters
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+	}
+
+	released_.notify_all();
+}
+
+metrics_exporter::metrics_exporter()
+	: state_mutex_(), collector_(), target_(), interval_(1000), listen_fd_(-1), thread_(), thread_mutex_(), wakeup_(),
+	stop_(false), running_(false)
+{
+}
+
+metrics_exporter::~metrics_exporter() { stop(); }
+
+void metrics_exporter::start(const std::string &target, std::chrono::milliseconds interval,
+							 std::function<void(metrics_writer &)> collector)
+{
+	stop();
+
+	if (target.compare(0, 5, "unix:") == 0)
+	{
+#if OMW_METRICS_SOCKETS
+		int error = 0;
+		listen_fd_ = open_socket(target.substr(5), error);
+		if (listen_fd_ < 0)
+		{
+			std::stringstream ss;
+			ss << "Cannot listen on " << target << ": " << std::strerror(error);
+			throw std::runtime_error(ss.str());
+		}
+#else
+		throw std::runtime_error("Unix domain sockets are not supported on this platform");
+#endif
+	}
+
+	target_ = target;
+	interval_ = interval;
+	collector_ = std::move(collector);
+	stop_ = false;
+	running_ = true;
+
+	thread_ = std::thread(&metrics_exporter::run, this);
+}
+
+void metrics_exporter::stop()
+{
+	if (!running_)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(thread_mutex_);
+		stop_ = true;
+	}
+
+	wakeup_.notify_all();
+	state_mutex_.interrupt();
+	thread_.join();
+	running_ = false;
+}
+
+bool metrics_exporter::collect(std::string &text)
+{
+	// Wait for the running call to end, unless the exporter is being stopped from it
+	if (!state_mutex_.lock_unless([this]() {
+			std::lock_guard<std::mutex> lock(thread_mutex_);
+			return stop_;
+		}))
+		return false;
+
+	std::lock_guard<call_mutex> state(state_mutex_, std::adopt_lock);
+
+	std::stringstream ss;
+	metrics_writer writer(ss);
+	collector_(writer);
+
+	text = ss.str();
+	return true;
+}
+
+void metrics_exporter::run()
+{
+#if defined(__linux__)
+	// Lowest priority for this thread only
+	setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19);
+#endif
+
+#if OMW_METRICS_SOCKETS
+	if (listen_fd_ >= 0)
+	{
+		std::string body;
+		auto next = std::chrono::steady_clock::now();
+
+		for (;;)
+		{
+			{
+				std::lock_guard<std::mutex> lock(thread_mutex_);
+				if (stop_)
+					break;
+			}
+
+			auto now = std::chrono::steady_clock::now();
+			if (now >= next)
+			{
+				if (!collect(body))
+					break;
+				next = now + interval_;
+			}
+
+			// Short timeout so stop requests are noticed promptly
+			struct pollfd pfd = { listen_fd_, POLLIN, 0 };
+			if (poll(&pfd, 1, 100) > 0)
+				serve_client(listen_fd_, body);
+		}
+
+		close(listen_fd_);
+		listen_fd_ = -1;
+		unlink(target_.c_str() + 5);
+		return;
+	}
+#endif
+
+	const std::string tmp_path(target_ + ".tmp");
+	std::unique_lock<std::mutex> lock(thread_mutex_);
+
+	while (!stop_)
+	{
+		lock.unlock();
+
+		std::string text;
+		if (!collect(text))
+			return;
+
+		// Write then rename, so readers never see a partial file
+		{
+			std::ofstream file(tmp_path, std::ios::out | std::ios::trunc);
+			file << text;
+		}
+		std::rename(tmp_path.c_str(), target_.c_str());
+
+		lock.lock();
+		wakeup_.wait_for(lock, interval_, [this]() { return stop_; });
+	}
+}
@@ -0,0 +1,163 @@
+#include <stdexcept>
+
+#include "omw/matrix.hpp"
+#include "omw/mip_pyramid.hpp"
+
+using namespace omw;
+
+std::shared_ptr<basic_matrix<float>> omw::downsample_box(const basic_matrix<float> &matrix)
+{
+	if (matrix.depth() < 2 || matrix.depth() > 3)
+		throw std::runtime_error("Only matrices of depth 2 or 3 can be downsampled");
+
+	const int rows = matrix.dims()[0], cols = matrix.dims()[1];
+	const int channels = matrix.depth() == 3 ? matrix.dims()[2] : 1;
+
+	// Get the source in row-major order
+	std::vector<float> row_major;
+	const float *src;
+
+	if (matrix.row_major())
+	{
+		src = matrix.data();
+	}
+	else
+	{
+		row_major.resize(size_t(rows) * cols * channels);
+		matrix.copy_to(row_major.data());
+		src = row_major.data();
+	}
+
+	std::vector<int> dims(matrix.dims(), matrix.dims() + matrix.depth());
+	dims[0] = (rows + 1) / 2;
+	dims[1] = (cols + 1) / 2;
+
+	std::vector<float> dst(size_t(dims[0]) * dims[1] * channels);
+	const size_t row_len = size_t(cols) * channels;
+
+	for (int i = 0; i < dims[0]; ++i)
+	{
+		const float *r0 = src + size_t(2 * i) * row_len;
+		const float *r1 = 2 * i + 1 < rows ? r0 + row_len : r0;
+		float *d = dst.data() + size_t(i) * dims[1] * channels;
+
+		for (int j = 0; j < dims[1]; ++j)
+		{
+			const size_t c0 = size_t(2 * j) * channels;
+			const size_t c1 = 2 * j + 1 < cols ? c0 + channels : c0;
+
+			for (int k = 0; k < channels; ++k)
+				d[j * channels + k] = 0.25f * (r0[c0 + k] + r0[c1 + k] + r1[c0 + k] + r1[c1 + k]);
+		}
+	}
+
+	return vector_matrix<float>::make(std::move(dst), std::move(dims));
+}
+
+progressive_results::progressive_results(std::size_t capacity)
+	: pending_(), lru_(), bytes_(0), capacity_(capacity), evicted_total_(0)
+{
+}
+
+void progressive_results::evict()
+{
+	// The most recently used result is kept whatever its size
+	while (bytes_ > capacity_ && lru_.size() > 1)
+	{
+		auto it = pending_.find(lru_.front());
+		bytes_ -= it->second.bytes;
+		pending_.erase(it);
+		lru_.pop_front();
+		++evicted_total_;
+	}
+}
+
+/**
+ * @brief Gets the size of the elements of a matrix, in bytes
+ */
+static std::size_t matrix_bytes(const basic_matrix<float> &matrix)
+{
+	std::size_t count = 1;
+	for (int k = 0; k < matrix.depth(); ++k)
+		count *= matrix.dims()[k];
+	return count * sizeof(float);
+}
+
+std::shared_ptr<basic_matrix<float>> progressive_results::begin(const std::string &id, const std::shared_ptr<basic_matrix<float>> &matrix, int levels)
+{
+	cancel(id);
+
+	entry e{ {}, 0, lru_.end() };
+	auto &pending(e.levels);
+	// The full resolution is only written by the last refinement, after the call that
+	// passed it
+	pending.push_back(owned_matrix(matrix));
+	e.bytes += matrix_bytes(*matrix);
+
+	// Each level is computed from the previous one, stopping at 1x1
+	for (int l = 0; l < levels; ++l)
+	{
+		const auto &last(*pending.back());
+		if (last.dims()[0] <= 1 && last.dims()[1] <= 1)
+			break;
+
+		pending.push_back(downsample_box(last));
+		e.bytes += matrix_bytes(*pending.back());
+	}
+
+	e.lru = lru_.insert(lru_.end(), id);
+	bytes_ += e.bytes;
+	pending_.emplace(id, std::move(e));
+	evict();
+
+	return next(id);
+}
+
+std::shared_ptr<basic_matrix<float>> progressive_results::next(const std::string &id)
+{
+	auto it = pending_.find(id);
+	if (it == pending_.end())
+		return {};
+
+	auto level(std::move(it->second.levels.back()));
+	it->second.levels.pop_back();
+
+	const std::size_t level_bytes = matrix_bytes(*level);
+	it->second.bytes -= level_bytes;
+	bytes_ -= level_bytes;
+
+	if (it->second.levels.empty())
+	{
+		lru_.erase(it->second.lru);
+		pending_.erase(it);
+	}
+	else
+	{
+		lru_.splice(lru_.end(), lru_, it->second.lru);
+	}
+
+	return level;
+}
+
+size_t progressive_results::remaining(const std::string &id) const
+{
+	auto it = pending_.find(id);
+	return it == pending_.end() ? 0 : it->second.levels.size();
+}
+
+void progressive_results::cancel(const std::string &id)
+{
+	auto it = pending_.find(id);
+	if (it == pending_.end())
+		return;
+
+	bytes_ -= it->second.bytes;
+	lru_.erase(it->second.lru);
+	pending_.erase(it);
+}
+
+void progressive_results::capacity(std::size_t new_capacity)
+{
+	capacity_ = new_capacity;
+	evict();
+}
@@ -1,8 +1,18 @@
+#include <algorithm>
 #include <dlfcn.h>
+#include <memory>
 #include <sstream>
 
 #include "omw/array.hpp"
+#include "omw/bitmask.hpp"
+#include "omw/dictionary.hpp"
 #include "omw/matrix.hpp"
+#include "omw/matrix_batch.hpp"
+#include "omw/matrix_view.hpp"
+#include "omw/ragged_array.hpp"
+#include "omw/range_view.hpp"
+#include "omw/tiled_matrix.hpp"
+#include "omw/transpose.hpp"
 #include "omw/wrapper_base.hpp"
 
 #include "omw/octavew.hpp"
@@ -79,18 +89,37 @@ void octavew::param_reader_base::check_parameter_idx(size_t paramIdx, const std:
 
 octave_value_list octavew::run_function(const octave_value_list &args, std::function<void(octavew &)> fun)
 {
+	return run_function("", args, fun);
+}
+
+octave_value_list octavew::run_function(const char *name, const octave_value_list &args, std::function<void(octavew &)> fun)
+{
+	std::lock_guard<call_mutex> lock(metrics().state_mutex());
+	profiler().begin_call(name);
+
 	try
 	{
 		current_args_ = &args;
 		result_ = octave_value_list();
 
 		fun(*this);
+		deliver_messages();
+
+		profiler().end_call(false);
 		return result_;
 	}
-	catch (std::runtime_error &ex)
+	catch (std::exception &ex)
 	{
+		profiler().end_call(true);
 		send_failure(ex.what());
 	}
+	catch (...)
+	{
+		// Interrupts and errors of the interpreter are left to Octave, the call is still
+		// accounted for
+		profiler().end_call(true);
+		throw;
+	}
 
 	return octave_value_list();
 }
@@ -102,7 +131,18 @@ octavew::result_writer_base::result_writer_base(octavew &w)
 
 void octavew::send_failure(const std::string &exceptionMessage, const std::string &messageName)
 {
-	octave_stdout << messageName << ": " << exceptionMessage << std::endl;
+	// The failure is written along with the messages queued by the call
+	messages().push(message_error, messageName, exceptionMessage);
+	deliver_messages();
+}
+
+void octavew::send_messages(const std::vector<queued_message> &messages)
+{
+	std::stringstream ss;
+	for (const auto &message : messages)
+		ss << message.name << ": " << message.format() << '\n';
+
+	octave_stdout << ss.str() << std::flush;
 }
 
 template <>
@@ -177,6 +217,20 @@ std::string octavew::param_reader<std::string>::try_read(size_t paramIdx, const
 	return (*w_.current_args_)(paramIdx).string_value();
 }
 
+/**
+ * @brief Reads the bounds of an Octave range value, without materializing it
+ */
+static range_view<float> octave_range(const octave_value &value)
+{
+#if OCTAVE_MAJOR_VERSION >= 7
+	auto range(value.range_value());
+	return range_view<float>(range.base(), range.increment(), range.numel(), range.final_value());
+#else
+	Range range(value.range_value());
+	return range_view<float>(range.base(), range.inc(), range.numel(), range.final_value());
+#endif
+}
+
 template <>
 std::shared_ptr<basic_array<float>>
 octavew::param_reader<std::shared_ptr<basic_array<float>>>::try_read(size_t paramIdx, const std::string &paramName,
@@ -184,6 +238,29 @@ octavew::param_reader<std::shared_ptr<basic_array<float>>>::try_read(size_t para
 {
 	check_parameter_idx(paramIdx, paramName);
 
+	// Ranges are converted from their bounds, without building an array of doubles first
+	if ((*w_.current_args_)(paramIdx).is_range())
+	{
+		if (!getData)
+			return {};
+
+		auto range(octave_range((*w_.current_args_)(paramIdx)));
+		std::vector<float> vecd(range.size());
+		range.read(0, range.size(), vecd.data());
+
+		const validation_options &options(w_.param_validation());
+		if (!options.enabled())
+			return vector_array<float>::make(std::move(vecd));
+
+		validator<float> validate(options, paramName);
+		for (auto &v : vecd)
+			v = validate(v);
+
+		auto result(vector_array<float>::make(std::move(vecd)));
+		result->stats(validate.stats());
+		return result;
+	}
+
 	auto av((*w_.current_args_)(paramIdx).array_value());
 	auto av_dims(av.dims());
 
@@ -197,15 +274,30 @@ octavew::param_reader<std::shared_ptr<basic_array<float>>>::try_read(size_t para
 		return {};
 
 	std::vector<float> vecd(av_dims(0) * av_dims(1));
-	for (int i = 0; i < av_dims(0); ++i)
-	{
-		for (int j = 0; j < av_dims(1); ++j)
+	auto copy = [&](auto &&convert) {
+		for (int i = 0; i < av_dims(0); ++i)
 		{
-			vecd[i * av_dims(1) + j] = static_cast<float>(av(i, j));
+			for (int j = 0; j < av_dims(1); ++j)
+			{
+				vecd[i * av_dims(1) + j] = convert(static_cast<float>(av(i, j)), j * av_dims(0) + i);
+			}
 		}
+	};
+
+	// Validation is fused in the conversion loop, errors report the column-major index
+	const validation_options &options(w_.param_validation());
+	if (!options.enabled())
+	{
+		copy([](float v, octave_idx_type) { return v; });
+		return vector_array<float>::make(std::move(vecd));
 	}
 
-	return vector_array<float>::make(vecd);
+	validator<float> validate(options, paramName);
+	copy(validate);
+
+	auto result(vector_array<float>::make(std::move(vecd)));
+	result->stats(validate.stats());
+	return result;
 }
 
 template <>
@@ -234,38 +326,764 @@ octavew::param_reader<std::shared_ptr<basic_matrix<float>>>::try_read(size_t par
 		static_cast<int>(d == 3 ? av.dim3() : 1)};
 	std::vector<float> f(dims[0] * dims[1] * dims[2]);
 
-	// Copy data
-	for (int i = 0; i < dims[0]; ++i)
-		for (int j = 0; j < dims[1]; ++j)
-			for (int k = 0; k < dims[2]; ++k)
+	// Copy data, transposing each channel from column-major to row-major
+	const int channels = dims[2];
+	const size_t plane = size_t(dims[0]) * dims[1];
+	const double *src = av.data();
+
+	// Blocks are converted out of order, so converters get the column-major index of the
+	// element in the Octave array for their error messages
+	auto copy = [&](auto &&convert) {
+		for (int k = 0; k < channels; ++k)
+			blocked_copy(src + k * plane, 1, dims[0], f.data() + k, std::ptrdiff_t(dims[1]) * channels, channels,
+						 dims[0], dims[1], w_.transpose_block(),
+						 [&](float v, std::ptrdiff_t offset) { return convert(v, k * plane + offset); });
+	};
+
+	// Validation is fused in the conversion loop
+	const validation_options &options(w_.param_validation());
+	if (!options.enabled())
+	{
+		copy([](float v, std::size_t) { return v; });
+		return vector_matrix<float>::make(std::move(f), std::move(dims));
+	}
+
+	validator<float> validate(options, paramName);
+	copy(validate);
+
+	auto result(vector_matrix<float>::make(std::move(f), std::move(dims)));
+	result->stats(validate.stats());
+	return result;
+}
+
+/**
+ * @brief Views the storage of an Octave array in place, the view keeping the array alive
+ *
+ * @tparam TSrc Type of the elements in memory. Elements of integer arrays are octave_int
+ *              values, which only hold a value of this type.
+ */
+template <typename TSrc, typename TArray>
+static matrix_view<float> octave_view(TArray &&array, const std::array<int, 3> &dims,
+									  const std::array<std::ptrdiff_t, 3> &strides)
+{
+	static_assert(sizeof(*array.data()) == sizeof(TSrc), "Unexpected element size");
+
+	auto av(std::make_shared<typename std::decay<TArray>::type>(std::move(array)));
+	return matrix_view<float>(av, reinterpret_cast<const TSrc *>(av->data()), dims, strides);
+}
+
+template <>
+matrix_view<float>
+octavew::param_reader<matrix_view<float>>::try_read(size_t paramIdx, const std::string &paramName,
+													bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	const octave_value &value((*w_.current_args_)(paramIdx));
+
+	if (!value. _OCTAVE_ISNUMERIC () && !value. _OCTAVE_ISLOGICAL ())
+	{
+		success = false;
+		return {};
+	}
+
+	auto av_dims(value.dims());
+
+	int d = av_dims.length();
+	if (d > 3)
+	{
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+		return {};
+
+	// Octave arrays are column-major, the view reorders them on access
+	std::array<int, 3> dims{ { static_cast<int>(av_dims(0)), static_cast<int>(av_dims(1)),
+							   static_cast<int>(d == 3 ? av_dims(2) : 1) } };
+	std::array<std::ptrdiff_t, 3> strides{ { 1, av_dims(0), av_dims(0) * av_dims(1) } };
+
+	// Arrays of the type of the argument share its storage, and the view converts their
+	// elements on access
+	if (value.is_single_type())
+		return octave_view<float>(value.float_array_value(), dims, strides);
+	if (value.is_int8_type())
+		return octave_view<std::int8_t>(value.int8_array_value(), dims, strides);
+	if (value.is_int16_type())
+		return octave_view<std::int16_t>(value.int16_array_value(), dims, strides);
+	if (value.is_int32_type())
+		return octave_view<std::int32_t>(value.int32_array_value(), dims, strides);
+	if (value.is_int64_type())
+		return octave_view<std::int64_t>(value.int64_array_value(), dims, strides);
+	if (value.is_uint8_type())
+		return octave_view<std::uint8_t>(value.uint8_array_value(), dims, strides);
+	if (value.is_uint16_type())
+		return octave_view<std::uint16_t>(value.uint16_array_value(), dims, strides);
+	if (value.is_uint32_type())
+		return octave_view<std::uint32_t>(value.uint32_array_value(), dims, strides);
+	if (value.is_uint64_type())
+		return octave_view<std::uint64_t>(value.uint64_array_value(), dims, strides);
+	if (value. _OCTAVE_ISLOGICAL ())
+		return octave_view<bool>(value.bool_array_value(), dims, strides);
+
+	return octave_view<double>(value.array_value(), dims, strides);
+}
+
+template <>
+range_view<float>
+octavew::param_reader<range_view<float>>::try_read(size_t paramIdx, const std::string &paramName,
+													bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	if (!(*w_.current_args_)(paramIdx).is_range())
+	{
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+		return {};
+
+	return octave_range((*w_.current_args_)(paramIdx));
+}
+
+template <>
+ragged_array<float>
+octavew::param_reader<ragged_array<float>>::try_read(size_t paramIdx, const std::string &paramName,
+													 bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	const octave_value &value((*w_.current_args_)(paramIdx));
+
+	if (!value. _OCTAVE_ISCELL ())
+	{
+		success = false;
+		return {};
+	}
+
+	// Every element must be a numeric vector, their lengths size the values buffer
+	Cell cell(value.cell_value());
+	std::size_t total = 0;
+
+	for (octave_idx_type i = 0; i < cell.numel(); ++i)
+	{
+		const octave_value &item(cell(i));
+		auto item_dims(item.dims());
+
+		if (!item. _OCTAVE_ISNUMERIC () || item_dims.length() != 2 ||
+			(item_dims(0) != 1 && item_dims(1) != 1 && item.numel() != 0))
+		{
+			success = false;
+			return {};
+		}
+
+		total += item.numel();
+	}
+
+	if (!getData)
+		return {};
+
+	ragged_array<float> result;
+	result.reserve(cell.numel(), total);
+
+	for (octave_idx_type i = 0; i < cell.numel(); ++i)
+	{
+		const octave_value &item(cell(i));
+		float *dst = result.append_row(item.numel());
+
+		if (item.is_single_type())
+		{
+			FloatNDArray av(item.float_array_value());
+			std::copy(av.data(), av.data() + av.numel(), dst);
+		}
+		else
+		{
+			NDArray av(item.array_value());
+			for (octave_idx_type j = 0; j < av.numel(); ++j)
+				dst[j] = static_cast<float>(av(j));
+		}
+	}
+
+	const validation_options &options(w_.param_validation());
+	if (options.enabled())
+	{
+		validator<float> validate(options, paramName);
+		float *values = result.data();
+
+		for (std::size_t i = 0; i < result.total_size(); ++i)
+			values[i] = validate(values[i]);
+	}
+
+	return result;
+}
+
+/**
+ * @brief Copies a column-major Octave array of at most 3 dimensions to row-major order,
+ * transposing each channel
+ */
+template <typename TSrc, typename TDst>
+static void octave_to_row_major(const TSrc *src, int rows, int cols, int channels, TDst *dst, int block)
+{
+	const size_t plane = size_t(rows) * cols;
+
+	for (int k = 0; k < channels; ++k)
+		blocked_copy(src + k * plane, 1, rows, dst + k, std::ptrdiff_t(cols) * channels, channels, rows, cols,
+					 block, [](TSrc v) { return static_cast<TDst>(v); });
+}
+
+/**
+ * @brief Copies the items of a column-major Octave value into a matrix batch
+ *
+ * @param value     Numeric array holding \p count items one after the other
+ * @param count     Number of items
+ * @param item_dims Dimensions of each item, at most 3
+ * @param block     Block size of the transposition
+ */
+static matrix_batch<float> octave_batch_items(const octave_value &value, std::size_t count,
+											  const std::vector<int> &item_dims, int block)
+{
+	matrix_batch<float> result(count, item_dims);
+
+	const int rows = item_dims[0], cols = item_dims[1];
+	const int channels = item_dims.size() == 3 ? item_dims[2] : 1;
+	const std::size_t n = result.item_size();
+
+	if (value.is_single_type())
+	{
+		FloatNDArray av(value.float_array_value());
+		for (std::size_t i = 0; i < count; ++i)
+			octave_to_row_major(av.data() + i * n, rows, cols, channels, result.item(i), block);
+	}
+	else
+	{
+		NDArray av(value.array_value());
+		for (std::size_t i = 0; i < count; ++i)
+			octave_to_row_major(av.data() + i * n, rows, cols, channels, result.item(i), block);
+	}
+
+	return result;
+}
+
+template <>
+matrix_batch<float>
+octavew::param_reader<matrix_batch<float>>::try_read(size_t paramIdx, const std::string &paramName,
+													 bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	const octave_value &value((*w_.current_args_)(paramIdx));
+	matrix_batch<float> result;
+
+	if (value. _OCTAVE_ISCELL ())
+	{
+		// Every element must be a numeric array of the dimensions of the first one
+		Cell cell(value.cell_value());
+		std::vector<int> item_dims{ 0, 0 };
+
+		for (octave_idx_type i = 0; i < cell.numel(); ++i)
+		{
+			const octave_value &item(cell(i));
+			auto av_dims(item.dims());
+
+			if (!item. _OCTAVE_ISNUMERIC () || av_dims.length() > 3)
+			{
+				success = false;
+				return {};
+			}
+
+			std::vector<int> dims;
+			for (int d = 0; d < av_dims.length(); ++d)
+				dims.push_back(static_cast<int>(av_dims(d)));
+
+			if (i == 0)
+				item_dims = std::move(dims);
+			else if (dims != item_dims)
 			{
-				size_t idx = (i * dims[1] + j) * dims[2] + k;
-				if (d == 3)
-					f[idx] = static_cast<float>(av(i, j, k));
-				else
-					f[idx] = static_cast<float>(av(i, j));
+				success = false;
+				return {};
 			}
+		}
+
+		if (!getData)
+			return {};
+
+		// Items are converted straight into their slot of the batch
+		result = matrix_batch<float>(cell.numel(), item_dims);
+
+		const int rows = item_dims[0], cols = item_dims[1];
+		const int channels = item_dims.size() == 3 ? item_dims[2] : 1;
+
+		for (octave_idx_type i = 0; i < cell.numel(); ++i)
+		{
+			const octave_value &item(cell(i));
+
+			if (item.is_single_type())
+			{
+				FloatNDArray av(item.float_array_value());
+				octave_to_row_major(av.data(), rows, cols, channels, result.item(i), w_.transpose_block());
+			}
+			else
+			{
+				NDArray av(item.array_value());
+				octave_to_row_major(av.data(), rows, cols, channels, result.item(i), w_.transpose_block());
+			}
+		}
+	}
+	else if (value. _OCTAVE_ISNUMERIC ())
+	{
+		// Packed batches have the item index as their last dimension
+		auto av_dims(value.dims());
+		int d = av_dims.length();
+
+		if (d < 3 || d > 4)
+		{
+			success = false;
+			return {};
+		}
+
+		if (!getData)
+			return {};
+
+		std::vector<int> item_dims;
+		for (int i = 0; i < d - 1; ++i)
+			item_dims.push_back(static_cast<int>(av_dims(i)));
+
+		result = octave_batch_items(value, av_dims(d - 1), item_dims, w_.transpose_block());
+	}
+	else
+	{
+		success = false;
+		return {};
+	}
+
+	const validation_options &options(w_.param_validation());
+	if (options.enabled())
+	{
+		validator<float> validate(options, paramName);
+		float *values = result.data();
+
+		for (std::size_t i = 0; i < result.size() * result.item_size(); ++i)
+			values[i] = validate(values[i]);
+	}
+
+	return result;
+}
+
+/**
+ * @brief Packs a column-major Octave array of at most 3 dimensions into a bitmask
+ */
+template <typename TSrc> static void octave_to_bitmask(const TSrc *src, bitmask &result, int block)
+{
+	const std::vector<int> &dims(result.dims());
+	const int channels = dims.size() == 3 ? dims[2] : 1;
+
+	// Vectors have the same element order in both layouts
+	if (channels == 1 && (dims[0] == 1 || dims[1] == 1))
+	{
+		result.assign(src);
+		return;
+	}
 
-	return vector_matrix<float>::make(std::move(f), std::move(dims));
+	std::unique_ptr<TSrc[]> row_major(new TSrc[result.size()]);
+	octave_to_row_major(src, dims[0], dims[1], channels, row_major.get(), block);
+	result.assign(row_major.get());
+}
+
+template <>
+bitmask
+octavew::param_reader<bitmask>::try_read(size_t paramIdx, const std::string &paramName,
+										 bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	const octave_value &value((*w_.current_args_)(paramIdx));
+
+	// Logical arrays, or 0/1 numeric arrays
+	if (!value. _OCTAVE_ISLOGICAL () && !value. _OCTAVE_ISNUMERIC ())
+	{
+		success = false;
+		return {};
+	}
+
+	auto av_dims(value.dims());
+
+	int d = av_dims.length();
+	if (d > 3)
+	{
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+		return {};
+
+	std::vector<int> dims;
+	for (int i = 0; i < d; ++i)
+		dims.push_back(static_cast<int>(av_dims(i)));
+
+	bitmask result(std::move(dims));
+
+	if (value. _OCTAVE_ISLOGICAL ())
+	{
+		boolNDArray av(value.bool_array_value());
+		octave_to_bitmask(av.data(), result, w_.transpose_block());
+	}
+	else
+	{
+		NDArray av(value.array_value());
+		check_binary(av.data(), result.size(), paramName);
+		octave_to_bitmask(av.data(), result, w_.transpose_block());
+	}
+
+	return result;
+}
+
+/**
+ * @brief Converts the value of a struct field to the value of a dictionary entry
+ *
+ * @param item  Value of the field
+ * @param value Value of the entry, or nullptr to only test the type of \p item
+ * @param block Block size of the transposition of arrays
+ * @return false if \p item is not a boolean, string, number or numeric array
+ */
+static bool octave_dictionary_value(const octave_value &item, dictionary_value *value, int block)
+{
+	if (item.is_string())
+	{
+		if (value)
+			*value = item.string_value();
+		return true;
+	}
+
+	if (!item. _OCTAVE_ISLOGICAL () && !item. _OCTAVE_ISNUMERIC ())
+		return false;
+
+	if (item.numel() == 1)
+	{
+		if (value)
+		{
+			if (item. _OCTAVE_ISLOGICAL ())
+				*value = item.is_true();
+			else if (item. _OCTAVE_ISINTEGER ())
+				*value = static_cast<int>(item.int32_scalar_value());
+			else
+				*value = item.float_value();
+		}
+
+		return true;
+	}
+
+	auto av_dims(item.dims());
+	int d = av_dims.length();
+	if (d > 3)
+		return false;
+
+	if (value)
+	{
+		std::vector<int> dims{ static_cast<int>(av_dims(0)), static_cast<int>(av_dims(1)),
+							   static_cast<int>(d == 3 ? av_dims(2) : 1) };
+		std::vector<float> f(size_t(dims[0]) * dims[1] * dims[2]);
+
+		NDArray av(item.array_value());
+		octave_to_row_major(av.data(), dims[0], dims[1], dims[2], f.data(), block);
+
+		*value = std::shared_ptr<basic_matrix<float>>(vector_matrix<float>::make(std::move(f), std::move(dims)));
+	}
+
+	return true;
+}
+
+template <>
+dictionary
+octavew::param_reader<dictionary>::try_read(size_t paramIdx, const std::string &paramName,
+											bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	const octave_value &value((*w_.current_args_)(paramIdx));
+
+	// Scalar structs, whose fields are the keys
+	if (!value. _OCTAVE_ISSTRUCT () || value.numel() != 1)
+	{
+		success = false;
+		return {};
+	}
+
+	octave_scalar_map map(value.scalar_map_value());
+	string_vector keys(map.fieldnames());
+
+	std::size_t key_bytes = 0;
+	for (octave_idx_type i = 0; i < keys.numel(); ++i)
+	{
+		if (!octave_dictionary_value(map.contents(keys(i)), nullptr, 0))
+		{
+			success = false;
+			return {};
+		}
+
+		key_bytes += keys(i).size();
+	}
+
+	if (!getData)
+		return {};
+
+	dictionary result;
+	result.reserve(keys.numel(), key_bytes);
+
+	for (octave_idx_type i = 0; i < keys.numel(); ++i)
+	{
+		dictionary_value item;
+		octave_dictionary_value(map.contents(keys(i)), &item, w_.transpose_block());
+		result.insert(keys(i), std::move(item));
+	}
+
+	return result;
+}
+
+template <>
+std::shared_ptr<tiled_matrix<float>>
+octavew::param_reader<std::shared_ptr<tiled_matrix<float>>>::try_read(size_t paramIdx, const std::string &paramName,
+																	 bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	auto av((*w_.current_args_)(paramIdx).array_value());
+	auto av_dims(av.dims());
+
+	int d = av_dims.length();
+	if (d <= 1 || d > 3)
+	{
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+		return {};
+
+	std::vector<int> dims{ static_cast<int>(av_dims(0)), static_cast<int>(av_dims(1)) };
+	if (d == 3)
+		dims.push_back(static_cast<int>(av_dims(2)));
+
+	auto result(tiled_matrix<float>::make(std::move(dims), w_.tile_size(), w_.tile_size()));
+
+	const int channels = result->channels();
+	const octave_idx_type rows = av_dims(0), plane = av_dims(0) * av_dims(1);
+	const double *src = av.data();
+
+	// Convert tile by tile, reading tile columns contiguously from the column-major source
+	for (auto t : result->tiles())
+		for (int k = 0; k < channels; ++k)
+			for (int c = 0; c < t.cols; ++c)
+			{
+				const double *s = src + k * plane + (t.col + c) * rows + t.row;
+				float *dst = t.data + c * channels + k;
+
+				for (int r = 0; r < t.rows; ++r)
+					dst[r * t.stride] = static_cast<float>(s[r]);
+			}
+
+	return result;
+}
+
+/**
+ * @brief Copies a row-major array of at most 3 dimensions to a column-major Octave array,
+ * transposing each channel
+ */
+static NDArray octave_from_row_major(const float *src, int rows, int cols, int channels, int block)
+{
+	NDArray data(dim_vector(rows, cols, channels));
+
+	// Need to copy from float* to double*, transposing each channel to column-major
+	const size_t plane = size_t(rows) * cols;
+	double *dst = data.fortran_vec();
+
+	for (int k = 0; k < channels; ++k)
+		blocked_copy(src + k, std::ptrdiff_t(cols) * channels, channels, dst + k * plane, 1, rows, rows, cols, block);
+
+	return data;
 }
 
 template <>
 void octavew::result_writer<std::shared_ptr<basic_matrix<float>>, void>::operator()(const std::shared_ptr<basic_matrix<float>> &result)
+{
+	// Tiled matrices are converted directly from their tiles
+	if (auto tiled = std::dynamic_pointer_cast<tiled_matrix<float>>(result))
+	{
+		result_writer<std::shared_ptr<tiled_matrix<float>>, void> writer(w_);
+		writer(tiled);
+		return;
+	}
+
+	// Get the elements in row-major order
+	std::vector<float> row_major;
+	const float *src;
+
+	if (result->row_major())
+	{
+		src = result->data();
+	}
+	else
+	{
+		row_major.resize(size_t(result->dims()[0]) * result->dims()[1] * (result->depth() == 3 ? result->dims()[2] : 1));
+		result->copy_to(row_major.data());
+		src = row_major.data();
+	}
+
+	const int channels = result->depth() == 3 ? result->dims()[2] : 1;
+	w_.result().append(octave_from_row_major(src, result->dims()[0], result->dims()[1], channels, w_.transpose_block()));
+}
+
+template <>
+void octavew::result_writer<std::shared_ptr<tiled_matrix<float>>, void>::operator()(const std::shared_ptr<tiled_matrix<float>> &result)
 {
 	// Create the NDArray
-	auto dims(dim_vector(result->dims()[0], result->dims()[1], result->dims()[2]));
-	NDArray data(dims);
+	const int channels = result->channels();
+	NDArray data(dim_vector(result->rows(), result->cols(), channels));
+
+	const octave_idx_type rows = result->rows(), plane = octave_idx_type(result->rows()) * result->cols();
+	double *dst = data.fortran_vec();
 
-	// Need to copy from float* to double*
-	for (int i = 0; i < result->dims()[0]; ++i)
-		for (int j = 0; j < result->dims()[1]; ++j)
-			for (int k = 0; k < result->dims()[2]; ++k)
+	// Scatter each tile into the column-major array
+	for (auto t : result->tiles())
+		for (int k = 0; k < channels; ++k)
+			for (int c = 0; c < t.cols; ++c)
 			{
-				size_t idx = (i * result->dims()[1] + j) * result->dims()[2] + k;
-				data(i, j, k) = static_cast<double>(result->data()[idx]);
+				const float *s = t.data + c * channels + k;
+				double *d = dst + k * plane + (t.col + c) * rows + t.row;
+
+				for (int r = 0; r < t.rows; ++r)
+					d[r] = static_cast<double>(s[r * t.stride]);
 			}
 
 	w_.result().append(data);
 }
 
+template <>
+void octavew::result_writer<ragged_array<float>, void>::operator()(const ragged_array<float> &result)
+{
+	// Rows are written as a cell array of row vectors
+	Cell cell(1, result.size());
+
+	for (std::size_t i = 0; i < result.size(); ++i)
+	{
+		RowVector row(result.row_size(i));
+		std::copy(result.row(i), result.row(i) + result.row_size(i), row.fortran_vec());
+		cell(i) = row;
+	}
+
+	w_.result().append(octave_value(cell));
+}
+
+template <>
+void octavew::result_writer<matrix_batch<float>, void>::operator()(const matrix_batch<float> &result)
+{
+	// Items are written as a cell array of arrays, vectors as row vectors
+	const std::vector<int> &dims(result.item_dims());
+	const int rows = dims.size() >= 2 ? dims[0] : 1;
+	const int cols = dims.size() >= 2 ? dims[1] : (dims.empty() ? 1 : dims[0]);
+	const int channels = dims.size() == 3 ? dims[2] : 1;
+
+	Cell cell(1, result.size());
+
+	for (std::size_t i = 0; i < result.size(); ++i)
+		cell(i) = octave_from_row_major(result.item(i), rows, cols, channels, w_.transpose_block());
+
+	w_.result().append(octave_value(cell));
+}
+
+template <>
+void octavew::result_writer<bitmask, void>::operator()(const bitmask &result)
+{
+	// Masks are written as logical arrays, vectors as row vectors
+	const std::vector<int> &dims(result.dims());
+	const int rows = dims.size() >= 2 ? dims[0] : 1;
+	const int cols = dims.size() >= 2 ? dims[1] : (dims.empty() ? 1 : dims[0]);
+	const int channels = dims.size() == 3 ? dims[2] : 1;
+
+	boolNDArray data(dim_vector(rows, cols, channels));
+	bool *dst = data.fortran_vec();
+
+	// Vectors have the same element order in both layouts
+	if (channels == 1 && (rows == 1 || cols == 1))
+	{
+		result.unpack(dst);
+	}
+	else
+	{
+		std::unique_ptr<bool[]> row_major(new bool[result.size()]);
+		result.unpack(row_major.get());
+
+		const size_t plane = size_t(rows) * cols;
+		for (int k = 0; k < channels; ++k)
+			blocked_copy(row_major.get() + k, std::ptrdiff_t(cols) * channels, channels, dst + k * plane, 1, rows,
+						 rows, cols, w_.transpose_block());
+	}
+
+	w_.result().append(octave_value(data));
+}
+
+template <>
+void octavew::result_writer<dictionary, void>::operator()(const dictionary &result)
+{
+	// Dictionaries are written as scalar structs
+	octave_scalar_map map;
+
+	for (std::size_t i = 0; i < result.size(); ++i)
+	{
+		const dictionary_value &value(result.value(i));
+		octave_value item;
+
+		if (const bool *flag = boost::get<bool>(&value))
+			item = *flag;
+		else if (const int *number = boost::get<int>(&value))
+			item = *number;
+		else if (const float *real = boost::get<float>(&value))
+			item = *real;
+		else if (const std::string *text = boost::get<std::string>(&value))
+			item = *text;
+		else if (const std::vector<int> *list = boost::get<std::vector<int>>(&value))
+		{
+			// Octave extents, like the result of size, are double row vectors
+			RowVector row(list->size());
+			for (std::size_t j = 0; j < list->size(); ++j)
+				row(j) = (*list)[j];
+			item = row;
+		}
+		else
+		{
+			const auto &matrix(boost::get<std::shared_ptr<basic_matrix<float>>>(value));
+			const int channels = matrix->depth() == 3 ? matrix->dims()[2] : 1;
+			const int cols = matrix->depth() >= 2 ? matrix->dims()[1] : 1;
+
+			std::vector<float> row_major;
+			const float *src;
+
+			if (matrix->row_major())
+			{
+				src = matrix->data();
+			}
+			else
+			{
+				row_major.resize(size_t(matrix->dims()[0]) * cols * channels);
+				matrix->copy_to(row_major.data());
+				src = row_major.data();
+			}
+
+			item = octave_from_row_major(src, matrix->dims()[0], cols, channels, w_.transpose_block());
+		}
+
+		map.assign(result.key(i), item);
+	}
+
+	w_.result().append(octave_value(map));
+}
+
+namespace omw
+{
+OMW_WRAPPER_INSTANTIATIONS(, octavew)
+}
+
 #endif /* OMW_OCTAVE */
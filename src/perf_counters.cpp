@@ -0,0 +1,141 @@
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "omw/perf_counters.hpp"
+
+using namespace omw;
+
+const char *omw::perf_event_name(perf_event event)
+{
+	switch (event)
+	{
+	case perf_cycles:
+		return "cycles";
+	case perf_instructions:
+		return "instructions";
+	case perf_llc_misses:
+		return "llc_misses";
+	case perf_branch_misses:
+		return "branch_misses";
+	default:
+		return "unknown";
+	}
+}
+
+#if defined(__linux__)
+
+perf_counters::perf_counters() : leader_(-1), open_count_(0), error_()
+{
+	static const std::uint64_t configs[perf_event_count] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+															 PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+
+	for (int i = 0; i < perf_event_count; ++i)
+	{
+		fds_[i] = -1;
+		slots_[i] = -1;
+
+		struct perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = configs[i];
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.disabled = leader_ < 0 ? 1 : 0;
+
+		// Count for the calling thread, on any CPU
+		int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, leader_, 0));
+		if (fd < 0)
+		{
+			if (error_.empty())
+				error_ = std::string("perf_event_open failed for ") + perf_event_name(perf_event(i)) + ": " + std::strerror(errno);
+			continue;
+		}
+
+		if (leader_ < 0)
+			leader_ = fd;
+
+		fds_[i] = fd;
+		slots_[i] = open_count_++;
+	}
+
+	if (leader_ >= 0)
+	{
+		ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	}
+}
+
+perf_counters::~perf_counters()
+{
+	for (int i = 0; i < perf_event_count; ++i)
+		if (fds_[i] >= 0)
+			close(fds_[i]);
+}
+
+void perf_counters::read(perf_reading &reading) const
+{
+	// Group read format: number of counters, time enabled and running, then their values
+	// in creation order
+	std::uint64_t buffer[3 + perf_event_count] = { 0 };
+
+	if (leader_ < 0 || ::read(leader_, buffer, sizeof(buffer)) <= 0)
+		std::memset(buffer, 0, sizeof(buffer));
+
+	reading.time_enabled = buffer[1];
+	reading.time_running = buffer[2];
+
+	for (int i = 0; i < perf_event_count; ++i)
+		reading.values[i] = slots_[i] >= 0 && std::uint64_t(slots_[i]) < buffer[0] ? buffer[3 + slots_[i]] : 0;
+}
+
+#else /* defined(__linux__) */
+
+perf_counters::perf_counters() : leader_(-1), open_count_(0), error_("Hardware counters are only supported on Linux")
+{
+	for (int i = 0; i < perf_event_count; ++i)
+	{
+		fds_[i] = -1;
+		slots_[i] = -1;
+	}
+}
+
+perf_counters::~perf_counters() {}
+
+void perf_counters::read(perf_reading &reading) const
+{
+	reading = perf_reading();
+}
+
+#endif /* defined(__linux__) */
+
+void perf_counters::read(std::uint64_t values[perf_event_count]) const
+{
+	perf_reading reading;
+	read(reading);
+	reading.elapsed_since(perf_reading(), values);
+}
+
+void perf_reading::elapsed_since(const perf_reading &start, std::uint64_t deltas[perf_event_count]) const
+{
+	// When more events are requested than the PMU has counters, the kernel multiplexes the
+	// group and it only counts part of the time: extrapolate to the whole time enabled
+	const std::uint64_t enabled = time_enabled > start.time_enabled ? time_enabled - start.time_enabled : 0;
+	const std::uint64_t running = time_running > start.time_running ? time_running - start.time_running : 0;
+	const double scale = running == 0 ? 0.0 : double(enabled) / double(running);
+
+	for (int i = 0; i < perf_event_count; ++i)
+	{
+		// Raw counts only grow, unless the counters were reset in between
+		const std::uint64_t value = values[i] > start.values[i] ? values[i] - start.values[i] : 0;
+		deltas[i] = running == enabled ? value : std::uint64_t(double(value) * scale);
+	}
+}
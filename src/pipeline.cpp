@@ -0,0 +1,499 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+#include "omw/mip_pyramid.hpp"
+#include "omw/pipeline.hpp"
+#include "omw/transpose.hpp"
+
+using namespace omw;
+
+/// Number of elements processed at once by fused elementwise stages, 16 KiB of floats
+static const std::size_t pipeline_chunk = 4096;
+
+static std::size_t element_count(const basic_matrix<float> &m)
+{
+	std::size_t count = 1;
+	for (int d = 0; d < m.depth(); ++d)
+		count *= m.dims()[d];
+	return count;
+}
+
+/**
+ * @brief Gets the elements of a matrix in row-major order, copying them only if needed
+ */
+static const float *row_major_data(const basic_matrix<float> &m, std::vector<float> &storage)
+{
+	if (m.row_major())
+		return m.data();
+
+	storage.resize(element_count(m));
+	m.copy_to(storage.data());
+	return storage.data();
+}
+
+static std::shared_ptr<basic_matrix<float>> transpose_stage(const std::vector<std::shared_ptr<basic_matrix<float>>> &inputs,
+															const std::vector<double> &)
+{
+	const basic_matrix<float> &m(*inputs[0]);
+	if (m.depth() < 2 || m.depth() > 3)
+		throw std::runtime_error("transpose: only matrices of depth 2 or 3 can be transposed");
+
+	const int rows = m.dims()[0], cols = m.dims()[1];
+	const int channels = m.depth() == 3 ? m.dims()[2] : 1;
+
+	std::vector<float> storage;
+	const float *src = row_major_data(m, storage);
+	std::vector<float> dst(element_count(m));
+
+	for (int k = 0; k < channels; ++k)
+		blocked_copy(src + k, std::ptrdiff_t(cols) * channels, channels, dst.data() + k, channels,
+					 std::ptrdiff_t(rows) * channels, rows, cols, 32);
+
+	std::vector<int> dims(m.dims(), m.dims() + m.depth());
+	std::swap(dims[0], dims[1]);
+	return vector_matrix<float>::make(std::move(dst), std::move(dims));
+}
+
+pipeline_registry::pipeline_registry() : stages_(), revision_(0)
+{
+	add_elementwise("scale", 1, 1, [](float *v, const float *const *, std::size_t n, const double *p) {
+		const float k = static_cast<float>(p[0]);
+		for (std::size_t i = 0; i < n; ++i)
+			v[i] *= k;
+	});
+
+	add_elementwise("offset", 1, 1, [](float *v, const float *const *, std::size_t n, const double *p) {
+		const float k = static_cast<float>(p[0]);
+		for (std::size_t i = 0; i < n; ++i)
+			v[i] += k;
+	});
+
+	add_elementwise("clamp", 1, 2, [](float *v, const float *const *, std::size_t n, const double *p) {
+		const float lo = static_cast<float>(p[0]), hi = static_cast<float>(p[1]);
+		for (std::size_t i = 0; i < n; ++i)
+			v[i] = std::min(std::max(v[i], lo), hi);
+	});
+
+	add_elementwise("abs", 1, 0, [](float *v, const float *const *, std::size_t n, const double *) {
+		for (std::size_t i = 0; i < n; ++i)
+			v[i] = std::fabs(v[i]);
+	});
+
+	add_elementwise("sqrt", 1, 0, [](float *v, const float *const *, std::size_t n, const double *) {
+		for (std::size_t i = 0; i < n; ++i)
+			v[i] = std::sqrt(v[i]);
+	});
+
+	add_elementwise("add", 2, 0, [](float *v, const float *const *in, std::size_t n, const double *) {
+		for (std::size_t i = 0; i < n; ++i)
+			v[i] += in[0][i];
+	});
+
+	add_elementwise("sub", 2, 0, [](float *v, const float *const *in, std::size_t n, const double *) {
+		for (std::size_t i = 0; i < n; ++i)
+			v[i] -= in[0][i];
+	});
+
+	add_elementwise("mul", 2, 0, [](float *v, const float *const *in, std::size_t n, const double *) {
+		for (std::size_t i = 0; i < n; ++i)
+			v[i] *= in[0][i];
+	});
+
+	add_stage("transpose", 1, 0, transpose_stage);
+
+	add_stage("downsample", 1, 0, [](const std::vector<std::shared_ptr<basic_matrix<float>>> &inputs,
+									 const std::vector<double> &) { return downsample_box(*inputs[0]); });
+}
+
+void pipeline_registry::add_elementwise(const std::string &name, int matrix_args, int scalar_args, elementwise_kernel kernel)
+{
+	if (matrix_args < 1)
+		throw std::runtime_error("Elementwise stage " + name + " needs at least one matrix argument");
+
+	pipeline_stage &stage(stages_[name]);
+	stage.name = name;
+	stage.matrix_args = matrix_args;
+	stage.scalar_args = scalar_args;
+	stage.kernel = std::move(kernel);
+	stage.function = stage_function();
+	revision_++;
+}
+
+void pipeline_registry::add_stage(const std::string &name, int matrix_args, int scalar_args, stage_function function)
+{
+	pipeline_stage &stage(stages_[name]);
+	stage.name = name;
+	stage.matrix_args = matrix_args;
+	stage.scalar_args = scalar_args;
+	stage.kernel = elementwise_kernel();
+	stage.function = std::move(function);
+	revision_++;
+}
+
+bool pipeline_registry::remove(const std::string &name)
+{
+	if (stages_.erase(name) == 0)
+		return false;
+
+	revision_++;
+	return true;
+}
+
+const pipeline_stage *pipeline_registry::find(const std::string &name) const
+{
+	auto it = stages_.find(name);
+	return it == stages_.end() ? nullptr : &it->second;
+}
+
+namespace omw
+{
+/**
+ * @brief Recursive descent parser of pipeline descriptions
+ */
+class pipeline_parser
+{
+	const std::string &src_;
+	const pipeline_registry &registry_;
+	std::size_t pos_;
+	pipeline &result_;
+	std::map<std::string, int> names_;
+
+	/// Argument of a call: a reference to a value, or a number
+	struct argument
+	{
+		bool is_number;
+		int ref;
+		double number;
+	};
+
+	[[noreturn]] void fail(const std::string &message) const
+	{
+		std::stringstream ss;
+		ss << "Invalid pipeline at offset " << pos_ << ": " << message;
+		throw std::runtime_error(ss.str());
+	}
+
+	void skip_spaces()
+	{
+		while (pos_ < src_.size() && std::isspace(static_cast<unsigned char>(src_[pos_])))
+			++pos_;
+	}
+
+	bool accept(char c)
+	{
+		skip_spaces();
+		if (pos_ < src_.size() && src_[pos_] == c)
+		{
+			++pos_;
+			return true;
+		}
+		return false;
+	}
+
+	void expect(char c)
+	{
+		if (!accept(c))
+			fail(std::string("expected '") + c + "'");
+	}
+
+	bool peek_identifier()
+	{
+		skip_spaces();
+		return pos_ < src_.size() && (std::isalpha(static_cast<unsigned char>(src_[pos_])) || src_[pos_] == '_');
+	}
+
+	std::string identifier()
+	{
+		if (!peek_identifier())
+			fail("expected a name");
+
+		std::size_t start = pos_;
+		while (pos_ < src_.size() && (std::isalnum(static_cast<unsigned char>(src_[pos_])) || src_[pos_] == '_'))
+			++pos_;
+
+		return src_.substr(start, pos_ - start);
+	}
+
+	/// References are step indices, or -1 - input index for inputs
+	int reference_of_name(const std::string &name)
+	{
+		auto it = names_.find(name);
+		if (it != names_.end())
+			return it->second;
+
+		// Unbound names are inputs
+		int ref = -1 - static_cast<int>(result_.inputs_.size());
+		result_.inputs_.push_back(name);
+		names_[name] = ref;
+		return ref;
+	}
+
+	argument parse_argument()
+	{
+		skip_spaces();
+		if (peek_identifier())
+		{
+			std::string name(identifier());
+
+			if (accept('('))
+				return argument{ false, parse_call(name), 0.0 };
+
+			return argument{ false, reference_of_name(name), 0.0 };
+		}
+
+		const char *begin = src_.c_str() + pos_;
+		char *end = nullptr;
+		double value = std::strtod(begin, &end);
+		if (end == begin)
+			fail("expected an argument");
+
+		pos_ += end - begin;
+		return argument{ true, -1, value };
+	}
+
+	/// Parses the arguments of a call whose name and opening parenthesis were read
+	int parse_call(const std::string &name)
+	{
+		const pipeline_stage *stage = registry_.find(name);
+		if (!stage)
+			fail("unknown stage " + name);
+
+		std::vector<argument> args;
+		if (!accept(')'))
+		{
+			do
+				args.push_back(parse_argument());
+			while (accept(','));
+			expect(')');
+		}
+
+		if (static_cast<int>(args.size()) != stage->matrix_args + stage->scalar_args)
+		{
+			std::stringstream ss;
+			ss << name << " expects " << stage->matrix_args << " matrix and " << stage->scalar_args
+			   << " scalar arguments";
+			fail(ss.str());
+		}
+
+		pipeline::step step;
+		step.stage = stage;
+
+		for (int i = 0; i < static_cast<int>(args.size()); ++i)
+		{
+			bool want_matrix = i < stage->matrix_args;
+			if (want_matrix == args[i].is_number)
+				fail(name + ": argument " + std::to_string(i + 1) + (want_matrix ? " must be a matrix" : " must be a number"));
+
+			if (want_matrix)
+				step.inputs.push_back(args[i].ref);
+			else
+				step.params.push_back(args[i].number);
+		}
+
+		result_.steps_.push_back(std::move(step));
+		return static_cast<int>(result_.steps_.size()) - 1;
+	}
+
+	void parse_statement()
+	{
+		std::string name(identifier());
+
+		if (accept('='))
+		{
+			std::string callee(identifier());
+			expect('(');
+			int ref = parse_call(callee);
+
+			if (names_.count(name))
+				fail(name + " is already bound");
+			names_[name] = ref;
+		}
+		else
+		{
+			expect('(');
+			parse_call(name);
+		}
+	}
+
+	public:
+	pipeline_parser(const std::string &src, const pipeline_registry &registry, pipeline &result)
+		: src_(src), registry_(registry), pos_(0), result_(result), names_()
+	{
+	}
+
+	void parse()
+	{
+		do
+		{
+			skip_spaces();
+			if (pos_ == src_.size())
+				break;
+			parse_statement();
+		} while (accept(';'));
+
+		skip_spaces();
+		if (pos_ != src_.size())
+			fail("unexpected character");
+		if (result_.steps_.empty())
+			fail("no stage to run");
+
+		// Now that every input is known, turn references into slots
+		for (auto &step : result_.steps_)
+			for (auto &input : step.inputs)
+				input = input < 0 ? -1 - input : result_.slot_of(input);
+	}
+};
+}
+
+pipeline pipeline::parse(const std::string &description, const pipeline_registry &registry)
+{
+	pipeline result;
+	pipeline_parser(description, registry, result).parse();
+	result.plan();
+	return result;
+}
+
+void pipeline::plan()
+{
+	// Count the uses of every slot, the output counts as a use
+	std::vector<int> uses(inputs_.size() + steps_.size(), 0);
+	for (const auto &s : steps_)
+		for (int input : s.inputs)
+			uses[input]++;
+	uses.back()++;
+
+	// Chain an elementwise step to the producer of its first argument when that
+	// producer is elementwise and this is the only use of its result
+	std::vector<int> group_of(steps_.size(), -1);
+	groups_.clear();
+
+	for (int i = 0; i < static_cast<int>(steps_.size()); ++i)
+	{
+		const step &s(steps_[i]);
+		int producer = s.inputs.empty() ? -1 : s.inputs[0] - static_cast<int>(inputs_.size());
+
+		if (s.stage->elementwise() && producer >= 0 && steps_[producer].stage->elementwise() &&
+			uses[s.inputs[0]] == 1 && groups_[group_of[producer]].back() == producer)
+		{
+			group_of[i] = group_of[producer];
+			groups_[group_of[i]].push_back(i);
+		}
+		else
+		{
+			group_of[i] = static_cast<int>(groups_.size());
+			groups_.push_back({ i });
+		}
+	}
+
+	// Run groups once their last step is reached, side inputs are computed by then
+	std::sort(groups_.begin(), groups_.end(),
+			  [](const std::vector<int> &a, const std::vector<int> &b) { return a.back() < b.back(); });
+}
+
+std::shared_ptr<basic_matrix<float>> pipeline::run(const std::map<std::string, std::shared_ptr<basic_matrix<float>>> &inputs) const
+{
+	std::vector<std::shared_ptr<basic_matrix<float>>> slots(inputs_.size() + steps_.size());
+
+	for (size_t i = 0; i < inputs_.size(); ++i)
+	{
+		auto it = inputs.find(inputs_[i]);
+		if (it == inputs.end() || !it->second)
+			throw std::runtime_error("Missing pipeline input " + inputs_[i]);
+		slots[i] = it->second;
+	}
+
+	for (const auto &group : groups_)
+	{
+		const step &head(steps_[group.front()]);
+
+		if (!head.stage->elementwise())
+		{
+			std::vector<std::shared_ptr<basic_matrix<float>>> args;
+			for (int input : head.inputs)
+				args.push_back(slots[input]);
+
+			slots[slot_of(group.front())] = head.stage->function(args, head.params);
+			continue;
+		}
+
+		// Fused pass: every stage of the chain is applied to a chunk before the next one
+		const basic_matrix<float> &first(*slots[head.inputs[0]]);
+		const std::size_t count = element_count(first);
+
+		std::vector<float> head_storage;
+		const float *head_data = row_major_data(first, head_storage);
+
+		// Side inputs of every stage, as contiguous row-major data
+		std::vector<std::vector<float>> side_storage;
+		std::vector<std::vector<const float *>> sides(group.size());
+		side_storage.reserve(group.size() * 2);
+
+		for (size_t g = 0; g < group.size(); ++g)
+		{
+			const step &s(steps_[group[g]]);
+			for (size_t a = 1; a < s.inputs.size(); ++a)
+			{
+				// Equal counts are not enough, the elements of a 2x3 and a 3x2 matrix do
+				// not correspond
+				const basic_matrix<float> &side(*slots[s.inputs[a]]);
+				if (side.depth() != first.depth() || !std::equal(first.dims(), first.dims() + first.depth(), side.dims()))
+					throw std::runtime_error(s.stage->name + ": matrix arguments have different dimensions");
+
+				side_storage.emplace_back();
+				sides[g].push_back(row_major_data(side, side_storage.back()));
+			}
+		}
+
+		std::vector<float> out(count);
+		std::vector<const float *> chunk_inputs;
+
+		for (std::size_t offset = 0; offset < count; offset += pipeline_chunk)
+		{
+			const std::size_t n = std::min(pipeline_chunk, count - offset);
+			std::copy_n(head_data + offset, n, out.data() + offset);
+
+			for (size_t g = 0; g < group.size(); ++g)
+			{
+				const step &s(steps_[group[g]]);
+
+				chunk_inputs.clear();
+				for (const float *side : sides[g])
+					chunk_inputs.push_back(side + offset);
+
+				s.stage->kernel(out.data() + offset, chunk_inputs.data(), n, s.params.data());
+			}
+		}
+
+		slots[slot_of(group.back())] =
+			vector_matrix<float>::make(std::move(out), std::vector<int>(first.dims(), first.dims() + first.depth()));
+	}
+
+	return slots.back();
+}
+
+pipeline_cache::pipeline_cache(std::size_t capacity) : pipelines_(), revision_(0), capacity_(capacity) {}
+
+std::shared_ptr<const pipeline> pipeline_cache::get(const std::string &description, const pipeline_registry &registry)
+{
+	if (registry.revision() != revision_)
+	{
+		pipelines_.clear();
+		revision_ = registry.revision();
+	}
+
+	auto it = pipelines_.find(description);
+	if (it != pipelines_.end())
+		return it->second;
+
+	auto parsed(std::make_shared<const pipeline>(pipeline::parse(description, registry)));
+
+	if (pipelines_.size() >= capacity_)
+		pipelines_.clear();
+
+	pipelines_.emplace(description, parsed);
+	return parsed;
+}
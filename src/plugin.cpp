@@ -0,0 +1,274 @@
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "omw/plugin.hpp"
+
+using namespace omw;
+
+namespace
+{
+/**
+ * @brief Registrar collecting the stages of a plugin, so that they are only added to the
+ * registry once the plugin has been registered successfully
+ */
+class collecting_registrar : public plugin_registrar
+{
+	public:
+	std::vector<pipeline_stage> stages;
+
+	void add_elementwise(const std::string &name, int matrix_args, int scalar_args, elementwise_kernel kernel) override
+	{
+		stages.push_back(pipeline_stage{ name, matrix_args, scalar_args, std::move(kernel), stage_function() });
+	}
+
+	void add_stage(const std::string &name, int matrix_args, int scalar_args, stage_function function) override
+	{
+		stages.push_back(pipeline_stage{ name, matrix_args, scalar_args, elementwise_kernel(), std::move(function) });
+	}
+};
+}
+
+/**
+ * @brief Throws an error about a plugin
+ */
+[[noreturn]] static void plugin_error(const std::string &path, const std::string &what)
+{
+	std::stringstream ss;
+	ss << "Cannot load plugin " << path << ": " << what;
+	throw std::runtime_error(ss.str());
+}
+
+/**
+ * @brief Gets the modification time of a file, in nanoseconds
+ */
+static std::int64_t file_mtime(const std::string &path)
+{
+	struct stat st;
+	if (stat(path.c_str(), &st) != 0)
+		plugin_error(path, std::strerror(errno));
+
+	return std::int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+}
+
+/**
+ * @brief Copies a file to a new temporary file
+ *
+ * @return Path of the copy
+ */
+static std::string copy_to_temporary(const std::string &path)
+{
+	const char *tmpdir = std::getenv("TMPDIR");
+	std::string copy_path(std::string(tmpdir && *tmpdir ? tmpdir : "/tmp") + "/omw_plugin_XXXXXX");
+
+	int dst = mkstemp(&copy_path[0]);
+	if (dst < 0)
+		plugin_error(path, std::string("cannot create a copy, ") + std::strerror(errno));
+
+	int src = open(path.c_str(), O_RDONLY);
+	bool ok = src >= 0;
+
+	char buffer[65536];
+	for (ssize_t n; ok && (n = read(src, buffer, sizeof(buffer))) != 0;)
+	{
+		ok = n > 0;
+		for (ssize_t written = 0, w; ok && written < n; written += w)
+			ok = (w = write(dst, buffer + written, n - written)) > 0;
+	}
+
+	const int err = errno;
+	if (src >= 0)
+		close(src);
+	close(dst);
+
+	if (!ok)
+	{
+		unlink(copy_path.c_str());
+		plugin_error(path, std::strerror(err));
+	}
+
+	return copy_path;
+}
+
+/**
+ * @brief Tests if a stage name can be called from a pipeline description
+ */
+static bool valid_stage_name(const std::string &name)
+{
+	if (name.empty() || !(std::isalpha(static_cast<unsigned char>(name[0])) || name[0] == '_'))
+		return false;
+
+	for (char c : name)
+	{
+		if (!(std::isalnum(static_cast<unsigned char>(c)) || c == '_'))
+			return false;
+	}
+
+	return true;
+}
+
+plugin_loader::plugin_loader() : plugins_(), retired_() {}
+
+void plugin_loader::check_stages(const std::string &path, const std::vector<pipeline_stage> &stages,
+								 const pipeline_registry &registry) const
+{
+	auto self = plugins_.find(path);
+	std::set<std::string> names;
+
+	for (const auto &stage : stages)
+	{
+		// Stages of the previous version of this plugin are replaced, any other
+		// registered stage is a builtin or belongs to another plugin
+		const bool replaced = self != plugins_.end() &&
+							  std::find(self->second.stages.begin(), self->second.stages.end(), stage.name) !=
+								  self->second.stages.end();
+
+		std::stringstream ss;
+		ss << "stage \"" << stage.name << "\" ";
+
+		if (!valid_stage_name(stage.name))
+			ss << "has an invalid name";
+		else if (!names.insert(stage.name).second)
+			ss << "is registered twice";
+		else if (stage.matrix_args < 0 || stage.scalar_args < 0)
+			ss << "has a negative number of arguments";
+		else if (!stage.kernel && !stage.function)
+			ss << "has no implementation";
+		else if (stage.elementwise() && stage.matrix_args < 1)
+			ss << "is elementwise and needs at least one matrix argument";
+		else if (registry.find(stage.name) && !replaced)
+		{
+			ss << "is already registered";
+			for (const auto &other : plugins_)
+			{
+				const auto &owned(other.second.stages);
+				if (std::find(owned.begin(), owned.end(), stage.name) != owned.end())
+					ss << " by plugin " << other.first;
+			}
+		}
+		else
+			continue;
+
+		plugin_error(path, ss.str());
+	}
+}
+
+std::size_t plugin_loader::load(const std::string &path, pipeline_registry &registry)
+{
+	const std::int64_t mtime = file_mtime(path);
+
+	// dlopen returns the same handle for a path that is already loaded, so every load
+	// maps its own copy. The copy is unlinked right away, the mapping keeps it alive.
+	const std::string copy_path(copy_to_temporary(path));
+	void *handle = dlopen(copy_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+	unlink(copy_path.c_str());
+
+	if (!handle)
+		plugin_error(path, dlerror());
+
+	collecting_registrar registrar;
+
+	try
+	{
+		auto abi = reinterpret_cast<int (*)()>(dlsym(handle, "omw_plugin_abi"));
+		auto entry = reinterpret_cast<void (*)(plugin_registrar *)>(dlsym(handle, "omw_plugin_register"));
+
+		if (!abi || !entry)
+			plugin_error(path, "no OMW_PLUGIN entry point");
+
+		if (abi() != OMW_PLUGIN_ABI)
+		{
+			std::stringstream ss;
+			ss << "plugin interface version " << abi() << " instead of " << OMW_PLUGIN_ABI;
+			plugin_error(path, ss.str());
+		}
+
+		entry(&registrar);
+
+		// The registry is only modified once every stage is known to be valid, so that
+		// a failed load keeps the previous version entirely
+		check_stages(path, registrar.stages, registry);
+	}
+	catch (...)
+	{
+		// The stages hold code of the plugin, release them before unmapping it
+		registrar.stages.clear();
+		dlclose(handle);
+		throw;
+	}
+
+	// Swap the stages of the previous version for the new ones
+	auto it = plugins_.find(path);
+	if (it == plugins_.end())
+		it = plugins_.emplace(path, plugin{ nullptr, 0, {}, 0 }).first;
+
+	plugin &p(it->second);
+	for (const auto &name : p.stages)
+		registry.remove(name);
+
+	p.stages.clear();
+	for (auto &stage : registrar.stages)
+	{
+		p.stages.push_back(stage.name);
+
+		if (stage.elementwise())
+			registry.add_elementwise(stage.name, stage.matrix_args, stage.scalar_args, std::move(stage.kernel));
+		else
+			registry.add_stage(stage.name, stage.matrix_args, stage.scalar_args, std::move(stage.function));
+	}
+
+	if (p.handle)
+		retired_.push_back(p.handle);
+
+	p.handle = handle;
+	p.mtime = mtime;
+	p.generation++;
+
+	return p.stages.size();
+}
+
+std::size_t plugin_loader::refresh(pipeline_registry &registry)
+{
+	// Collect the paths first, load modifies the map
+	std::vector<std::string> modified;
+	for (const auto &entry : plugins_)
+	{
+		if (file_mtime(entry.first) != entry.second.mtime)
+			modified.push_back(entry.first);
+	}
+
+	for (const auto &path : modified)
+		load(path, registry);
+
+	return modified.size();
+}
+
+bool plugin_loader::unload(const std::string &path, pipeline_registry &registry)
+{
+	auto it = plugins_.find(path);
+	if (it == plugins_.end())
+		return false;
+
+	for (const auto &name : it->second.stages)
+		registry.remove(name);
+
+	retired_.push_back(it->second.handle);
+	plugins_.erase(it);
+	return true;
+}
+
+int plugin_loader::generation(const std::string &path) const
+{
+	auto it = plugins_.find(path);
+	return it == plugins_.end() ? 0 : it->second.generation;
+}
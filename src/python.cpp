@@ -0,0 +1,1382 @@
+#include "omw/python.hpp"
+
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+#include "omw/array.hpp"
+#include "omw/bitmask.hpp"
+#include "omw/dictionary.hpp"
+#include "omw/matrix.hpp"
+#include "omw/matrix_batch.hpp"
+#include "omw/matrix_view.hpp"
+#include "omw/ragged_array.hpp"
+#include "omw/range_view.hpp"
+#include "omw/snapshot.hpp"
+#include "omw/tiled_matrix.hpp"
+#include "omw/wrapper_base.hpp"
+
+#if OMW_PYTHON
+
+using namespace omw;
+
+namespace
+{
+/**
+ * @brief Buffer of a parameter, released when the last array or matrix using it is
+ * destroyed
+ */
+struct buffer_holder
+{
+	Py_buffer view;
+
+	~buffer_holder()
+	{
+		// Arrays kept after the interpreter exits cannot release their buffer
+		if (!Py_IsInitialized())
+			return;
+
+		PyGILState_STATE state = PyGILState_Ensure();
+		PyBuffer_Release(&view);
+		PyGILState_Release(state);
+	}
+};
+
+/// Element types of buffers that can be read
+enum buffer_format
+{
+	format_unsupported,
+	format_float,
+	format_double,
+	format_bytes
+};
+
+/**
+ * @brief Gets the buffer of an object
+ *
+ * @param obj   Object to get the buffer of
+ * @param ndim  Number of dimensions to accept
+ * @param bytes Accept bool, int8 and uint8 buffers instead of float and double ones
+ * @return Buffer, or nullptr if \p obj does not export a buffer of the accepted element
+ *         types with the requested number of dimensions
+ */
+std::shared_ptr<buffer_holder> get_buffer(PyObject *obj, int min_ndim, int max_ndim, buffer_format &format,
+										  bool bytes = false)
+{
+	if (!PyObject_CheckBuffer(obj))
+		return {};
+
+	auto holder(std::make_shared<buffer_holder>());
+	if (PyObject_GetBuffer(obj, &holder->view, PyBUF_RECORDS_RO) != 0)
+	{
+		PyErr_Clear();
+		// Nothing to release
+		std::memset(&holder->view, 0, sizeof(holder->view));
+		return {};
+	}
+
+	const Py_buffer &view(holder->view);
+
+	// Native byte order and alignment only
+	const char *f = view.format ? view.format : "B";
+	if (*f == '@' || *f == '=')
+		++f;
+
+	format = format_unsupported;
+	if (bytes)
+	{
+		if ((std::strcmp(f, "?") == 0 || std::strcmp(f, "b") == 0 || std::strcmp(f, "B") == 0) && view.itemsize == 1)
+			format = format_bytes;
+	}
+	else if (std::strcmp(f, "f") == 0 && view.itemsize == sizeof(float))
+		format = format_float;
+	else if (std::strcmp(f, "d") == 0 && view.itemsize == sizeof(double))
+		format = format_double;
+
+	if (format == format_unsupported || view.ndim < min_ndim || view.ndim > max_ndim)
+		return {};
+
+	return holder;
+}
+
+/**
+ * @brief Gets the dimensions of a buffer
+ */
+std::vector<int> buffer_dims(const Py_buffer &view)
+{
+	std::vector<int> dims(view.ndim);
+	for (int d = 0; d < view.ndim; ++d)
+		dims[d] = static_cast<int>(view.shape[d]);
+	return dims;
+}
+
+/**
+ * @brief Copies the elements of a buffer of up to 3 dimensions in row-major order,
+ * following its strides
+ */
+template <typename TSrc, typename Fun> void copy_buffer(const Py_buffer &view, float *dst, Fun &&convert)
+{
+	Py_ssize_t shape[3] = { 1, 1, 1 }, strides[3] = { 0, 0, 0 };
+	for (int d = 0; d < view.ndim; ++d)
+	{
+		shape[d] = view.shape[d];
+		strides[d] = view.strides[d];
+	}
+
+	const char *base = static_cast<const char *>(view.buf);
+	for (Py_ssize_t i = 0; i < shape[0]; ++i)
+		for (Py_ssize_t j = 0; j < shape[1]; ++j)
+		{
+			const char *src = base + i * strides[0] + j * strides[1];
+			for (Py_ssize_t k = 0; k < shape[2]; ++k)
+				*dst++ = convert(static_cast<float>(*reinterpret_cast<const TSrc *>(src + k * strides[2])));
+		}
+}
+
+template <typename Fun> void copy_buffer(const Py_buffer &view, buffer_format format, float *dst, Fun &&convert)
+{
+	if (format == format_float)
+		copy_buffer<float>(view, dst, convert);
+	else
+		copy_buffer<double>(view, dst, convert);
+}
+
+/**
+ * @brief Tests if a buffer can be used in place as row-major floats
+ */
+bool in_place(const Py_buffer &view, buffer_format format)
+{
+	return format == format_float && PyBuffer_IsContiguous(&view, 'C');
+}
+
+/**
+ * @brief Python object exporting the elements of an omw::basic_matrix through the
+ * buffer protocol
+ */
+struct matrix_object
+{
+	PyObject_HEAD
+	std::shared_ptr<basic_matrix<float>> *matrix;
+	Py_ssize_t shape[8];
+	Py_ssize_t strides[8];
+};
+
+void matrix_dealloc(PyObject *self)
+{
+	delete reinterpret_cast<matrix_object *>(self)->matrix;
+	Py_TYPE(self)->tp_free(self);
+}
+
+int matrix_getbuffer(PyObject *self, Py_buffer *view, int flags)
+{
+	matrix_object &m(*reinterpret_cast<matrix_object *>(self));
+
+	if (flags & PyBUF_WRITABLE)
+	{
+		PyErr_SetString(PyExc_BufferError, "omw.matrix objects are read-only");
+		view->obj = nullptr;
+		return -1;
+	}
+
+	const basic_matrix<float> &matrix(**m.matrix);
+	Py_ssize_t count = 1;
+	for (int d = 0; d < matrix.depth(); ++d)
+		count *= matrix.dims()[d];
+
+	view->buf = const_cast<float *>(matrix.data());
+	view->obj = self;
+	Py_INCREF(self);
+	view->len = count * sizeof(float);
+	view->itemsize = sizeof(float);
+	view->readonly = 1;
+	view->format = (flags & PyBUF_FORMAT) ? const_cast<char *>("f") : nullptr;
+	view->ndim = matrix.depth();
+	view->shape = (flags & PyBUF_ND) ? m.shape : nullptr;
+	view->strides = (flags & PyBUF_STRIDES) ? m.strides : nullptr;
+	view->suboffsets = nullptr;
+	view->internal = nullptr;
+
+	return 0;
+}
+
+PyObject *matrix_shape(PyObject *self, void *)
+{
+	matrix_object &m(*reinterpret_cast<matrix_object *>(self));
+	int depth = (*m.matrix)->depth();
+
+	PyObject *shape = PyTuple_New(depth);
+	if (!shape)
+		return nullptr;
+
+	for (int d = 0; d < depth; ++d)
+		PyTuple_SET_ITEM(shape, d, PyLong_FromSsize_t(m.shape[d]));
+	return shape;
+}
+
+PyBufferProcs matrix_buffer_procs = { matrix_getbuffer, nullptr };
+
+PyGetSetDef matrix_getset[] = { { const_cast<char *>("shape"), matrix_shape, nullptr,
+								  const_cast<char *>("Dimensions of the matrix"), nullptr },
+								{ nullptr, nullptr, nullptr, nullptr, nullptr } };
+
+PyTypeObject matrix_type = { PyVarObject_HEAD_INIT(nullptr, 0) "omw.matrix", sizeof(matrix_object) };
+
+bool matrix_type_ready()
+{
+	if (matrix_type.tp_flags & Py_TPFLAGS_READY)
+		return true;
+
+	matrix_type.tp_dealloc = matrix_dealloc;
+	matrix_type.tp_as_buffer = &matrix_buffer_procs;
+	matrix_type.tp_flags = Py_TPFLAGS_DEFAULT;
+	matrix_type.tp_doc = "Result matrix of an omw function, in row-major order. Supports the buffer protocol.";
+	matrix_type.tp_getset = matrix_getset;
+
+	return PyType_Ready(&matrix_type) == 0;
+}
+}
+
+python::python(std::function<void(void)> userInitializer)
+: wrapper_base<python>(std::forward<std::function<void(void)>>(userInitializer)), current_args_(), result_()
+{
+}
+
+PyObject *python::result()
+{
+	if (result_stack_.empty())
+		return result_;
+	return result_stack_.top();
+}
+
+void python::append_result(PyObject *value)
+{
+	if (!value)
+	{
+		PyErr_Clear();
+		throw std::runtime_error("Failed to convert a result to a Python object");
+	}
+
+	int status = PyList_Append(result(), value);
+	Py_DECREF(value);
+
+	if (status != 0)
+	{
+		PyErr_Clear();
+		throw std::runtime_error("Failed to append a result");
+	}
+}
+
+void python::push_result()
+{
+	if (result_stack_.empty())
+	{
+		result_stack_.push(result_);
+	}
+	else
+	{
+		// The sublist is kept alive by its parent
+		PyObject *sublist = PyList_New(0);
+		PyObject *parent = result();
+		append_result(sublist);
+		result_stack_.push(PyList_GET_ITEM(parent, PyList_GET_SIZE(parent) - 1));
+	}
+}
+
+void python::pop_result()
+{
+	result_stack_.pop();
+}
+
+python::param_reader_base::param_reader_base(python &w) : w_(w) {}
+
+void python::param_reader_base::check_parameter_idx(size_t paramIdx, const std::string &paramName)
+{
+	if (size_t(PyTuple_GET_SIZE(w_.current_args_)) <= paramIdx)
+	{
+		std::stringstream ss;
+		ss << "Requested parameter " << paramName << " at index " << paramIdx
+		   << " but there is not enough parameters";
+		throw std::runtime_error(ss.str());
+	}
+}
+
+PyObject *python::run_function(const char *name, PyObject *args, std::function<void(python &)> fun)
+{
+	std::lock_guard<call_mutex> lock(metrics().state_mutex());
+	profiler().begin_call(name);
+
+	current_args_ = args;
+	result_ = PyList_New(0);
+	result_stack_ = std::stack<PyObject *>();
+
+	if (!result_)
+	{
+		profiler().end_call(true);
+		return nullptr;
+	}
+
+	try
+	{
+		fun(*this);
+		deliver_messages();
+
+		profiler().end_call(false);
+	}
+	catch (std::exception &ex)
+	{
+		// Exceptions must not propagate into the interpreter
+		profiler().end_call(true);
+		Py_CLEAR(result_);
+		send_failure(ex.what());
+		return nullptr;
+	}
+	catch (...)
+	{
+		// Nor any other exception, which would reach std::terminate in the C frames of
+		// the interpreter
+		profiler().end_call(true);
+		Py_CLEAR(result_);
+		send_failure("unknown exception");
+		return nullptr;
+	}
+
+	PyObject *result = nullptr;
+	switch (PyList_GET_SIZE(result_))
+	{
+	case 0:
+		result = Py_None;
+		Py_INCREF(result);
+		break;
+	case 1:
+		result = PyList_GET_ITEM(result_, 0);
+		Py_INCREF(result);
+		break;
+	default:
+		result = PyList_AsTuple(result_);
+		break;
+	}
+
+	Py_CLEAR(result_);
+	return result;
+}
+
+PyObject *python::to_python(bool value) { return PyBool_FromLong(value); }
+
+PyObject *python::to_python(int value) { return PyLong_FromLong(value); }
+
+PyObject *python::to_python(unsigned int value) { return PyLong_FromUnsignedLong(value); }
+
+PyObject *python::to_python(float value) { return PyFloat_FromDouble(value); }
+
+PyObject *python::to_python(const char *value) { return PyUnicode_FromString(value); }
+
+PyObject *python::to_python(const std::string &value)
+{
+	return PyUnicode_FromStringAndSize(value.data(), value.size());
+}
+
+PyObject *python::to_python(const std::vector<int> &value)
+{
+	PyObject *result = PyTuple_New(value.size());
+	if (!result)
+		return nullptr;
+
+	for (std::size_t i = 0; i < value.size(); ++i)
+	{
+		PyObject *item = to_python(value[i]);
+		if (!item)
+		{
+			Py_DECREF(result);
+			return nullptr;
+		}
+
+		PyTuple_SET_ITEM(result, i, item);
+	}
+
+	return result;
+}
+
+PyObject *python::to_python(const ragged_array<float> &value)
+{
+	PyObject *result = PyList_New(value.size());
+	if (!result)
+		return nullptr;
+
+	for (std::size_t i = 0; i < value.size(); ++i)
+	{
+		std::vector<float> elements(value.row(i), value.row(i) + value.row_size(i));
+		PyObject *row = to_python(vector_matrix<float>::make(std::move(elements),
+															 std::vector<int>{ static_cast<int>(value.row_size(i)) }));
+		if (!row)
+		{
+			Py_DECREF(result);
+			return nullptr;
+		}
+
+		// Steals the reference
+		PyList_SET_ITEM(result, i, row);
+	}
+
+	return result;
+}
+
+PyObject *python::to_python(const bitmask &value)
+{
+	PyObject *bytes = PyBytes_FromStringAndSize(nullptr, value.size());
+	if (!bytes)
+		return nullptr;
+
+	value.unpack(reinterpret_cast<unsigned char *>(PyBytes_AS_STRING(bytes)));
+
+	PyObject *view = PyMemoryView_FromObject(bytes);
+	Py_DECREF(bytes);
+	if (!view)
+		return nullptr;
+
+	// Shapes cannot have zero extents, empty masks stay 1-D
+	PyObject *shape = nullptr;
+	if (value.size() > 0)
+	{
+		shape = PyTuple_New(value.dims().size());
+		if (!shape)
+		{
+			Py_DECREF(view);
+			return nullptr;
+		}
+
+		for (std::size_t d = 0; d < value.dims().size(); ++d)
+			PyTuple_SET_ITEM(shape, d, PyLong_FromLong(value.dims()[d]));
+	}
+
+	// bool memoryviews are used in place by numpy.asarray
+	PyObject *result = shape ? PyObject_CallMethod(view, "cast", "sO", "?", shape)
+							 : PyObject_CallMethod(view, "cast", "s", "?");
+	Py_XDECREF(shape);
+	Py_DECREF(view);
+
+	return result;
+}
+
+PyObject *python::to_python(const dictionary &value)
+{
+	PyObject *result = PyDict_New();
+	if (!result)
+		return nullptr;
+
+	for (std::size_t i = 0; i < value.size(); ++i)
+	{
+		const dictionary_value &entry(value.value(i));
+		PyObject *item;
+
+		if (const bool *flag = boost::get<bool>(&entry))
+			item = to_python(*flag);
+		else if (const int *number = boost::get<int>(&entry))
+			item = to_python(*number);
+		else if (const float *real = boost::get<float>(&entry))
+			item = to_python(*real);
+		else if (const std::string *text = boost::get<std::string>(&entry))
+			item = to_python(*text);
+		else if (const std::vector<int> *list = boost::get<std::vector<int>>(&entry))
+			item = to_python(*list);
+		else
+			item = to_python(boost::get<std::shared_ptr<basic_matrix<float>>>(entry));
+
+		const std::string key(value.key(i));
+		PyObject *pykey = item ? PyUnicode_FromStringAndSize(key.data(), key.size()) : nullptr;
+
+		if (!pykey || PyDict_SetItem(result, pykey, item) != 0)
+		{
+			Py_XDECREF(pykey);
+			Py_XDECREF(item);
+			Py_DECREF(result);
+			return nullptr;
+		}
+
+		Py_DECREF(pykey);
+		Py_DECREF(item);
+	}
+
+	return result;
+}
+
+PyObject *python::to_python(const matrix_batch<float> &value)
+{
+	// The batch is already a row-major array, the matrix shares its storage
+	return to_python(value.as_matrix());
+}
+
+PyObject *python::to_python(const std::shared_ptr<basic_matrix<float>> &value)
+{
+	if (value->depth() > 8 || !matrix_type_ready())
+		return nullptr;
+
+	// Exported buffers are row-major
+	std::shared_ptr<basic_matrix<float>> matrix(value);
+	if (!matrix->row_major())
+	{
+		std::vector<int> dims(value->dims(), value->dims() + value->depth());
+		std::size_t count = 1;
+		for (int d : dims)
+			count *= d;
+
+		std::vector<float> elements(count);
+		value->copy_to(elements.data());
+		matrix = vector_matrix<float>::make(std::move(elements), std::move(dims));
+	}
+
+	matrix_object *result = PyObject_New(matrix_object, &matrix_type);
+	if (!result)
+		return nullptr;
+
+	result->matrix = new std::shared_ptr<basic_matrix<float>>(std::move(matrix));
+
+	const basic_matrix<float> &m(**result->matrix);
+	Py_ssize_t stride = sizeof(float);
+	for (int d = m.depth() - 1; d >= 0; --d)
+	{
+		result->shape[d] = m.dims()[d];
+		result->strides[d] = stride;
+		stride *= m.dims()[d];
+	}
+
+	return reinterpret_cast<PyObject *>(result);
+}
+
+python::result_writer_base::result_writer_base(python &w)
+	: w_(w)
+{
+}
+
+void python::send_failure(const std::string &exceptionMessage, const std::string &messageName)
+{
+	// The warnings of the call are still issued before its exception is raised
+	try
+	{
+		deliver_messages();
+	}
+	catch (std::exception &)
+	{
+		PyErr_Clear();
+	}
+
+	PyErr_SetString(PyExc_RuntimeError, (messageName + ": " + exceptionMessage).c_str());
+}
+
+void python::send_messages(const std::vector<queued_message> &messages)
+{
+	for (const auto &message : messages)
+	{
+		const std::string text(message.format());
+
+		if (message.kind == message_progress)
+		{
+			PySys_FormatStderr("%s: %s\n", message.name.c_str(), text.c_str());
+		}
+		else if (PyErr_WarnFormat(PyExc_RuntimeWarning, 1, "%s: %s", message.name.c_str(), text.c_str()) < 0)
+		{
+			// The warning filters turned the warning into an exception
+			throw std::runtime_error(message.name + ": " + text);
+		}
+	}
+}
+
+template <>
+bool python::param_reader<bool>::try_read(size_t paramIdx, const std::string &paramName, bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	if (!PyBool_Check(arg(paramIdx)))
+	{
+		success = false;
+		return false;
+	}
+
+	return arg(paramIdx) == Py_True;
+}
+
+/**
+ * @brief Reads an integer parameter, accepting any object that implements __index__
+ */
+static bool read_integer(PyObject *obj, long long &value)
+{
+	if (PyFloat_Check(obj) || !PyIndex_Check(obj))
+		return false;
+
+	PyObject *index = PyNumber_Index(obj);
+	if (!index)
+	{
+		PyErr_Clear();
+		return false;
+	}
+
+	int overflow = 0;
+	value = PyLong_AsLongLongAndOverflow(index, &overflow);
+	Py_DECREF(index);
+
+	if (overflow != 0 || (value == -1 && PyErr_Occurred()))
+	{
+		PyErr_Clear();
+		return false;
+	}
+
+	return true;
+}
+
+template <>
+int python::param_reader<int>::try_read(size_t paramIdx, const std::string &paramName, bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	long long value;
+	if (!read_integer(arg(paramIdx), value) || value < std::numeric_limits<int>::min() ||
+		value > std::numeric_limits<int>::max())
+	{
+		success = false;
+		return 0;
+	}
+
+	return static_cast<int>(value);
+}
+
+template <>
+unsigned int python::param_reader<unsigned int>::try_read(size_t paramIdx, const std::string &paramName,
+														 bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	long long value;
+	if (!read_integer(arg(paramIdx), value) || value < 0 || value > std::numeric_limits<unsigned int>::max())
+	{
+		success = false;
+		return 0;
+	}
+
+	return static_cast<unsigned int>(value);
+}
+
+template <>
+float python::param_reader<float>::try_read(size_t paramIdx, const std::string &paramName, bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	PyObject *obj = arg(paramIdx);
+
+	// Objects exporting buffers are arrays, even if they convert to float
+	PyNumberMethods *number = Py_TYPE(obj)->tp_as_number;
+	if (!PyFloat_Check(obj) && !PyLong_Check(obj) &&
+		(!number || !number->nb_float || PyObject_CheckBuffer(obj)))
+	{
+		success = false;
+		return 0.0f;
+	}
+
+	double value = PyFloat_AsDouble(obj);
+	if (value == -1.0 && PyErr_Occurred())
+	{
+		PyErr_Clear();
+		success = false;
+		return 0.0f;
+	}
+
+	return static_cast<float>(value);
+}
+
+template <>
+std::string python::param_reader<std::string>::try_read(size_t paramIdx, const std::string &paramName,
+													   bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	if (!PyUnicode_Check(arg(paramIdx)))
+	{
+		success = false;
+		return std::string();
+	}
+
+	if (!getData)
+		return std::string();
+
+	Py_ssize_t size;
+	const char *data = PyUnicode_AsUTF8AndSize(arg(paramIdx), &size);
+	if (!data)
+	{
+		PyErr_Clear();
+		success = false;
+		return std::string();
+	}
+
+	return std::string(data, size);
+}
+
+template <>
+std::shared_ptr<basic_array<float>>
+python::param_reader<std::shared_ptr<basic_array<float>>>::try_read(size_t paramIdx, const std::string &paramName,
+																   bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	buffer_format format;
+	auto buffer(get_buffer(arg(paramIdx), 1, 2, format));
+	if (!buffer)
+	{
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+		return {};
+
+	const Py_buffer &view(buffer->view);
+	const std::size_t count = view.len / view.itemsize;
+	const validation_options &options(w_.param_validation());
+
+	// float32 contiguous buffers are used in place
+	if (in_place(view, format))
+	{
+		const float *data = static_cast<const float *>(view.buf);
+		auto result(mapped_array<float>::make(buffer, data, count));
+
+		if (options.enabled())
+		{
+			validator<float> validate(options, paramName);
+			for (std::size_t i = 0; i < count; ++i)
+				validate(data[i]);
+			result->stats(validate.stats());
+		}
+
+		return result;
+	}
+
+	// Validation is fused in the conversion loop
+	std::vector<float> vecd(count);
+	if (!options.enabled())
+	{
+		copy_buffer(view, format, vecd.data(), [](float v) { return v; });
+		return vector_array<float>::make(std::move(vecd));
+	}
+
+	validator<float> validate(options, paramName);
+	copy_buffer(view, format, vecd.data(), validate);
+
+	auto result(vector_array<float>::make(std::move(vecd)));
+	result->stats(validate.stats());
+	return result;
+}
+
+template <>
+std::shared_ptr<basic_matrix<float>>
+python::param_reader<std::shared_ptr<basic_matrix<float>>>::try_read(size_t paramIdx, const std::string &paramName,
+																	bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	buffer_format format;
+	auto buffer(get_buffer(arg(paramIdx), 2, 3, format));
+	if (!buffer)
+	{
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+		return {};
+
+	const Py_buffer &view(buffer->view);
+	const std::size_t count = view.len / view.itemsize;
+	const validation_options &options(w_.param_validation());
+
+	// float32 C-contiguous buffers are used in place
+	if (in_place(view, format))
+	{
+		const float *data = static_cast<const float *>(view.buf);
+		auto result(mapped_matrix<float>::make(buffer, data, buffer_dims(view)));
+
+		if (options.enabled())
+		{
+			validator<float> validate(options, paramName);
+			for (std::size_t i = 0; i < count; ++i)
+				validate(data[i]);
+			result->stats(validate.stats());
+		}
+
+		return result;
+	}
+
+	// Validation is fused in the conversion loop
+	std::vector<float> f(count);
+	if (!options.enabled())
+	{
+		copy_buffer(view, format, f.data(), [](float v) { return v; });
+		return vector_matrix<float>::make(std::move(f), buffer_dims(view));
+	}
+
+	validator<float> validate(options, paramName);
+	copy_buffer(view, format, f.data(), validate);
+
+	auto result(vector_matrix<float>::make(std::move(f), buffer_dims(view)));
+	result->stats(validate.stats());
+	return result;
+}
+
+template <>
+matrix_view<float>
+python::param_reader<matrix_view<float>>::try_read(size_t paramIdx, const std::string &paramName,
+												   bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	buffer_format format;
+	auto buffer(get_buffer(arg(paramIdx), 1, 3, format));
+	if (!buffer)
+	{
+		success = false;
+		return {};
+	}
+
+	const Py_buffer &view(buffer->view);
+
+	// Views address elements, so strides must be multiples of the element size
+	std::array<int, 3> dims{ { 1, 1, 1 } };
+	std::array<std::ptrdiff_t, 3> strides{ { 1, 1, 1 } };
+	for (int d = 0; d < view.ndim; ++d)
+	{
+		if (view.strides[d] % view.itemsize != 0)
+		{
+			success = false;
+			return {};
+		}
+
+		dims[d] = static_cast<int>(view.shape[d]);
+		strides[d] = view.strides[d] / view.itemsize;
+	}
+
+	if (!getData)
+		return {};
+
+	// Any layout is viewed in place
+	if (format == format_float)
+		return matrix_view<float>(buffer, static_cast<const float *>(view.buf), dims, strides);
+
+	return matrix_view<float>(buffer, static_cast<const double *>(view.buf), dims, strides);
+}
+
+/**
+ * @brief Reads an integer attribute of a range object
+ */
+static bool range_attribute(PyObject *obj, const char *name, long long &value)
+{
+	PyObject *attr = PyObject_GetAttrString(obj, name);
+	if (!attr)
+	{
+		PyErr_Clear();
+		return false;
+	}
+
+	bool result = read_integer(attr, value);
+	Py_DECREF(attr);
+	return result;
+}
+
+template <>
+range_view<float>
+python::param_reader<range_view<float>>::try_read(size_t paramIdx, const std::string &paramName,
+												   bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	PyObject *obj = arg(paramIdx);
+	if (!PyRange_Check(obj))
+	{
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+		return {};
+
+	// range objects only hold their bounds, like Octave ranges
+	long long start, step;
+	Py_ssize_t size = PyObject_Size(obj);
+	if (size < 0 || !range_attribute(obj, "start", start) || !range_attribute(obj, "step", step))
+	{
+		PyErr_Clear();
+		std::stringstream ss;
+		ss << "Failed to read the bounds of range parameter " << paramName << " at index " << paramIdx;
+		throw std::runtime_error(ss.str());
+	}
+
+	return range_view<float>(double(start), double(step), std::size_t(size));
+}
+
+template <>
+ragged_array<float>
+python::param_reader<ragged_array<float>>::try_read(size_t paramIdx, const std::string &paramName,
+													bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	// Ragged arrays are lists or tuples of 1-D buffers
+	PyObject *obj = arg(paramIdx);
+	if (!PyList_Check(obj) && !PyTuple_Check(obj))
+	{
+		success = false;
+		return {};
+	}
+
+	const Py_ssize_t rows = PySequence_Fast_GET_SIZE(obj);
+	PyObject **items = PySequence_Fast_ITEMS(obj);
+
+	std::vector<std::shared_ptr<buffer_holder>> buffers(rows);
+	std::vector<buffer_format> formats(rows);
+	std::size_t total = 0;
+
+	for (Py_ssize_t i = 0; i < rows; ++i)
+	{
+		buffers[i] = get_buffer(items[i], 1, 1, formats[i]);
+		if (!buffers[i])
+		{
+			success = false;
+			return {};
+		}
+
+		total += buffers[i]->view.shape[0];
+	}
+
+	if (!getData)
+		return {};
+
+	ragged_array<float> result;
+	result.reserve(rows, total);
+
+	// Validation is fused in the conversion loop
+	const validation_options &options(w_.param_validation());
+	validator<float> validate(options, paramName);
+
+	for (Py_ssize_t i = 0; i < rows; ++i)
+	{
+		const Py_buffer &view(buffers[i]->view);
+		float *dst = result.append_row(view.shape[0]);
+
+		if (options.enabled())
+			copy_buffer(view, formats[i], dst, validate);
+		else
+			copy_buffer(view, formats[i], dst, [](float v) { return v; });
+	}
+
+	return result;
+}
+
+template <>
+matrix_batch<float>
+python::param_reader<matrix_batch<float>>::try_read(size_t paramIdx, const std::string &paramName,
+													bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	PyObject *obj = arg(paramIdx);
+	const validation_options &options(w_.param_validation());
+	validator<float> validate(options, paramName);
+
+	// Batches are lists or tuples of equally shaped buffers
+	if (PyList_Check(obj) || PyTuple_Check(obj))
+	{
+		const Py_ssize_t count = PySequence_Fast_GET_SIZE(obj);
+		PyObject **items = PySequence_Fast_ITEMS(obj);
+
+		std::vector<std::shared_ptr<buffer_holder>> buffers(count);
+		std::vector<buffer_format> formats(count);
+		std::vector<int> item_dims;
+
+		for (Py_ssize_t i = 0; i < count; ++i)
+		{
+			buffers[i] = get_buffer(items[i], 1, 3, formats[i]);
+			if (!buffers[i] || (i > 0 && buffer_dims(buffers[i]->view) != item_dims))
+			{
+				success = false;
+				return {};
+			}
+
+			if (i == 0)
+				item_dims = buffer_dims(buffers[i]->view);
+		}
+
+		if (!getData)
+			return {};
+
+		// Items are converted straight into their slot of the batch
+		matrix_batch<float> result(count, std::move(item_dims));
+
+		for (Py_ssize_t i = 0; i < count; ++i)
+		{
+			if (options.enabled())
+				copy_buffer(buffers[i]->view, formats[i], result.item(i), validate);
+			else
+				copy_buffer(buffers[i]->view, formats[i], result.item(i), [](float v) { return v; });
+		}
+
+		return result;
+	}
+
+	// Or packed buffers, whose first dimension is the item index
+	buffer_format format;
+	auto buffer(get_buffer(obj, 2, 4, format));
+	if (!buffer)
+	{
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+		return {};
+
+	const Py_buffer &view(buffer->view);
+	std::vector<int> dims(buffer_dims(view));
+	matrix_batch<float> result(dims[0], std::vector<int>(dims.begin() + 1, dims.end()));
+
+	if (in_place(view, format))
+	{
+		std::memcpy(result.data(), view.buf, result.size() * result.item_size() * sizeof(float));
+
+		if (options.enabled())
+		{
+			float *values = result.data();
+			for (std::size_t i = 0; i < result.size() * result.item_size(); ++i)
+				values[i] = validate(values[i]);
+		}
+
+		return result;
+	}
+
+	// Strided buffers are copied one item at a time, through a view of the item
+	Py_buffer item(view);
+	item.ndim = view.ndim - 1;
+	item.shape = view.shape + 1;
+	item.strides = view.strides + 1;
+
+	for (std::size_t i = 0; i < result.size(); ++i)
+	{
+		item.buf = static_cast<char *>(view.buf) + i * view.strides[0];
+
+		if (options.enabled())
+			copy_buffer(item, format, result.item(i), validate);
+		else
+			copy_buffer(item, format, result.item(i), [](float v) { return v; });
+	}
+
+	return result;
+}
+
+template <>
+bitmask
+python::param_reader<bitmask>::try_read(size_t paramIdx, const std::string &paramName,
+										bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	PyObject *obj = arg(paramIdx);
+
+	// Lists or tuples of bool objects
+	if (PyList_Check(obj) || PyTuple_Check(obj))
+	{
+		const Py_ssize_t length = PySequence_Fast_GET_SIZE(obj);
+		PyObject **items = PySequence_Fast_ITEMS(obj);
+
+		for (Py_ssize_t i = 0; i < length; ++i)
+		{
+			if (!PyBool_Check(items[i]))
+			{
+				success = false;
+				return {};
+			}
+		}
+
+		if (!getData)
+			return {};
+
+		// bool objects are singletons, elements are told apart by identity
+		bitmask result(std::vector<int>{ static_cast<int>(length) });
+		for (Py_ssize_t i = 0; i < length; ++i)
+			if (items[i] == Py_True)
+				result.set(i);
+
+		return result;
+	}
+
+	// Or bool, int8 and uint8 buffers
+	buffer_format format;
+	auto buffer(get_buffer(obj, 1, 3, format, true));
+	if (!buffer)
+	{
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+		return {};
+
+	const Py_buffer &view(buffer->view);
+	bitmask result(buffer_dims(view));
+
+	if (PyBuffer_IsContiguous(&view, 'C'))
+	{
+		check_binary(static_cast<const unsigned char *>(view.buf), result.size(), paramName);
+		result.assign(static_cast<const unsigned char *>(view.buf));
+		return result;
+	}
+
+	std::vector<float> f(result.size());
+	copy_buffer<unsigned char>(view, f.data(), [](float v) { return v; });
+	check_binary(f.data(), result.size(), paramName);
+	result.assign(f.data());
+
+	return result;
+}
+
+/**
+ * @brief Converts the value of a dict item to the value of a dictionary entry
+ *
+ * @param item  Value of the item
+ * @param value Value of the entry, or nullptr to only test the type of \p item
+ * @return false if \p item is not a bool, int, float, str or float buffer
+ */
+static bool python_dictionary_value(PyObject *item, dictionary_value *value)
+{
+	if (PyBool_Check(item))
+	{
+		if (value)
+			*value = item == Py_True;
+		return true;
+	}
+
+	if (PyLong_Check(item))
+	{
+		int overflow;
+		long number = PyLong_AsLongAndOverflow(item, &overflow);
+		if (overflow || number < std::numeric_limits<int>::min() || number > std::numeric_limits<int>::max())
+			return false;
+
+		if (value)
+			*value = static_cast<int>(number);
+		return true;
+	}
+
+	if (PyFloat_Check(item))
+	{
+		if (value)
+			*value = static_cast<float>(PyFloat_AS_DOUBLE(item));
+		return true;
+	}
+
+	if (PyUnicode_Check(item))
+	{
+		Py_ssize_t size;
+		const char *text = PyUnicode_AsUTF8AndSize(item, &size);
+		if (!text)
+		{
+			PyErr_Clear();
+			return false;
+		}
+
+		if (value)
+			*value = std::string(text, size);
+		return true;
+	}
+
+	buffer_format format;
+	auto buffer(get_buffer(item, 1, 3, format));
+	if (!buffer)
+		return false;
+
+	if (value)
+	{
+		const Py_buffer &view(buffer->view);
+
+		// float32 C-contiguous buffers are used in place
+		if (in_place(view, format))
+		{
+			*value = mapped_matrix<float>::make(buffer, static_cast<const float *>(view.buf), buffer_dims(view));
+		}
+		else
+		{
+			std::vector<float> f(view.len / view.itemsize);
+			copy_buffer(view, format, f.data(), [](float v) { return v; });
+			*value = vector_matrix<float>::make(std::move(f), buffer_dims(view));
+		}
+	}
+
+	return true;
+}
+
+template <>
+dictionary
+python::param_reader<dictionary>::try_read(size_t paramIdx, const std::string &paramName,
+										   bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	// Dicts whose keys are all str
+	PyObject *obj = arg(paramIdx);
+	if (!PyDict_Check(obj))
+	{
+		success = false;
+		return {};
+	}
+
+	PyObject *key, *item;
+	Py_ssize_t pos = 0, size;
+	std::size_t key_bytes = 0;
+
+	while (PyDict_Next(obj, &pos, &key, &item))
+	{
+		// The UTF-8 form of the keys is cached by the str objects for the second pass
+		if (!PyUnicode_Check(key) || !PyUnicode_AsUTF8AndSize(key, &size))
+		{
+			PyErr_Clear();
+
+			success = false;
+			return {};
+		}
+
+		if (!python_dictionary_value(item, nullptr))
+		{
+			success = false;
+			return {};
+		}
+
+		key_bytes += size;
+	}
+
+	if (!getData)
+		return {};
+
+	dictionary result;
+	result.reserve(PyDict_Size(obj), key_bytes);
+
+	pos = 0;
+	while (PyDict_Next(obj, &pos, &key, &item))
+	{
+		const char *text = PyUnicode_AsUTF8AndSize(key, &size);
+
+		dictionary_value value;
+		python_dictionary_value(item, &value);
+		result.insert(text, size, std::move(value));
+	}
+
+	return result;
+}
+
+template <>
+std::shared_ptr<tiled_matrix<float>>
+python::param_reader<std::shared_ptr<tiled_matrix<float>>>::try_read(size_t paramIdx, const std::string &paramName,
+																	bool &success, bool getData)
+{
+	check_parameter_idx(paramIdx, paramName);
+
+	buffer_format format;
+	auto buffer(get_buffer(arg(paramIdx), 2, 3, format));
+	if (!buffer)
+	{
+		success = false;
+		return {};
+	}
+
+	if (!getData)
+		return {};
+
+	const Py_buffer &view(buffer->view);
+	auto result(tiled_matrix<float>::make(buffer_dims(view), w_.tile_size(), w_.tile_size()));
+
+	if (in_place(view, format))
+	{
+		result->copy_from(static_cast<const float *>(view.buf));
+	}
+	else
+	{
+		std::vector<float> f(view.len / view.itemsize);
+		copy_buffer(view, format, f.data(), [](float v) { return v; });
+		result->copy_from(f.data());
+	}
+
+	return result;
+}
+
+python_function::python_function(const char *name, const char *usage, std::function<PyObject *(PyObject *)> fun)
+: def_{ name, &python_function::call, METH_VARARGS, usage }, fun_(std::move(fun))
+{
+	registry()[name] = this;
+}
+
+std::map<std::string, python_function *> &python_function::registry()
+{
+	static std::map<std::string, python_function *> functions;
+	return functions;
+}
+
+PyObject *python_function::call(PyObject *self, PyObject *args)
+{
+	auto function = static_cast<python_function *>(PyCapsule_GetPointer(self, nullptr));
+	if (!function)
+		return nullptr;
+
+	return function->fun_(args);
+}
+
+PyObject *python_function::make_function(PyObject *module)
+{
+	PyObject *self = PyCapsule_New(this, nullptr, nullptr);
+	if (!self)
+		return nullptr;
+
+	PyObject *module_name = PyModule_GetNameObject(module);
+	if (!module_name)
+	{
+		Py_DECREF(self);
+		return nullptr;
+	}
+
+	PyObject *function = PyCFunction_NewEx(&def_, self, module_name);
+	Py_DECREF(module_name);
+	Py_DECREF(self);
+	return function;
+}
+
+PyObject *omw::python_module(const char *name)
+{
+	static PyModuleDef module_def = { PyModuleDef_HEAD_INIT, nullptr, nullptr, -1, nullptr };
+	module_def.m_name = name;
+
+	if (!matrix_type_ready())
+		return nullptr;
+
+	PyObject *module = PyModule_Create(&module_def);
+	if (!module)
+		return nullptr;
+
+	Py_INCREF(&matrix_type);
+	if (PyModule_AddObject(module, "matrix", reinterpret_cast<PyObject *>(&matrix_type)) != 0)
+	{
+		Py_DECREF(&matrix_type);
+		Py_DECREF(module);
+		return nullptr;
+	}
+
+	for (auto &function : python_function::registry())
+	{
+		PyObject *object = function.second->make_function(module);
+		if (!object || PyModule_AddObject(module, function.first.c_str(), object) != 0)
+		{
+			Py_XDECREF(object);
+			Py_DECREF(module);
+			return nullptr;
+		}
+	}
+
+	return module;
+}
+
+namespace omw
+{
+OMW_WRAPPER_INSTANTIATIONS(, python)
+}
+
+#endif /* OMW_PYTHON */
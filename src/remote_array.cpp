@@ -0,0 +1,193 @@
+#include <sstream>
+#include <stdexcept>
+
+#include "omw/matrix.hpp"
+#include "omw/remote_array.hpp"
+
+using namespace omw;
+
+std::shared_ptr<basic_matrix<float>> omw::slice_matrix(const basic_matrix<float> &matrix, const std::vector<int> &start,
+													   const std::vector<int> &stop, const std::vector<int> &step)
+{
+	const int depth = matrix.depth();
+	if (depth == 0 || start.size() != size_t(depth) || stop.size() != size_t(depth) || step.size() != size_t(depth))
+	{
+		std::stringstream ss;
+		ss << "Expected slice bounds for " << depth << " dimensions";
+		throw std::runtime_error(ss.str());
+	}
+
+	// Output dimensions and source strides, in elements
+	std::vector<int> dims(depth);
+	std::vector<size_t> strides(depth);
+	size_t count = 1, stride = 1;
+
+	for (int k = depth - 1; k >= 0; --k)
+	{
+		const int d = matrix.dims()[k];
+		if (start[k] < 0 || stop[k] < start[k] || stop[k] > d || step[k] < 1)
+		{
+			std::stringstream ss;
+			ss << "Invalid slice " << start[k] << ":" << stop[k] << ":" << step[k] << " of dimension " << k << " of size "
+			   << d;
+			throw std::runtime_error(ss.str());
+		}
+
+		dims[k] = (stop[k] - start[k] + step[k] - 1) / step[k];
+		strides[k] = stride * step[k];
+		count *= dims[k];
+		stride *= d;
+	}
+
+	// Get the source in row-major order
+	std::vector<float> row_major;
+	const float *src;
+
+	if (matrix.row_major())
+	{
+		src = matrix.data();
+	}
+	else
+	{
+		row_major.resize(stride);
+		matrix.copy_to(row_major.data());
+		src = row_major.data();
+	}
+
+	// Offset of the first element
+	size_t offset = 0;
+	stride = 1;
+	for (int k = depth - 1; k >= 0; --k)
+	{
+		offset += start[k] * stride;
+		stride *= matrix.dims()[k];
+	}
+
+	std::vector<float> dst(count);
+	if (count == 0)
+		return vector_matrix<float>::make(std::move(dst), std::move(dims));
+
+	// Walk the outer dimensions like an odometer, copying rows of the last one
+	const int inner = dims[depth - 1];
+	const size_t inner_stride = strides[depth - 1];
+	std::vector<int> idx(depth, 0);
+	float *d = dst.data();
+
+	for (;;)
+	{
+		const float *s = src + offset;
+		for (int j = 0; j < inner; ++j)
+			d[j] = s[j * inner_stride];
+		d += inner;
+
+		int k = depth - 2;
+		for (; k >= 0; --k)
+		{
+			offset += strides[k];
+			if (++idx[k] < dims[k])
+				break;
+
+			offset -= strides[k] * dims[k];
+			idx[k] = 0;
+		}
+
+		if (k < 0)
+			break;
+	}
+
+	return vector_matrix<float>::make(std::move(dst), std::move(dims));
+}
+
+remote_arrays::remote_arrays(std::size_t capacity, std::size_t reference_limit)
+	: entries_(), lru_(), bytes_(0), capacity_(capacity), referenced_bytes_(0), reference_limit_(reference_limit),
+	  next_id_(1), evicted_total_(0)
+{
+}
+
+void remote_arrays::evict()
+{
+	while (bytes_ > capacity_ && !lru_.empty())
+	{
+		auto it = entries_.find(lru_.front());
+		bytes_ -= it->second.bytes;
+		entries_.erase(it);
+		lru_.pop_front();
+		++evicted_total_;
+	}
+}
+
+int remote_arrays::put(const std::shared_ptr<basic_matrix<float>> &matrix)
+{
+	size_t count = 1;
+	for (int k = 0; k < matrix->depth(); ++k)
+		count *= matrix->dims()[k];
+
+	const size_t bytes = count * sizeof(float);
+	if (bytes > reference_limit_ || referenced_bytes_ > reference_limit_ - bytes)
+	{
+		std::stringstream ss;
+		ss << "Cannot keep a remote array of " << bytes << " bytes, " << referenced_bytes_
+		   << " bytes of remote arrays are not released yet, out of at most " << reference_limit_;
+		throw std::runtime_error(ss.str());
+	}
+
+	// Copies are in row-major order, which slices are taken from
+	const int id = next_id_++;
+	entries_[id] = entry{ owned_matrix(matrix), bytes, true, lru_.end() };
+	bytes_ += bytes;
+	referenced_bytes_ += bytes;
+
+	evict();
+	return id;
+}
+
+std::shared_ptr<basic_matrix<float>> remote_arrays::get(int id)
+{
+	auto it = entries_.find(id);
+	if (it == entries_.end())
+	{
+		std::stringstream ss;
+		ss << "Unknown remote array " << id << ", it may have been evicted";
+		throw std::runtime_error(ss.str());
+	}
+
+	if (!it->second.referenced)
+		lru_.splice(lru_.end(), lru_, it->second.lru);
+
+	return it->second.matrix;
+}
+
+bool remote_arrays::release(int id)
+{
+	auto it = entries_.find(id);
+	if (it == entries_.end() || !it->second.referenced)
+		return false;
+
+	it->second.referenced = false;
+	it->second.lru = lru_.insert(lru_.end(), id);
+	referenced_bytes_ -= it->second.bytes;
+
+	evict();
+	return true;
+}
+
+void remote_arrays::erase(int id)
+{
+	auto it = entries_.find(id);
+	if (it == entries_.end())
+		return;
+
+	if (it->second.referenced)
+		referenced_bytes_ -= it->second.bytes;
+	else
+		lru_.erase(it->second.lru);
+
+	bytes_ -= it->second.bytes;
+	entries_.erase(it);
+}
+
+void remote_arrays::capacity(std::size_t new_capacity)
+{
+	capacity_ = new_capacity;
+	evict();
+}
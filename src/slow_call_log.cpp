@@ -0,0 +1,86 @@
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include "omw/call_profiler.hpp"
+#include "omw/slow_call_log.hpp"
+
+using namespace omw;
+
+static void format_list(std::ostream &os, const std::vector<std::string> &items)
+{
+	os << '(';
+	for (size_t i = 0; i < items.size(); ++i)
+		os << (i > 0 ? ", " : "") << items[i];
+	os << ')';
+}
+
+std::string slow_call_record::format() const
+{
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(3);
+
+	ss << function << " total=" << total_nanoseconds / 1e6 << "ms";
+	for (size_t p = 0; p < phase_nanoseconds.size(); ++p)
+		ss << ' ' << call_phase_name(call_phase(p)) << '=' << phase_nanoseconds[p] / 1e6 << "ms";
+
+	ss << " args=";
+	format_list(ss, arguments);
+	ss << " results=";
+	format_list(ss, results);
+
+	if (failed)
+		ss << " failed";
+
+	return ss.str();
+}
+
+slow_call_log::slow_call_log(std::size_t capacity)
+	: threshold_(0), capacity_(capacity), records_(), path_(), file_()
+{
+}
+
+void slow_call_log::capacity(std::size_t new_capacity)
+{
+	capacity_ = new_capacity;
+	while (records_.size() > capacity_)
+		records_.pop_front();
+}
+
+void slow_call_log::file(const std::string &path)
+{
+	if (file_.is_open())
+		file_.close();
+
+	path_ = path;
+	if (path_.empty())
+		return;
+
+	file_.open(path_, std::ios::out | std::ios::app);
+	if (!file_)
+	{
+		std::stringstream ss;
+		ss << "Cannot open slow call log " << path_;
+		path_.clear();
+		throw std::runtime_error(ss.str());
+	}
+}
+
+void slow_call_log::add(slow_call_record record)
+{
+	if (file_.is_open())
+		file_ << record.format() << std::endl;
+
+	if (capacity_ == 0)
+		return;
+
+	if (records_.size() >= capacity_)
+		records_.pop_front();
+
+	records_.push_back(std::move(record));
+}
+
+void slow_call_log::clear()
+{
+	records_.clear();
+}
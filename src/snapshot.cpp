@@ -0,0 +1,360 @@
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define OMW_SNAPSHOT_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "omw/snapshot.hpp"
+
+using namespace omw;
+
+namespace
+{
+const char snapshot_magic[8] = { 'O', 'M', 'W', 'S', 'N', 'A', 'P', '1' };
+/// Version of the layout below, bumped whenever it changes
+const std::uint32_t snapshot_version = 2;
+const std::uint32_t snapshot_byte_order = 0x01020304;
+/// Alignment of entry data in the file, a cache line
+const std::uint64_t snapshot_alignment = 64;
+/// Maximum depth of matrices in snapshots
+const int snapshot_max_depth = 8;
+
+struct snapshot_header
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t byte_order;
+	std::uint32_t entry_count;
+	std::uint32_t reserved;
+	std::uint64_t file_size;
+};
+
+struct snapshot_entry
+{
+	std::uint64_t name_offset;
+	std::uint64_t data_offset;
+	std::uint64_t data_size;
+	std::uint32_t name_length;
+	std::uint32_t kind;
+	std::uint32_t element_size;
+	std::int32_t depth;
+	std::int32_t dims[snapshot_max_depth];
+};
+
+std::uint64_t align(std::uint64_t offset)
+{
+	return (offset + snapshot_alignment - 1) / snapshot_alignment * snapshot_alignment;
+}
+
+[[noreturn]] void invalid_snapshot(const std::string &path, const char *reason)
+{
+	std::stringstream ss;
+	ss << "Invalid snapshot " << path << ": " << reason;
+	throw std::runtime_error(ss.str());
+}
+}
+
+/**
+ * @brief Gets a temporary path next to a file, unique to the calling process and call
+ */
+static std::string temporary_path(const std::string &path)
+{
+	static std::atomic<unsigned> counter(0);
+
+	std::stringstream ss;
+	ss << path << ".tmp";
+#if OMW_SNAPSHOT_MMAP
+	ss << '.' << getpid();
+#endif
+	ss << '.' << counter++;
+	return ss.str();
+}
+
+void resident_state::put(const std::string &name, std::shared_ptr<basic_matrix<float>> matrix)
+{
+	put_owned(name, owned_matrix(matrix));
+}
+
+void resident_state::put_owned(const std::string &name, std::shared_ptr<basic_matrix<float>> matrix)
+{
+	if (matrix->depth() > snapshot_max_depth)
+		throw std::runtime_error("Matrix " + name + " has too many dimensions to be part of a snapshot");
+
+	entry &e(entries_[name]);
+	e.kind = kind_matrix;
+	e.matrix = std::move(matrix);
+	e.owner.reset();
+	e.data = nullptr;
+	e.bytes = 0;
+	e.element_size = sizeof(float);
+}
+
+void resident_state::put_table(const std::string &name, std::shared_ptr<const void> owner, const void *data,
+							   std::size_t bytes, std::size_t element_size)
+{
+	entry &e(entries_[name]);
+	e.kind = kind_table;
+	e.matrix.reset();
+	e.owner = std::move(owner);
+	e.data = data;
+	e.bytes = bytes;
+	e.element_size = element_size;
+}
+
+std::shared_ptr<basic_matrix<float>> resident_state::matrix(const std::string &name) const
+{
+	auto it = entries_.find(name);
+	if (it == entries_.end() || it->second.kind != kind_matrix)
+		return {};
+	return it->second.matrix;
+}
+
+std::vector<std::string> resident_state::names() const
+{
+	std::vector<std::string> result;
+	for (const auto &e : entries_)
+		result.push_back(e.first);
+	return result;
+}
+
+void resident_state::save(const std::string &path) const
+{
+	// Lay out the file: header, entry table, names, then aligned data
+	std::vector<snapshot_entry> table;
+	std::vector<std::vector<float>> row_major;
+	std::vector<const void *> sources;
+
+	std::uint64_t offset = sizeof(snapshot_header) + entries_.size() * sizeof(snapshot_entry);
+
+	for (const auto &named : entries_)
+	{
+		const entry &e(named.second);
+		snapshot_entry se;
+		std::memset(&se, 0, sizeof(se));
+
+		se.name_offset = offset;
+		se.name_length = static_cast<std::uint32_t>(named.first.size());
+		se.kind = e.kind;
+		se.element_size = static_cast<std::uint32_t>(e.element_size);
+		offset += se.name_length;
+
+		if (e.kind == kind_matrix)
+		{
+			const basic_matrix<float> &m(*e.matrix);
+			std::size_t count = 1;
+
+			se.depth = m.depth();
+			for (int d = 0; d < se.depth; ++d)
+			{
+				se.dims[d] = m.dims()[d];
+				count *= m.dims()[d];
+			}
+
+			se.data_size = count * sizeof(float);
+
+			if (m.row_major())
+			{
+				sources.push_back(m.data());
+			}
+			else
+			{
+				row_major.emplace_back(count);
+				m.copy_to(row_major.back().data());
+				sources.push_back(row_major.back().data());
+			}
+		}
+		else
+		{
+			se.data_size = e.bytes;
+			sources.push_back(e.data);
+		}
+
+		table.push_back(se);
+	}
+
+	for (auto &se : table)
+	{
+		offset = align(offset);
+		se.data_offset = offset;
+		offset += se.data_size;
+	}
+
+	snapshot_header header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, snapshot_magic, sizeof(header.magic));
+	header.version = snapshot_version;
+	header.byte_order = snapshot_byte_order;
+	header.entry_count = static_cast<std::uint32_t>(table.size());
+	header.file_size = offset;
+
+	// Write to a temporary file, then replace the snapshot: entries mapped from the
+	// previous file stay valid as the old inode lives until it is unmapped. Wrappers of
+	// other threads and processes may save to the same path, each uses its own file.
+	const std::string tmp_path(temporary_path(path));
+	{
+		std::ofstream file(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file)
+			throw std::runtime_error("Cannot write snapshot " + tmp_path);
+
+		file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char *>(table.data()), table.size() * sizeof(snapshot_entry));
+
+		for (const auto &named : entries_)
+			file.write(named.first.data(), named.first.size());
+
+		static const char padding[snapshot_alignment] = { 0 };
+		std::uint64_t position = sizeof(header) + table.size() * sizeof(snapshot_entry);
+		for (const auto &named : entries_)
+			position += named.first.size();
+
+		for (size_t i = 0; i < table.size(); ++i)
+		{
+			file.write(padding, table[i].data_offset - position);
+			file.write(static_cast<const char *>(sources[i]), table[i].data_size);
+			position = table[i].data_offset + table[i].data_size;
+		}
+
+		file.close();
+		if (!file)
+		{
+			std::remove(tmp_path.c_str());
+			throw std::runtime_error("Cannot write snapshot " + tmp_path);
+		}
+	}
+
+	if (std::rename(tmp_path.c_str(), path.c_str()) != 0)
+	{
+		const int err = errno;
+		std::remove(tmp_path.c_str());
+		throw std::runtime_error("Cannot replace snapshot " + path + ": " + std::strerror(err));
+	}
+}
+
+std::shared_ptr<const void> omw::map_file(const std::string &path, std::size_t &size)
+{
+#if OMW_SNAPSHOT_MMAP
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		if (errno == ENOENT)
+			return {};
+		throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		close(fd);
+		throw std::runtime_error("Cannot map empty file " + path);
+	}
+
+	size = static_cast<std::size_t>(st.st_size);
+	void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (addr == MAP_FAILED)
+		throw std::runtime_error("Cannot map " + path + ": " + std::strerror(errno));
+
+	return std::shared_ptr<const void>(addr, [size](const void *p) { munmap(const_cast<void *>(p), size); });
+#else
+	// Without mmap, read the file in a single buffer
+	std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file)
+		return {};
+
+	size = static_cast<std::size_t>(file.tellg());
+	auto buffer(std::make_shared<std::vector<char>>(size));
+	file.seekg(0);
+	file.read(buffer->data(), size);
+
+	return std::shared_ptr<const void>(buffer, buffer->data());
+#endif
+}
+
+std::size_t resident_state::load(const std::string &path)
+{
+	std::size_t size = 0;
+	auto mapping(map_file(path, size));
+	if (!mapping)
+		return 0;
+
+	const char *base = static_cast<const char *>(mapping.get());
+
+	// Validate everything before registering any entry
+	if (size < sizeof(snapshot_header))
+		invalid_snapshot(path, "truncated header");
+
+	snapshot_header header;
+	std::memcpy(&header, base, sizeof(header));
+
+	if (std::memcmp(header.magic, snapshot_magic, sizeof(header.magic)) != 0)
+		invalid_snapshot(path, "bad magic");
+	if (header.version != snapshot_version)
+		invalid_snapshot(path, "written by another version");
+	if (header.byte_order != snapshot_byte_order)
+		invalid_snapshot(path, "written with another byte order");
+	if (header.file_size != size)
+		invalid_snapshot(path, "truncated file");
+	if (header.entry_count > (size - sizeof(snapshot_header)) / sizeof(snapshot_entry))
+		invalid_snapshot(path, "truncated entry table");
+
+	const snapshot_entry *table = reinterpret_cast<const snapshot_entry *>(base + sizeof(snapshot_header));
+
+	for (std::uint32_t i = 0; i < header.entry_count; ++i)
+	{
+		const snapshot_entry &se(table[i]);
+
+		// Offsets and sizes are untrusted, compare them without overflowing
+		if (se.name_offset > size || se.name_length > size - se.name_offset || se.data_offset > size ||
+			se.data_size > size - se.data_offset || se.data_offset % snapshot_alignment != 0)
+			invalid_snapshot(path, "entry out of bounds");
+
+		if (se.kind == kind_matrix)
+		{
+			if (se.depth < 1 || se.depth > snapshot_max_depth || se.element_size != sizeof(float))
+				invalid_snapshot(path, "bad matrix entry");
+
+			// data_size is within the file, so a valid element count never overflows
+			std::uint64_t count = 1;
+			for (int d = 0; d < se.depth; ++d)
+			{
+				if (se.dims[d] < 0 || (se.dims[d] > 0 && count > se.data_size / sizeof(float) / std::uint64_t(se.dims[d])))
+					invalid_snapshot(path, "bad matrix size");
+				count *= se.dims[d];
+			}
+
+			if (count * sizeof(float) != se.data_size)
+				invalid_snapshot(path, "bad matrix size");
+		}
+		else if (se.kind != kind_table || se.element_size == 0 || se.data_size % se.element_size != 0)
+		{
+			invalid_snapshot(path, "bad entry kind");
+		}
+	}
+
+	// Register entries pointing into the mapping
+	for (std::uint32_t i = 0; i < header.entry_count; ++i)
+	{
+		const snapshot_entry &se(table[i]);
+		const std::string name(base + se.name_offset, se.name_length);
+		const void *data = base + se.data_offset;
+
+		if (se.kind == kind_matrix)
+			put_owned(name, mapped_matrix<float>::make(mapping, static_cast<const float *>(data),
+													   std::vector<int>(se.dims, se.dims + se.depth)));
+		else
+			put_table(name, mapping, data, se.data_size, se.element_size);
+	}
+
+	return header.entry_count;
+}
@@ -0,0 +1,69 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 10;
+
+octave_ok 'view_at([1 2; 3 4], 1, 0)', <<OCTAVE_CODE;
+result = omw_test_view_at([1 2; 3 4], 1, 0)
+exit(ifelse(result == 3,0,2))
+OCTAVE_CODE
+
+mathematica_ok 'OmwViewAt[{{1., 2.}, {3., 4.}}, 1, 0]', <<MATHEMATICA_CODE;
+Assert[OmwViewAt[{{1., 2.}, {3., 4.}}, 1, 0] == 3.]
+MATHEMATICA_CODE
+
+octave_ok 'blocks, steps and transpositions', <<OCTAVE_CODE;
+m = [0 1 2 3; 4 5 6 7; 8 9 10 11];
+a = omw_test_view_block(m, 1, 1, 2, 3, 1, 1, false)
+b = omw_test_view_block(m, 0, 0, 2, 2, 2, 2, false)
+c = omw_test_view_block(m, 1, 0, 2, 2, 1, 2, true)
+exit(ifelse(isequal(a, [5 6 7; 9 10 11]) && isequal(b, [0 2; 8 10]) && isequal(c, [1 9; 2 10]),0,2))
+OCTAVE_CODE
+
+octave_ok 'integer arrays are converted', <<OCTAVE_CODE;
+b = omw_test_view_block(int32([0 1 2 3; 4 5 6 7; 8 9 10 11]), 0, 0, 2, 2, 2, 2, false)
+exit(ifelse(isequal(b, [0 2; 8 10]),0,2))
+OCTAVE_CODE
+
+octave_ok 'int16 arrays are viewed in place', <<OCTAVE_CODE;
+m = int16([0 -1 2 3; 4 5 -6 7; 8 9 10 -32768]);
+a = omw_test_view_at(m, 2, 3)
+b = omw_test_view_block(m, 0, 1, 3, 2, 1, 1, true)
+exit(ifelse(a == -32768 && isequal(b, [4 8; 5 9; -6 10]),0,2))
+OCTAVE_CODE
+
+octave_ok 'logical arrays are viewed in place', <<OCTAVE_CODE;
+m = logical([1 0 1; 0 1 1]);
+a = omw_test_view_at(m, 1, 0)
+b = omw_test_view_block(m, 0, 0, 2, 2, 1, 2, false)
+exit(ifelse(a == 0 && isequal(b, [1 1; 0 1]),0,2))
+OCTAVE_CODE
+
+mathematica_ok 'blocks, steps and transpositions', <<MATHEMATICA_CODE;
+m = {{0., 1., 2., 3.}, {4., 5., 6., 7.}, {8., 9., 10., 11.}};
+Assert[OmwViewBlock[m, 1, 1, 2, 3, 1, 1, False] == {{5., 6., 7.}, {9., 10., 11.}}];
+Assert[OmwViewBlock[m, 0, 0, 2, 2, 2, 2, False] == {{0., 2.}, {8., 10.}}];
+Assert[OmwViewBlock[m, 1, 0, 2, 2, 1, 2, True] == {{1., 9.}, {2., 10.}}]
+MATHEMATICA_CODE
+
+python_ok 'blocks, steps and transpositions', <<PYTHON_CODE;
+import array
+x = memoryview(array.array('d', range(12))).cast('B').cast('d', [3, 4])
+assert memoryview(m.omw_test_view_block(x, 1, 1, 2, 3, 1, 1, False)).tolist() == [[5, 6, 7], [9, 10, 11]]
+PYTHON_CODE
+
+python_ok 'strided and transposed sources', <<PYTHON_CODE;
+import array
+x = memoryview(array.array('f', range(12))).cast('B').cast('f', [3, 4])
+assert memoryview(m.omw_test_view_block(x, 0, 0, 2, 2, 2, 2, False)).tolist() == [[0, 2], [8, 10]]
+assert memoryview(m.omw_test_view_block(x, 1, 0, 2, 2, 1, 2, True)).tolist() == [[1, 9], [2, 10]]
+PYTHON_CODE
+
+python_fails 'blocks must be inside the view', <<PYTHON_CODE;
+import array
+x = memoryview(array.array('f', range(12))).cast('B').cast('f', [3, 4])
+m.omw_test_view_block(x, 2, 0, 2, 2, 1, 1, False)
+PYTHON_CODE
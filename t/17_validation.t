@@ -0,0 +1,45 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 6;
+
+octave_ok 'sum_finite([1 2; 3 4])', <<OCTAVE_CODE;
+result = omw_test_sum_finite([1 2; 3 4])
+exit(ifelse(result == 10,0,2))
+OCTAVE_CODE
+
+mathematica_ok 'OmwSumFinite[{{1., 2.}, {3., 4.}}]', <<MATHEMATICA_CODE;
+Assert[OmwSumFinite[{{1., 2.}, {3., 4.}}] == 10.]
+MATHEMATICA_CODE
+
+octave_fails 'sum_finite([1 NaN; 3 4])', <<OCTAVE_CODE;
+omw_test_sum_finite([1 NaN; 3 4])
+OCTAVE_CODE
+
+octave_ok 'errors report the column-major index', <<OCTAVE_CODE;
+m = ones(40, 40);
+m(36, 4) = NaN;
+try
+	omw_test_sum_finite(m);
+	exit(2)
+catch err
+	exit(ifelse(!isempty(strfind(err.message, 'at element 155 ')),0,2))
+end
+OCTAVE_CODE
+
+mathematica_fails 'OmwSumFinite[{{1., Indeterminate}, {3., 4.}}]', <<MATHEMATICA_CODE;
+OmwSumFinite[{{1., Indeterminate}, {3., 4.}}]
+MATHEMATICA_CODE
+
+python_ok 'errors report the row-major index', <<PYTHON_CODE;
+import array
+x = memoryview(array.array('f', [1, 2, 3, float('nan')])).cast('B').cast('f', [2, 2])
+try:
+    m.omw_test_sum_finite(x)
+    raise SystemExit(2)
+except RuntimeError as e:
+    assert 'at element 3 ' in str(e), str(e)
+PYTHON_CODE
@@ -0,0 +1,50 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 6;
+
+octave_ok 'tiled_roundtrip(magic(5))', <<OCTAVE_CODE;
+result = omw_test_tiled_roundtrip(magic(5))
+exit(ifelse(isequal(result, magic(5)),0,2))
+OCTAVE_CODE
+
+mathematica_ok 'OmwTiledRoundtrip[{{1., 2., 3.}, {4., 5., 6.}, {7., 8., 9.}}]', <<MATHEMATICA_CODE;
+Assert[OmwTiledRoundtrip[{{1., 2., 3.}, {4., 5., 6.}, {7., 8., 9.}}] == {{1., 2., 3.}, {4., 5., 6.}, {7., 8., 9.}}]
+MATHEMATICA_CODE
+
+octave_ok 'tiled neighborhoods and clamping', <<OCTAVE_CODE;
+A = magic(5);
+exit(ifelse(isequal(omw_test_tiled_neighborhood(A, 2, 2, 1), A(2:4, 2:4)) && isequal(omw_test_tiled_neighborhood(A, 0, 4, 1), A([1 1 2], [4 5 5])) && omw_test_tiled_clamped(A, -3, 7) == A(1, 5),0,2))
+OCTAVE_CODE
+
+python_ok 'tiled_clamped clamps to the borders', <<PYTHON_CODE;
+import array
+x = memoryview(array.array('f', range(25))).cast('B').cast('f', [5, 5])
+assert m.omw_test_tiled_clamped(x, 3, 2) == 17
+assert m.omw_test_tiled_clamped(x, -3, 7) == 4
+assert m.omw_test_tiled_clamped(x, 9, -1) == 20
+assert m.omw_test_tiled_clamped(x, 9, 9) == 24
+PYTHON_CODE
+
+python_ok 'tiled_neighborhood crosses tiles and clamps to the borders', <<PYTHON_CODE;
+import array
+x = memoryview(array.array('f', range(25))).cast('B').cast('f', [5, 5])
+def n(i, j, radius):
+    return memoryview(m.omw_test_tiled_neighborhood(x, i, j, radius)).tolist()
+# Each 2x2 tile holds a single element of the center row and column
+assert n(2, 2, 1) == [[6, 7, 8], [11, 12, 13], [16, 17, 18]]
+assert n(3, 1, 2) == [[5, 5, 6, 7, 8], [10, 10, 11, 12, 13], [15, 15, 16, 17, 18], [20, 20, 21, 22, 23], [20, 20, 21, 22, 23]]
+assert n(0, 4, 1) == [[3, 4, 4], [3, 4, 4], [8, 9, 9]]
+assert n(4, 0, 1) == [[15, 15, 16], [20, 20, 21], [20, 20, 21]]
+assert n(3, 3, 0) == [[18]]
+PYTHON_CODE
+
+python_ok 'tiled_neighborhood keeps channels together', <<PYTHON_CODE;
+import array
+x = memoryview(array.array('f', range(18))).cast('B').cast('f', [3, 3, 2])
+r = memoryview(m.omw_test_tiled_neighborhood(x, 2, 1, 1)).tolist()
+assert r == [[[6, 7], [8, 9], [10, 11]], [[12, 13], [14, 15], [16, 17]], [[12, 13], [14, 15], [16, 17]]], r
+PYTHON_CODE
@@ -0,0 +1,24 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 3;
+
+octave_ok 'frame("s", ...)', <<OCTAVE_CODE;
+omw_test_frame("s", [1 2; 3 4]);
+result = omw_test_frame("s", [1 2; 3 5])
+exit(ifelse(isequal(result, [1 2; 3 5]),0,2))
+OCTAVE_CODE
+
+mathematica_ok 'OmwFrame["s", ...]', <<MATHEMATICA_CODE;
+OmwFrame["s", {{1., 2.}, {3., 4.}}];
+Assert[OmwFrame["s", {{1., 2.}, {3., 5.}}] == {{1., 2.}, {3., 5.}}]
+MATHEMATICA_CODE
+
+mathematica_ok 'OmwFrame["t", ...] after a lost patch', <<MATHEMATICA_CODE;
+OmwFrame["t", {{1., 2.}, {3., 4.}}];
+Block[{OMW`ApplyFramePatch = Null &}, OmwFrame["t", {{1., 2.}, {3., 5.}}]];
+Assert[OmwFrame["t", {{1., 2.}, {3., 6.}}] == {{1., 2.}, {3., 6.}}]
+MATHEMATICA_CODE
@@ -0,0 +1,56 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 6;
+
+octave_ok 'progressive("p", [1 2; 3 4], 1)', <<OCTAVE_CODE;
+preview = omw_test_progressive("p", [1 2; 3 4], 1)
+result = omw_test_refine("p")
+exit(ifelse(preview == 2.5 && isequal(result, [1 2; 3 4]),0,2))
+OCTAVE_CODE
+
+mathematica_ok 'OmwProgressive["p", {{1., 2.}, {3., 4.}}, 1]', <<MATHEMATICA_CODE;
+Assert[OmwProgressive["p", {{1., 2.}, {3., 4.}}, 1] == {{2.5}}];
+Assert[OmwRefine["p"] == {{1., 2.}, {3., 4.}}]
+MATHEMATICA_CODE
+
+octave_fails 'refine("none")', <<OCTAVE_CODE;
+value = omw_test_refine("none")
+exit(0)
+OCTAVE_CODE
+
+mathematica_fails 'OmwRefine["none"]', <<MATHEMATICA_CODE;
+OmwRefine["none"]
+MATHEMATICA_CODE
+
+python_ok 'progressive results are discarded past the capacity', <<PYTHON_CODE;
+import array
+x = memoryview(array.array('f', [1, 2, 3, 4])).cast('B').cast('f', [2, 2])
+previous = m.omw_test_progressive_capacity(16)
+try:
+    m.omw_test_progressive("p1", x, 1)
+    m.omw_test_progressive("p2", x, 1)
+    assert memoryview(m.omw_test_refine("p2")).tolist() == [[1, 2], [3, 4]]
+    try:
+        m.omw_test_refine("p1")
+        assert False, "p1 was not discarded"
+    except RuntimeError as e:
+        assert 'discarded' in str(e), e
+finally:
+    m.omw_test_progressive_capacity(previous)
+PYTHON_CODE
+
+python_ok 'refinements do not depend on the source after the call', <<PYTHON_CODE;
+import array
+a = array.array('f', range(16))
+x = memoryview(a).cast('B').cast('f', [4, 4])
+assert memoryview(m.omw_test_progressive("s", x, 2)).tolist() == [[7.5]]
+x.release()
+a[0] = 100
+a.append(16)
+assert memoryview(m.omw_test_refine("s")).tolist() == [[2.5, 4.5], [10.5, 12.5]]
+assert memoryview(m.omw_test_refine("s")).tolist() == [[4 * i + j for j in range(4)] for i in range(4)]
+PYTHON_CODE
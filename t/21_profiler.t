@@ -0,0 +1,22 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 2;
+
+octave_ok 'calls("omw_test_times")', <<OCTAVE_CODE;
+omw_test_profile(true);
+omw_test_times(2, 3);
+omw_test_times(4, 5);
+result = omw_test_calls("omw_test_times")
+exit(ifelse(result == 2,0,2))
+OCTAVE_CODE
+
+mathematica_ok 'OmwCalls["omw_test_times"]', <<MATHEMATICA_CODE;
+OmwProfile[True];
+OmwTimes[2, 3];
+OmwTimes[4, 5];
+Assert[OmwCalls["omw_test_times"] == 2]
+MATHEMATICA_CODE
@@ -0,0 +1,22 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 2;
+
+octave_ok 'slow call record of omw_test_times', <<OCTAVE_CODE;
+omw_test_slow_threshold(1);
+omw_test_times(2, 3);
+omw_test_slow_threshold(0);
+result = omw_test_slow_last()
+exit(ifelse(!isempty(strfind(result, "omw_test_times")) && !isempty(strfind(result, "X: int")),0,2))
+OCTAVE_CODE
+
+mathematica_ok 'slow call record of omw_test_times', <<MATHEMATICA_CODE;
+OmwSlowThreshold[1];
+OmwTimes[2, 3];
+OmwSlowThreshold[0];
+Assert[StringContainsQ[OmwSlowLast[], "omw_test_times"] && StringContainsQ[OmwSlowLast[], "X: int"]]
+MATHEMATICA_CODE
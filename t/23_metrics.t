@@ -0,0 +1,50 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 4;
+
+octave_ok 'metrics file', <<OCTAVE_CODE;
+target = [tempname() ".prom"];
+omw_test_metrics(target, 50);
+omw_test_times(2, 3);
+pause(0.5);
+text = fileread(target)
+omw_test_metrics("", 0);
+exit(ifelse(!isempty(strfind(text, 'omw_calls_total{function="omw_test_times"} 1')),0,2))
+OCTAVE_CODE
+
+mathematica_ok 'metrics file', <<MATHEMATICA_CODE;
+target = FileNameJoin[{\$TemporaryDirectory, "omw_test.prom"}];
+OmwMetrics[target, 50];
+OmwTimes[2, 3];
+Pause[0.5];
+text = Import[target, "Text"];
+OmwMetrics["", 0];
+Assert[StringContainsQ[text, "omw_calls_total{function=\\"omw_test_times\\"} 1"]]
+MATHEMATICA_CODE
+
+python_ok 'metrics file', <<PYTHON_CODE;
+import os, tempfile, time
+target = os.path.join(tempfile.mkdtemp(), 'omw_test.prom')
+m.omw_test_metrics(target, 50)
+m.omw_test_times(2, 3)
+time.sleep(0.5)
+text = open(target).read()
+m.omw_test_metrics("", 0)
+assert 'omw_calls_total{function="omw_test_times"}' in text, text
+PYTHON_CODE
+
+python_ok 'metrics sockets never replace other files', <<PYTHON_CODE;
+import os, tempfile
+path = os.path.join(tempfile.mkdtemp(), 'not_a_socket')
+open(path, 'w').write('keep')
+try:
+    m.omw_test_metrics('unix:' + path, 50)
+    assert False, 'listening on a regular file'
+except RuntimeError as e:
+    assert 'File exists' in str(e), e
+assert open(path).read() == 'keep'
+PYTHON_CODE
@@ -0,0 +1,26 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 2;
+
+octave_ok 'autotune cache', <<OCTAVE_CODE;
+cache = tempname();
+first = omw_test_autotune(cache)
+second = omw_test_autotune(cache)
+A = single(rand(37, 41, 3));
+B = omw_test_frame("autotune", A);
+delete(cache);
+exit(ifelse(!first && second && isequal(A, B),0,2))
+OCTAVE_CODE
+
+mathematica_ok 'autotune cache', <<MATHEMATICA_CODE;
+cache = FileNameJoin[{\$TemporaryDirectory, "omw_test_autotune"}];
+Quiet[DeleteFile[cache]];
+first = OmwAutotune[cache];
+second = OmwAutotune[cache];
+DeleteFile[cache];
+Assert[!first && second]
+MATHEMATICA_CODE
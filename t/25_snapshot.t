@@ -0,0 +1,88 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 8;
+
+octave_ok 'snapshot roundtrip', <<OCTAVE_CODE;
+path = tempname();
+A = single(rand(5, 7, 3));
+B = omw_test_snapshot(path, A);
+delete(path);
+exit(ifelse(isequal(A, B),0,2))
+OCTAVE_CODE
+
+mathematica_ok 'snapshot roundtrip', <<MATHEMATICA_CODE;
+path = FileNameJoin[{\$TemporaryDirectory, "omw_test_snapshot"}];
+m = N[Partition[Range[35], 7]];
+r = OmwSnapshot[path, m];
+DeleteFile[path];
+Assert[r == m]
+MATHEMATICA_CODE
+
+python_ok 'snapshot roundtrip', <<PYTHON_CODE;
+import array, os, tempfile
+path = os.path.join(tempfile.mkdtemp(), 'omw_test_snapshot')
+x = memoryview(array.array('f', range(35))).cast('B').cast('f', [5, 7])
+assert memoryview(m.omw_test_snapshot(path, x)).tolist() == x.tolist()
+PYTHON_CODE
+
+python_ok 'snapshot tables', <<PYTHON_CODE;
+import array, os, tempfile
+path = os.path.join(tempfile.mkdtemp(), 'omw_test_snapshot')
+x = memoryview(array.array('f', [3, -1, 4, 1, 5, 9])).cast('B').cast('f', [2, 3])
+assert memoryview(m.omw_test_snapshot_table(path, x)).tolist() == [3, -1, 4, 1, 5, 9]
+assert m.omw_test_snapshot_load(path, False) == 1
+PYTHON_CODE
+
+octave_ok 'resident state entries outlive the call', <<OCTAVE_CODE;
+A = single([1 2; 3 4]);
+omw_test_state_put("a", A);
+A(1, 1) = 5;
+exit(ifelse(isequal(omw_test_state_get("a"), single([1 2; 3 4])),0,2))
+OCTAVE_CODE
+
+python_ok 'resident state entries outlive the call', <<PYTHON_CODE;
+import array
+a = array.array('f', [1, 2, 3, 4])
+x = memoryview(a).cast('B').cast('f', [2, 2])
+m.omw_test_state_put('a', x)
+a[0] = 5
+assert memoryview(m.omw_test_state_get('a')).tolist() == [[1, 2], [3, 4]]
+PYTHON_CODE
+
+python_ok 'corrupt snapshots are rejected', <<PYTHON_CODE;
+import array, os, tempfile
+path = os.path.join(tempfile.mkdtemp(), 'omw_test_snapshot')
+x = memoryview(array.array('f', range(6))).cast('B').cast('f', [2, 3])
+m.omw_test_snapshot(path, x)
+data = open(path, 'rb').read()
+
+def rejected(contents, reason):
+    open(path, 'wb').write(contents)
+    try:
+        m.omw_test_snapshot_load(path, False)
+    except RuntimeError as e:
+        assert reason in str(e), e
+        return True
+    return False
+
+assert rejected(b'garbage', 'truncated header')
+assert rejected(data[:8] + b'\\x01' + data[9:], 'another version')
+assert rejected(data[:-4], 'truncated file')
+# Entry count far past the end of the file
+assert rejected(data[:16] + b'\\xff\\xff\\xff\\x7f' + data[20:], 'truncated entry table')
+# Name offset close to 2^64, which wraps around when added to the name length
+assert rejected(data[:32] + b'\\xf0' + b'\\xff' * 7 + data[40:], 'out of bounds')
+PYTHON_CODE
+
+python_ok 'warm restart from a corrupt snapshot starts cold', <<PYTHON_CODE;
+import os, tempfile
+path = os.path.join(tempfile.mkdtemp(), 'omw_test_snapshot')
+open(path, 'wb').write(b'garbage')
+assert m.omw_test_snapshot_load(path, True) == 0
+missing = os.path.join(tempfile.mkdtemp(), 'none')
+assert m.omw_test_snapshot_load(missing, True) == 0
+PYTHON_CODE
@@ -0,0 +1,46 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 6;
+
+octave_ok 'fused chain', <<OCTAVE_CODE;
+A = single(reshape(1:12, 3, 4));
+B = omw_test_pipeline("scale(offset(x, 1), 2)", A)
+exit(ifelse(isequal(B, (A + 1) * 2),0,2))
+OCTAVE_CODE
+
+octave_ok 'dag with general stages', <<OCTAVE_CODE;
+A = single(reshape(1:12, 3, 4));
+B = omw_test_pipeline("a = scale(x, 2); add(a, transpose(transpose(x)))", A)
+exit(ifelse(isequal(B, 3 * A),0,2))
+OCTAVE_CODE
+
+mathematica_ok 'fused chain', <<MATHEMATICA_CODE;
+m = N[Partition[Range[12], 4]];
+Assert[OmwPipeline["scale(offset(x, 1), 2)", m] == (m + 1) * 2]
+MATHEMATICA_CODE
+
+mathematica_fails 'unknown stage', <<MATHEMATICA_CODE;
+OmwPipeline["nope(x)", {{1., 2.}}]
+MATHEMATICA_CODE
+
+python_ok 'side inputs must have the same dimensions', <<PYTHON_CODE;
+import array
+x = memoryview(array.array('f', range(6))).cast('B').cast('f', [2, 3])
+assert memoryview(m.omw_test_pipeline("add(x, x)", x)).tolist() == [[0, 2, 4], [6, 8, 10]]
+try:
+    m.omw_test_pipeline("add(x, transpose(x))", x)
+    assert False, "a 2x3 and a 3x2 matrix were added"
+except RuntimeError as e:
+    assert 'different dimensions' in str(e), e
+PYTHON_CODE
+
+python_ok 'repeated descriptions', <<PYTHON_CODE;
+import array
+x = memoryview(array.array('f', range(6))).cast('B').cast('f', [2, 3])
+for i in range(3):
+    assert memoryview(m.omw_test_pipeline("scale(offset(x, 1), 2)", x)).tolist() == [[2, 4, 6], [8, 10, 12]]
+PYTHON_CODE
@@ -0,0 +1,39 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use File::Spec;
+use File::Temp qw(tempdir);
+use Test::More tests => 3;
+
+batch_ok 'omw_test_times over records', 'omw_test_times',
+	[ map { [[int => $_], [int => 3]] } 1..100 ],
+	sub {
+		my @results = @_;
+		return @results == 100 && !grep { $results[$_ - 1][1][1] != 3 * $_ } 1..100;
+	};
+
+batch_ok 'failed records do not stop the run', 'omw_test_pipeline',
+	[ [[string => 'scale(x, 2)'], [matrix => [2, 2], [1, 2, 3, 4]]],
+	  [[string => 'nope(x)'], [matrix => [2, 2], [1, 2, 3, 4]]] ],
+	sub {
+		my ($ok, $failed) = @_;
+		return $ok->[0] eq 'list' && "@{$ok->[1][2]}" eq '2 4 6 8' && $failed->[0] eq 'error';
+	};
+
+my $snapshot = File::Spec->catfile(tempdir(CLEANUP => 1), 'snapshot');
+
+batch_ok 'workers save their snapshot to the same path', 'omw_test_snapshot_load',
+	[ map { [[string => $snapshot], [bool => 1]] } 1..64 ],
+	sub {
+		# Every worker saved when its wrapper was destroyed, the last rename wins
+		open(my $in, '<:raw', $snapshot) or return 0;
+		my $bytes = do { local $/; <$in> };
+		close $in;
+
+		my ($magic, undef, undef, undef, undef, $size) = unpack('a8LLLLQ', $bytes);
+		return @_ == 64 && $magic eq 'OMWSNAP1' && $size == length($bytes)
+			&& !grep { $_->[0] ne 'list' } @_;
+	};
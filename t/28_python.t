@@ -0,0 +1,38 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 4;
+
+python_ok 'scalars and strings', <<PYTHON_CODE;
+assert m.omw_test_times(6, 7) == 42
+assert m.omw_test_concat("a", "b") == "ab"
+assert m.omw_test_concat_pl("a", "b", "c") == "abc"
+PYTHON_CODE
+
+python_ok 'matrices through the buffer protocol', <<PYTHON_CODE;
+import array
+a = memoryview(array.array('f', range(12))).cast('B').cast('f', [3, 4])
+r = m.omw_test_pipeline("scale(offset(x, 1), 2)", a)
+assert r.shape == (3, 4)
+assert memoryview(r).tolist() == [[(4 * i + j + 1) * 2 for j in range(4)] for i in range(3)]
+d = memoryview(array.array('d', range(12))).cast('B').cast('d', [3, 4])
+assert m.omw_test_view_at(d, 1, 2) == 6.0
+PYTHON_CODE
+
+python_fails 'failures raise RuntimeError', <<PYTHON_CODE;
+m.omw_test_times(2, 10 ** 12)
+PYTHON_CODE
+
+python_ok 'other exceptions raise RuntimeError', <<PYTHON_CODE;
+m.omw_test_profile(True)
+try:
+    m.omw_test_throw_unknown()
+    assert False, 'no error'
+except RuntimeError as e:
+    assert 'unknown exception' in str(e), str(e)
+assert m.omw_test_calls('omw_test_throw_unknown') == 1
+assert m.omw_test_times(6, 7) == 42
+PYTHON_CODE
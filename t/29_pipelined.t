@@ -0,0 +1,31 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 5;
+
+mathematica_ok 'flush per call', <<MATHEMATICA_CODE;
+OmwFlushPolicy["call", 0];
+Assert[OMW`CallPipelined[OmwPipelined, {{"omw_test_times", 3, 4}, {"omw_test_concat", "a", "b"}}] == {12, "ab"}]
+MATHEMATICA_CODE
+
+mathematica_ok 'flush every n calls', <<MATHEMATICA_CODE;
+OmwFlushPolicy["calls", 16];
+Assert[OMW`CallPipelined[OmwPipelined, Table[{"omw_test_times", i, 2}, {i, 100}]] == 2 Range[100]]
+MATHEMATICA_CODE
+
+mathematica_ok 'flush past a byte threshold', <<MATHEMATICA_CODE;
+OmwFlushPolicy["bytes", 64];
+m = N[Partition[Range[12], 4]];
+Assert[OMW`CallPipelined[OmwPipelined, Table[{"omw_test_tiled_roundtrip", m}, {8}]] == Table[m, {8}]]
+MATHEMATICA_CODE
+
+mathematica_ok 'failed calls do not stop the batch', <<MATHEMATICA_CODE;
+Assert[Quiet[OMW`CallPipelined[OmwPipelined, {{"omw_test_times", 3, 4}, {"nope"}, {"omw_test_times", 2, 3}}]] == {12, \$Failed, 6}]
+MATHEMATICA_CODE
+
+mathematica_ok 'failures after the result keep the answers in place', <<MATHEMATICA_CODE;
+Assert[Quiet[OMW`CallPipelined[OmwPipelined, {{"omw_test_fail_after_result", 1}, {"omw_test_times", 2, 3}}]] == {1, 6}]
+MATHEMATICA_CODE
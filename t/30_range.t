@@ -0,0 +1,27 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 4;
+
+octave_ok 'ranges are read lazily', <<OCTAVE_CODE;
+[s, lazy] = omw_test_range_sum(1:1000)
+exit(ifelse(s == 500500 && lazy == 1,0,2))
+OCTAVE_CODE
+
+octave_ok 'arrays are still accepted', <<OCTAVE_CODE;
+[s, lazy] = omw_test_range_sum([1 2 3 4])
+exit(ifelse(s == 10 && lazy == 0,0,2))
+OCTAVE_CODE
+
+mathematica_ok 'lists are read as arrays', <<MATHEMATICA_CODE;
+Assert[OmwRangeSum[N[Range[1000]]] == {500500., 0}]
+MATHEMATICA_CODE
+
+python_ok 'range objects are read lazily', <<PYTHON_CODE;
+import array
+assert m.omw_test_range_sum(range(1, 1001)) == (500500.0, 1)
+assert m.omw_test_range_sum(array.array('f', [1, 2, 3, 4])) == (10.0, 0)
+PYTHON_CODE
@@ -0,0 +1,19 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 3;
+
+startup_ok 'load to first call', octave => <<OCTAVE_CODE;
+omw_test_times(2, 3);
+OCTAVE_CODE
+
+startup_ok 'load to first call', mathematica => <<MATHEMATICA_CODE;
+OmwTimes[2, 3]
+MATHEMATICA_CODE
+
+startup_ok 'load to first call', python => <<PYTHON_CODE;
+m.omw_test_times(2, 3)
+PYTHON_CODE
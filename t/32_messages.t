@@ -0,0 +1,50 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 6;
+
+octave_ok 'repeated warnings are written once', <<OCTAVE_CODE;
+out = evalc('r = omw_test_messages(5, false);')
+exit(ifelse(r == 5 && numel(strfind(out, 'warn: repeated warning (repeated 5 times)')) == 1 && numel(strfind(out, 'warn:')) == 2,0,2))
+OCTAVE_CODE
+
+octave_ok 'failures are written after the warnings', <<OCTAVE_CODE;
+out = evalc('omw_test_messages(2, true);')
+exit(ifelse(strfind(out, 'warn: last warning') < strfind(out, 'err: failed after warnings'),0,2))
+OCTAVE_CODE
+
+mathematica_ok 'warnings are sent before the result', <<MATHEMATICA_CODE;
+Assert[Quiet[OmwMessages[5, False]] == 5];
+Assert[OMW`Progress[] == "5/5"]
+MATHEMATICA_CODE
+
+python_ok 'repeated warnings are issued once', <<PYTHON_CODE;
+import warnings
+with warnings.catch_warnings(record=True) as w:
+    warnings.simplefilter("always")
+    assert m.omw_test_messages(5, False) == 5
+texts = [str(x.message) for x in w]
+assert texts == ["warn: repeated warning (repeated 5 times)", "warn: last warning"], texts
+PYTHON_CODE
+
+python_ok 'warnings turned into errors fail the call', <<PYTHON_CODE;
+import warnings
+with warnings.catch_warnings():
+    warnings.simplefilter("error")
+    try:
+        m.omw_test_messages(1, False)
+        assert False
+    except RuntimeError as e:
+        assert "repeated warning" in str(e), e
+PYTHON_CODE
+
+batch_ok 'messages do not change the results', 'omw_test_messages',
+	[[[int => 3], [bool => 0]], [[int => 2], [bool => 1]]],
+	sub {
+		my ($ok, $failed) = @_;
+		return $ok->[0] eq 'list' && $ok->[1][1] == 3
+			&& $failed->[0] eq 'error' && $failed->[1] =~ /failed after warnings/;
+	};
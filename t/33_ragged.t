@@ -0,0 +1,35 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 5;
+
+octave_ok 'cell arrays of vectors', <<OCTAVE_CODE;
+[y, n] = omw_test_ragged({[1 2 3], [], [4; 5]})
+exit(ifelse(n == 5 && isequal(y, {[1 3 6], zeros(1, 0), [4 9]}),0,2))
+OCTAVE_CODE
+
+octave_fails 'cells must hold vectors', <<OCTAVE_CODE;
+omw_test_ragged({[1 2; 3 4]})
+OCTAVE_CODE
+
+mathematica_ok 'nested lists', <<MATHEMATICA_CODE;
+Assert[OmwRagged[{{1., 2., 3.}, {}, {4., 5.}}] == {{{1., 3., 6.}, {}, {4., 9.}}, 5}]
+MATHEMATICA_CODE
+
+python_ok 'lists of buffers', <<PYTHON_CODE;
+import array
+y, n = m.omw_test_ragged([array.array('f', [1, 2, 3]), array.array('d'), array.array('d', [4, 5])])
+assert n == 5
+assert [list(memoryview(r)) for r in y] == [[1, 3, 6], [], [4, 9]], y
+PYTHON_CODE
+
+batch_ok 'lists of vectors', 'omw_test_ragged',
+	[[[list => [matrix => [3], [1, 2, 3]], [matrix => [0], []], [matrix => [2], [4, 5]]]]],
+	sub {
+		my ($r) = @_;
+		my ($rows, $n) = @{$r}[1, 2];
+		return $n->[1] == 5 && join('|', map { "@{$_->[2]}" } @{$rows}[1..3]) eq '1 3 6||4 9';
+	};
@@ -0,0 +1,53 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 8;
+
+octave_ok 'cell arrays of matrices', <<OCTAVE_CODE;
+[y, n] = omw_test_matrix_batch({[1 2; 3 4], single([5 6; 7 8])})
+exit(ifelse(n == 2 && isequal(y, {[1 2; 3 4], [10 12; 14 16]}),0,2))
+OCTAVE_CODE
+
+octave_ok 'packed arrays', <<OCTAVE_CODE;
+[y, n] = omw_test_matrix_batch(cat(3, [1 2; 3 4], [5 6; 7 8]))
+exit(ifelse(n == 2 && isequal(y, {[1 2; 3 4], [10 12; 14 16]}),0,2))
+OCTAVE_CODE
+
+octave_fails 'cells must hold matrices of the same size', <<OCTAVE_CODE;
+omw_test_matrix_batch({[1 2], [1 2 3]})
+OCTAVE_CODE
+
+mathematica_ok 'lists of matrices', <<MATHEMATICA_CODE;
+Assert[OmwMatrixBatch[{{{1., 2.}, {3., 4.}}, {{5., 6.}, {7., 8.}}}] == {{{{1., 2.}, {3., 4.}}, {{10., 12.}, {14., 16.}}}, 2}]
+MATHEMATICA_CODE
+
+python_ok 'lists of buffers', <<PYTHON_CODE;
+import array
+y, n = m.omw_test_matrix_batch([array.array('f', [1, 2]), array.array('d', [3, 4])])
+assert n == 2
+assert memoryview(y).tolist() == [[1, 2], [6, 8]], memoryview(y).tolist()
+PYTHON_CODE
+
+python_ok 'packed buffers', <<PYTHON_CODE;
+import array
+x = memoryview(array.array('f', [1, 2, 3, 4, 5, 6, 7, 8])).cast('B').cast('f', [2, 2, 2])
+y, n = m.omw_test_matrix_batch(x)
+assert n == 2
+assert memoryview(y).tolist() == [[[1, 2], [3, 4]], [[10, 12], [14, 16]]], memoryview(y).tolist()
+PYTHON_CODE
+
+python_fails 'buffers must have the same shape', <<PYTHON_CODE;
+import array
+m.omw_test_matrix_batch([array.array('f', [1, 2]), array.array('f', [1, 2, 3])])
+PYTHON_CODE
+
+batch_ok 'lists of matrices', 'omw_test_matrix_batch',
+	[[[list => [matrix => [2], [1, 2]], [matrix => [2], [3, 4]]]]],
+	sub {
+		my ($r) = @_;
+		my ($y, $n) = @{$r}[1, 2];
+		return $n->[1] == 2 && "@{$y->[1]}" eq '2 2' && "@{$y->[2]}" eq '1 2 6 8';
+	};
@@ -0,0 +1,75 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 11;
+
+octave_ok 'logical matrices', <<OCTAVE_CODE;
+x = logical([1 0 1; 0 1 1]);
+[y, n] = omw_test_bitmask(x)
+exit(ifelse(n == 4 && islogical(y) && isequal(y, x),0,2))
+OCTAVE_CODE
+
+octave_ok 'numeric 0/1 vectors', <<OCTAVE_CODE;
+x = double(mod(1:70, 3) == 0);
+[y, n] = omw_test_bitmask(x)
+exit(ifelse(n == 23 && islogical(y) && isequal(y, x == 1),0,2))
+OCTAVE_CODE
+
+mathematica_ok 'lists of booleans', <<MATHEMATICA_CODE;
+Assert[OmwBitmask[{True, False, True}] == {{1, 0, 1}, 2}]
+MATHEMATICA_CODE
+
+mathematica_ok '0/1 integer arrays', <<MATHEMATICA_CODE;
+Assert[OmwBitmask[{{1, 0}, {0, 1}}] == {{{1, 0}, {0, 1}}, 2}]
+MATHEMATICA_CODE
+
+python_ok 'lists of bools', <<PYTHON_CODE;
+y, n = m.omw_test_bitmask([True, False, True])
+assert n == 2
+assert y.tolist() == [True, False, True], y.tolist()
+PYTHON_CODE
+
+python_ok 'byte buffers', <<PYTHON_CODE;
+import array
+x = memoryview(array.array('B', [i % 3 == 0 for i in range(140)])).cast('B', [2, 70])
+y, n = m.omw_test_bitmask(x)
+assert n == 47
+assert y.tolist() == [[i % 3 == 0 for i in range(j * 70, (j + 1) * 70)] for j in range(2)]
+PYTHON_CODE
+
+python_fails 'lists must hold bools', <<PYTHON_CODE;
+m.omw_test_bitmask([True, 0])
+PYTHON_CODE
+
+batch_ok 'lists of bools', 'omw_test_bitmask',
+	[[[list => [bool => 1], [bool => 0], [bool => 1]]]],
+	sub {
+		my ($r) = @_;
+		my ($y, $n) = @{$r}[1, 2];
+		return $n->[1] == 2 && "@{$y->[1]}" eq '3' && "@{$y->[2]}" eq '1 0 1';
+	};
+
+python_ok 'buffers must hold 0 or 1', <<PYTHON_CODE;
+import array
+x = memoryview(array.array('B', [1, 0, 2, 1])).cast('B', [2, 2])
+try:
+    m.omw_test_bitmask(x)
+    assert False, "2 was read as a set element"
+except RuntimeError as e:
+    assert 'found 2 at element 2 ' in str(e), e
+PYTHON_CODE
+
+octave_fails 'arrays must hold 0 or 1', <<OCTAVE_CODE;
+omw_test_bitmask([1 0; 0.5 1])
+exit(0)
+OCTAVE_CODE
+
+batch_ok 'matrices must hold 0 or 1', 'omw_test_bitmask',
+	[[[matrix => [2, 2], [1, 0, 3, 1]]]],
+	sub {
+		my ($r) = @_;
+		return $r->[0] eq 'error' && $r->[1] =~ /found 3 at element 2 /;
+	};
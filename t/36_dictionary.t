@@ -0,0 +1,54 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 7;
+
+octave_ok 'structs', <<OCTAVE_CODE;
+y = omw_test_dictionary(struct('scale', 2, 'x', [1 2; 3 4], 'name', 'abc', 'flag', true))
+exit(ifelse(y.count == 4 && isequal(y.x, [2 4; 6 8]) && strcmp(y.name, 'abc') && islogical(y.flag) && y.flag,0,2))
+OCTAVE_CODE
+
+mathematica_ok 'associations', <<MATHEMATICA_CODE;
+Assert[OmwDictionary[<|"scale" -> 2., "x" -> {{1., 2.}, {3., 4.}}, "n" -> 3, "flag" -> True|>] ==
+	<|"scale" -> 2., "x" -> {{2., 4.}, {6., 8.}}, "n" -> 3, "flag" -> True, "count" -> 4|>]
+MATHEMATICA_CODE
+
+python_ok 'dicts', <<PYTHON_CODE;
+import array
+y = m.omw_test_dictionary({'scale': 2.0, 'x': array.array('d', [1, 2]), 'n': 3, 'name': 'abc', 'flag': True})
+assert list(y) == ['scale', 'x', 'n', 'name', 'flag', 'count'], list(y)
+assert memoryview(y['x']).tolist() == [2, 4]
+assert y['scale'] == 2.0 and y['n'] == 3 and y['name'] == 'abc' and y['flag'] is True and y['count'] == 5, y
+PYTHON_CODE
+
+python_fails 'keys must be strings', <<PYTHON_CODE;
+m.omw_test_dictionary({1: 2})
+PYTHON_CODE
+
+batch_ok 'lists of pairs', 'omw_test_dictionary',
+	[[[list => [list => [string => 'scale'], [float => 2]], [list => [string => 'x'], [matrix => [2], [1, 2]]]]]],
+	sub {
+		my ($r) = @_;
+		my (undef, $scale, $x, $count) = @{$r->[1]};
+		return $scale->[1][1] eq 'scale' && $scale->[2][1] == 2 && $x->[1][1] eq 'x' && "@{$x->[2][2]}" eq '2 4'
+			&& $count->[1][1] eq 'count' && $count->[2][1] == 2;
+	};
+
+python_ok 'numbers convert between int and float', <<PYTHON_CODE;
+import array
+y = m.omw_test_dictionary({'scale': 2, 'offset': 1.0, 'x': array.array('d', [1, 2])})
+assert memoryview(y['x']).tolist() == [3, 5], memoryview(y['x']).tolist()
+try:
+    m.omw_test_dictionary({'offset': 1.5})
+    assert False, "1.5 was read as an integer"
+except RuntimeError as e:
+    assert 'not an integer' in str(e), e
+PYTHON_CODE
+
+octave_ok 'integer fields of structs', <<OCTAVE_CODE;
+y = omw_test_dictionary(struct('offset', 1, 'x', [1 2]))
+exit(ifelse(isequal(y.x, [2 3]),0,2))
+OCTAVE_CODE
@@ -0,0 +1,42 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 7;
+
+mathematica_ok 'graphics complex', <<MATHEMATICA_CODE;
+Assert[OmwGraphics[4] == Graphics[GraphicsComplex[{{0., 0.}, {1., 1.}, {2., 0.}, {3., 1.}},
+	{Point[{1, 2, 3, 4}], Line[{{1, 2, 3, 4}}], Polygon[{{1, 2, 3}, {1, 3, 4}}]}]]]
+MATHEMATICA_CODE
+
+mathematica_ok 'packed coordinates', <<MATHEMATICA_CODE;
+Assert[Developer`PackedArrayQ[OmwGraphics[1000][[1, 1]]]]
+MATHEMATICA_CODE
+
+mathematica_ok 'single vertex', <<MATHEMATICA_CODE;
+Assert[OmwGraphics[1] == Graphics[GraphicsComplex[{{0., 0.}}, {Point[{1}], Line[{{1}}]}]]]
+MATHEMATICA_CODE
+
+mathematica_ok 'points are a flat index list', <<MATHEMATICA_CODE;
+Assert[MatchQ[OmwGraphics[3][[1, 2, 1]], Point[{1, 2, 3}]]]
+MATHEMATICA_CODE
+
+python_ok 'vertex of the graphics dimension', <<PYTHON_CODE;
+assert m.omw_test_graphics_vertex(2, 2) == 1
+assert m.omw_test_graphics_vertex(3, 3) == 1
+PYTHON_CODE
+
+python_ok 'vertex dimension mismatch', <<PYTHON_CODE;
+for dimension, n in ((3, 2), (2, 3)):
+    try:
+        m.omw_test_graphics_vertex(dimension, n)
+        assert False, 'no error'
+    except RuntimeError as e:
+        assert 'Cannot add a %dD vertex to %dD graphics' % (n, dimension) in str(e), str(e)
+PYTHON_CODE
+
+mathematica_fails 'vertex dimension mismatch', <<MATHEMATICA_CODE;
+OmwGraphicsVertex[2, 3]
+MATHEMATICA_CODE
@@ -0,0 +1,103 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 11;
+
+octave_ok 'slices and downsampled views', <<OCTAVE_CODE;
+y = omw_test_remote([1 2 3 4; 5 6 7 8; 9 10 11 12], 0)
+s = omw_test_remote_slice(y.id, [0 3 2 1 4 2])
+d = omw_test_remote_downsample(y.id, 1)
+n = omw_test_remote_release(y.id)
+exit(ifelse(strcmp(y.dtype, 'float32') && isequal(y.dims(:)', [3 4]) && isequal(s, [2 4; 10 12]) && isequal(d, [3.5 5.5; 9.5 11.5]) && n == 1,0,2))
+OCTAVE_CODE
+
+octave_fails 'released arrays are evicted past the capacity', <<OCTAVE_CODE;
+a = omw_test_remote(ones(3, 4), 48);
+b = omw_test_remote(ones(3, 4), 48);
+omw_test_remote_release(a.id);
+s = omw_test_remote_slice(a.id, [0 1 1 0 1 1])
+exit(0)
+OCTAVE_CODE
+
+mathematica_ok 'slices and downsampled views', <<MATHEMATICA_CODE;
+y = OmwRemote[{{1., 2., 3., 4.}, {5., 6., 7., 8.}, {9., 10., 11., 12.}}, 0];
+Assert[y["dtype"] == "float32" && y["dims"] === {3, 4}];
+Assert[OmwRemoteSlice[y["id"], {0, 3, 2, 1, 4, 2}] == {{2., 4.}, {10., 12.}}];
+Assert[OmwRemoteDownsample[y["id"], 1] == {{3.5, 5.5}, {9.5, 11.5}}];
+Assert[OmwRemoteRelease[y["id"]] == 1]
+MATHEMATICA_CODE
+
+python_ok 'slices and downsampled views', <<PYTHON_CODE;
+import array
+x = memoryview(array.array('f', range(1, 13))).cast('B').cast('f', [3, 4])
+y = m.omw_test_remote(x, 0)
+assert y['dtype'] == 'float32' and y['dims'] == (3, 4), y
+assert memoryview(m.omw_test_remote_slice(y['id'], array.array('f', [0, 3, 2, 1, 4, 2]))).tolist() == [[2, 4], [10, 12]]
+assert memoryview(m.omw_test_remote_slice(y['id'], array.array('f', [1, 2, 1, 0, 4, 1]))).tolist() == [[5, 6, 7, 8]]
+assert memoryview(m.omw_test_remote_downsample(y['id'], 1)).tolist() == [[3.5, 5.5], [9.5, 11.5]]
+assert m.omw_test_remote_release(y['id']) == 1
+PYTHON_CODE
+
+python_ok 'referenced arrays are kept past the capacity', <<PYTHON_CODE;
+import array
+x = memoryview(array.array('f', range(12))).cast('B').cast('f', [3, 4])
+a = m.omw_test_remote(x, 16)
+b = m.omw_test_remote(x, 16)
+assert memoryview(m.omw_test_remote_slice(a['id'], array.array('f', [2, 3, 1, 2, 4, 1]))).tolist() == [[10, 11]]
+assert m.omw_test_remote_release(a['id']) == 1
+assert m.omw_test_remote_release(b['id']) == 0
+PYTHON_CODE
+
+python_fails 'evicted arrays cannot be fetched', <<PYTHON_CODE;
+import array
+x = memoryview(array.array('f', range(12))).cast('B').cast('f', [3, 4])
+a = m.omw_test_remote(x, 48)
+b = m.omw_test_remote(x, 48)
+m.omw_test_remote_release(a['id'])
+m.omw_test_remote_slice(a['id'], array.array('f', [0, 1, 1, 0, 1, 1]))
+PYTHON_CODE
+
+python_fails 'slices must be within bounds', <<PYTHON_CODE;
+import array
+y = m.omw_test_remote(memoryview(array.array('f', range(12))).cast('B').cast('f', [3, 4]), 0)
+m.omw_test_remote_slice(y['id'], array.array('f', [0, 3, 1, 0, 5, 1]))
+PYTHON_CODE
+
+python_ok 'buffers are copied', <<PYTHON_CODE;
+import array
+a = array.array('f', range(12))
+y = m.omw_test_remote(memoryview(a).cast('B').cast('f', [3, 4]), 0)
+a[0] = 100
+assert memoryview(m.omw_test_remote_slice(y['id'], array.array('f', [0, 1, 1, 0, 2, 1]))).tolist() == [[0, 1]]
+PYTHON_CODE
+
+python_ok 'unreleased arrays are limited', <<PYTHON_CODE;
+import array
+x = memoryview(array.array('f', range(12))).cast('B').cast('f', [3, 4])
+assert m.omw_test_remote_limit(100) == 0
+a = m.omw_test_remote(x, 0)
+b = m.omw_test_remote(x, 0)
+try:
+    m.omw_test_remote(x, 0)
+    assert False, 'no error'
+except RuntimeError as e:
+    assert 'not released yet' in str(e), str(e)
+m.omw_test_remote_release(a['id'])
+assert m.omw_test_remote_limit(100) == 48
+c = m.omw_test_remote(x, 0)
+assert m.omw_test_remote_limit(100) == 96
+PYTHON_CODE
+
+octave_ok 'integer extents', <<OCTAVE_CODE;
+y = omw_test_remote(ones(2, 5), 0)
+exit(ifelse(isequal(y.dims, [2 5]),0,2))
+OCTAVE_CODE
+
+mathematica_ok 'release after use', <<MATHEMATICA_CODE;
+y = OmwRemote[{{1., 2.}, {3., 4.}}, 0];
+Assert[OMW`WithRemote[OmwRemoteRelease, y, OmwRemoteSlice[y["id"], {1, 2, 1, 0, 2, 1}]] == {{3., 4.}}];
+Assert[OmwRemoteLimit[1000] == 0]
+MATHEMATICA_CODE
@@ -0,0 +1,106 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+use FindBin;
+use lib "$FindBin::Bin/";
+use TestHelpers;
+use Test::More tests => 9;
+
+python_ok 'plugins are reloaded without losing state', <<PYTHON_CODE;
+import array, os, shutil, tempfile
+d = os.path.dirname(m.__file__)
+p = os.path.join(tempfile.mkdtemp(), 'plugin.so')
+shutil.copy(os.path.join(d, 'omw_test_plugin_v1.so'), p)
+x = memoryview(array.array('f', [1, 2, 3, 4])).cast('B').cast('f', [2, 2])
+r = m.omw_test_remote(x, 0)
+assert m.omw_test_load_plugin(p) == 2
+assert memoryview(m.omw_test_pipeline('plugin_scale(plugin_identity(x))', x)).tolist() == [[2, 4], [6, 8]]
+assert m.omw_test_reload_plugins() == 0
+shutil.copy(os.path.join(d, 'omw_test_plugin_v2.so'), p)
+os.utime(p, ns=(0, os.stat(p).st_mtime_ns + 1000000000))
+assert m.omw_test_reload_plugins() == 1
+assert memoryview(m.omw_test_pipeline('plugin_scale(x)', x)).tolist() == [[3, 6], [9, 12]]
+assert memoryview(m.omw_test_remote_slice(r['id'], array.array('f', [0, 2, 1, 0, 2, 1]))).tolist() == [[1, 2], [3, 4]]
+PYTHON_CODE
+
+python_fails 'stages removed by a new version are unavailable', <<PYTHON_CODE;
+import array, os, shutil, tempfile
+d = os.path.dirname(m.__file__)
+p = os.path.join(tempfile.mkdtemp(), 'plugin.so')
+x = memoryview(array.array('f', [1, 2, 3, 4])).cast('B').cast('f', [2, 2])
+shutil.copy(os.path.join(d, 'omw_test_plugin_v1.so'), p)
+m.omw_test_load_plugin(p)
+shutil.copy(os.path.join(d, 'omw_test_plugin_v2.so'), p)
+assert m.omw_test_load_plugin(p) == 1
+m.omw_test_pipeline('plugin_identity(x)', x)
+PYTHON_CODE
+
+python_fails 'missing plugins fail to load', <<PYTHON_CODE;
+m.omw_test_load_plugin('/nonexistent/plugin.so')
+PYTHON_CODE
+
+python_fails 'shared objects without an entry point fail to load', <<PYTHON_CODE;
+m.omw_test_load_plugin(m.__file__)
+PYTHON_CODE
+
+python_ok 'plugins cannot take the stages of another plugin', <<PYTHON_CODE;
+import array, os, shutil, tempfile
+d = os.path.dirname(m.__file__)
+x = memoryview(array.array('f', [1, 2, 3, 4])).cast('B').cast('f', [2, 2])
+p1 = os.path.join(tempfile.mkdtemp(), 'plugin.so')
+p2 = os.path.join(tempfile.mkdtemp(), 'plugin.so')
+shutil.copy(os.path.join(d, 'omw_test_plugin_v1.so'), p1)
+shutil.copy(os.path.join(d, 'omw_test_plugin_v2.so'), p2)
+m.omw_test_load_plugin(p1)
+try:
+    m.omw_test_load_plugin(p2)
+    assert False, 'no error'
+except RuntimeError as e:
+    assert 'already registered by plugin ' + p1 in str(e), str(e)
+assert memoryview(m.omw_test_pipeline('plugin_scale(x)', x)).tolist() == [[2, 4], [6, 8]]
+PYTHON_CODE
+
+python_ok 'plugins cannot replace builtin stages', <<PYTHON_CODE;
+import array, os
+d = os.path.dirname(m.__file__)
+x = memoryview(array.array('f', [1, 2, 3, 4])).cast('B').cast('f', [2, 2])
+try:
+    m.omw_test_load_plugin(os.path.join(d, 'omw_test_plugin_v3.so'))
+    assert False, 'no error'
+except RuntimeError as e:
+    assert 'stage "scale" is already registered' in str(e), str(e)
+assert memoryview(m.omw_test_pipeline('scale(x, 3)', x)).tolist() == [[3, 6], [9, 12]]
+PYTHON_CODE
+
+python_ok 'rejected versions keep the previous one', <<PYTHON_CODE;
+import array, os, shutil, tempfile
+d = os.path.dirname(m.__file__)
+x = memoryview(array.array('f', [1, 2, 3, 4])).cast('B').cast('f', [2, 2])
+p = os.path.join(tempfile.mkdtemp(), 'plugin.so')
+shutil.copy(os.path.join(d, 'omw_test_plugin_v1.so'), p)
+m.omw_test_load_plugin(p)
+shutil.copy(os.path.join(d, 'omw_test_plugin_v4.so'), p)
+try:
+    m.omw_test_load_plugin(p)
+    assert False, 'no error'
+except RuntimeError as e:
+    assert 'needs at least one matrix argument' in str(e), str(e)
+assert memoryview(m.omw_test_pipeline('plugin_scale(plugin_identity(x))', x)).tolist() == [[2, 4], [6, 8]]
+PYTHON_CODE
+
+python_fails 'stages of rejected plugins are not registered', <<PYTHON_CODE;
+import array, os
+d = os.path.dirname(m.__file__)
+x = memoryview(array.array('f', [1, 2, 3, 4])).cast('B').cast('f', [2, 2])
+try:
+    m.omw_test_load_plugin(os.path.join(d, 'omw_test_plugin_v4.so'))
+except RuntimeError:
+    pass
+m.omw_test_pipeline('plugin_offset(x)', x)
+PYTHON_CODE
+
+octave_ok 'plugin stages in pipelines', <<OCTAVE_CODE;
+n = omw_test_load_plugin(fullfile(fileparts(which('omw_tests')), 'omw_test_plugin_v2.so'))
+y = omw_test_pipeline('plugin_scale(x)', [1 2; 3 4])
+exit(ifelse(n == 1 && isequal(y, [3 6; 9 12]),0,2))
+OCTAVE_CODE
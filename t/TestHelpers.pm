@@ -6,21 +6,27 @@ use Test::More;
 use File::Spec;
 use IPC::Open3;
 use Getopt::Long;
+use File::Temp qw(tempfile);
+use Time::HiRes qw(gettimeofday tv_interval);
 require Exporter;
 
 our @ISA = qw(Exporter);
-our @EXPORT = qw(octave_ok mathematica_ok octave_fails mathematica_fails);
+our @EXPORT = qw(octave_ok mathematica_ok octave_fails mathematica_fails batch_ok python_ok python_fails startup_ok);
 
 our $_initialized = 0;
 our $_octave_pkg_name;
 our $_mathematica_pkg_name;
+our $_batch_runner_name;
+our $_python_module_name;
 our $_binary_path;
 
 sub check_init {
 	unless ($_initialized) {
 		GetOptions("path=s" => \$_binary_path,
 			"octave-pkg=s" => \$_octave_pkg_name,
-			"mathematica-pkg=s" => \$_mathematica_pkg_name);
+			"mathematica-pkg=s" => \$_mathematica_pkg_name,
+			"batch-runner=s" => \$_batch_runner_name,
+			"python-module=s" => \$_python_module_name);
 
 		$_initialized = 1;
 	}
@@ -41,6 +47,7 @@ sub command_run {
 
 			# Send code
 			print CHLD_IN $code;
+			close CHLD_IN;
 
 			# Get output
 			my $output = do { local $/; <CHLD_OUT> };
@@ -139,6 +146,181 @@ sub mathematica_fails {
 	command_run 'math', $code, $message, 1;
 }
 
+sub python_prepare {
+	my ($message, $code, @extra) = @_;
+	$message = "Python: $message";
+
+	# Import the module as m
+	$code = <<PYTHON_CODE;
+import $_python_module_name as m
+$code
+PYTHON_CODE
+
+	# Prepend the path of the current testing version
+	if (defined binary_path) {
+		my $path = binary_path;
+		$code = <<PYTHON_CODE;
+import sys
+sys.path.insert(0, "$path")
+$code
+PYTHON_CODE
+	}
+
+	return ($message, $code, @extra);
+}
+
+sub python_ok {
+	my ($message, $code) = python_prepare(@_);
+	command_run 'python3', $code, $message, 0;
+}
+
+sub python_fails {
+	my ($message, $code) = python_prepare(@_);
+	command_run 'python3', $code, $message, 1;
+}
+
+# Runs $code in $cmd $runs times, and returns the fastest wall-clock time in seconds,
+# or undef if the command is not available or fails
+sub time_command {
+	my ($cmd, $code, $runs) = @_;
+	my $best;
+
+	for (1..$runs) {
+		my $start = [gettimeofday];
+		my $pid = eval { open3(\*TIME_IN, \*TIME_OUT, undef, $cmd) };
+		return undef unless $pid;
+
+		print TIME_IN $code;
+		close TIME_IN;
+		my $output = do { local $/; <TIME_OUT> };
+		waitpid($pid, 0);
+		return undef if $?;
+
+		my $elapsed = tv_interval($start);
+		$best = $elapsed if !defined $best || $elapsed < $best;
+	}
+
+	return $best;
+}
+
+# Measures the time from loading the module of $host to the end of a first call in
+# $code, as the difference with the startup time of the host alone
+my %_startup_hosts = (
+	octave => ['octave-cli', \&octave_prepare, "1;\n"],
+	mathematica => ['math', \&mathematica_prepare, "Exit[0]\n"],
+	python => ['python3', \&python_prepare, "pass\n"]);
+
+sub startup_ok {
+	my ($message, $host, $code) = @_;
+	my ($cmd, $prepare, $empty) = @{$_startup_hosts{$host}};
+	($message, $code) = $prepare->($message, $code);
+
+	SKIP: {
+		my $host_time = time_command($cmd, $empty, 3);
+		skip("$message (skipped because $cmd is not available)", 1) unless defined $host_time;
+
+		my $total_time = time_command($cmd, $code, 3);
+		ok(defined $total_time, $message) or last SKIP;
+
+		diag sprintf("%s: %.1f ms", $message, 1000 * ($total_time - $host_time));
+	}
+}
+
+# Batch files, see omw/batch_file.hpp. Values are array refs: [bool => 1],
+# [int => 2], [unsigned => 3], [float => 1.5], [string => "a"],
+# [matrix => [dims], [row-major elements]], [list => values...], [error => "message"]
+my %_batch_kinds = (bool => 0, int => 1, unsigned => 2, float => 3, string => 4,
+	matrix => 5, list => 6, error => 7);
+my %_batch_names = reverse %_batch_kinds;
+
+sub _batch_pad {
+	my ($bytes) = @_;
+	return $bytes . ("\0" x ((8 - length($bytes) % 8) % 8));
+}
+
+sub batch_encode_value {
+	my ($kind, @rest) = @{$_[0]};
+	my $code = $_batch_kinds{$kind};
+
+	if ($kind eq 'bool' or $kind eq 'int' or $kind eq 'unsigned') {
+		return pack('LLq', $code, 0, $rest[0]);
+	} elsif ($kind eq 'float') {
+		return pack('LLd', $code, 0, $rest[0]);
+	} elsif ($kind eq 'string' or $kind eq 'error') {
+		return pack('LL', $code, length($rest[0])) . _batch_pad($rest[0]);
+	} elsif ($kind eq 'matrix') {
+		my ($dims, $data) = @rest;
+		return pack('LL', $code, scalar @$dims) . _batch_pad(pack('l*', @$dims))
+			. _batch_pad(pack('f*', @$data));
+	} else {
+		return pack('LL', $code, scalar @rest) . join('', map { batch_encode_value($_) } @rest);
+	}
+}
+
+sub batch_decode_value {
+	my ($bytes, $offset) = @_;
+	my ($code, $size) = unpack("x$$offset LL", $$bytes);
+	my $kind = $_batch_names{$code};
+	$$offset += 8;
+
+	my $take = sub {
+		my ($length) = @_;
+		my $data = substr($$bytes, $$offset, $length);
+		$$offset += $length + (8 - $length % 8) % 8;
+		return $data;
+	};
+
+	if ($kind eq 'bool' or $kind eq 'int' or $kind eq 'unsigned') {
+		return [$kind => unpack('q', $take->(8))];
+	} elsif ($kind eq 'float') {
+		return [$kind => unpack('d', $take->(8))];
+	} elsif ($kind eq 'string' or $kind eq 'error') {
+		return [$kind => $take->($size)];
+	} elsif ($kind eq 'matrix') {
+		my @dims = unpack('l*', $take->(4 * $size));
+		my $count = 1;
+		$count *= $_ for @dims;
+		return [$kind => [@dims], [unpack('f*', $take->(4 * $count))]];
+	} else {
+		return [$kind => map { batch_decode_value($bytes, $offset) } 1..$size];
+	}
+}
+
+# Runs $function on the argument records with the batch runner, and checks the
+# decoded result records with $check
+sub batch_ok {
+	my ($message, $function, $records, $check) = @_;
+	$message = "Batch: $message";
+
+	SKIP: {
+		my $runner = defined binary_path
+			? File::Spec->catfile(binary_path, $_batch_runner_name // 'omw_tests_batch')
+			: ($_batch_runner_name // 'omw_tests_batch');
+		skip("$message (skipped because $runner is not available)", 1)
+			unless defined binary_path ? -x $runner : 1;
+
+		my ($in, $input) = tempfile(UNLINK => 1);
+		my (undef, $output) = tempfile(UNLINK => 1);
+		binmode $in;
+		print $in pack('a8LL', 'OMWBATC1', 0x01020304, scalar @$records);
+		print $in batch_encode_value([list => @$_]) for @$records;
+		close $in;
+
+		system($runner, $function, $input, $output);
+		diag "$runner exited with status " . ($? >> 8) if $?;
+
+		open(my $out, '<:raw', $output) or do { fail($message); last SKIP; };
+		my $bytes = do { local $/; <$out> };
+		close $out;
+
+		my (undef, undef, $count) = unpack('a8LL', $bytes);
+		my $offset = 16;
+		my @results = map { batch_decode_value(\$bytes, \$offset) } 1..($count // 0);
+
+		ok($check->(@results), $message);
+	}
+}
+
 check_init;
 
 1;
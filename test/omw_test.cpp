@@ -56,6 +56,518 @@ template <typename TWrapper> void impl_omw_test_concat_pl(TWrapper &w)
 	w.write_result(ss.str());
 }
 
+template <typename TWrapper> void impl_omw_test_view_at(TWrapper &w)
+{
+	auto m = w.template get_param<omw::matrix_view<float>>(0, "M");
+	int i = w.template get_param<int>(1, "I");
+	int j = w.template get_param<int>(2, "J");
+
+	float result = m.roi(i, j, 1, 1)(0, 0);
+
+	w.write_result(result);
+}
+
+template <typename TWrapper> void impl_omw_test_view_block(TWrapper &w)
+{
+	auto m = w.template get_param<omw::matrix_view<float>>(0, "M");
+	int i0 = w.template get_param<int>(1, "I0");
+	int j0 = w.template get_param<int>(2, "J0");
+	int h = w.template get_param<int>(3, "H");
+	int wd = w.template get_param<int>(4, "W");
+	int si = w.template get_param<int>(5, "Si");
+	int sj = w.template get_param<int>(6, "Sj");
+	bool transposed = w.template get_param<bool>(7, "Transposed");
+
+	auto view((transposed ? m.transposed() : m).step(si, sj));
+
+	std::vector<float> block(size_t(h) * wd * view.dims()[2]);
+	view.read_block(i0, j0, h, wd, block.data());
+
+	w.write_result(omw::vector_matrix<float>::make(std::move(block), std::vector<int>{ h, wd }));
+}
+
+template <typename TWrapper> void impl_omw_test_sum_finite(TWrapper &w)
+{
+	omw::validation_options options;
+	options.reject_non_finite = true;
+	options.compute_stats = true;
+
+	auto m = w.template get_param<std::shared_ptr<omw::basic_matrix<float>>>(0, "M", options);
+
+	float result = static_cast<float>(m->stats().sum);
+
+	w.write_result(result);
+}
+
+template <typename TWrapper> std::shared_ptr<omw::tiled_matrix<float>> read_tiled(TWrapper &w, size_t paramIdx)
+{
+	// Small tiles exercise the tile borders, the wrapper is shared by the other tests so
+	// the previous size is restored even if reading fails
+	struct tile_size_scope
+	{
+		TWrapper &w_;
+		int previous_;
+		~tile_size_scope() { w_.tile_size(previous_); }
+	} scope{ w, w.tile_size() };
+
+	w.tile_size(2);
+
+	return w.template get_param<std::shared_ptr<omw::tiled_matrix<float>>>(paramIdx, "M");
+}
+
+template <typename TWrapper> void impl_omw_test_tiled_roundtrip(TWrapper &w)
+{
+	auto m = read_tiled(w, 0);
+
+	w.write_result(m);
+}
+
+template <typename TWrapper> void impl_omw_test_tiled_clamped(TWrapper &w)
+{
+	auto m = read_tiled(w, 0);
+	int i = w.template get_param<int>(1, "I");
+	int j = w.template get_param<int>(2, "J");
+
+	w.write_result(m->at_clamped(i, j));
+}
+
+template <typename TWrapper> void impl_omw_test_tiled_neighborhood(TWrapper &w)
+{
+	auto m = read_tiled(w, 0);
+	int i = w.template get_param<int>(1, "I");
+	int j = w.template get_param<int>(2, "J");
+	int radius = w.template get_param<int>(3, "Radius");
+
+	std::vector<int> dims{ 2 * radius + 1, 2 * radius + 1 };
+	if (m->depth() == 3)
+		dims.push_back(m->channels());
+
+	std::vector<float> elements(std::size_t(dims[0]) * dims[1] * m->channels());
+	m->neighborhood(i, j, radius, elements.data());
+
+	w.write_result(omw::vector_matrix<float>::make(std::move(elements), std::move(dims)));
+}
+
+template <typename TWrapper> void impl_omw_test_frame(TWrapper &w)
+{
+	std::string id = w.template get_param<std::string>(0, "Id");
+	auto m = w.template get_param<std::shared_ptr<omw::basic_matrix<float>>>(1, "M");
+
+	// The kernel evaluates the sequence number of the last frame it applied with the call
+	int host_sequence = -1;
+	OM_MATHEMATICA(w, [&]() { host_sequence = w.template get_param<int>(2, "Sequence"); });
+
+	w.write_frame(id, m, host_sequence);
+}
+
+template <typename TWrapper> void impl_omw_test_progressive(TWrapper &w)
+{
+	std::string id = w.template get_param<std::string>(0, "Id");
+	auto m = w.template get_param<std::shared_ptr<omw::basic_matrix<float>>>(1, "M");
+	int levels = w.template get_param<int>(2, "Levels");
+
+	w.write_progressive(id, m, levels);
+}
+
+template <typename TWrapper> void impl_omw_test_refine(TWrapper &w)
+{
+	std::string id = w.template get_param<std::string>(0, "Id");
+
+	w.write_refinement(id);
+}
+
+template <typename TWrapper> void impl_omw_test_progressive_capacity(TWrapper &w)
+{
+	int capacity = w.template get_param<int>(0, "Capacity");
+
+	int previous = static_cast<int>(w.progressive().capacity());
+	w.progressive().capacity(capacity);
+
+	w.write_result(previous);
+}
+
+template <typename TWrapper> void impl_omw_test_profile(TWrapper &w)
+{
+	bool enable = w.template get_param<bool>(0, "Enable");
+
+	w.profiler().enabled(enable);
+	w.profiler().hardware_counters(enable);
+}
+
+template <typename TWrapper> void impl_omw_test_calls(TWrapper &w)
+{
+	std::string name = w.template get_param<std::string>(0, "Name");
+
+	auto it = w.profiler().functions().find(name);
+	int result = it == w.profiler().functions().end() ? 0 : static_cast<int>(it->second.calls);
+
+	w.write_result(result);
+}
+
+template <typename TWrapper> void impl_omw_test_slow_threshold(TWrapper &w)
+{
+	int threshold = w.template get_param<int>(0, "Threshold");
+
+	w.profiler().slow_calls().threshold(threshold);
+}
+
+template <typename TWrapper> void impl_omw_test_slow_last(TWrapper &w)
+{
+	const auto &records(w.profiler().slow_calls().records());
+	std::string result = records.empty() ? std::string() : records.back().format();
+
+	w.write_result(result);
+}
+
+template <typename TWrapper> void impl_omw_test_metrics(TWrapper &w)
+{
+	std::string target = w.template get_param<std::string>(0, "Target");
+	int interval = w.template get_param<int>(1, "Interval");
+
+	if (target.empty())
+		w.stop_metrics();
+	else
+		w.start_metrics(target, interval);
+}
+
+template <typename TWrapper> void impl_omw_test_autotune(TWrapper &w)
+{
+	std::string cache = w.template get_param<std::string>(0, "Cache");
+
+	bool result = w.autotune(cache).from_cache;
+
+	w.write_result(result);
+}
+
+template <typename TWrapper> void impl_omw_test_snapshot(TWrapper &w)
+{
+	std::string path = w.template get_param<std::string>(0, "Path");
+	auto m = w.template get_param<std::shared_ptr<omw::basic_matrix<float>>>(1, "M");
+
+	w.state().put("m", m);
+	w.state().save(path);
+	w.state().clear();
+	w.state().load(path);
+
+	w.write_result(w.state().matrix("m"));
+}
+
+template <typename TWrapper> void impl_omw_test_snapshot_table(TWrapper &w)
+{
+	std::string path = w.template get_param<std::string>(0, "Path");
+	auto m = w.template get_param<std::shared_ptr<omw::basic_matrix<float>>>(1, "M");
+
+	std::size_t count = 1;
+	for (int k = 0; k < m->depth(); ++k)
+		count *= m->dims()[k];
+
+	std::vector<float> row_major(count);
+	m->copy_to(row_major.data());
+	std::vector<std::int32_t> table(row_major.begin(), row_major.end());
+
+	w.state().put_table("t", std::move(table));
+	w.state().save(path);
+	w.state().clear();
+	w.state().load(path);
+
+	auto loaded = w.state().template table<std::int32_t>("t");
+	std::vector<float> elements(loaded.begin(), loaded.end());
+	std::vector<int> dims{ static_cast<int>(elements.size()) };
+
+	w.write_result(omw::vector_matrix<float>::make(std::move(elements), std::move(dims)));
+}
+
+template <typename TWrapper> void impl_omw_test_state_put(TWrapper &w)
+{
+	std::string name = w.template get_param<std::string>(0, "Name");
+	auto m = w.template get_param<std::shared_ptr<omw::basic_matrix<float>>>(1, "M");
+
+	w.state().put(name, m);
+}
+
+template <typename TWrapper> void impl_omw_test_state_get(TWrapper &w)
+{
+	std::string name = w.template get_param<std::string>(0, "Name");
+
+	w.write_result(w.state().matrix(name));
+}
+
+template <typename TWrapper> void impl_omw_test_snapshot_load(TWrapper &w)
+{
+	std::string path = w.template get_param<std::string>(0, "Path");
+	bool warm = w.template get_param<bool>(1, "Warm");
+
+	w.state().clear();
+
+	std::size_t count = warm ? w.warm_restart(path) : w.state().load(path);
+	w.write_result(static_cast<int>(count));
+}
+
+template <typename TWrapper> void impl_omw_test_pipeline(TWrapper &w)
+{
+	std::string description = w.template get_param<std::string>(0, "Pipeline");
+	auto x = w.template get_param<std::shared_ptr<omw::basic_matrix<float>>>(1, "X");
+
+	w.write_result(w.run_pipeline(description, { { "x", x } }));
+}
+
+template <typename TWrapper> void impl_omw_test_range_sum(TWrapper &w)
+{
+	auto x = w.template get_param<boost::variant<omw::range_view<float>, std::shared_ptr<omw::basic_array<float>>>>(0, "X");
+
+	// Ranges are summed from their bounds, other arrays element by element
+	double sum = 0.0;
+	int lazy = 0;
+
+	if (auto range = boost::get<omw::range_view<float>>(&x))
+	{
+		sum = range->size() * (range->base() + range->last()) / 2.0;
+		lazy = 1;
+	}
+	else
+	{
+		auto &array = boost::get<std::shared_ptr<omw::basic_array<float>>>(x);
+		for (size_t i = 0; i < array->size(); ++i)
+			sum += (*array)[i];
+	}
+
+	w.write_result(static_cast<float>(sum), lazy);
+}
+
+template <typename TWrapper> void impl_omw_test_ragged(TWrapper &w)
+{
+	auto x = w.template get_param<omw::ragged_array<float>>(0, "X");
+
+	// Cumulative sums within each row
+	for (size_t i = 0; i < x.size(); ++i)
+	{
+		float *row = x.row(i);
+		for (size_t j = 1; j < x.row_size(i); ++j)
+			row[j] += row[j - 1];
+	}
+
+	w.write_result(x, static_cast<int>(x.total_size()));
+}
+
+template <typename TWrapper> void impl_omw_test_matrix_batch(TWrapper &w)
+{
+	auto x = w.template get_param<omw::matrix_batch<float>>(0, "X");
+
+	// Scale each item by its 1-based index
+	for (size_t i = 0; i < x.size(); ++i)
+	{
+		float *item = x.item(i);
+		for (size_t j = 0; j < x.item_size(); ++j)
+			item[j] *= static_cast<float>(i + 1);
+	}
+
+	w.write_result(x, static_cast<int>(x.size()));
+}
+
+template <typename TWrapper> void impl_omw_test_bitmask(TWrapper &w)
+{
+	auto x = w.template get_param<omw::bitmask>(0, "X");
+
+	w.write_result(x, static_cast<int>(x.count()));
+}
+
+template <typename TWrapper> void impl_omw_test_dictionary(TWrapper &w)
+{
+	omw::dictionary x = w.template get_param<omw::dictionary>(0, "X");
+	float scale = x.get<float>("scale", 1.0f);
+	int offset = x.get<int>("offset", 0);
+
+	// Copy the entries, scaling the matrices
+	omw::dictionary y;
+	for (size_t i = 0; i < x.size(); ++i)
+	{
+		const auto *matrix = boost::get<std::shared_ptr<omw::basic_matrix<float>>>(&x.value(i));
+		if (!matrix)
+		{
+			y.insert(x.key(i), x.value(i));
+			continue;
+		}
+
+		std::vector<int> dims((*matrix)->dims(), (*matrix)->dims() + (*matrix)->depth());
+		size_t count = 1;
+		for (int d : dims)
+			count *= d;
+
+		std::vector<float> f(count);
+		(*matrix)->copy_to(f.data());
+
+		for (auto &v : f)
+			v = v * scale + offset;
+
+		y.insert(x.key(i), omw::vector_matrix<float>::make(std::move(f), std::move(dims)));
+	}
+
+	y.insert("count", static_cast<int>(x.size()));
+	w.write_result(y);
+}
+
+template <typename TWrapper> void impl_omw_test_remote(TWrapper &w)
+{
+	auto m = w.template get_param<std::shared_ptr<omw::basic_matrix<float>>>(0, "M");
+	int capacity = w.template get_param<int>(1, "Capacity");
+
+	if (capacity > 0)
+		w.remote().capacity(capacity);
+
+	w.write_remote(m);
+}
+
+template <typename TWrapper> void impl_omw_test_remote_slice(TWrapper &w)
+{
+	int id = w.template get_param<int>(0, "Id");
+	auto spec = w.template get_param<std::shared_ptr<omw::basic_array<float>>>(1, "Spec");
+
+	// Spec holds start, stop and step for each dimension
+	std::vector<int> start, stop, step;
+	for (size_t i = 0; i + 2 < spec->size(); i += 3)
+	{
+		start.push_back(static_cast<int>((*spec)[i]));
+		stop.push_back(static_cast<int>((*spec)[i + 1]));
+		step.push_back(static_cast<int>((*spec)[i + 2]));
+	}
+
+	w.write_remote_slice(id, start, stop, step);
+}
+
+template <typename TWrapper> void impl_omw_test_remote_downsample(TWrapper &w)
+{
+	int id = w.template get_param<int>(0, "Id");
+	int levels = w.template get_param<int>(1, "Levels");
+
+	w.write_remote_downsampled(id, levels);
+}
+
+template <typename TWrapper> void impl_omw_test_remote_release(TWrapper &w)
+{
+	int id = w.template get_param<int>(0, "Id");
+
+	w.remote().release(id);
+	w.write_result(static_cast<int>(w.remote().size()));
+}
+
+template <typename TWrapper> void impl_omw_test_remote_limit(TWrapper &w)
+{
+	int limit = w.template get_param<int>(0, "Limit");
+
+	w.remote().reference_limit(limit);
+	w.write_result(static_cast<int>(w.remote().referenced_bytes()));
+}
+
+template <typename TWrapper> void impl_omw_test_load_plugin(TWrapper &w)
+{
+	std::string path = w.template get_param<std::string>(0, "Path");
+
+	w.write_result(static_cast<int>(w.load_plugin(path)));
+}
+
+template <typename TWrapper> void impl_omw_test_reload_plugins(TWrapper &w)
+{
+	w.write_result(static_cast<int>(w.reload_plugins()));
+}
+
+template <typename TWrapper> void impl_omw_test_messages(TWrapper &w)
+{
+	int n = w.template get_param<int>(0, "N");
+	bool fail = w.template get_param<bool>(1, "Fail");
+
+	// Repeated warnings are delivered once, and progress updates replace each other
+	for (int i = 1; i <= n; ++i)
+	{
+		w.warning("repeated warning");
+		w.progress(std::to_string(i) + "/" + std::to_string(n));
+	}
+
+	w.warning("last warning");
+
+	if (fail)
+		throw std::runtime_error("failed after warnings");
+
+	w.write_result(n);
+}
+
+template <typename TWrapper> void impl_omw_test_graphics(TWrapper &w)
+{
+	OM_MATHEMATICA(w, [&]() {
+		int n = w.template get_param<int>(0, "N");
+
+		// n vertices zigzagging along the x axis, a point at each, a line through them
+		// and a fan of triangles
+		omw::graphics g;
+		g.reserve(n);
+
+		std::vector<std::uint32_t> indices;
+		for (int i = 0; i < n; ++i)
+			indices.push_back(g.vertex(static_cast<float>(i), static_cast<float>(i % 2)));
+
+		g.points(indices.data(), indices.size());
+		g.line(indices.data(), indices.size());
+
+		for (int i = 1; i + 1 < n; ++i)
+		{
+			// Braced initializers would split the macro argument
+			std::uint32_t triangle[3];
+			triangle[0] = 0;
+			triangle[1] = i;
+			triangle[2] = i + 1;
+			g.polygon(triangle, 3);
+		}
+
+		w.write_result(g);
+	});
+}
+
+template <typename TWrapper> void impl_omw_test_graphics_vertex(TWrapper &w)
+{
+	int dimension = w.template get_param<int>(0, "Dimension");
+	int coordinates = w.template get_param<int>(1, "Coordinates");
+
+	omw::graphics g(dimension);
+	if (coordinates == 3)
+		g.vertex(1.0f, 2.0f, 3.0f);
+	else
+		g.vertex(1.0f, 2.0f);
+
+	w.write_result(static_cast<int>(g.vertex_count()));
+}
+
+template <typename TWrapper> void impl_omw_test_flush_policy(TWrapper &w)
+{
+	OM_MATHEMATICA(w, [&]() {
+		std::string mode = w.template get_param<std::string>(0, "Mode");
+		unsigned int n = w.template get_param<unsigned int>(1, "N");
+
+		if (mode == "calls")
+			w.pipeline_flush(omw::flush_policy::every_calls(n));
+		else if (mode == "bytes")
+			w.pipeline_flush(omw::flush_policy::every_bytes(n));
+		else
+			w.pipeline_flush(omw::flush_policy());
+	});
+}
+
+template <typename TWrapper> void impl_omw_test_throw_unknown(TWrapper &w)
+{
+	(void)w;
+
+	// Not derived from std::exception
+	throw 42;
+}
+
+template <typename TWrapper> void impl_omw_test_fail_after_result(TWrapper &w)
+{
+	OM_MATHEMATICA(w, [&]() {
+		int n = w.template get_param<int>(0, "N");
+
+		w.write_result(n);
+		throw std::runtime_error("failed after the result");
+	});
+}
+
 #if OMW_OCTAVE
 
 static omw::octavew wrapper(reinterpret_cast<void *>(&impl_omw_test_times<omw::octavew>));
@@ -68,6 +580,44 @@ DEFUN_DLD(omw_tests, args, , "omw_tests() initializes the omw_test oct file")
 	wrapper.set_autoload("omw_test_ftimes");
 	wrapper.set_autoload("omw_test_concat");
 	wrapper.set_autoload("omw_test_concat_pl");
+	wrapper.set_autoload("omw_test_view_at");
+	wrapper.set_autoload("omw_test_view_block");
+	wrapper.set_autoload("omw_test_sum_finite");
+	wrapper.set_autoload("omw_test_tiled_roundtrip");
+	wrapper.set_autoload("omw_test_tiled_clamped");
+	wrapper.set_autoload("omw_test_tiled_neighborhood");
+	wrapper.set_autoload("omw_test_frame");
+	wrapper.set_autoload("omw_test_progressive");
+	wrapper.set_autoload("omw_test_progressive_capacity");
+	wrapper.set_autoload("omw_test_refine");
+	wrapper.set_autoload("omw_test_profile");
+	wrapper.set_autoload("omw_test_calls");
+	wrapper.set_autoload("omw_test_slow_threshold");
+	wrapper.set_autoload("omw_test_slow_last");
+	wrapper.set_autoload("omw_test_metrics");
+	wrapper.set_autoload("omw_test_autotune");
+	wrapper.set_autoload("omw_test_snapshot");
+	wrapper.set_autoload("omw_test_snapshot_table");
+	wrapper.set_autoload("omw_test_snapshot_load");
+	wrapper.set_autoload("omw_test_state_put");
+	wrapper.set_autoload("omw_test_state_get");
+	wrapper.set_autoload("omw_test_pipeline");
+	wrapper.set_autoload("omw_test_flush_policy");
+	wrapper.set_autoload("omw_test_fail_after_result");
+	wrapper.set_autoload("omw_test_range_sum");
+	wrapper.set_autoload("omw_test_messages");
+	wrapper.set_autoload("omw_test_ragged");
+	wrapper.set_autoload("omw_test_matrix_batch");
+	wrapper.set_autoload("omw_test_bitmask");
+	wrapper.set_autoload("omw_test_dictionary");
+	wrapper.set_autoload("omw_test_remote");
+	wrapper.set_autoload("omw_test_remote_slice");
+	wrapper.set_autoload("omw_test_remote_downsample");
+	wrapper.set_autoload("omw_test_remote_release");
+	wrapper.set_autoload("omw_test_remote_limit");
+	wrapper.set_autoload("omw_test_graphics_vertex");
+	wrapper.set_autoload("omw_test_load_plugin");
+	wrapper.set_autoload("omw_test_reload_plugins");
 
 	return octave_value();
 }
@@ -75,7 +625,7 @@ DEFUN_DLD(omw_tests, args, , "omw_tests() initializes the omw_test oct file")
 #define OM_DEFUN(name, oct_usage)                                    \
 	DEFUN_DLD(name, args, , oct_usage)                               \
 	{                                                                \
-		return wrapper.run_function(args, impl_##name<omw::octavew>); \
+		return wrapper.run_function(#name, args, impl_##name<omw::octavew>); \
 	}
 
 #endif /* OMW_OCTAVE */
@@ -85,12 +635,38 @@ DEFUN_DLD(omw_tests, args, , "omw_tests() initializes the omw_test oct file")
 // Mathematica API wrapper
 static omw::mathematica wrapper("OMW", stdlink);
 
-#define OM_DEFUN(name, oct_usage) \
-	extern "C" void name();       \
-	void name() { wrapper.run_function(impl_##name<omw::mathematica>); }
+#define OM_DEFUN(name, oct_usage)                                                         \
+	extern "C" void name();                                                               \
+	static omw::mathematica_function name##_pipelined(#name, impl_##name<omw::mathematica>); \
+	void name() { wrapper.run_function(#name, impl_##name<omw::mathematica>); }
+
+OM_DEFUN(omw_test_graphics, "omw_test_graphics(n) returns graphics of n points, a line through them and a fan of triangles")
+
+// Entry point of pipelined batches of the functions below
+extern "C" void omw_test_pipelined();
+void omw_test_pipelined() { wrapper.run_pipelined(); }
 
 #endif /* OMW_MATHEMATICA */
 
+#if OMW_BATCH
+
+#define OM_DEFUN(name, oct_usage) \
+	static omw::batch_function name##_batch(#name, oct_usage, impl_##name<omw::batch>);
+
+#endif /* OMW_BATCH */
+
+#if OMW_PYTHON
+
+// Python API wrapper
+static omw::python wrapper;
+
+#define OM_DEFUN(name, oct_usage)                                              \
+	static omw::python_function name##_python(#name, oct_usage, [](PyObject *args) { \
+		return wrapper.run_function(#name, args, impl_##name<omw::python>);         \
+	});
+
+#endif /* OMW_PYTHON */
+
 #if !defined(OM_DEFUN)
 
 #define OM_DEFUN(name, oct_usage)
@@ -108,3 +684,81 @@ OM_DEFUN(omw_test_ftimes, "omw_test_ftimes(x, y) returns x * y")
 OM_DEFUN(omw_test_concat, "omw_test_concat(a, b) returns a . b")
 
 OM_DEFUN(omw_test_concat_pl, "omw_test_concat_pl(a, b, ...) returns a . b . ... ")
+
+OM_DEFUN(omw_test_view_at, "omw_test_view_at(m, i, j) returns m(i + 1, j + 1)")
+
+OM_DEFUN(omw_test_view_block, "omw_test_view_block(m, i0, j0, h, w, si, sj, t) reads an h x w block at (i0, j0) of m, transposed if t, keeping every si-th row and sj-th column")
+
+OM_DEFUN(omw_test_sum_finite, "omw_test_sum_finite(m) returns sum(m(:)), failing on non-finite values")
+
+OM_DEFUN(omw_test_tiled_roundtrip, "omw_test_tiled_roundtrip(m) returns m after storing it in tiles")
+
+OM_DEFUN(omw_test_tiled_clamped, "v = omw_test_tiled_clamped(m, i, j) returns the element of m nearest to the 0-based row i and column j, with 2x2 tiles")
+
+OM_DEFUN(omw_test_tiled_neighborhood, "n = omw_test_tiled_neighborhood(m, i, j, radius) returns the neighborhood of radius radius around the 0-based row i and column j of m, with 2x2 tiles")
+
+OM_DEFUN(omw_test_frame, "omw_test_frame(id, m) returns m as the next frame of stream id")
+
+OM_DEFUN(omw_test_progressive, "omw_test_progressive(id, m, levels) returns m downsampled levels times")
+
+OM_DEFUN(omw_test_progressive_capacity, "previous = omw_test_progressive_capacity(bytes) sets the size above which progressive results are discarded")
+
+OM_DEFUN(omw_test_refine, "omw_test_refine(id) returns the next refinement of the progressive result id")
+
+OM_DEFUN(omw_test_profile, "omw_test_profile(enable) enables or disables call profiling")
+
+OM_DEFUN(omw_test_calls, "omw_test_calls(name) returns the number of profiled calls to name")
+
+OM_DEFUN(omw_test_slow_threshold, "omw_test_slow_threshold(ns) sets the slow call threshold in nanoseconds")
+
+OM_DEFUN(omw_test_slow_last, "omw_test_slow_last() returns the last slow call record")
+
+OM_DEFUN(omw_test_metrics, "omw_test_metrics(target, interval) publishes metrics to target every interval ms")
+
+OM_DEFUN(omw_test_autotune, "omw_test_autotune(cache) applies tuning parameters, returns true if they were cached")
+
+OM_DEFUN(omw_test_snapshot, "omw_test_snapshot(path, m) returns m after saving it to the snapshot path and mapping it back")
+
+OM_DEFUN(omw_test_snapshot_table, "omw_test_snapshot_table(path, m) returns the elements of m as integers after saving them as a table to the snapshot path and mapping it back")
+
+OM_DEFUN(omw_test_snapshot_load, "count = omw_test_snapshot_load(path, warm) loads the snapshot path, through warm_restart if warm is true")
+
+OM_DEFUN(omw_test_state_put, "omw_test_state_put(name, m) registers m as the resident state entry name")
+
+OM_DEFUN(omw_test_state_get, "m = omw_test_state_get(name) returns the resident state entry name")
+
+OM_DEFUN(omw_test_pipeline, "omw_test_pipeline(p, x) runs the pipeline p with the input x")
+
+OM_DEFUN(omw_test_flush_policy, "omw_test_flush_policy(mode, n) flushes pipelined calls per call, every n calls or n bytes")
+
+OM_DEFUN(omw_test_fail_after_result, "omw_test_fail_after_result(n) returns n, and then fails")
+
+OM_DEFUN(omw_test_throw_unknown, "omw_test_throw_unknown() throws an exception that is not a std::exception")
+
+OM_DEFUN(omw_test_range_sum, "[s, lazy] = omw_test_range_sum(x) returns sum(x), lazy being true if x was read as a range")
+
+OM_DEFUN(omw_test_messages, "omw_test_messages(n, fail) queues n identical warnings and progress updates, and returns n or fails")
+
+OM_DEFUN(omw_test_ragged, "[y, n] = omw_test_ragged(x) returns the cumulative sums of each vector of x, and the number of values")
+
+OM_DEFUN(omw_test_matrix_batch, "[y, n] = omw_test_matrix_batch(x) returns the matrices of x scaled by their index, and their number")
+
+OM_DEFUN(omw_test_bitmask, "[y, n] = omw_test_bitmask(x) returns x as a logical array, and the number of true elements")
+
+OM_DEFUN(omw_test_dictionary, "y = omw_test_dictionary(x) returns the fields of x with arrays scaled by x.scale and offset by the integer x.offset, and their number as y.count")
+
+OM_DEFUN(omw_test_remote, "y = omw_test_remote(m, capacity) keeps m in the native process and returns its descriptor, evicting released arrays past capacity bytes if capacity > 0")
+
+OM_DEFUN(omw_test_remote_slice, "omw_test_remote_slice(id, [start stop step ...]) returns a strided slice of the remote array id, with 0-based bounds")
+
+OM_DEFUN(omw_test_remote_downsample, "omw_test_remote_downsample(id, levels) returns the remote array id downsampled levels times")
+
+OM_DEFUN(omw_test_remote_release, "omw_test_remote_release(id) releases the remote array id, and returns the number of arrays kept")
+
+OM_DEFUN(omw_test_remote_limit, "omw_test_remote_limit(bytes) limits the size of the unreleased remote arrays, and returns their current size")
+
+OM_DEFUN(omw_test_graphics_vertex, "omw_test_graphics_vertex(dimension, n) adds a vertex of n coordinates to graphics of the given dimension, and returns the number of vertices")
+
+OM_DEFUN(omw_test_load_plugin, "omw_test_load_plugin(path) loads or reloads the plugin at path, and returns the number of its pipeline stages")
+
+OM_DEFUN(omw_test_reload_plugins, "omw_test_reload_plugins() reloads the plugins that were rebuilt, and returns their number")
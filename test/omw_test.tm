@@ -58,6 +58,418 @@ void omw_test_concat_pl P(( ));
 :ReturnType:     Manual
 :End:
 
+void omw_test_view_at P(( ));
+
+:Begin:
+:Function:       omw_test_view_at
+:Pattern:        OmwViewAt[m_List, i_Integer, j_Integer]
+:Arguments:      { m, i, j }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_view_block P(( ));
+
+:Begin:
+:Function:       omw_test_view_block
+:Pattern:        OmwViewBlock[m_List, i0_Integer, j0_Integer, h_Integer, w_Integer, si_Integer, sj_Integer, t_?BooleanQ]
+:Arguments:      { m, i0, j0, h, w, si, sj, t }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_sum_finite P(( ));
+
+:Begin:
+:Function:       omw_test_sum_finite
+:Pattern:        OmwSumFinite[m_List]
+:Arguments:      { m }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_tiled_roundtrip P(( ));
+
+:Begin:
+:Function:       omw_test_tiled_roundtrip
+:Pattern:        OmwTiledRoundtrip[m_List]
+:Arguments:      { m }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_tiled_clamped P(( ));
+
+:Begin:
+:Function:       omw_test_tiled_clamped
+:Pattern:        OmwTiledClamped[m_List, i_Integer, j_Integer]
+:Arguments:      { m, i, j }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_tiled_neighborhood P(( ));
+
+:Begin:
+:Function:       omw_test_tiled_neighborhood
+:Pattern:        OmwTiledNeighborhood[m_List, i_Integer, j_Integer, radius_Integer]
+:Arguments:      { m, i, j, radius }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_frame P(( ));
+
+:Begin:
+:Function:       omw_test_frame
+:Pattern:        OmwFrame[id_String, m_List]
+:Arguments:      { id, m, OMW`FrameSequence[id] }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_progressive P(( ));
+
+:Begin:
+:Function:       omw_test_progressive
+:Pattern:        OmwProgressive[id_String, m_List, levels_Integer]
+:Arguments:      { id, m, levels }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_progressive_capacity P(( ));
+
+:Begin:
+:Function:       omw_test_progressive_capacity
+:Pattern:        OmwProgressiveCapacity[bytes_Integer]
+:Arguments:      { bytes }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_refine P(( ));
+
+:Begin:
+:Function:       omw_test_refine
+:Pattern:        OmwRefine[id_String]
+:Arguments:      { id }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_profile P(( ));
+
+:Begin:
+:Function:       omw_test_profile
+:Pattern:        OmwProfile[enable_?BooleanQ]
+:Arguments:      { enable }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_calls P(( ));
+
+:Begin:
+:Function:       omw_test_calls
+:Pattern:        OmwCalls[name_String]
+:Arguments:      { name }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_slow_threshold P(( ));
+
+:Begin:
+:Function:       omw_test_slow_threshold
+:Pattern:        OmwSlowThreshold[ns_Integer]
+:Arguments:      { ns }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_slow_last P(( ));
+
+:Begin:
+:Function:       omw_test_slow_last
+:Pattern:        OmwSlowLast[]
+:Arguments:      { }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_metrics P(( ));
+
+:Begin:
+:Function:       omw_test_metrics
+:Pattern:        OmwMetrics[target_String, interval_Integer]
+:Arguments:      { target, interval }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_autotune P(( ));
+
+:Begin:
+:Function:       omw_test_autotune
+:Pattern:        OmwAutotune[cache_String]
+:Arguments:      { cache }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_snapshot P(( ));
+
+:Begin:
+:Function:       omw_test_snapshot
+:Pattern:        OmwSnapshot[path_String, m_List]
+:Arguments:      { path, m }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_snapshot_table P(( ));
+
+:Begin:
+:Function:       omw_test_snapshot_table
+:Pattern:        OmwSnapshotTable[path_String, m_List]
+:Arguments:      { path, m }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_snapshot_load P(( ));
+
+:Begin:
+:Function:       omw_test_snapshot_load
+:Pattern:        OmwSnapshotLoad[path_String, warm_?BooleanQ]
+:Arguments:      { path, warm }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_state_put P(( ));
+
+:Begin:
+:Function:       omw_test_state_put
+:Pattern:        OmwStatePut[name_String, m_List]
+:Arguments:      { name, m }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_state_get P(( ));
+
+:Begin:
+:Function:       omw_test_state_get
+:Pattern:        OmwStateGet[name_String]
+:Arguments:      { name }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_pipeline P(( ));
+
+:Begin:
+:Function:       omw_test_pipeline
+:Pattern:        OmwPipeline[p_String, x_List]
+:Arguments:      { p, x }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_flush_policy P(( ));
+
+:Begin:
+:Function:       omw_test_flush_policy
+:Pattern:        OmwFlushPolicy[mode_String, n_Integer]
+:Arguments:      { mode, n }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_fail_after_result P(( ));
+
+:Begin:
+:Function:       omw_test_fail_after_result
+:Pattern:        OmwFailAfterResult[n_Integer]
+:Arguments:      { n }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_pipelined P(( ));
+
+:Begin:
+:Function:       omw_test_pipelined
+:Pattern:        OmwPipelined[calls_List]
+:Arguments:      { calls }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_graphics P(( ));
+
+:Begin:
+:Function:       omw_test_graphics
+:Pattern:        OmwGraphics[n_Integer]
+:Arguments:      { n }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_range_sum P(( ));
+
+:Begin:
+:Function:       omw_test_range_sum
+:Pattern:        OmwRangeSum[x_List]
+:Arguments:      { x }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+void omw_test_messages P(( ));
+
+:Begin:
+:Function:       omw_test_messages
+:Pattern:        OmwMessages[n_Integer, fail_?BooleanQ]
+:Arguments:      { n, fail }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+
+void omw_test_ragged P(( ));
+
+:Begin:
+:Function:       omw_test_ragged
+:Pattern:        OmwRagged[x_List]
+:Arguments:      { x }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+
+void omw_test_matrix_batch P(( ));
+
+:Begin:
+:Function:       omw_test_matrix_batch
+:Pattern:        OmwMatrixBatch[x_List]
+:Arguments:      { x }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+
+void omw_test_bitmask P(( ));
+
+:Begin:
+:Function:       omw_test_bitmask
+:Pattern:        OmwBitmask[x_List]
+:Arguments:      { x }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+
+void omw_test_dictionary P(( ));
+
+:Begin:
+:Function:       omw_test_dictionary
+:Pattern:        OmwDictionary[x_Association]
+:Arguments:      { x }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+
+void omw_test_remote P(( ));
+
+:Begin:
+:Function:       omw_test_remote
+:Pattern:        OmwRemote[m_List, capacity_Integer]
+:Arguments:      { m, capacity }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+
+void omw_test_remote_slice P(( ));
+
+:Begin:
+:Function:       omw_test_remote_slice
+:Pattern:        OmwRemoteSlice[id_Integer, spec_List]
+:Arguments:      { id, spec }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+
+void omw_test_remote_downsample P(( ));
+
+:Begin:
+:Function:       omw_test_remote_downsample
+:Pattern:        OmwRemoteDownsample[id_Integer, levels_Integer]
+:Arguments:      { id, levels }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+
+void omw_test_remote_release P(( ));
+
+:Begin:
+:Function:       omw_test_remote_release
+:Pattern:        OmwRemoteRelease[id_Integer]
+:Arguments:      { id }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+
+void omw_test_remote_limit P(( ));
+
+:Begin:
+:Function:       omw_test_remote_limit
+:Pattern:        OmwRemoteLimit[bytes_Integer]
+:Arguments:      { bytes }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+
+void omw_test_graphics_vertex P(( ));
+
+:Begin:
+:Function:       omw_test_graphics_vertex
+:Pattern:        OmwGraphicsVertex[dimension_Integer, coordinates_Integer]
+:Arguments:      { dimension, coordinates }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+
+void omw_test_load_plugin P(( ));
+
+:Begin:
+:Function:       omw_test_load_plugin
+:Pattern:        OmwLoadPlugin[path_String]
+:Arguments:      { path }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
+
+void omw_test_reload_plugins P(( ));
+
+:Begin:
+:Function:       omw_test_reload_plugins
+:Pattern:        OmwReloadPlugins[]
+:Arguments:      { }
+:ArgumentTypes:  { Manual }
+:ReturnType:     Manual
+:End:
+
 
 :Evaluate: OMW::err = "An error occurred: `1`"
 
@@ -0,0 +1,40 @@
+#include <omw/plugin.hpp>
+
+// Built as version 1 and 2 to test reloading, and as versions 3 and 4, which the
+// loader rejects
+#ifndef OMW_TEST_PLUGIN_VERSION
+#define OMW_TEST_PLUGIN_VERSION 1
+#endif
+
+OMW_PLUGIN(registrar)
+{
+#if OMW_TEST_PLUGIN_VERSION >= 3
+	// Valid on its own, but must not be registered since another stage is rejected
+	registrar.add_elementwise("plugin_offset", 1, 0, [](float *v, const float *const *, std::size_t n, const double *) {
+		for (std::size_t i = 0; i < n; ++i)
+			v[i] += 1.0f;
+	});
+
+#if OMW_TEST_PLUGIN_VERSION == 3
+	// Name of a builtin stage
+	registrar.add_elementwise("scale", 1, 1, [](float *, const float *const *, std::size_t, const double *) {});
+#else
+	// Elementwise stages need a matrix argument
+	registrar.add_elementwise("plugin_fill", 0, 0, [](float *, const float *const *, std::size_t, const double *) {});
+#endif
+#else
+	// Scales by version + 1, so that the tests can tell versions apart
+	registrar.add_elementwise("plugin_scale", 1, 0, [](float *v, const float *const *, std::size_t n, const double *) {
+		for (std::size_t i = 0; i < n; ++i)
+			v[i] *= OMW_TEST_PLUGIN_VERSION + 1;
+	});
+
+#if OMW_TEST_PLUGIN_VERSION == 1
+	// Only in the first version, removed when reloading the second one
+	registrar.add_stage("plugin_identity", 1, 0,
+						[](const std::vector<std::shared_ptr<omw::basic_matrix<float>>> &inputs, const std::vector<double> &) {
+							return inputs[0];
+						});
+#endif
+#endif
+}
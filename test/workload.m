@@ -0,0 +1,13 @@
+% Profiling workload of the Octave test module, run by the PGO build of omw_test_octave
+omw_tests();
+
+A = magic(64);
+for n = 1:2000
+  omw_test_times(2, 3);
+  omw_test_ftimes(2, 3);
+  omw_test_concat("a", "b");
+  omw_test_view_at(A, 1, 0);
+  omw_test_sum_finite(A);
+  omw_test_tiled_roundtrip(A);
+  omw_test_range_sum(1:1000);
+end
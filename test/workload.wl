@@ -0,0 +1,13 @@
+(* Profiling workload of the Mathematica test package, run by the PGO build of omw_test_mathematica *)
+<<OMW`
+
+a = N[Table[i + j, {i, 64}, {j, 64}]];
+Do[
+  OmwTimes[2, 3];
+  OmwFTimes[2., 3.];
+  OmwConcat["a", "b"];
+  OmwViewAt[a, 1, 0];
+  OmwSumFinite[a];
+  OmwTiledRoundtrip[a];
+  OmwRangeSum[N[Range[1000]]],
+  {2000}]